@@ -0,0 +1,129 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file checkpoint_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Background checkpointing tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/clset.h"
+#include "../xcsf/pa.h"
+#include "../xcsf/param.h"
+#include "../xcsf/prediction.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcs_supervised.h"
+#include "../xcsf/xcsf.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+#include "model_fixture.h"
+
+TEST_CASE("CHECKPOINT")
+{
+    /* train with checkpoints enabled */
+    const char *name = "checkpoint_test.xcsf";
+    remove(name);
+    struct ModelFixture f;
+    model_fixture_init(&f, 50, 100, 1000);
+    param_set_checkpoint_trials(&f.xcsf, 30);
+    param_set_checkpoint_file(&f.xcsf, name);
+    model_fixture_fit(&f);
+    /* test the checkpoint after trial 90 is complete and can be loaded */
+    struct XCSF loaded;
+    param_init(&loaded, 1, 1, 1);
+    xcsf_init(&loaded);
+    CHECK(xcsf_load(&loaded, name) > 0);
+    CHECK(loaded.pset.size > 0);
+    CHECK_EQ(loaded.POP_SIZE, 50);
+    FILE *fp = fopen("checkpoint_test.xcsf.tmp", "rb");
+    CHECK(fp == NULL);
+    remove(name);
+    xcsf_free(&loaded);
+    param_free(&loaded);
+    model_fixture_free(&f);
+}
+
+/**
+ * @brief Serialised model recorded by the performance callback.
+ */
+struct Recorded {
+    char *buffer; //!< Serialised model
+    size_t size; //!< Number of bytes in the serialised model
+};
+
+/**
+ * @brief Records the model at the trial a checkpoint is taken.
+ */
+static bool
+record_model(const struct XCSF *xcsf, void *data, const int trial,
+             const double error, const double terror)
+{
+    (void) trial;
+    (void) error;
+    (void) terror;
+    struct Recorded *r = (struct Recorded *) data;
+    free(r->buffer);
+    xcsf_serialise(xcsf, &r->buffer, &r->size);
+    return false;
+}
+
+TEST_CASE("CHECKPOINT_SHARED")
+{
+    /* train past a checkpoint taken by sharing the population */
+    const char *name = "checkpoint_shared_test.xcsf";
+    remove(name);
+    struct ModelFixture f;
+    model_fixture_init(&f, 50, 100, 90); // callback after trial 91
+    param_set_checkpoint_trials(&f.xcsf, 91);
+    param_set_checkpoint_file(&f.xcsf, name);
+    pred_param_set_type(&f.xcsf, PRED_TYPE_NEURAL);
+    struct Recorded recorded = { NULL, 0 };
+    f.xcsf.perf_ptr = record_model;
+    f.xcsf.perf_data = &recorded;
+    model_fixture_fit(&f);
+    /* test the checkpoint is the recorded model and sharing has ended */
+    const struct Clist *iter = f.xcsf.pset.list;
+    while (iter != NULL) {
+        CHECK(iter->cl->share == NULL);
+        iter = iter->next;
+    }
+    FILE *fp = fopen(name, "rb");
+    CHECK(fp != NULL);
+    if (fp != NULL) {
+        fseek(fp, 0, SEEK_END);
+        const size_t size = (size_t) ftell(fp);
+        CHECK_EQ(size, recorded.size);
+        char *file = (char *) malloc(size);
+        fseek(fp, 0, SEEK_SET);
+        CHECK_EQ(fread(file, sizeof(char), size, fp), size);
+        CHECK(size == recorded.size &&
+              memcmp(file, recorded.buffer, size) == 0);
+        free(file);
+        fclose(fp);
+    }
+    free(recorded.buffer);
+    remove(name);
+    model_fixture_free(&f);
+}
@@ -0,0 +1,192 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file clset_export_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Set-wide classifier parameter export tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/cl.h"
+#include "../xcsf/clset.h"
+#include "../xcsf/clset_export.h"
+#include "../xcsf/cond_rectangle.h"
+#include "../xcsf/condition.h"
+#include "../xcsf/neural_layer.h"
+#include "../xcsf/param.h"
+#include "../xcsf/pred_neural.h"
+#include "../xcsf/pred_nlms.h"
+#include "../xcsf/prediction.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcsf.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+#define N_CL (10)
+
+TEST_CASE("CLSET_EXPORT")
+{
+    /* populate a set with random classifiers */
+    struct XCSF xcsf;
+    rand_init();
+    param_init(&xcsf, 3, 1, 1);
+    cond_param_set_type(&xcsf, COND_TYPE_HYPERRECTANGLE);
+    pred_param_set_type(&xcsf, PRED_TYPE_NLMS_LINEAR);
+    xcsf_init(&xcsf);
+    for (int i = 0; i < N_CL; ++i) {
+        struct Cl *c = (struct Cl *) malloc(sizeof(struct Cl));
+        cl_init(&xcsf, c, 1, 0);
+        cl_rand(&xcsf, c);
+        c->fit = i;
+        c->num = i + 1;
+        clset_add(&xcsf.pset, c);
+    }
+    /* test classifier parameters are copied in list order */
+    double err[N_CL];
+    double fit[N_CL];
+    int num[N_CL];
+    int exp[N_CL];
+    clset_export_cl(&xcsf.pset, err, fit, num, exp);
+    int i = 0;
+    for (const struct Clist *iter = xcsf.pset.list; iter != NULL;
+         iter = iter->next) {
+        CHECK_EQ(fit[i], iter->cl->fit);
+        CHECK_EQ(num[i], iter->cl->num);
+        CHECK_EQ(err[i], iter->cl->err);
+        CHECK_EQ(exp[i], iter->cl->exp);
+        ++i;
+    }
+    /* test condition centers and spreads */
+    double center[N_CL * 3];
+    double spread[N_CL * 3];
+    CHECK_EQ(clset_export_cond(&xcsf, &xcsf.pset, center, spread), 3);
+    const struct CondRectangle *cond =
+        (struct CondRectangle *) xcsf.pset.list->cl->cond;
+    CHECK_EQ(center[2], cond->center[2]);
+    CHECK_EQ(spread[1], cond->spread[1]);
+    /* test prediction weights */
+    const int n = clset_export_pred(&xcsf, &xcsf.pset, NULL);
+    CHECK_EQ(n, 4);
+    double *weights = (double *) malloc(sizeof(double) * N_CL * n);
+    clset_export_pred(&xcsf, &xcsf.pset, weights);
+    const struct PredNLMS *pred =
+        (struct PredNLMS *) xcsf.pset.list->next->cl->pred;
+    CHECK_EQ(weights[n], pred->weights[0]);
+    /* test non-neural sets have no layer weights */
+    int n_weights[N_CL];
+    CHECK_EQ(clset_export_layer(&xcsf, &xcsf.pset, false, 0, NULL, n_weights),
+             0);
+    CHECK_EQ(n_weights[0], 0);
+    free(weights);
+    xcsf_free(&xcsf);
+    param_free(&xcsf);
+}
+
+/**
+ * @brief Checks that exported weights are those of a layer's sublayers.
+ * @param [in] sub The sublayers in the order they are exported.
+ * @param [in] n_sub The number of sublayers.
+ * @param [in] weights The exported weights.
+ * @return The number of weights checked.
+ */
+static int
+check_sublayers(const struct Layer *const *sub, const int n_sub,
+                const double *weights)
+{
+    int n = 0;
+    for (int i = 0; i < n_sub; ++i) {
+        for (int j = 0; j < sub[i]->n_weights; ++j) {
+            CHECK_EQ(weights[n], sub[i]->weights[j]);
+            ++n;
+        }
+    }
+    return n;
+}
+
+TEST_CASE("CLSET_EXPORT_RECURRENT")
+{
+    /* populate a set with recurrent and LSTM neural predictions */
+    struct XCSF xcsf;
+    rand_init();
+    param_init(&xcsf, 3, 1, 1);
+    cond_param_set_type(&xcsf, COND_TYPE_HYPERRECTANGLE);
+    pred_param_set_type(&xcsf, PRED_TYPE_NEURAL);
+    struct ArgsLayer *hidden = xcsf.pred->largs;
+    hidden->type = RECURRENT;
+    struct ArgsLayer *lstm = layer_args_copy(hidden);
+    lstm->type = LSTM;
+    lstm->next = hidden->next;
+    hidden->next = lstm;
+    xcsf_init(&xcsf);
+    for (int i = 0; i < N_CL; ++i) {
+        struct Cl *c = (struct Cl *) malloc(sizeof(struct Cl));
+        cl_init(&xcsf, c, 1, 0);
+        cl_rand(&xcsf, c);
+        clset_add(&xcsf.pset, c);
+    }
+    /* test recurrent weights are copied from the sublayers */
+    int n_weights[N_CL];
+    size_t total =
+        clset_export_layer(&xcsf, &xcsf.pset, false, 0, NULL, n_weights);
+    CHECK(total > 0);
+    double *weights = (double *) malloc(sizeof(double) * total);
+    CHECK_EQ(clset_export_layer(&xcsf, &xcsf.pset, false, 0, weights, NULL),
+             total);
+    int offset = 0;
+    int i = 0;
+    for (const struct Clist *iter = xcsf.pset.list; iter != NULL;
+         iter = iter->next) {
+        const struct PredNeural *pred = (struct PredNeural *) iter->cl->pred;
+        const struct Layer *l = pred->net.tail->layer;
+        CHECK_EQ(l->type, RECURRENT);
+        const struct Layer *sub[3] = { l->input_layer, l->self_layer,
+                                       l->output_layer };
+        CHECK_EQ(n_weights[i], l->n_weights);
+        CHECK_EQ(check_sublayers(sub, 3, weights + offset), l->n_weights);
+        offset += n_weights[i];
+        ++i;
+    }
+    free(weights);
+    /* test LSTM weights are copied from the sublayers */
+    total = clset_export_layer(&xcsf, &xcsf.pset, false, 1, NULL, n_weights);
+    weights = (double *) malloc(sizeof(double) * total);
+    clset_export_layer(&xcsf, &xcsf.pset, false, 1, weights, NULL);
+    offset = 0;
+    i = 0;
+    for (const struct Clist *iter = xcsf.pset.list; iter != NULL;
+         iter = iter->next) {
+        const struct PredNeural *pred = (struct PredNeural *) iter->cl->pred;
+        const struct Layer *l = pred->net.tail->prev->layer;
+        CHECK_EQ(l->type, LSTM);
+        const struct Layer *sub[8] = { l->uf, l->ui, l->ug, l->uo,
+                                       l->wf, l->wi, l->wg, l->wo };
+        CHECK_EQ(n_weights[i], l->n_weights);
+        CHECK_EQ(check_sublayers(sub, 8, weights + offset), l->n_weights);
+        offset += n_weights[i];
+        ++i;
+    }
+    free(weights);
+    xcsf_free(&xcsf);
+    param_free(&xcsf);
+}
@@ -0,0 +1,109 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file cond_dgp_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Dynamical GP graph condition tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/cl.h"
+#include "../xcsf/clset.h"
+#include "../xcsf/cond_dgp.h"
+#include "../xcsf/condition.h"
+#include "../xcsf/param.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcsf.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+#define N_CL (20)
+#define N_X (30)
+
+TEST_CASE("COND_DGP_MATCH_BLOCK")
+{
+    /* create a set of random DGP graph conditions */
+    struct XCSF xcsf;
+    rand_init();
+    param_init(&xcsf, 2, 1, 1);
+    param_set_stateful(&xcsf, false);
+    cond_param_set_type(&xcsf, COND_TYPE_DGP);
+    struct Cl cls[N_CL];
+    struct Set set;
+    clset_init(&set);
+    for (int i = 0; i < N_CL; ++i) {
+        cl_init(&xcsf, &cls[i], 1, 1);
+        cond_dgp_init(&xcsf, &cls[i]);
+        clset_add(&set, &cls[i]);
+    }
+    double x[N_X * 2];
+    for (int i = 0; i < N_X * 2; ++i) {
+        x[i] = rand_uniform(0, 1);
+    }
+    bool expected[N_CL][N_X];
+    for (int i = 0; i < N_CL; ++i) {
+        for (int j = 0; j < N_X; ++j) {
+            expected[i][j] = cond_dgp_match(&xcsf, &cls[i], &x[j * 2]);
+        }
+    }
+    /* test matching within an evaluated block is unchanged */
+    cond_dgp_match_block(&xcsf, &set, x, N_X);
+    for (int i = 0; i < N_CL; ++i) {
+        const struct CondDGP *cond = (struct CondDGP *) cls[i].cond;
+        CHECK_EQ(cond->block, x);
+        for (int j = 0; j < N_X; ++j) {
+            CHECK_EQ(cond_dgp_match(&xcsf, &cls[i], &x[j * 2]), expected[i][j]);
+        }
+    }
+    /* test inputs outside the block are evaluated as normal */
+    const double y[2] = { 0.5, 0.5 };
+    for (int i = 0; i < N_CL; ++i) {
+        const struct CondDGP *cond = (struct CondDGP *) cls[i].cond;
+        graph_update(&cond->dgp, y, true);
+        const bool match = graph_output(&cond->dgp, 0) > 0.5;
+        CHECK_EQ(cond_dgp_match(&xcsf, &cls[i], y), match);
+    }
+    /* test stateful graphs are not evaluated as a block */
+    cond_dgp_match_block(&xcsf, &set, NULL, 0);
+    param_set_stateful(&xcsf, true);
+    cond_dgp_match_block(&xcsf, &set, x, N_X);
+    for (int i = 0; i < N_CL; ++i) {
+        CHECK(((struct CondDGP *) cls[i].cond)->block == NULL);
+    }
+    param_set_stateful(&xcsf, false);
+    cond_dgp_match_block(&xcsf, &set, x, N_X);
+    /* test mutation and clearing discard the block */
+    cond_dgp_mutate(&xcsf, &cls[0]);
+    CHECK(((struct CondDGP *) cls[0].cond)->block == NULL);
+    cond_dgp_match_block(&xcsf, &set, NULL, 0);
+    for (int i = 0; i < N_CL; ++i) {
+        CHECK(((struct CondDGP *) cls[i].cond)->block == NULL);
+    }
+    clset_free(&set);
+    for (int i = 0; i < N_CL; ++i) {
+        cond_dgp_free(&xcsf, &cls[i]);
+        free(cls[i].prediction);
+    }
+    param_free(&xcsf);
+}
@@ -30,6 +30,7 @@ extern "C" {
 #include "../xcsf/param.h"
 #include "../xcsf/utils.h"
 #include "../xcsf/xcsf.h"
+#include <math.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -50,23 +51,23 @@ TEST_CASE("COND_ELLIPSOID")
     cond_ellipsoid_init(&xcsf, &c1);
     const double x[5] = { 0.8455260670, 0.7566081103, 0.3125093674,
                           0.3449376898, 0.3677518467 };
-    const double true_center[5] = { 0.6917788795, 0.7276272381, 0.2457498699,
-                                    0.2704867908, 0.0000000000 };
-    const double true_spread[5] = { 0.5881265924, 0.8586376463, 0.2309959724,
-                                    0.5802303236, 0.9674486498 };
-    const double false_center[5] = { 0.8992419107, 0.5587937197, 0.6346787906,
-                                     0.0464343089, 0.4214295062 };
-    const double false_spread[5] = { 0.9658827122, 0.7107445754, 0.7048862747,
-                                     0.1036188594, 0.4501471722 };
+    const real true_center[5] = { 0.6917788795, 0.7276272381, 0.2457498699,
+                                  0.2704867908, 0.0000000000 };
+    const real true_spread[5] = { 0.5881265924, 0.8586376463, 0.2309959724,
+                                  0.5802303236, 0.9674486498 };
+    const real false_center[5] = { 0.8992419107, 0.5587937197, 0.6346787906,
+                                   0.0464343089, 0.4214295062 };
+    const real false_spread[5] = { 0.9658827122, 0.7107445754, 0.7048862747,
+                                   0.1036188594, 0.4501471722 };
     /* test for true match condition */
     struct CondEllipsoid *p = (struct CondEllipsoid *) c1.cond;
-    memcpy(p->center, true_center, sizeof(double) * xcsf.x_dim);
-    memcpy(p->spread, true_spread, sizeof(double) * xcsf.x_dim);
+    memcpy(p->center, true_center, sizeof(real) * xcsf.x_dim);
+    memcpy(p->spread, true_spread, sizeof(real) * xcsf.x_dim);
     bool match = cond_ellipsoid_match(&xcsf, &c1, x);
     CHECK_EQ(match, true);
     /* test for false match condition */
-    memcpy(p->center, false_center, sizeof(double) * xcsf.x_dim);
-    memcpy(p->spread, false_spread, sizeof(double) * xcsf.x_dim);
+    memcpy(p->center, false_center, sizeof(real) * xcsf.x_dim);
+    memcpy(p->spread, false_spread, sizeof(real) * xcsf.x_dim);
     match = cond_ellipsoid_match(&xcsf, &c1, x);
     CHECK_EQ(match, false);
     /* test general */
@@ -74,12 +75,12 @@ TEST_CASE("COND_ELLIPSOID")
     cl_init(&xcsf, &c2, 1, 1);
     cond_ellipsoid_init(&xcsf, &c2);
     struct CondEllipsoid *p2 = (struct CondEllipsoid *) c2.cond;
-    const double center2[5] = { 0.6, 0.7, 0.2, 0.3, 0.0 };
-    const double spread2[5] = { 0.1, 0.1, 0.1, 0.1, 0.1 };
-    memcpy(p2->center, center2, sizeof(double) * xcsf.x_dim);
-    memcpy(p2->spread, spread2, sizeof(double) * xcsf.x_dim);
-    memcpy(p->center, true_center, sizeof(double) * xcsf.x_dim);
-    memcpy(p->spread, true_spread, sizeof(double) * xcsf.x_dim);
+    const real center2[5] = { 0.6, 0.7, 0.2, 0.3, 0.0 };
+    const real spread2[5] = { 0.1, 0.1, 0.1, 0.1, 0.1 };
+    memcpy(p2->center, center2, sizeof(real) * xcsf.x_dim);
+    memcpy(p2->spread, spread2, sizeof(real) * xcsf.x_dim);
+    memcpy(p->center, true_center, sizeof(real) * xcsf.x_dim);
+    memcpy(p->spread, true_spread, sizeof(real) * xcsf.x_dim);
     bool general = cond_ellipsoid_general(&xcsf, &c1, &c2);
     CHECK_EQ(general, true);
     general = cond_ellipsoid_general(&xcsf, &c2, &c1);
@@ -89,3 +90,61 @@ TEST_CASE("COND_ELLIPSOID")
     match = cond_ellipsoid_match(&xcsf, &c2, x);
     CHECK_EQ(match, true);
 }
+
+/**
+ * @brief Checks the hyperellipsoid distance kernel used for an input
+ * dimension against the generic loop.
+ * @param [in] x_dim The number of input dimensions.
+ */
+static void
+check_kernel(const int x_dim)
+{
+    struct XCSF xcsf;
+    struct Cl c;
+    param_init(&xcsf, x_dim, 1, 1);
+    cond_param_set_type(&xcsf, COND_TYPE_HYPERELLIPSOID);
+    cond_param_set_min(&xcsf, 0);
+    cond_param_set_max(&xcsf, 1);
+    cond_param_set_spread_min(&xcsf, 0.1);
+    cl_init(&xcsf, &c, 1, 1);
+    cond_ellipsoid_init(&xcsf, &c);
+    struct CondEllipsoid *p = (struct CondEllipsoid *) c.cond;
+    double x[16];
+    /* test every dimension is read */
+    for (int d = 0; d < x_dim; ++d) {
+        for (int i = 0; i < x_dim; ++i) {
+            x[i] = p->center[i];
+        }
+        CHECK(cond_ellipsoid_match(&xcsf, &c, x));
+        x[d] += p->spread[d] * 1.5;
+        CHECK(!cond_ellipsoid_match(&xcsf, &c, x));
+    }
+    /* test random inputs match as with the generic loop */
+    for (int t = 0; t < 1000; ++t) {
+        const double scale = rand_uniform(0.5, 3) / sqrt(x_dim);
+        double dist = 0;
+        for (int i = 0; i < x_dim; ++i) {
+            p->center[i] = rand_uniform(0, 1);
+            p->spread[i] = rand_uniform(0.1, 1);
+            x[i] = p->center[i] + p->spread[i] * scale * rand_uniform(-1, 1);
+            const double d = (x[i] - p->center[i]) / p->spread[i];
+            dist += d * d;
+        }
+        if (fabs(dist - 1) > 1e-9) {
+            CHECK_EQ(cond_ellipsoid_match(&xcsf, &c, x), dist < 1);
+        }
+    }
+    cond_ellipsoid_free(&xcsf, &c);
+    free(c.prediction);
+    param_free(&xcsf);
+}
+
+TEST_CASE("COND_ELLIPSOID_KERNELS")
+{
+    /* test each fixed-dimension kernel */
+    rand_init();
+    const int x_dims[5] = { 1, 2, 4, 8, 16 };
+    for (int i = 0; i < 5; ++i) {
+        check_kernel(x_dims[i]);
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file cond_gp_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Tree GP condition tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/cl.h"
+#include "../xcsf/clset.h"
+#include "../xcsf/cond_gp.h"
+#include "../xcsf/condition.h"
+#include "../xcsf/param.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcsf.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+#define N_CL (20)
+#define N_X (30)
+
+TEST_CASE("COND_GP_MATCH_BLOCK")
+{
+    /* create a set of random tree GP conditions */
+    struct XCSF xcsf;
+    rand_init();
+    param_init(&xcsf, 2, 1, 1);
+    cond_param_set_type(&xcsf, COND_TYPE_GP);
+    struct Cl cls[N_CL];
+    struct Set set;
+    clset_init(&set);
+    for (int i = 0; i < N_CL; ++i) {
+        cl_init(&xcsf, &cls[i], 1, 1);
+        cond_gp_init(&xcsf, &cls[i]);
+        clset_add(&set, &cls[i]);
+    }
+    double x[N_X * 2];
+    for (int i = 0; i < N_X * 2; ++i) {
+        x[i] = rand_uniform(-1, 1);
+    }
+    bool expected[N_CL][N_X];
+    for (int i = 0; i < N_CL; ++i) {
+        for (int j = 0; j < N_X; ++j) {
+            expected[i][j] = cond_gp_match(&xcsf, &cls[i], &x[j * 2]);
+        }
+    }
+    /* test matching within an evaluated block is unchanged */
+    cond_gp_match_block(&xcsf, &set, x, N_X);
+    for (int i = 0; i < N_CL; ++i) {
+        const struct CondGP *cond = (struct CondGP *) cls[i].cond;
+        CHECK_EQ(cond->block, x);
+        for (int j = 0; j < N_X; ++j) {
+            CHECK_EQ(cond_gp_match(&xcsf, &cls[i], &x[j * 2]), expected[i][j]);
+        }
+    }
+    /* test inputs outside the block are evaluated as normal */
+    const double y[2] = { 0.5, 0.5 };
+    for (int i = 0; i < N_CL; ++i) {
+        const struct CondGP *cond = (struct CondGP *) cls[i].cond;
+        CHECK_EQ(cond_gp_match(&xcsf, &cls[i], y),
+                 tree_eval(&cond->gp, y) > 0.5);
+    }
+    /* test mutation and clearing discard the block */
+    cond_gp_mutate(&xcsf, &cls[0]);
+    CHECK(((struct CondGP *) cls[0].cond)->block == NULL);
+    cond_gp_match_block(&xcsf, &set, NULL, 0);
+    for (int i = 0; i < N_CL; ++i) {
+        CHECK(((struct CondGP *) cls[i].cond)->block == NULL);
+    }
+    clset_free(&set);
+    for (int i = 0; i < N_CL; ++i) {
+        cond_gp_free(&xcsf, &cls[i]);
+        free(cls[i].prediction);
+    }
+    param_free(&xcsf);
+}
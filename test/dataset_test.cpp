@@ -0,0 +1,67 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file dataset_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Binary dataset file tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/dataset.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcsf.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+#define N_SAMPLES (100)
+#define X_DIM (7)
+#define Y_DIM (2)
+
+TEST_CASE("DATASET")
+{
+    /* test a saved dataset is mapped with identical values */
+    rand_init();
+    double x[N_SAMPLES * X_DIM];
+    double y[N_SAMPLES * Y_DIM];
+    for (int i = 0; i < N_SAMPLES * X_DIM; ++i) {
+        x[i] = rand_uniform(-1, 1);
+    }
+    for (int i = 0; i < N_SAMPLES * Y_DIM; ++i) {
+        y[i] = rand_uniform(-1, 1);
+    }
+    struct Input data = { x, y, X_DIM, Y_DIM, N_SAMPLES };
+    const char *name = "dataset_test.bin";
+    CHECK_EQ(dataset_save(&data, name), N_SAMPLES * (X_DIM + Y_DIM) + 1);
+    CHECK(dataset_exists(name));
+    struct Input mapped;
+    dataset_load(&mapped, name);
+    CHECK_EQ(mapped.n_samples, N_SAMPLES);
+    CHECK_EQ(mapped.x_dim, X_DIM);
+    CHECK_EQ(mapped.y_dim, Y_DIM);
+    CHECK_EQ(memcmp(mapped.x, x, sizeof(x)), 0);
+    CHECK_EQ(memcmp(mapped.y, y, sizeof(y)), 0);
+    dataset_free(&mapped);
+    remove(name);
+    CHECK(!dataset_exists(name));
+}
@@ -0,0 +1,175 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file dgp_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Dynamical GP graph tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/dgp.h"
+#include "../xcsf/utils.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+#define N_SAMPLES (13)
+#define N_NODES (10)
+#define N_INPUTS (4)
+
+TEST_CASE("DGP")
+{
+    /* create a random graph */
+    rand_init();
+    struct ArgsDGP args;
+    graph_args_init(&args);
+    graph_param_set_max_k(&args, 2);
+    graph_param_set_max_t(&args, 10);
+    graph_param_set_n(&args, N_NODES);
+    graph_param_set_n_inputs(&args, N_INPUTS);
+    graph_param_set_evolve_cycles(&args, false);
+    struct Graph dgp;
+    graph_init(&dgp, &args);
+    graph_rand(&dgp);
+    /* test updating until a fixed point matches updating all cycles */
+    double x[N_SAMPLES * N_INPUTS];
+    for (int i = 0; i < N_SAMPLES * N_INPUTS; ++i) {
+        x[i] = rand_uniform(0, 1);
+    }
+    double expected[N_SAMPLES * N_NODES];
+    for (int i = 0; i < N_SAMPLES; ++i) {
+        graph_reset(&dgp);
+        for (int t = 0; t < dgp.t; ++t) {
+            double state[N_NODES];
+            for (int j = 0; j < N_NODES; ++j) {
+                const int *c = &dgp.connectivity[j * dgp.max_k];
+                double in[2];
+                for (int k = 0; k < 2; ++k) {
+                    in[k] = (c[k] < N_INPUTS) ? x[i * N_INPUTS + c[k]]
+                                              : dgp.state[c[k] - N_INPUTS];
+                }
+                switch (dgp.function[j]) {
+                    case 0:
+                        state[j] = 1 - in[0];
+                        break;
+                    case 1:
+                        state[j] = in[0] * in[1];
+                        break;
+                    default:
+                        state[j] = in[0] + in[1];
+                        break;
+                }
+                state[j] = clamp(state[j], 0, 1);
+            }
+            memcpy(dgp.state, state, sizeof(double) * N_NODES);
+        }
+        memcpy(&expected[i * N_NODES], dgp.state, sizeof(double) * N_NODES);
+        graph_update(&dgp, &x[i * N_INPUTS], true);
+        for (int j = 0; j < N_NODES; ++j) {
+            CHECK_EQ(dgp.state[j], expected[i * N_NODES + j]);
+        }
+    }
+    /* test batch updates are identical to individual updates */
+    double outputs[N_SAMPLES];
+    for (int j = 0; j < N_NODES; ++j) {
+        graph_update_batch(&dgp, x, N_SAMPLES, j, outputs);
+        for (int i = 0; i < N_SAMPLES; ++i) {
+            CHECK_EQ(outputs[i], expected[i * N_NODES + j]);
+        }
+    }
+    /* test the graph is recompiled after being loaded */
+    FILE *fp = tmpfile();
+    graph_save(&dgp, fp);
+    rewind(fp);
+    struct Graph loaded;
+    graph_load(&loaded, &args, VERSION_BUILD, fp);
+    fclose(fp);
+    for (int i = 0; i < N_SAMPLES; ++i) {
+        graph_update(&loaded, &x[i * N_INPUTS], true);
+        for (int j = 0; j < N_NODES; ++j) {
+            CHECK_EQ(loaded.state[j], expected[i * N_NODES + j]);
+        }
+    }
+    graph_free(&loaded);
+    /* test covering sets the state of a node after updating */
+    for (int i = 0; i < N_SAMPLES; ++i) {
+        const bool high = (i % 2 == 0);
+        CHECK(graph_cover(&dgp, &x[i * N_INPUTS], 0, high));
+        graph_update(&dgp, &x[i * N_INPUTS], true);
+        CHECK_EQ(graph_output(&dgp, 0) > 0.5, high);
+    }
+    graph_free(&dgp);
+}
+
+TEST_CASE("DGP_SPARSE_MUTATE")
+{
+    /* create a large graph that mutates only sampled nodes */
+    rand_init();
+    struct ArgsDGP args;
+    graph_args_init(&args);
+    graph_param_set_max_k(&args, 2);
+    graph_param_set_max_t(&args, 10);
+    graph_param_set_n(&args, 1000);
+    graph_param_set_n_inputs(&args, N_INPUTS);
+    graph_param_set_evolve_cycles(&args, false);
+    graph_param_set_sparse_mutate(&args, true);
+    struct Graph dgp;
+    graph_init(&dgp, &args);
+    graph_rand(&dgp);
+    CHECK(dgp.sparse_mutate);
+    int *function = (int *) malloc(sizeof(int) * dgp.n);
+    int *connectivity = (int *) malloc(sizeof(int) * dgp.klen);
+    memcpy(function, dgp.function, sizeof(int) * dgp.n);
+    memcpy(connectivity, dgp.connectivity, sizeof(int) * dgp.klen);
+    /* probability that a selected connection is redrawn unchanged */
+    double n_change = 0;
+    for (int i = 0; i < dgp.klen; ++i) {
+        n_change += 1 - ((connectivity[i] < N_INPUTS) ? 0.5 / N_INPUTS
+                                                      : 0.5 / dgp.n);
+    }
+    /* test the alterations match the self-adapted mutation rates */
+    double expected_func = 0;
+    double expected_conn = 0;
+    int changed_func = 0;
+    int changed_conn = 0;
+    for (int t = 0; t < 100; ++t) {
+        dgp.mu[0] = 0.1;
+        dgp.mu[1] = 0.1;
+        graph_mutate(&dgp);
+        expected_func += dgp.mu[0] * dgp.n * (DGP_NUM_FUNC - 1) / DGP_NUM_FUNC;
+        expected_conn += dgp.mu[1] * n_change;
+        for (int i = 0; i < dgp.n; ++i) {
+            changed_func += (dgp.function[i] != function[i]) ? 1 : 0;
+        }
+        for (int i = 0; i < dgp.klen; ++i) {
+            changed_conn += (dgp.connectivity[i] != connectivity[i]) ? 1 : 0;
+        }
+        memcpy(dgp.function, function, sizeof(int) * dgp.n);
+        memcpy(dgp.connectivity, connectivity, sizeof(int) * dgp.klen);
+    }
+    CHECK(fabs(changed_func / expected_func - 1) < 0.05);
+    CHECK(fabs(changed_conn / expected_conn - 1) < 0.05);
+    free(function);
+    free(connectivity);
+    graph_free(&dgp);
+}
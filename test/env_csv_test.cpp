@@ -0,0 +1,189 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file env_csv_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief CSV input environment tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/dataset.h"
+#include "../xcsf/env_csv.h"
+#include "../xcsf/param.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcsf.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <utime.h>
+}
+
+#define N_ROWS (50)
+#define N_COLS (300)
+
+TEST_CASE("ENV_CSV")
+{
+    /* write wide files with a header, blank lines, and mixed formats */
+    rand_init();
+    const char *suffix[4] = { "train_x", "train_y", "test_x", "test_y" };
+    const int cols[4] = { N_COLS, 1, N_COLS, 1 };
+    char str[N_ROWS][N_COLS][32];
+    for (int i = 0; i < N_ROWS; ++i) {
+        for (int j = 0; j < N_COLS; ++j) {
+            switch (j % 4) {
+                case 0:
+                    snprintf(str[i][j], 32, "%.17g", rand_uniform(-1, 1));
+                    break;
+                case 1:
+                    snprintf(str[i][j], 32, "%.6f", rand_uniform(0, 1000));
+                    break;
+                case 2:
+                    snprintf(str[i][j], 32, " %.3e ", rand_uniform(-1, 1));
+                    break;
+                default:
+                    snprintf(str[i][j], 32, "%d", rand_uniform_int(-9, 9));
+                    break;
+            }
+        }
+    }
+    for (int f = 0; f < 4; ++f) {
+        char name[64];
+        snprintf(name, 64, "env_csv_test_%s.csv", suffix[f]);
+        FILE *fp = fopen(name, "wt");
+        for (int j = 0; j < cols[f]; ++j) {
+            fprintf(fp, "%sx%d", (j > 0) ? "," : "", j);
+        }
+        fprintf(fp, "\n\n");
+        for (int i = 0; i < N_ROWS; ++i) {
+            for (int j = 0; j < cols[f]; ++j) {
+                fprintf(fp, "%s%s", (j > 0) ? "," : "", str[i][j]);
+            }
+            fprintf(fp, (i % 2 == 0) ? "\r\n" : "\n");
+        }
+        fclose(fp);
+    }
+    /* test the parsed values are identical to strtod */
+    struct XCSF xcsf;
+    env_csv_init(&xcsf, "env_csv_test");
+    const struct EnvCSV *env = (struct EnvCSV *) xcsf.env;
+    CHECK_EQ(env->train_data->n_samples, N_ROWS);
+    CHECK_EQ(env->train_data->x_dim, N_COLS);
+    CHECK_EQ(env->test_data->y_dim, 1);
+    for (int i = 0; i < N_ROWS; ++i) {
+        for (int j = 0; j < N_COLS; ++j) {
+            const double x = strtod(str[i][j], NULL);
+            CHECK_EQ(env->train_data->x[i * N_COLS + j], x);
+            CHECK_EQ(env->test_data->x[i * N_COLS + j], x);
+        }
+        CHECK_EQ(env->train_data->y[i], strtod(str[i][0], NULL));
+    }
+    env_csv_free(&xcsf);
+    param_free(&xcsf);
+    for (int f = 0; f < 4; ++f) {
+        char name[64];
+        snprintf(name, 64, "env_csv_test_%s.csv", suffix[f]);
+        remove(name);
+    }
+}
+
+TEST_CASE("ENV_CSV_STREAM")
+{
+    /* write binary training and test datasets */
+    rand_init();
+    double x[N_ROWS * 2];
+    double y[N_ROWS];
+    for (int i = 0; i < N_ROWS; ++i) {
+        x[i * 2] = i;
+        x[i * 2 + 1] = -i;
+        y[i] = i * 10;
+    }
+    const struct Input data = { x, y, 2, 1, N_ROWS };
+    dataset_save(&data, "env_csv_stream_test_train.bin");
+    dataset_save(&data, "env_csv_stream_test_test.bin");
+    /* test the training data are streamed and the test data mapped */
+    struct XCSF xcsf;
+    env_csv_stream_init(&xcsf, "env_csv_stream_test");
+    const struct EnvCSV *env = (struct EnvCSV *) xcsf.env;
+    CHECK(env->train_stream != NULL);
+    CHECK(env->train_data == NULL);
+    CHECK_EQ(xcsf.x_dim, 2);
+    CHECK_EQ(xcsf.y_dim, 1);
+    CHECK_EQ(env->test_data->n_samples, N_ROWS);
+    bool seen[N_ROWS] = { false };
+    for (int i = 0; i < N_ROWS; ++i) {
+        const double *sx = NULL;
+        const double *sy = NULL;
+        stream_next(env->train_stream, &sx, &sy);
+        const int row = (int) sx[0];
+        CHECK_EQ(sx[1], -row);
+        CHECK_EQ(sy[0], row * 10);
+        CHECK(!seen[row]);
+        seen[row] = true;
+    }
+    env_csv_free(&xcsf);
+    param_free(&xcsf);
+    remove("env_csv_stream_test_train.bin");
+    remove("env_csv_stream_test_test.bin");
+}
+
+TEST_CASE("ENV_CSV_BINARY")
+{
+    /* write csv files and binary files holding different values */
+    const char *suffix[4] = { "train_x", "train_y", "test_x", "test_y" };
+    for (int f = 0; f < 4; ++f) {
+        char name[64];
+        snprintf(name, 64, "env_csv_binary_test_%s.csv", suffix[f]);
+        FILE *fp = fopen(name, "wt");
+        fprintf(fp, "v\n1\n1\n");
+        fclose(fp);
+    }
+    double x[2] = { 2, 2 };
+    double y[2] = { 2, 2 };
+    const struct Input data = { x, y, 1, 1, 2 };
+    dataset_save(&data, "env_csv_binary_test_train.bin");
+    dataset_save(&data, "env_csv_binary_test_test.bin");
+    /* test the binary files are used when at least as new as the csv */
+    struct XCSF xcsf;
+    env_csv_init(&xcsf, "env_csv_binary_test");
+    const struct EnvCSV *env = (struct EnvCSV *) xcsf.env;
+    CHECK(env->binary);
+    CHECK_EQ(env->train_data->x[0], 2);
+    env_csv_free(&xcsf);
+    param_free(&xcsf);
+    /* test the csv files are used when a binary file is older */
+    const struct utimbuf old = { 1, 1 };
+    utime("env_csv_binary_test_test.bin", &old);
+    env_csv_init(&xcsf, "env_csv_binary_test");
+    env = (struct EnvCSV *) xcsf.env;
+    CHECK(!env->binary);
+    CHECK_EQ(env->train_data->x[0], 1);
+    CHECK_EQ(env->test_data->x[0], 1);
+    env_csv_free(&xcsf);
+    param_free(&xcsf);
+    for (int f = 0; f < 4; ++f) {
+        char name[64];
+        snprintf(name, 64, "env_csv_binary_test_%s.csv", suffix[f]);
+        remove(name);
+    }
+    remove("env_csv_binary_test_train.bin");
+    remove("env_csv_binary_test_test.bin");
+}
@@ -0,0 +1,103 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file gp_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Tree GP unit tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/gp.h"
+#include "../xcsf/utils.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+#define N_X (20)
+
+TEST_CASE("GP")
+{
+    rand_init();
+    struct ArgsGPTree args;
+    tree_args_init(&args);
+    tree_param_set_max(&args, 1);
+    tree_param_set_min(&args, -1);
+    tree_param_set_n_inputs(&args, 2);
+    tree_param_set_n_constants(&args, 1);
+    tree_param_set_init_depth(&args, 5);
+    tree_param_set_max_len(&args, 500);
+    tree_args_init_constants(&args);
+    args.constants[0] = 0.5;
+    /* test evaluation of a known tree: (I:0 - (I:1 / 0.5)) */
+    const int len = 5;
+    const int tree[5] = { 1, 5, 3, 6, 4 };
+    const double mu = 0.1;
+    FILE *fp = tmpfile();
+    fwrite(&len, sizeof(int), 1, fp);
+    fwrite(tree, sizeof(int), len, fp);
+    fwrite(&mu, sizeof(double), 1, fp);
+    rewind(fp);
+    struct GPTree gp;
+    tree_load(&gp, &args, VERSION_BUILD, fp);
+    fclose(fp);
+    CHECK_EQ(gp.len, 5);
+    CHECK_EQ(gp.stack_size, 3);
+    const double x[2] = { 0.5, 0.125 };
+    CHECK_EQ(tree_eval(&gp, x), 0.25);
+    /* test covering inserts a root so that the tree evaluates above 0.5 */
+    CHECK(tree_cover(&gp, &args, x));
+    CHECK_EQ(gp.len, 9);
+    CHECK_EQ(tree_eval(&gp, x), 0.75);
+    tree_free(&gp);
+    /* test the compiled code is refreshed by crossover and mutation */
+    double xr[N_X * 2];
+    for (int i = 0; i < N_X * 2; ++i) {
+        xr[i] = rand_uniform(-1, 1);
+    }
+    for (int t = 0; t < 10; ++t) {
+        struct GPTree p1;
+        struct GPTree p2;
+        tree_rand(&p1, &args);
+        tree_copy(&p2, &p1);
+        tree_crossover(&p1, &p2, &args);
+        tree_mutate(&p2, &args);
+        struct GPTree compiled;
+        fp = tmpfile();
+        tree_save(&p2, fp);
+        rewind(fp);
+        tree_load(&compiled, &args, VERSION_BUILD, fp);
+        fclose(fp);
+        /* test batch evaluation is identical to individual evaluation */
+        double out[N_X];
+        tree_eval_batch(&p2, &args, xr, N_X, out);
+        for (int i = 0; i < N_X; ++i) {
+            CHECK_EQ(tree_eval(&p2, &xr[i * 2]),
+                     tree_eval(&compiled, &xr[i * 2]));
+            CHECK_EQ(out[i], tree_eval(&p2, &xr[i * 2]));
+        }
+        tree_free(&p1);
+        tree_free(&p2);
+        tree_free(&compiled);
+    }
+    tree_args_free(&args);
+}
@@ -0,0 +1,140 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file metrics_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Performance log tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/metrics.h"
+#include "../xcsf/pa.h"
+#include "../xcsf/param.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcs_supervised.h"
+#include "../xcsf/xcsf.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+#define N_SAMPLES (20)
+
+/**
+ * @brief Suppresses the display of performance.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] data Unused.
+ * @param [in] trial The number of learning trials executed.
+ * @param [in] error The current training error.
+ * @param [in] terror The current testing error.
+ * @return Whether to stop.
+ */
+static bool
+perf_quiet(const struct XCSF *xcsf, void *data, const int trial,
+           const double error, const double terror)
+{
+    (void) xcsf;
+    (void) data;
+    (void) trial;
+    (void) error;
+    (void) terror;
+    return false;
+}
+
+/**
+ * @brief Reads the lines of a performance log.
+ * @param [in] name The name of the log file.
+ * @param [out] first The first line of the log.
+ * @param [out] second The second line of the log.
+ * @return The number of lines in the log.
+ */
+static int
+read_log(const char *name, char *first, char *second)
+{
+    FILE *fp = fopen(name, "r");
+    CHECK(fp != NULL);
+    if (fp == NULL) {
+        return 0;
+    }
+    char line[1024];
+    int n = 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (n == 0) {
+            strcpy(first, line);
+        } else if (n == 1) {
+            strcpy(second, line);
+        }
+        ++n;
+    }
+    fclose(fp);
+    return n;
+}
+
+TEST_CASE("METRICS")
+{
+    rand_init();
+    double x[N_SAMPLES];
+    double y[N_SAMPLES];
+    for (int i = 0; i < N_SAMPLES; ++i) {
+        x[i] = (double) i / N_SAMPLES;
+        y[i] = x[i] * x[i];
+    }
+    const struct Input data = { x, y, 1, 1, N_SAMPLES };
+    const char *name = "metrics_test.log";
+    char first[1024];
+    char second[1024];
+    struct XCSF xcsf;
+    param_init(&xcsf, 1, 1, 1);
+    param_set_pop_size(&xcsf, 50);
+    param_set_max_trials(&xcsf, 100);
+    param_set_perf_trials(&xcsf, 10);
+    param_set_metrics_format_string(&xcsf, "csv");
+    param_set_metrics_file(&xcsf, name);
+    xcsf_init(&xcsf);
+    pa_init(&xcsf);
+    xcsf.perf_ptr = perf_quiet;
+    /* test a CSV log has a header and one row per report */
+    xcs_supervised_fit(&xcsf, &data, NULL, false);
+    CHECK(xcsf.n_covered > 0);
+    CHECK_EQ(read_log(name, first, second), 10);
+    CHECK_EQ(strncmp(first, "trial,time,error,test_error,trials_per_sec,", 43),
+             0);
+    CHECK_EQ(strncmp(second, "10,", 3), 0);
+    /* test successive fits append to the same log */
+    xcs_supervised_fit(&xcsf, &data, NULL, false);
+    CHECK_EQ(read_log(name, first, second), 19);
+    /* test changing the format restarts the log */
+    param_set_metrics_format(&xcsf, METRICS_JSONL);
+    xcs_supervised_fit(&xcsf, &data, NULL, false);
+    CHECK_EQ(read_log(name, first, second), 9);
+    CHECK_EQ(strncmp(first, "{\"trial\":10,", 12), 0);
+    CHECK(strstr(first, "\"cover_rate\":") != NULL);
+    CHECK(strstr(first, "\"ea_events\":") != NULL);
+    CHECK_EQ(first[strlen(first) - 2], '}');
+    /* test disabling the log closes it */
+    param_set_metrics_format(&xcsf, METRICS_NONE);
+    xcs_supervised_fit(&xcsf, &data, NULL, false);
+    CHECK(xcsf.metrics == NULL);
+    remove(name);
+    pa_free(&xcsf);
+    xcsf_free(&xcsf);
+    param_free(&xcsf);
+}
@@ -0,0 +1,94 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file model_fixture.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Small supervised model shared by the system-level tests.
+ */
+
+#pragma once
+
+extern "C" {
+#include "../xcsf/pa.h"
+#include "../xcsf/param.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcs_supervised.h"
+#include "../xcsf/xcsf.h"
+#include <math.h>
+}
+
+#define N_SAMPLES (20) //!< Number of training samples
+
+/**
+ * @brief A model learning y = sin(6 x) from evenly spaced samples of [0,1).
+ */
+struct ModelFixture {
+    double x[N_SAMPLES]; //!< Feature variables
+    double y[N_SAMPLES]; //!< Target variables
+    struct Input data; //!< Training data referring to x and y
+    struct XCSF xcsf; //!< The model
+};
+
+/**
+ * @brief Seeds the random number generator and creates an empty model.
+ * @details Further parameters may be set before fitting.
+ * @param [out] f The fixture to initialise.
+ * @param [in] pop_size The maximum number of micro-classifiers.
+ * @param [in] max_trials The number of trials executed by each fit.
+ * @param [in] perf_trials The number of trials between performance reports.
+ */
+static inline void
+model_fixture_init(struct ModelFixture *f, const int pop_size,
+                   const int max_trials, const int perf_trials)
+{
+    rand_init();
+    for (int i = 0; i < N_SAMPLES; ++i) {
+        f->x[i] = (double) i / N_SAMPLES;
+        f->y[i] = sin(f->x[i] * 6);
+    }
+    f->data = { f->x, f->y, 1, 1, N_SAMPLES };
+    param_init(&f->xcsf, 1, 1, 1);
+    param_set_pop_size(&f->xcsf, pop_size);
+    param_set_max_trials(&f->xcsf, max_trials);
+    param_set_perf_trials(&f->xcsf, perf_trials);
+    xcsf_init(&f->xcsf);
+    pa_init(&f->xcsf);
+}
+
+/**
+ * @brief Fits the model to the training data in order.
+ * @param [in] f The fixture to fit.
+ * @return The average training error.
+ */
+static inline double
+model_fixture_fit(struct ModelFixture *f)
+{
+    return xcs_supervised_fit(&f->xcsf, &f->data, NULL, false);
+}
+
+/**
+ * @brief Frees the model.
+ * @param [in] f The fixture to free.
+ */
+static inline void
+model_fixture_free(struct ModelFixture *f)
+{
+    pa_free(&f->xcsf);
+    xcsf_free(&f->xcsf);
+    param_free(&f->xcsf);
+}
@@ -0,0 +1,110 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file neural_batch_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Batched neural network forward propagation tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/neural.h"
+#include "../xcsf/neural_activations.h"
+#include "../xcsf/neural_batch.h"
+#include "../xcsf/neural_layer.h"
+#include "../xcsf/utils.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+#define N_NETS (10)
+
+TEST_CASE("NEURAL_BATCH")
+{
+    /* create networks with differing numbers of hidden neurons */
+    rand_init();
+    struct Net nets[N_NETS];
+    struct Net copies[N_NETS];
+    struct Net *batch_nets[N_NETS];
+    struct ArgsLayer args;
+    layer_args_init(&args);
+    args.type = CONNECTED;
+    args.function = LOGISTIC;
+    args.n_inputs = 4;
+    args.eta = 0.1;
+    args.sgd_weights = true;
+    for (int i = 0; i < N_NETS; ++i) {
+        neural_init(&nets[i]);
+        args.n_inputs = 4;
+        args.n_init = 1 + i % 4;
+        args.n_max = args.n_init;
+        neural_push(&nets[i], layer_init(&args));
+        args.n_inputs = args.n_init;
+        args.n_init = 1;
+        args.n_max = 1;
+        neural_push(&nets[i], layer_init(&args));
+        neural_copy(&copies[i], &nets[i]);
+        batch_nets[i] = &nets[i];
+    }
+    /* test batched outputs are identical to individual propagation */
+    const double x[4] = { 0.1, 0.4, -0.3, 0.9 };
+    const double y[1] = { 0.7 };
+    struct NeuralBatch *batch = neural_batch_init();
+    for (int t = 0; t < 3; ++t) {
+        neural_batch_forward(batch, batch_nets, N_NETS, x);
+        for (int i = 0; i < N_NETS; ++i) {
+            neural_batch_propagate(batch, &nets[i], x, true);
+            neural_propagate(&copies[i], x, true);
+            CHECK_EQ(neural_output(&nets[i], 0), neural_output(&copies[i], 0));
+        }
+        /* test modified networks are repacked */
+        neural_learn(&nets[t], y, x);
+        neural_learn(&copies[t], y, x);
+    }
+    CHECK_EQ(batch->n_slots, N_NETS + 2);
+    /* test a network with a different number of inputs is not batched */
+    struct Net odd;
+    struct Net odd_copy;
+    neural_init(&odd);
+    args.n_inputs = 2;
+    args.n_init = 3;
+    args.n_max = 3;
+    neural_push(&odd, layer_init(&args));
+    neural_copy(&odd_copy, &odd);
+    struct Net *mixed[3] = { &nets[0], &odd, &nets[1] };
+    neural_batch_forward(batch, mixed, 3, x);
+    neural_batch_propagate(batch, &odd, x, false);
+    neural_propagate(&odd_copy, x, false);
+    for (int i = 0; i < 3; ++i) {
+        CHECK_EQ(neural_output(&odd, i), neural_output(&odd_copy, i));
+    }
+    neural_batch_propagate(batch, &nets[1], x, false);
+    neural_propagate(&copies[1], x, false);
+    CHECK_EQ(neural_output(&nets[1], 0), neural_output(&copies[1], 0));
+    neural_batch_free(batch);
+    neural_free(&odd);
+    neural_free(&odd_copy);
+    for (int i = 0; i < N_NETS; ++i) {
+        neural_free(&nets[i]);
+        neural_free(&copies[i]);
+    }
+}
@@ -71,61 +71,61 @@ TEST_CASE("NEURAL_LAYER_CONNECTED")
     CHECK_EQ(l->eta, 0.1);
     CHECK_EQ(l->momentum, 0.9);
     /* test one forward pass of input */
-    const double x[10] = { -0.4792173279, -0.2056298252, -0.1775459629,
-                           -0.0814486626, 0.0923277094,  0.2779675621,
-                           -0.3109822596, -0.6788371120, -0.0714929928,
-                           -0.1332985280 };
-    const double output[2] = { 0.7936726123, 0.0963342482 };
-    const double orig_weights[20] = {
-        0.3326639519,  -0.4446678553, 0.1033557369,  -1.2581317787,
-        2.8042169798,  0.2236021733,  -1.2206964138, -0.2022042865,
-        -1.5489524535, -2.0932767781, 5.4797621223,  0.3326639519,
-        -0.4446678553, 0.1033557369,  -1.2581317787, 2.8042169798,
-        0.2236021733,  -1.2206964138, -0.2022042865, -1.5489524535
-    };
-    const double orig_biases[2] = { 0.1033557369, -1.2581317787 };
-    memcpy(l->weights, orig_weights, sizeof(double) * l->n_weights);
-    memcpy(l->biases, orig_biases, sizeof(double) * l->n_outputs);
+    const real x[10] = { -0.4792173279, -0.2056298252, -0.1775459629,
+                         -0.0814486626, 0.0923277094,  0.2779675621,
+                         -0.3109822596, -0.6788371120, -0.0714929928,
+                         -0.1332985280 };
+    const real output[2] = { 0.7936726123, 0.0963342482 };
+    const real orig_weights[20] = {
+      0.3326639519,  -0.4446678553, 0.1033557369,  -1.2581317787,
+      2.8042169798,  0.2236021733,  -1.2206964138, -0.2022042865,
+      -1.5489524535, -2.0932767781, 5.4797621223,  0.3326639519,
+      -0.4446678553, 0.1033557369,  -1.2581317787, 2.8042169798,
+      0.2236021733,  -1.2206964138, -0.2022042865, -1.5489524535
+  };
+    const real orig_biases[2] = { 0.1033557369, -1.2581317787 };
+    memcpy(l->weights, orig_weights, sizeof(real) * l->n_weights);
+    memcpy(l->biases, orig_biases, sizeof(real) * l->n_outputs);
     neural_layer_connected_forward(l, &net, x);
-    double output_error = 0;
+    real output_error = 0;
     for (int i = 0; i < l->n_outputs; ++i) {
         output_error += fabs(l->output[i] - output[i]);
     }
     CHECK_EQ(doctest::Approx(output_error), 0);
     /* test one backward pass of input */
-    const double y[2] = { 0.7343893899, 0.2289711363 };
-    const double new_weights[20] = {
-        0.3331291764,  -0.4444682297, 0.1035280986,  -1.2580527083,
-        2.8041273480,  0.2233323222,  -1.2203945120, -0.2015452710,
-        -1.5488830481, -2.0931473718, 5.4792087908,  0.3324265201,
-        -0.4448728599, 0.1032616917,  -1.2580251719, 2.8045379369,
-        0.2232430956,  -1.2214802376, -0.2022868364, -1.5491063675
-    };
-    const double new_biases[2] = { 0.1023849362, -1.2569771221 };
+    const real y[2] = { 0.7343893899, 0.2289711363 };
+    const real new_weights[20] = {
+      0.3331291764,  -0.4444682297, 0.1035280986,  -1.2580527083,
+      2.8041273480,  0.2233323222,  -1.2203945120, -0.2015452710,
+      -1.5488830481, -2.0931473718, 5.4792087908,  0.3324265201,
+      -0.4448728599, 0.1032616917,  -1.2580251719, 2.8045379369,
+      0.2232430956,  -1.2214802376, -0.2022868364, -1.5491063675
+  };
+    const real new_biases[2] = { 0.1023849362, -1.2569771221 };
     for (int i = 0; i < l->n_outputs; ++i) {
         l->delta[i] = y[i] - l->output[i];
     }
     neural_layer_connected_backward(l, &net, x, 0);
     neural_layer_connected_update(l);
-    double weight_error = 0;
+    real weight_error = 0;
     for (int i = 0; i < l->n_weights; ++i) {
         weight_error += fabs(l->weights[i] - new_weights[i]);
     }
     CHECK_EQ(doctest::Approx(weight_error), 0);
-    double bias_error = 0;
+    real bias_error = 0;
     for (int i = 0; i < l->n_outputs; ++i) {
         bias_error += fabs(l->biases[i] - new_biases[i]);
     }
     CHECK_EQ(doctest::Approx(bias_error), 0);
     /* test convergence on one input */
-    const double conv_weights[20] = {
-        0.4127301724,  -0.4103118294, 0.1330195938,  -1.2445235759,
-        2.7887911379,  0.1771601713,  -1.1687384133, -0.0887861801,
-        -1.5370076147, -2.0710056524, 5.2313215338,  0.2260593034,
-        -0.5367129900, 0.0611303154,  -1.2102663341, 2.9483236736,
-        0.0623796734,  -1.5726258658, -0.2392683912, -1.6180583952
-    };
-    const double conv_biases[2] = { -0.0637213195, -0.7397018847 };
+    const real conv_weights[20] = {
+      0.4127301724,  -0.4103118294, 0.1330195938,  -1.2445235759,
+      2.7887911379,  0.1771601713,  -1.1687384133, -0.0887861801,
+      -1.5370076147, -2.0710056524, 5.2313215338,  0.2260593034,
+      -0.5367129900, 0.0611303154,  -1.2102663341, 2.9483236736,
+      0.0623796734,  -1.5726258658, -0.2392683912, -1.6180583952
+  };
+    const real conv_biases[2] = { -0.0637213195, -0.7397018847 };
     for (int i = 0; i < 200; ++i) {
         neural_layer_connected_forward(l, &net, x);
         for (int j = 0; j < l->n_outputs; ++j) {
@@ -137,14 +137,93 @@ TEST_CASE("NEURAL_LAYER_CONNECTED")
     neural_layer_connected_forward(l, &net, x);
     CHECK_EQ(doctest::Approx(l->output[0]), y[0]);
     CHECK_EQ(doctest::Approx(l->output[1]), y[1]);
-    double conv_weight_error = 0;
+    real conv_weight_error = 0;
     for (int i = 0; i < l->n_weights; ++i) {
         conv_weight_error += fabs(l->weights[i] - conv_weights[i]);
     }
     CHECK_EQ(doctest::Approx(conv_weight_error), 0);
-    double conv_bias_error = 0;
+    real conv_bias_error = 0;
     for (int i = 0; i < l->n_outputs; ++i) {
         conv_bias_error += fabs(l->biases[i] - conv_biases[i]);
     }
     CHECK_EQ(doctest::Approx(conv_bias_error), 0);
+    /* test neuron growth within reserved memory does not reallocate */
+    args.evolve_neurons = true;
+    args.max_neuron_grow = 1;
+    args.n_init = 2;
+    args.n_max = 10;
+    struct Layer *hidden = layer_init(&args);
+    CHECK_EQ(hidden->n_outputs_alloc, 4);
+    const real *weights = hidden->weights;
+    layer_add_neurons(hidden, 2);
+    CHECK_EQ(hidden->n_outputs, 4);
+    CHECK_EQ(hidden->weights, weights);
+    /* test resizing inputs preserves the weights of each neuron */
+    args.n_inputs = 4;
+    args.n_init = 3;
+    struct Layer *next = layer_init(&args);
+    real next_weights[12];
+    memcpy(next_weights, next->weights, sizeof(real) * 12);
+    layer_add_neurons(hidden, 1);
+    layer_resize(next, hidden);
+    CHECK_EQ(next->n_inputs, 5);
+    CHECK_EQ(next->n_weights, 15);
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            CHECK_EQ(next->weights[i * 5 + j], next_weights[i * 4 + j]);
+        }
+    }
+    layer_add_neurons(hidden, -3);
+    layer_resize(next, hidden);
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 2; ++j) {
+            CHECK_EQ(next->weights[i * 2 + j], next_weights[i * 4 + j]);
+        }
+    }
+    layer_free(hidden);
+    layer_free(next);
+    free(hidden);
+    free(next);
+}
+
+TEST_CASE("NEURAL_LAYER_CONNECTED_SPARSE_MUTATE")
+{
+    /* create a layer that mutates only sampled weights and biases */
+    rand_init();
+    struct ArgsLayer args;
+    layer_args_init(&args);
+    args.type = CONNECTED;
+    args.function = LINEAR;
+    args.n_inputs = 100;
+    args.n_init = 10;
+    args.n_max = 10;
+    args.evolve_weights = true;
+    args.sparse_mutate = true;
+    struct Layer *l = layer_init(&args);
+    CHECK(l->options & LAYER_SPARSE_MUTATE);
+    real *orig_weights = (real *) malloc(sizeof(real) * l->n_weights);
+    real *orig_biases = (real *) malloc(sizeof(real) * l->n_biases);
+    memcpy(orig_weights, l->weights, sizeof(real) * l->n_weights);
+    memcpy(orig_biases, l->biases, sizeof(real) * l->n_biases);
+    /* test the elements perturbed match the self-adapted mutation rate */
+    double expected = 0;
+    int changed = 0;
+    for (int t = 0; t < 100; ++t) {
+        l->mu[4] = 0.1;
+        neural_layer_connected_mutate(l);
+        expected += l->mu[4] * (l->n_weights + l->n_biases);
+        for (int i = 0; i < l->n_weights; ++i) {
+            changed += (l->weights[i] != orig_weights[i]) ? 1 : 0;
+        }
+        for (int i = 0; i < l->n_biases; ++i) {
+            changed += (l->biases[i] != orig_biases[i]) ? 1 : 0;
+        }
+        memcpy(l->weights, orig_weights, sizeof(real) * l->n_weights);
+        memcpy(l->biases, orig_biases, sizeof(real) * l->n_biases);
+    }
+    CHECK(fabs(changed / expected - 1) < 0.05);
+    free(orig_weights);
+    free(orig_biases);
+    layer_free(l);
+    free(l);
 }
@@ -70,11 +70,11 @@ TEST_CASE("NEURAL_LAYER_LSTM")
     CHECK_EQ(l->max_outputs, 1);
     CHECK_EQ(l->n_weights, 8);
     /* test forward passing input */
-    const double x[1] = { 0.90598097 };
-    const double orig_weights[8] = { 0.1866107,   -0.6872276,  1.0366809,
-                                     -0.02821708, -0.21004653, 0.4503114,
-                                     0.49545765,  0.71247584 };
-    const double orig_biases[4] = { 0, 1, 0, 0 };
+    const real x[1] = { 0.90598097 };
+    const real orig_weights[8] = { 0.1866107,   -0.6872276,  1.0366809,
+                                   -0.02821708, -0.21004653, 0.4503114,
+                                   0.49545765,  0.71247584 };
+    const real orig_biases[4] = { 0, 1, 0, 0 };
     l->ui->weights[0] = orig_weights[0];
     l->uf->weights[0] = orig_weights[1];
     l->ug->weights[0] = orig_weights[2];
@@ -101,7 +101,7 @@ TEST_CASE("NEURAL_LAYER_LSTM")
     neural_layer_lstm_forward(l, &net, x);
     CHECK_EQ(doctest::Approx(l->output[0]), 0.37268567);
     /* test one backward pass of input */
-    const double y[1] = { 0.946146918 };
+    const real y[1] = { 0.946146918 };
     for (int i = 0; i < l->n_outputs; ++i) {
         l->delta[i] = y[i] - l->output[i];
     }
@@ -69,9 +69,9 @@ TEST_CASE("NEURAL_LAYER_RECURRENT")
     CHECK_EQ(l->n_outputs, 1);
     CHECK_EQ(l->max_outputs, 1);
     /* test forward passing input */
-    const double x[1] = { 0.90598097 };
-    const double orig_weights[2] = { -0.0735234, -1 };
-    const double orig_biases[1] = { 0 };
+    const real x[1] = { 0.90598097 };
+    const real orig_weights[2] = { -0.0735234, -1 };
+    const real orig_biases[1] = { 0 };
     l->input_layer->weights[0] = orig_weights[0];
     l->input_layer->biases[0] = orig_biases[0];
     l->self_layer->weights[0] = orig_weights[1];
@@ -80,7 +80,7 @@ TEST_CASE("NEURAL_LAYER_RECURRENT")
     l->output_layer->biases[0] = 0;
     // first time
     neural_layer_recurrent_forward(l, &net, x);
-    double output_error = fabs(l->output[0] - 0.48335347);
+    real output_error = fabs(l->output[0] - 0.48335347);
     CHECK_EQ(doctest::Approx(output_error), 0);
     // second time
     neural_layer_recurrent_forward(l, &net, x);
@@ -91,7 +91,7 @@ TEST_CASE("NEURAL_LAYER_RECURRENT")
     output_error = fabs(l->output[0] - 0.39353347);
     CHECK_EQ(doctest::Approx(output_error), 0);
     /* test one backward pass of input */
-    const double y[1] = { 0.946146918 };
+    const real y[1] = { 0.946146918 };
     for (int i = 0; i < l->n_outputs; ++i) {
         l->delta[i] = y[i] - l->output[i];
     }
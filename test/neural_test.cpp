@@ -54,17 +54,17 @@ TEST_CASE("NEURAL")
                            -0.3109822596, -0.6788371120, -0.0714929928,
                            -0.1332985280 };
     const double output[2] = { 0.5804315660, 0.2146193788 };
-    const double orig_weights1[20] = {
-        0.3326639519,  -0.4446678553, 0.1033557369,  -1.2581317787,
-        2.8042169798,  0.2236021733,  -1.2206964138, -0.2022042865,
-        -1.5489524535, -2.0932767781, 5.4797621223,  0.3326639519,
-        -0.4446678553, 0.1033557369,  -1.2581317787, 2.8042169798,
-        0.2236021733,  -1.2206964138, -0.2022042865, -1.5489524535
-    };
-    const double orig_biases1[2] = { 0.1033557369, -1.2581317787 };
-    const double orig_weights2[4] = { 0.3326639519, -0.4446678553, 0.1033557369,
-                                      -1.2581317787 };
-    const double orig_biases2[2] = { 0.1033557369, -1.2581317787 };
+    const real orig_weights1[20] = {
+      0.3326639519,  -0.4446678553, 0.1033557369,  -1.2581317787,
+      2.8042169798,  0.2236021733,  -1.2206964138, -0.2022042865,
+      -1.5489524535, -2.0932767781, 5.4797621223,  0.3326639519,
+      -0.4446678553, 0.1033557369,  -1.2581317787, 2.8042169798,
+      0.2236021733,  -1.2206964138, -0.2022042865, -1.5489524535
+  };
+    const real orig_biases1[2] = { 0.1033557369, -1.2581317787 };
+    const real orig_weights2[4] = { 0.3326639519, -0.4446678553, 0.1033557369,
+                                    -1.2581317787 };
+    const real orig_biases2[2] = { 0.1033557369, -1.2581317787 };
     neural_init(&net);
     struct ArgsLayer args;
     layer_args_init(&args);
@@ -78,13 +78,13 @@ TEST_CASE("NEURAL")
     args.decay = 0;
     args.sgd_weights = true;
     l = layer_init(&args);
-    memcpy(l->weights, orig_weights1, sizeof(double) * l->n_weights);
-    memcpy(l->biases, orig_biases1, sizeof(double) * l->n_outputs);
+    memcpy(l->weights, orig_weights1, sizeof(real) * l->n_weights);
+    memcpy(l->biases, orig_biases1, sizeof(real) * l->n_outputs);
     neural_push(&net, l);
     args.n_inputs = 2;
     l = layer_init(&args);
-    memcpy(l->weights, orig_weights2, sizeof(double) * l->n_weights);
-    memcpy(l->biases, orig_biases2, sizeof(double) * l->n_outputs);
+    memcpy(l->weights, orig_weights2, sizeof(real) * l->n_weights);
+    memcpy(l->biases, orig_biases2, sizeof(real) * l->n_outputs);
     neural_push(&net, l);
     neural_propagate(&net, x, false);
     double output_error = 0;
@@ -100,4 +100,47 @@ TEST_CASE("NEURAL")
     }
     CHECK_EQ(doctest::Approx(neural_output(&net, 0)), y[0]);
     CHECK_EQ(doctest::Approx(neural_output(&net, 1)), y[1]);
+    /* test a mini-batch of identical samples equals a single update */
+    struct Net single;
+    struct Net batch;
+    neural_copy(&single, &net);
+    neural_copy(&batch, &net);
+    neural_propagate(&single, x, false);
+    neural_learn(&single, y, x);
+    for (int i = 0; i < 2; ++i) {
+        neural_propagate(&batch, x, false);
+        neural_learn_batch(&batch, y, x, 2);
+    }
+    CHECK_EQ(batch.n_accumulated, 0);
+    neural_propagate(&single, x, false);
+    neural_propagate(&batch, x, false);
+    CHECK_EQ(neural_output(&batch, 0), neural_output(&single, 0));
+    CHECK_EQ(neural_output(&batch, 1), neural_output(&single, 1));
+    neural_free(&single);
+    neural_free(&batch);
+    /* test covering an output whose weighted input is beyond the clamp */
+    l = net.head->layer;
+    memset(l->weights, 0, sizeof(real) * l->n_weights);
+    l->biases[0] = 500;
+    neural_propagate(&net, x, false);
+    const double other = neural_output(&net, 1);
+    CHECK(neural_cover_output(&net, x, 0, false));
+    neural_propagate(&net, x, false);
+    CHECK(neural_output(&net, 0) < 0.5);
+    CHECK_EQ(neural_output(&net, 1), other);
+    l->biases[0] = -500;
+    CHECK(neural_cover_output(&net, x, 0, true));
+    neural_propagate(&net, x, false);
+    CHECK(neural_output(&net, 0) > 0.5);
+    /* test outputs that are not fully-connected are not covered */
+    struct Net soft;
+    neural_init(&soft);
+    args.type = SOFTMAX;
+    args.n_inputs = 10;
+    args.n_init = 10;
+    args.n_max = 10;
+    neural_push(&soft, layer_init(&args));
+    CHECK(!neural_cover_output(&soft, x, 0, true));
+    neural_free(&soft);
+    neural_free(&net);
 }
@@ -0,0 +1,104 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file pipeline_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Specialised trial pipeline unit tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/action.h"
+#include "../xcsf/cl.h"
+#include "../xcsf/condition.h"
+#include "../xcsf/param.h"
+#include "../xcsf/pipeline.h"
+#include "../xcsf/prediction.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcsf.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+#define N_CL (20)
+
+TEST_CASE("PIPELINE")
+{
+    /* test selection */
+    struct XCSF xcsf;
+    rand_init();
+    param_init(&xcsf, 4, 1, 1);
+    param_set_beta(&xcsf, 0.2);
+    action_param_set_type(&xcsf, ACT_TYPE_INTEGER);
+    cond_param_set_type(&xcsf, COND_TYPE_HYPERRECTANGLE);
+    pred_param_set_type(&xcsf, PRED_TYPE_NLMS_LINEAR);
+    CHECK_EQ(strcmp(pipeline_name(&xcsf), "rectangle-nlms"), 0);
+    pred_param_set_type(&xcsf, PRED_TYPE_NEURAL);
+    CHECK_EQ(strcmp(pipeline_name(&xcsf), "neural"), 0);
+    pred_param_set_type(&xcsf, PRED_TYPE_RLS_QUADRATIC);
+    cond_param_set_type(&xcsf, COND_TYPE_HYPERELLIPSOID);
+    CHECK_EQ(strcmp(pipeline_name(&xcsf), "ellipsoid-rls"), 0);
+    action_param_set_type(&xcsf, ACT_TYPE_NEURAL);
+    CHECK_EQ(strcmp(pipeline_name(&xcsf), "generic"), 0);
+    /* test specialised and generic pipelines produce identical results */
+    action_param_set_type(&xcsf, ACT_TYPE_INTEGER);
+    cond_param_set_type(&xcsf, COND_TYPE_HYPERRECTANGLE);
+    pred_param_set_type(&xcsf, PRED_TYPE_NLMS_LINEAR);
+    const struct PipelineVtbl *specialised = xcsf.pipe_vptr;
+    action_param_set_type(&xcsf, ACT_TYPE_NEURAL);
+    const struct PipelineVtbl *generic = xcsf.pipe_vptr;
+    action_param_set_type(&xcsf, ACT_TYPE_INTEGER);
+    struct Cl *c1[N_CL];
+    struct Cl *c2[N_CL];
+    for (int i = 0; i < N_CL; ++i) {
+        c1[i] = (struct Cl *) malloc(sizeof(struct Cl));
+        c2[i] = (struct Cl *) malloc(sizeof(struct Cl));
+        cl_init(&xcsf, c1[i], 1, 0);
+        cl_rand(&xcsf, c1[i]);
+        cl_init_copy(&xcsf, c2[i], c1[i]);
+    }
+    const double x[4] = { 0.2, 0.4, 0.6, 0.8 };
+    const double y[1] = { 0.7 };
+    xcsf.pipe_vptr = specialised;
+    pipeline_match(&xcsf, c1, N_CL, x);
+    pipeline_predict(&xcsf, c1, N_CL, x);
+    pipeline_update(&xcsf, c1, N_CL, x, y, N_CL, true);
+    pipeline_update(&xcsf, c1, N_CL, x, y, N_CL, false);
+    xcsf.pipe_vptr = generic;
+    pipeline_match(&xcsf, c2, N_CL, x);
+    pipeline_predict(&xcsf, c2, N_CL, x);
+    pipeline_update(&xcsf, c2, N_CL, x, y, N_CL, true);
+    pipeline_update(&xcsf, c2, N_CL, x, y, N_CL, false);
+    for (int i = 0; i < N_CL; ++i) {
+        CHECK_EQ(c1[i]->m, c2[i]->m);
+        CHECK_EQ(c1[i]->age, c2[i]->age);
+        CHECK_EQ(c1[i]->mtotal, c2[i]->mtotal);
+        CHECK_EQ(c1[i]->exp, c2[i]->exp);
+        CHECK_EQ(c1[i]->action, c2[i]->action);
+        CHECK_EQ(c1[i]->err, c2[i]->err);
+        CHECK_EQ(c1[i]->size, c2[i]->size);
+        CHECK_EQ(c1[i]->prediction[0], c2[i]->prediction[0]);
+        cl_free(&xcsf, c1[i]);
+        cl_free(&xcsf, c2[i]);
+    }
+    param_free(&xcsf);
+}
@@ -58,21 +58,21 @@ TEST_CASE("PRED_NLMS")
                            -0.0814486626, 0.0923277094,  0.2779675621,
                            -0.3109822596, -0.6788371120, -0.0714929928,
                            -0.1332985280 };
-    const double orig_weights[11] = {
-        0.3326639519,  -0.4446678553, 0.1033557369,  -1.2581317787,
-        2.8042169798,  0.2236021733,  -1.2206964138, -0.2022042865,
-        -1.5489524535, -2.0932767781, 5.4797621223
-    };
-    memcpy(p->weights, orig_weights, sizeof(double) * 11);
+    const real orig_weights[11] = {
+      0.3326639519,  -0.4446678553, 0.1033557369,  -1.2581317787,
+      2.8042169798,  0.2236021733,  -1.2206964138, -0.2022042865,
+      -1.5489524535, -2.0932767781, 5.4797621223
+  };
+    memcpy(p->weights, orig_weights, sizeof(real) * 11);
     pred_nlms_compute(&xcsf, &c, x);
     CHECK_EQ(doctest::Approx(c.prediction[0]), 0.7343893899);
     /* test one backward pass of input */
     const double y[1] = { -0.8289711363 };
-    const double new_weights[11] = {
-        0.2535580953,  -0.4067589581, 0.1196222604,  -1.2440868532,
-        2.8106600460,  0.2162985108,  -1.2426852759, -0.1776037685,
-        -1.4952524623, -2.0876212637, 5.4903068165
-    };
+    const real new_weights[11] = {
+      0.2535580953,  -0.4067589581, 0.1196222604,  -1.2440868532,
+      2.8106600460,  0.2162985108,  -1.2426852759, -0.1776037685,
+      -1.4952524623, -2.0876212637, 5.4903068165
+  };
     pred_nlms_update(&xcsf, &c, x, y);
     double weight_error = 0;
     for (int i = 0; i < 11; ++i) {
@@ -87,3 +87,53 @@ TEST_CASE("PRED_NLMS")
     pred_nlms_compute(&xcsf, &c, x);
     CHECK_EQ(doctest::Approx(c.prediction[0]), y[0]);
 }
+
+/**
+ * @brief Checks the linear prediction kernel used for an input dimension
+ * against the generic loop.
+ * @param [in] x_dim The number of input dimensions.
+ */
+static void
+check_kernel(const int x_dim)
+{
+    struct XCSF xcsf;
+    struct Cl c;
+    param_init(&xcsf, x_dim, 2, 1);
+    pred_param_set_type(&xcsf, PRED_TYPE_NLMS_LINEAR);
+    pred_param_set_x0(&xcsf, 0.5);
+    cl_init(&xcsf, &c, 1, 1);
+    pred_nlms_init(&xcsf, &c);
+    struct PredNLMS *p = (struct PredNLMS *) c.pred;
+    CHECK_EQ(p->n, x_dim + 1);
+    double x[16];
+    for (int t = 0; t < 100; ++t) {
+        for (int i = 0; i < p->n_weights; ++i) {
+            p->weights[i] = rand_uniform(-1, 1);
+        }
+        for (int i = 0; i < x_dim; ++i) {
+            x[i] = rand_uniform(-1, 1);
+        }
+        pred_nlms_compute(&xcsf, &c, x);
+        for (int j = 0; j < 2; ++j) {
+            const real *w = &p->weights[j * p->n];
+            double expected = w[0] * 0.5;
+            for (int i = 0; i < x_dim; ++i) {
+                expected += w[i + 1] * x[i];
+            }
+            CHECK_EQ(doctest::Approx(c.prediction[j]), expected);
+        }
+    }
+    pred_nlms_free(&xcsf, &c);
+    free(c.prediction);
+    param_free(&xcsf);
+}
+
+TEST_CASE("PRED_NLMS_KERNELS")
+{
+    /* test each fixed-length kernel */
+    rand_init();
+    const int x_dims[5] = { 1, 2, 4, 8, 16 };
+    for (int i = 0; i < 5; ++i) {
+        check_kernel(x_dims[i]);
+    }
+}
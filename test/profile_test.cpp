@@ -0,0 +1,99 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file profile_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Per-phase timing and event counter tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/condition.h"
+#include "../xcsf/pa.h"
+#include "../xcsf/param.h"
+#include "../xcsf/prediction.h"
+#include "../xcsf/profile.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcs_supervised.h"
+#include "../xcsf/xcsf.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+#define N_SAMPLES (20)
+#define N_TRIALS (50)
+
+TEST_CASE("PROFILE")
+{
+    rand_init();
+    double x[N_SAMPLES];
+    double y[N_SAMPLES];
+    for (int i = 0; i < N_SAMPLES; ++i) {
+        x[i] = (double) i / N_SAMPLES;
+        y[i] = x[i] * x[i];
+    }
+    const struct Input data = { x, y, 1, 1, N_SAMPLES };
+    struct XCSF xcsf;
+    param_init(&xcsf, 1, 1, 1);
+    param_set_pop_size(&xcsf, 20);
+    param_set_max_trials(&xcsf, N_TRIALS);
+    param_set_perf_trials(&xcsf, 1000);
+    cond_param_set_type(&xcsf, COND_TYPE_HYPERRECTANGLE);
+    pred_param_set_type(&xcsf, PRED_TYPE_NLMS_LINEAR);
+    xcsf_init(&xcsf);
+    pa_init(&xcsf);
+    /* test each trial is counted when instrumentation is compiled in */
+    profile_reset();
+    xcs_supervised_fit(&xcsf, &data, NULL, false);
+    const uint64_t expected = profile_enabled() ? N_TRIALS : 0;
+    CHECK_EQ(profile_calls(PROF_MATCH), expected);
+    CHECK_EQ(profile_calls(PROF_PA_BUILD), expected);
+    CHECK_EQ(profile_calls(PROF_UPDATE), expected);
+    CHECK_EQ(profile_counter(PROF_COVERED) > 0, profile_enabled());
+    CHECK_EQ(profile_counter(PROF_ALLOCATED) >= profile_counter(PROF_COVERED),
+             true);
+    CHECK_EQ(profile_time(PROF_MATCH) >= profile_time(PROF_COVER), true);
+    CHECK_EQ(strcmp(profile_phase_name(PROF_EA), "ea"), 0);
+    CHECK_EQ(strcmp(profile_counter_name(PROF_DELETED), "deleted"), 0);
+    /* test hardware events are only sampled once counters are open */
+    CHECK_EQ(profile_hw(PROF_MATCH, PROF_HW_CYCLES), 0);
+    if (profile_hw_open()) {
+        xcs_supervised_fit(&xcsf, &data, NULL, false);
+        CHECK(profile_hw(PROF_MATCH, PROF_HW_INSTRUCTIONS) > 0);
+        CHECK(profile_ipc(PROF_MATCH) > 0);
+        CHECK_EQ(profile_hw(PROF_NEURAL_FORWARD, PROF_HW_CYCLES), 0);
+        profile_hw_close();
+    }
+    /* test resetting */
+    profile_reset();
+    for (int i = 0; i < PROF_PHASES; ++i) {
+        CHECK_EQ(profile_calls(i), 0);
+        CHECK_EQ(profile_time(i), 0);
+        CHECK_EQ(profile_hw(i, PROF_HW_CYCLES), 0);
+    }
+    for (int i = 0; i < PROF_COUNTERS; ++i) {
+        CHECK_EQ(profile_counter(i), 0);
+    }
+    pa_free(&xcsf);
+    xcsf_free(&xcsf);
+    param_free(&xcsf);
+}
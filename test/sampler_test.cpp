@@ -0,0 +1,85 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file sampler_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief In-memory data set sampler tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/sampler.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcsf.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+#define N_SAMPLES (100)
+#define N_EPOCHS (5)
+
+TEST_CASE("SAMPLER")
+{
+    /* create a data set where each sample identifies its row */
+    rand_init();
+    double x[N_SAMPLES * 2];
+    double y[N_SAMPLES];
+    for (int i = 0; i < N_SAMPLES; ++i) {
+        x[i * 2] = i;
+        x[i * 2 + 1] = -i;
+        y[i] = i * 10;
+    }
+    const struct Input data = { x, y, 2, 1, N_SAMPLES };
+    /* test sequential draws read the rows in place and in order */
+    struct Sampler s;
+    sampler_init(&s, &data, false);
+    const double *sx = NULL;
+    const double *sy = NULL;
+    for (int i = 0; i < N_SAMPLES * N_EPOCHS; ++i) {
+        sampler_next(&s, i, &sx, &sy);
+        const int row = i % N_SAMPLES;
+        CHECK_EQ(sx, &x[row * 2]);
+        CHECK_EQ(sy, &y[row]);
+    }
+    sampler_free(&s);
+    /* test each shuffled epoch visits every row exactly once */
+    sampler_init(&s, &data, true);
+    bool in_order = true;
+    for (int e = 0; e < N_EPOCHS; ++e) {
+        bool seen[N_SAMPLES] = { false };
+        for (int i = 0; i < N_SAMPLES; ++i) {
+            sampler_next(&s, e * N_SAMPLES + i, &sx, &sy);
+            const int row = (int) sx[0];
+            CHECK(row >= 0);
+            CHECK(row < N_SAMPLES);
+            CHECK(!seen[row]);
+            seen[row] = true;
+            CHECK_EQ(sx[1], -row);
+            CHECK_EQ(sy[0], row * 10);
+            if (row != i) {
+                in_order = false;
+            }
+        }
+    }
+    CHECK(!in_order);
+    sampler_free(&s);
+}
@@ -0,0 +1,85 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file stream_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Training data stream tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/dataset.h"
+#include "../xcsf/stream.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcsf.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+#define N_SAMPLES (25)
+#define CHUNK (4)
+
+TEST_CASE("STREAM")
+{
+    /* write a dataset where each sample identifies its row */
+    rand_init();
+    double x[N_SAMPLES * 2];
+    double y[N_SAMPLES];
+    for (int i = 0; i < N_SAMPLES; ++i) {
+        x[i * 2] = i;
+        x[i * 2 + 1] = -i;
+        y[i] = i * 10;
+    }
+    struct Input data = { x, y, 2, 1, N_SAMPLES };
+    const char *name = "stream_test.bin";
+    dataset_save(&data, name);
+    /* test sequential epochs */
+    struct Stream *stream = stream_open(name, CHUNK, false);
+    const double *sx = NULL;
+    const double *sy = NULL;
+    for (int i = 0; i < N_SAMPLES * 3; ++i) {
+        stream_next(stream, &sx, &sy);
+        const int row = i % N_SAMPLES;
+        CHECK_EQ(sx[0], row);
+        CHECK_EQ(sx[1], -row);
+        CHECK_EQ(sy[0], row * 10);
+        CHECK_EQ(stream->epoch, i / N_SAMPLES);
+    }
+    stream_free(stream);
+    /* test shuffling draws each sample of a chunk once */
+    stream = stream_open(name, CHUNK, true);
+    for (int start = 0; start < N_SAMPLES; start += CHUNK) {
+        const int n = (N_SAMPLES - start < CHUNK) ? N_SAMPLES - start : CHUNK;
+        bool seen[CHUNK] = { false };
+        for (int i = 0; i < n; ++i) {
+            stream_next(stream, &sx, &sy);
+            const int row = (int) sx[0];
+            CHECK(row >= start);
+            CHECK(row < start + n);
+            CHECK(!seen[row - start]);
+            seen[row - start] = true;
+            CHECK_EQ(sy[0], row * 10);
+        }
+    }
+    stream_free(stream);
+    remove(name);
+}
@@ -25,6 +25,7 @@
 
 extern "C" {
 #include "../xcsf/utils.h"
+#include <math.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -97,4 +98,13 @@ TEST_CASE("UTIL")
     x[1] = -0.2;
     max = max_index(x, 5);
     CHECK_EQ(max, 4);
+    // test geometric skipping
+    CHECK_EQ(rand_skip(1, 10), 0);
+    CHECK_EQ(rand_skip(0, 10), 10);
+    double mean_skip = 0;
+    for (int i = 0; i < 10000; ++i) {
+        mean_skip += rand_skip(0.2, 1000);
+    }
+    mean_skip /= 10000;
+    CHECK(fabs(mean_skip - 4) < 0.5);
 }
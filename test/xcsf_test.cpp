@@ -0,0 +1,323 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file xcsf_test.cpp
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief System-level function tests.
+ */
+
+#include "../lib/doctest/doctest/doctest.h"
+
+extern "C" {
+#include "../xcsf/cl.h"
+#include "../xcsf/clset.h"
+#include "../xcsf/cond_rectangle.h"
+#include "../xcsf/condition.h"
+#include "../xcsf/pa.h"
+#include "../xcsf/pred_rls.h"
+#include "../xcsf/param.h"
+#include "../xcsf/prediction.h"
+#include "../xcsf/utils.h"
+#include "../xcsf/xcs_supervised.h"
+#include "../xcsf/xcsf.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+#include "model_fixture.h"
+
+/**
+ * @brief Serialises each classifier in the population into memory.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [out] sizes The number of bytes serialised for each classifier.
+ * @return The serialised bytes of each classifier.
+ */
+static char **
+serialise(const struct XCSF *xcsf, long *sizes)
+{
+    char **buffers = (char **) malloc(sizeof(char *) * xcsf->pset.size);
+    int i = 0;
+    for (const struct Clist *iter = xcsf->pset.list; iter != NULL;
+         iter = iter->next) {
+        FILE *fp = tmpfile();
+        cl_save(xcsf, iter->cl, fp);
+        sizes[i] = ftell(fp);
+        buffers[i] = (char *) malloc(sizes[i]);
+        rewind(fp);
+        CHECK_EQ(fread(buffers[i], sizeof(char), sizes[i], fp),
+                 (size_t) sizes[i]);
+        fclose(fp);
+        ++i;
+    }
+    return buffers;
+}
+
+TEST_CASE("XCSF_STORE_PSET")
+{
+    struct ModelFixture f;
+    model_fixture_init(&f, 100, 200, 1000);
+    cond_param_set_type(&f.xcsf, COND_TYPE_HYPERRECTANGLE);
+    pred_param_set_type(&f.xcsf, PRED_TYPE_NLMS_LINEAR);
+    model_fixture_fit(&f);
+    /* test the stored population shares components until modified */
+    const int n = f.xcsf.pset.size;
+    long *sizes = (long *) malloc(sizeof(long) * n);
+    char **stored = serialise(&f.xcsf, sizes);
+    xcsf_store_pset(&f.xcsf);
+    CHECK_EQ(f.xcsf.prev_pset.size, n);
+    const struct Cl *c = f.xcsf.pset.list->cl;
+    CHECK(c->share != NULL);
+    CHECK(c->share->share == c);
+    CHECK(c->share->pred == c->pred);
+    model_fixture_fit(&f);
+    /* test the retrieved population is identical to that stored */
+    xcsf_retrieve_pset(&f.xcsf);
+    CHECK_EQ(f.xcsf.prev_pset.size, 0);
+    CHECK_EQ(f.xcsf.pset.size, n);
+    long *retrieved_sizes = (long *) malloc(sizeof(long) * n);
+    char **retrieved = serialise(&f.xcsf, retrieved_sizes);
+    for (int i = 0; i < n; ++i) {
+        const int j = n - 1 - i; // stored in reverse order
+        CHECK_EQ(retrieved_sizes[i], sizes[j]);
+        CHECK_EQ(memcmp(retrieved[i], stored[j], sizes[j]), 0);
+        free(stored[j]);
+        free(retrieved[i]);
+    }
+    for (const struct Clist *iter = f.xcsf.pset.list; iter != NULL;
+         iter = iter->next) {
+        CHECK(iter->cl->share == NULL);
+    }
+    /* test a discarded snapshot leaves the population intact */
+    xcsf_store_pset(&f.xcsf);
+    model_fixture_fit(&f);
+    xcsf_store_pset(&f.xcsf);
+    xcsf_store_pset(&f.xcsf);
+    free(stored);
+    free(retrieved);
+    free(sizes);
+    free(retrieved_sizes);
+    model_fixture_free(&f);
+    /* test updating a stored neural prediction keeps its activations */
+    model_fixture_init(&f, 100, 200, 1000);
+    struct XCSF *net = &f.xcsf;
+    cond_param_set_type(net, COND_TYPE_HYPERRECTANGLE);
+    pred_param_set_type(net, PRED_TYPE_NEURAL);
+    model_fixture_fit(&f);
+    char *buffer = NULL;
+    size_t size = 0;
+    xcsf_serialise(net, &buffer, &size);
+    struct XCSF ref;
+    param_init(&ref, 1, 1, 1);
+    xcsf_init(&ref);
+    xcsf_deserialise(&ref, buffer, size);
+    const struct Clist *last = ref.pset.list; // loaded in reverse order
+    while (last->next != NULL) {
+        last = last->next;
+    }
+    struct Cl *ref_cl = last->cl;
+    struct Cl *live = net->pset.list->cl;
+    const double p_stored = cl_predict(net, live, &f.x[1])[0];
+    cl_predict(net, live, &f.x[0]);
+    cl_predict(&ref, ref_cl, &f.x[0]);
+    xcsf_store_pset(net);
+    const struct Cl *stored_cl = live->share;
+    CHECK(stored_cl != NULL);
+    const void *pred = live->pred;
+    cl_update(net, live, &f.x[0], &f.y[0], live->num, true);
+    cl_update(&ref, ref_cl, &f.x[0], &f.y[0], ref_cl->num, true);
+    CHECK(live->share == NULL);
+    CHECK(live->pred == pred);
+    CHECK(stored_cl->pred != pred);
+    CHECK_EQ(cl_predict(net, live, &f.x[1])[0],
+             cl_predict(&ref, ref_cl, &f.x[1])[0]);
+    CHECK_EQ(cl_predict(net, stored_cl, &f.x[1])[0], p_stored);
+    free(buffer);
+    xcsf_free(&ref);
+    param_free(&ref);
+    model_fixture_free(&f);
+}
+
+/**
+ * @brief Records performance reports and requests a stop after the second.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] data The number of reports received.
+ * @param [in] trial The number of learning trials executed.
+ * @param [in] error The current training error.
+ * @param [in] terror The current testing error.
+ * @return Whether to stop.
+ */
+static bool
+perf_stop(const struct XCSF *xcsf, void *data, const int trial,
+          const double error, const double terror)
+{
+    (void) xcsf;
+    (void) error;
+    (void) terror;
+    int *reports = (int *) data;
+    ++(*reports);
+    CHECK_EQ(trial, *reports * 10);
+    return *reports == 2;
+}
+
+TEST_CASE("XCSF_PERF_CALLBACK")
+{
+    struct ModelFixture f;
+    model_fixture_init(&f, 50, 100, 10);
+    /* test the callback replaces printing and can stop training early */
+    int reports = 0;
+    f.xcsf.perf_ptr = perf_stop;
+    f.xcsf.perf_data = &reports;
+    model_fixture_fit(&f);
+    CHECK_EQ(reports, 2);
+    model_fixture_free(&f);
+}
+
+TEST_CASE("XCSF_SERIALISE")
+{
+    struct ModelFixture f;
+    model_fixture_init(&f, 100, 200, 1000);
+    struct XCSF *xcsf = &f.xcsf;
+    cond_param_set_type(xcsf, COND_TYPE_HYPERRECTANGLE);
+    pred_param_set_type(xcsf, PRED_TYPE_NLMS_LINEAR);
+    model_fixture_fit(&f);
+    /* test a model read from memory serialises identically */
+    char *buffer = NULL;
+    size_t size = 0;
+    xcsf_serialise(xcsf, &buffer, &size);
+    struct XCSF copy;
+    param_init(&copy, 1, 1, 1);
+    xcsf_init(&copy);
+    xcsf_deserialise(&copy, buffer, size);
+    pa_init(&copy);
+    CHECK_EQ(copy.pset.size, xcsf->pset.size);
+    CHECK_EQ(copy.time, xcsf->time);
+    char *copy_buffer = NULL;
+    size_t copy_size = 0;
+    xcsf_serialise(&copy, &copy_buffer, &copy_size);
+    CHECK_EQ(copy_size, size);
+    /* test a saved model holds exactly the serialised bytes */
+    const char *name = "xcsf_serialise_test.bin";
+    xcsf_save(xcsf, name);
+    FILE *fp = fopen(name, "rb");
+    char *saved = (char *) malloc(size + 1);
+    CHECK_EQ(fread(saved, sizeof(char), size + 1, fp), size);
+    fclose(fp);
+    remove(name);
+    CHECK_EQ(memcmp(saved, buffer, size), 0);
+    free(saved);
+    /* test predictions are identical up to summation order */
+    double p1[N_SAMPLES];
+    double p2[N_SAMPLES];
+    xcs_supervised_predict(xcsf, f.x, p1, N_SAMPLES);
+    xcs_supervised_predict(&copy, f.x, p2, N_SAMPLES);
+    for (int i = 0; i < N_SAMPLES; ++i) {
+        CHECK_EQ(doctest::Approx(p1[i]), p2[i]);
+    }
+    free(buffer);
+    free(copy_buffer);
+    pa_free(&copy);
+    xcsf_free(&copy);
+    param_free(&copy);
+    model_fixture_free(&f);
+}
+
+TEST_CASE("XCSF_BYTES")
+{
+    struct ModelFixture f;
+    model_fixture_init(&f, 100, 200, 1000);
+    struct XCSF *xcsf = &f.xcsf;
+    cond_param_set_type(xcsf, COND_TYPE_HYPERRECTANGLE);
+    pred_param_set_type(xcsf, PRED_TYPE_RLS_LINEAR);
+    model_fixture_fit(&f);
+    /* test each component reports its allocations including scratch space */
+    const struct Cl *c = xcsf->pset.list->cl;
+    CHECK_EQ(cond_bytes(xcsf, c),
+             sizeof(struct CondRectangle) + 2 * sizeof(real) + sizeof(double));
+    const size_t n = 2; // offset and one input
+    CHECK_EQ(pred_bytes(xcsf, c),
+             sizeof(struct PredRLS) + sizeof(double) * (n + 3 * n * n + 2 * n));
+    /* test the population totals aggregate every classifier */
+    struct SetBytes bytes;
+    clset_bytes(xcsf, &xcsf->pset, &bytes);
+    const size_t size = xcsf->pset.size;
+    CHECK_EQ(bytes.cond, size * cond_bytes(xcsf, c));
+    CHECK_EQ(bytes.pred, size * pred_bytes(xcsf, c));
+    const size_t cl_size =
+        sizeof(struct Clist) + sizeof(struct Cl) + sizeof(double);
+    CHECK_EQ(bytes.cl, size * cl_size);
+    CHECK_EQ(bytes.shared, 0);
+    model_fixture_free(&f);
+}
+
+#ifndef SINGLE_PRECISION
+/**
+ * @brief Loads a model saved by version 1.2.0 and checks its predictions.
+ * @details Each model was fitted for 400 trials with a population of 20 to
+ * y = 0.5 sin(6 x0) + 0.1 x1, where x0 = i / 20 and x1 = 1 - x0.
+ * @param [in] name The name of the saved model within the test data.
+ * @param [in] size The number of classifiers in the saved population.
+ * @param [in] expected Predictions made before saving for samples 0, 5, 10
+ * and 15.
+ */
+static void
+check_legacy(const char *name, const int size, const double *expected)
+{
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", TEST_DATA_DIR, name);
+    double x[N_SAMPLES * 2];
+    for (int i = 0; i < N_SAMPLES; ++i) {
+        x[2 * i] = (double) i / N_SAMPLES;
+        x[2 * i + 1] = 1 - x[2 * i];
+    }
+    struct XCSF xcsf;
+    param_init(&xcsf, 2, 1, 1);
+    xcsf_init(&xcsf);
+    CHECK(xcsf_load(&xcsf, path) > 0);
+    pa_init(&xcsf);
+    CHECK_EQ(xcsf.pset.size, size);
+    CHECK_EQ(xcsf.load_build, VERSION_BUILD);
+    double p[N_SAMPLES];
+    xcs_supervised_predict(&xcsf, x, p, N_SAMPLES);
+    for (int i = 0; i < 4; ++i) {
+        CHECK_EQ(doctest::Approx(p[i * 5]), expected[i]);
+    }
+    pa_free(&xcsf);
+    xcsf_free(&xcsf);
+    param_free(&xcsf);
+}
+
+TEST_CASE("XCSF_LOAD_LEGACY")
+{
+    rand_init();
+    /* test tree GP conditions with NLMS predictions */
+    const double gp[4] = { 0.59889442320294373, 0.32329821394488339,
+                           0.047702004686823105, -0.22789420457123716 };
+    check_legacy("legacy_gp.xcsf", 17, gp);
+    /* test DGP conditions with NLMS predictions */
+    const double dgp[4] = { 0.48362051670496142, 0.34861967956720408,
+                            0.046071805016421045, -0.23399956741068126 };
+    check_legacy("legacy_dgp.xcsf", 17, dgp);
+    /* test hyperrectangle conditions with neural predictions */
+    const double neural[4] = { 0.24535341841115491, 0.18075224711816223,
+                               0.18067819805848837, 0.125630060737876 };
+    check_legacy("legacy_neural.xcsf", 20, neural);
+}
+#endif
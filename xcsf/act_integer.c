@@ -144,8 +144,9 @@ act_integer_print(const struct XCSF *xcsf, const struct Cl *c)
  * @param [in] c The classifier whose action is being covered.
  * @param [in] x The input state to cover.
  * @param [in] action The action to cover.
+ * @return Whether the action matches the value (always).
  */
-void
+bool
 act_integer_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x,
                   const int action)
 {
@@ -153,6 +154,7 @@ act_integer_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x,
     (void) x;
     struct ActInteger *act = c->act;
     act->action = action;
+    return true;
 }
 
 /**
@@ -238,3 +240,17 @@ act_integer_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
     c->act = new;
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by an integer action.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose action memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+act_integer_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    (void) xcsf;
+    (void) c;
+    return sizeof(struct ActInteger) + sizeof(double) * N_MU;
+}
@@ -53,7 +53,7 @@ void
 act_integer_copy(const struct XCSF *xcsf, struct Cl *dest,
                  const struct Cl *src);
 
-void
+bool
 act_integer_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x,
                   const int action);
 
@@ -76,6 +76,9 @@ act_integer_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp);
 size_t
 act_integer_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
 
+size_t
+act_integer_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
 /**
  * @brief Integer action implemented functions.
  */
@@ -83,5 +86,6 @@ static struct ActVtbl const act_integer_vtbl = {
     &act_integer_general, &act_integer_crossover, &act_integer_mutate,
     &act_integer_compute, &act_integer_copy,      &act_integer_cover,
     &act_integer_free,    &act_integer_init,      &act_integer_print,
-    &act_integer_update,  &act_integer_save,      &act_integer_load
+    &act_integer_update,  &act_integer_save,      &act_integer_load,
+    &act_integer_bytes
 };
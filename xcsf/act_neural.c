@@ -92,7 +92,7 @@ bool
 act_neural_mutate(const struct XCSF *xcsf, const struct Cl *c)
 {
     (void) xcsf;
-    const struct ActNeural *act = c->act;
+    struct ActNeural *act = c->act;
     return neural_mutate(&act->net);
 }
 
@@ -108,8 +108,14 @@ act_neural_compute(const struct XCSF *xcsf, const struct Cl *c, const double *x)
 {
     struct ActNeural *act = c->act;
     neural_propagate(&act->net, x, xcsf->explore);
-    const double *outputs = neural_outputs(&act->net);
-    return max_index(outputs, xcsf->n_actions);
+    const real *outputs = neural_outputs(&act->net);
+    int action = 0;
+    for (int i = 1; i < xcsf->n_actions; ++i) {
+        if (outputs[i] > outputs[action]) {
+            action = i;
+        }
+    }
+    return action;
 }
 
 /**
@@ -147,15 +153,21 @@ act_neural_print(const struct XCSF *xcsf, const struct Cl *c)
  * @param [in] c The classifier whose action is being covered.
  * @param [in] x The input state to cover.
  * @param [in] action The action to cover.
+ * @return Whether a network computing the action was found within
+ * ACT_COVER_ATTEMPTS random networks.
  */
-void
+bool
 act_neural_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x,
                  const int action)
 {
-    const struct ActNeural *act = c->act;
-    do {
+    struct ActNeural *act = c->act;
+    for (int i = 0; i < ACT_COVER_ATTEMPTS; ++i) {
         neural_rand(&act->net);
-    } while (action != act_neural_compute(xcsf, c, x));
+        if (act_neural_compute(xcsf, c, x) == action) {
+            return true;
+        }
+    }
+    return false;
 }
 
 /**
@@ -221,3 +233,17 @@ act_neural_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
     c->act = new;
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by a neural action.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose action memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+act_neural_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    (void) xcsf;
+    const struct ActNeural *act = c->act;
+    return sizeof(struct ActNeural) + neural_bytes(&act->net);
+}
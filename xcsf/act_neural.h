@@ -54,7 +54,7 @@ act_neural_compute(const struct XCSF *xcsf, const struct Cl *c,
 void
 act_neural_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src);
 
-void
+bool
 act_neural_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x,
                  const int action);
 
@@ -77,6 +77,9 @@ act_neural_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp);
 size_t
 act_neural_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
 
+size_t
+act_neural_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
 /**
  * @brief neural action implemented functions.
  */
@@ -84,5 +87,6 @@ static struct ActVtbl const act_neural_vtbl = {
     &act_neural_general, &act_neural_crossover, &act_neural_mutate,
     &act_neural_compute, &act_neural_copy,      &act_neural_cover,
     &act_neural_free,    &act_neural_init,      &act_neural_print,
-    &act_neural_update,  &act_neural_save,      &act_neural_load
+    &act_neural_update,  &act_neural_save,      &act_neural_load,
+    &act_neural_bytes
 };
@@ -24,6 +24,7 @@
 #include "action.h"
 #include "act_integer.h"
 #include "act_neural.h"
+#include "pipeline.h"
 #include "utils.h"
 
 /**
@@ -170,7 +171,7 @@ action_param_load(struct XCSF *xcsf, FILE *fp)
     struct ArgsAct *act = xcsf->act;
     size_t s = 0;
     s += fread(&act->type, sizeof(int), 1, fp);
-    s += layer_args_load(&act->largs, fp);
+    s += layer_args_load(&act->largs, xcsf->load_build, fp);
     return s;
 }
 
@@ -190,6 +191,7 @@ void
 action_param_set_type_string(struct XCSF *xcsf, const char *a)
 {
     xcsf->act->type = action_type_as_int(a);
+    pipeline_set(xcsf);
 }
 
 void
@@ -201,4 +203,5 @@ action_param_set_type(struct XCSF *xcsf, const int a)
     } else {
         xcsf->act->type = a;
     }
+    pipeline_set(xcsf);
 }
@@ -31,6 +31,8 @@
 #define ACT_STRING_INTEGER ("integer\0") //!< Integer
 #define ACT_STRING_NEURAL ("neural\0") //!< Neural
 
+#define ACT_COVER_ATTEMPTS (100) //!< Random covering attempts before failing
+
 /**
  * @brief Parameters for initialising and operating actions.
  */
@@ -77,7 +79,7 @@ struct ActVtbl {
                             const double *x);
     void (*act_impl_copy)(const struct XCSF *xcsf, struct Cl *dest,
                           const struct Cl *src);
-    void (*act_impl_cover)(const struct XCSF *xcsf, const struct Cl *c,
+    bool (*act_impl_cover)(const struct XCSF *xcsf, const struct Cl *c,
                            const double *x, const int action);
     void (*act_impl_free)(const struct XCSF *xcsf, const struct Cl *c);
     void (*act_impl_init)(const struct XCSF *xcsf, struct Cl *c);
@@ -87,6 +89,7 @@ struct ActVtbl {
     size_t (*act_impl_save)(const struct XCSF *xcsf, const struct Cl *c,
                             FILE *fp);
     size_t (*act_impl_load)(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
+    size_t (*act_impl_bytes)(const struct XCSF *xcsf, const struct Cl *c);
 };
 
 /**
@@ -115,6 +118,18 @@ act_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
     return (*c->act_vptr->act_impl_load)(xcsf, c, fp);
 }
 
+/**
+ * @brief Returns the number of bytes of heap memory used by the action.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose action memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+static inline size_t
+act_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    return (*c->act_vptr->act_impl_bytes)(xcsf, c);
+}
+
 /**
  * @brief Returns whether the action of classifier c1 is more general than c2.
  * @param [in] xcsf The XCSF data structure.
@@ -184,12 +199,13 @@ act_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
  * @param [in] c The classifier whose action is being covered.
  * @param [in] x The input state to cover.
  * @param [in] action The action to cover.
+ * @return Whether the action now matches the specified value.
  */
-static inline void
+static inline bool
 act_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x,
           const int action)
 {
-    (*c->act_vptr->act_impl_cover)(xcsf, c, x, action);
+    return (*c->act_vptr->act_impl_cover)(xcsf, c, x, action);
 }
 
 /**
@@ -24,13 +24,13 @@
 #include "blas.h"
 
 static void
-gemm_nn(const int M, const int N, const int K, const double ALPHA,
-        const double *A, const int lda, const double *B, const int ldb,
-        double *C, const int ldc)
+gemm_nn(const int M, const int N, const int K, const real ALPHA,
+        const real *A, const int lda, const real *B, const int ldb,
+        real *C, const int ldc)
 {
     for (int i = 0; i < M; ++i) {
         for (int k = 0; k < K; ++k) {
-            const double A_PART = ALPHA * A[i * lda + k];
+            const real A_PART = ALPHA * A[i * lda + k];
             for (int j = 0; j < N; ++j) {
                 C[i * ldc + j] += A_PART * B[k * ldb + j];
             }
@@ -39,13 +39,13 @@ gemm_nn(const int M, const int N, const int K, const double ALPHA,
 }
 
 static void
-gemm_nt(const int M, const int N, const int K, const double ALPHA,
-        const double *A, const int lda, const double *B, const int ldb,
-        double *C, const int ldc)
+gemm_nt(const int M, const int N, const int K, const real ALPHA,
+        const real *A, const int lda, const real *B, const int ldb,
+        real *C, const int ldc)
 {
     for (int i = 0; i < M; ++i) {
         for (int j = 0; j < N; ++j) {
-            double sum = 0;
+            real sum = 0;
             for (int k = 0; k < K; ++k) {
                 sum += ALPHA * A[i * lda + k] * B[j * ldb + k];
             }
@@ -55,13 +55,13 @@ gemm_nt(const int M, const int N, const int K, const double ALPHA,
 }
 
 static void
-gemm_tn(const int M, const int N, const int K, const double ALPHA,
-        const double *A, const int lda, const double *B, const int ldb,
-        double *C, const int ldc)
+gemm_tn(const int M, const int N, const int K, const real ALPHA,
+        const real *A, const int lda, const real *B, const int ldb,
+        real *C, const int ldc)
 {
     for (int i = 0; i < M; ++i) {
         for (int k = 0; k < K; ++k) {
-            const double A_PART = ALPHA * A[k * lda + i];
+            const real A_PART = ALPHA * A[k * lda + i];
             for (int j = 0; j < N; ++j) {
                 C[i * ldc + j] += A_PART * B[k * ldb + j];
             }
@@ -70,13 +70,13 @@ gemm_tn(const int M, const int N, const int K, const double ALPHA,
 }
 
 static void
-gemm_tt(const int M, const int N, const int K, const double ALPHA,
-        const double *A, const int lda, const double *B, const int ldb,
-        double *C, const int ldc)
+gemm_tt(const int M, const int N, const int K, const real ALPHA,
+        const real *A, const int lda, const real *B, const int ldb,
+        real *C, const int ldc)
 {
     for (int i = 0; i < M; ++i) {
         for (int j = 0; j < N; ++j) {
-            double sum = 0;
+            real sum = 0;
             for (int k = 0; k < K; ++k) {
                 sum += ALPHA * A[i + k * lda] * B[k + j * ldb];
             }
@@ -106,8 +106,8 @@ gemm_tt(const int M, const int N, const int K, const double ALPHA,
  */
 void
 blas_gemm(const int TA, const int TB, const int M, const int N, const int K,
-          const double ALPHA, const double *A, const int lda, const double *B,
-          const int ldb, const double BETA, double *C, const int ldc)
+          const real ALPHA, const real *A, const int lda, const real *B,
+          const int ldb, const real BETA, real *C, const int ldc)
 {
     for (int i = 0; i < M; ++i) {
         for (int j = 0; j < N; ++j) {
@@ -135,8 +135,8 @@ blas_gemm(const int TA, const int TB, const int M, const int N, const int K,
  * @param [in] INCY Stride between consecutive elements of Y.
  */
 void
-blas_axpy(const int N, const double ALPHA, const double *X, const int INCX,
-          double *Y, const int INCY)
+blas_axpy(const int N, const real ALPHA, const real *X, const int INCX,
+          real *Y, const int INCY)
 {
     if (ALPHA != 1) {
         for (int i = 0; i < N; ++i) {
@@ -157,7 +157,7 @@ blas_axpy(const int N, const double ALPHA, const double *X, const int INCX,
  * @param [in] INCX Stride between consecutive elements of X.
  */
 void
-blas_scal(const int N, const double ALPHA, double *X, const int INCX)
+blas_scal(const int N, const real ALPHA, real *X, const int INCX)
 {
     if (ALPHA != 0) {
         for (int i = 0; i < N; ++i) {
@@ -178,7 +178,7 @@ blas_scal(const int N, const double ALPHA, double *X, const int INCX)
  * @param [in] INCX Stride between consecutive elements of X.
  */
 void
-blas_fill(const int N, const double ALPHA, double *X, const int INCX)
+blas_fill(const int N, const real ALPHA, real *X, const int INCX)
 {
     for (int i = 0; i < N; ++i) {
         X[i * INCX] = ALPHA;
@@ -192,15 +192,15 @@ blas_fill(const int N, const double ALPHA, double *X, const int INCX)
  * @param [in] INCX Stride between consecutive elements of X.
  * @param [in] Y Vector with N elements.
  * @param [in] INCY Stride between consecutive elements of Y.
- * @return The resulting dot product.
+ * @return The resulting dot product (accumulated with double precision).
  */
 double
-blas_dot(const int N, const double *X, const int INCX, const double *Y,
+blas_dot(const int N, const real *X, const int INCX, const real *Y,
          const int INCY)
 {
     double dot = 0;
     for (int i = 0; i < N; ++i) {
-        dot += X[i * INCX] * Y[i * INCY];
+        dot += (double) X[i * INCX] * Y[i * INCY];
     }
     return dot;
 }
@@ -214,7 +214,7 @@ blas_dot(const int N, const double *X, const int INCX, const double *Y,
  * @param [in] INCY Stride between consecutive elements of Y.
  */
 void
-blas_mul(const int N, const double *X, const int INCX, double *Y,
+blas_mul(const int N, const real *X, const int INCX, real *Y,
          const int INCY)
 {
     for (int i = 0; i < N; ++i) {
@@ -226,10 +226,10 @@ blas_mul(const int N, const double *X, const int INCX, double *Y,
  * @brief Returns the sum of the vector X.
  * @param [in] X Vector with N elements.
  * @param [in] N The number of elements in vector X.
- * @return The resulting sum.
+ * @return The resulting sum (accumulated with double precision).
  */
 double
-blas_sum(const double *X, const int N)
+blas_sum(const real *X, const int N)
 {
     double sum = 0;
     for (int i = 0; i < N; ++i) {
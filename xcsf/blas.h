@@ -23,28 +23,30 @@
 
 #pragma once
 
+#include "precision.h"
+
 void
 blas_gemm(const int TA, const int TB, const int M, const int N, const int K,
-          const double ALPHA, const double *A, const int lda, const double *B,
-          const int ldb, const double BETA, double *C, const int ldc);
+          const real ALPHA, const real *A, const int lda, const real *B,
+          const int ldb, const real BETA, real *C, const int ldc);
 
 void
-blas_axpy(const int N, const double ALPHA, const double *X, const int INCX,
-          double *Y, const int INCY);
+blas_axpy(const int N, const real ALPHA, const real *X, const int INCX,
+          real *Y, const int INCY);
 
 void
-blas_mul(const int N, const double *X, const int INCX, double *Y,
+blas_mul(const int N, const real *X, const int INCX, real *Y,
          const int INCY);
 
 void
-blas_scal(const int N, const double ALPHA, double *X, const int INCX);
+blas_scal(const int N, const real ALPHA, real *X, const int INCX);
 
 void
-blas_fill(const int N, const double ALPHA, double *X, const int INCX);
+blas_fill(const int N, const real ALPHA, real *X, const int INCX);
 
 double
-blas_dot(const int N, const double *X, const int INCX, const double *Y,
+blas_dot(const int N, const real *X, const int INCX, const real *Y,
          const int INCY);
 
 double
-blas_sum(const double *X, const int N);
+blas_sum(const real *X, const int N);
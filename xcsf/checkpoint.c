@@ -0,0 +1,328 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file checkpoint.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Periodic checkpointing written on a background thread.
+ * @details Between trials, a snapshot of the population is taken by sharing
+ * the classifiers' conditions, predictions, and actions, as when storing the
+ * population, so that only the parameters are copied on the training thread.
+ * The snapshot is serialised to a temporary file on a background thread and
+ * renamed over the checkpoint so that an interrupted write never corrupts the
+ * last checkpoint. Training copies a shared component into the snapshot only
+ * when it is modified, under a lock held by the writer for each classifier.
+ * Populations that cannot be shared are serialised into memory instead.
+ */
+
+#include "checkpoint.h"
+#include "cl.h"
+#include "clset.h"
+#include "condition.h"
+#include "param.h"
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+#define CHECKPOINT_BUFFER (1 << 20) //!< Bytes buffered when writing a snapshot
+
+/**
+ * @brief Writes a snapshot to an open file.
+ * @param [in] c The checkpoint.
+ * @param [in] fp Pointer to the file to be written.
+ * @return Whether the snapshot was written without error.
+ */
+static bool
+checkpoint_write_model(const struct Checkpoint *c, FILE *fp)
+{
+    if (c->buffer != NULL) {
+        return fwrite(c->buffer, sizeof(char), c->size, fp) == c->size;
+    }
+    setvbuf(fp, NULL, _IOFBF, CHECKPOINT_BUFFER);
+    xcsf_write(&c->model, fp);
+    return ferror(fp) == 0;
+}
+
+/**
+ * @brief Writes a snapshot to its checkpoint file.
+ * @details Failures are reported without stopping training.
+ * @param [in] c The checkpoint.
+ */
+static void
+checkpoint_write_file(const struct Checkpoint *c)
+{
+    const size_t len = strlen(c->filename);
+    char *tmp = malloc(len + 5);
+    memcpy(tmp, c->filename, len);
+    memcpy(tmp + len, ".tmp", 5);
+    FILE *fp = fopen(tmp, "wb");
+    if (fp == 0) {
+        printf("Warning: checkpoint %s not written. %s.\n", tmp,
+               strerror(errno));
+        free(tmp);
+        return;
+    }
+    const bool written = checkpoint_write_model(c, fp);
+    fflush(fp);
+#ifndef _WIN32
+    fsync(fileno(fp));
+#endif
+    if (!written || fclose(fp) != 0) {
+        printf("Warning: checkpoint %s not written. %s.\n", tmp,
+               strerror(errno));
+        remove(tmp);
+        free(tmp);
+        return;
+    }
+#ifdef _WIN32
+    remove(c->filename);
+#endif
+    if (rename(tmp, c->filename) != 0) {
+        printf("Warning: checkpoint %s not renamed. %s.\n", tmp,
+               strerror(errno));
+    }
+    free(tmp);
+}
+
+/**
+ * @brief Writes a snapshot and releases any serialised buffer.
+ * @param [in] arg The checkpoint.
+ * @return NULL.
+ */
+static void *
+checkpoint_write(void *arg)
+{
+    struct Checkpoint *c = arg;
+    checkpoint_write_file(c);
+    free(c->buffer);
+    c->buffer = NULL;
+    c->size = 0;
+    return NULL;
+}
+
+#ifdef CHECKPOINT_THREAD
+
+/**
+ * @brief Returns whether a snapshot may share the population's components.
+ * @details Components must not be modified by matching, which rules out
+ * graphs, whose saved states are updated by every match, and any stateful
+ * networks. Each classifier can share with only one other, so a population
+ * still sharing with a stored population is serialised instead.
+ * @param [in] xcsf The XCSF data structure.
+ * @return Whether the snapshot can be taken by sharing components.
+ */
+static bool
+checkpoint_shareable(const struct XCSF *xcsf)
+{
+    if (xcsf->cond->type == COND_TYPE_DGP ||
+        xcsf->cond->type == RULE_TYPE_DGP || !xcsf_pset_shareable(xcsf)) {
+        return false;
+    }
+    const struct Clist *iter = xcsf->pset.list;
+    while (iter != NULL) {
+        if (iter->cl->share != NULL) {
+            return false;
+        }
+        iter = iter->next;
+    }
+    return true;
+}
+
+/**
+ * @brief Takes a snapshot that shares the population's components.
+ * @details The parameters are copied by saving and reloading them, so that
+ * the writer never reads those of the live model. The snapshot classifiers
+ * are listed in the same order as the population.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The checkpoint.
+ */
+static void
+checkpoint_share(struct XCSF *xcsf, struct Checkpoint *c)
+{
+    struct XCSF *model = &c->model;
+    char *params = NULL;
+    size_t size = 0;
+    FILE *fp = open_memstream(&params, &size);
+    param_save(xcsf, fp);
+    fclose(fp);
+    param_init(model, xcsf->x_dim, xcsf->y_dim, xcsf->n_actions);
+    fp = fmemopen(params, size, "rb");
+    param_load(model, fp);
+    fclose(fp);
+    free(params);
+    struct Cl **clist = malloc(sizeof(struct Cl *) * xcsf->pset.size);
+    int n = 0;
+    const struct Clist *iter = xcsf->pset.list;
+    while (iter != NULL) {
+        clist[n] = iter->cl;
+        ++n;
+        iter = iter->next;
+    }
+    clset_init(&model->pset);
+    for (int i = n - 1; i >= 0; --i) {
+        struct Cl *new = malloc(sizeof(struct Cl));
+        cl_share(xcsf, new, clist[i]);
+        clset_add(&model->pset, new);
+    }
+    free(clist);
+    model->checkpoint = c;
+    c->shared = true;
+}
+
+/**
+ * @brief Frees a shared snapshot once it has been written.
+ * @details Components still shared are handed back to the population.
+ * @param [in] c The checkpoint.
+ */
+static void
+checkpoint_unshare(struct Checkpoint *c)
+{
+    if (c->shared) {
+        c->shared = false;
+        clset_kill(&c->model, &c->model.pset);
+        c->model.checkpoint = NULL;
+        param_free(&c->model);
+    }
+}
+
+#endif
+
+/**
+ * @brief Takes a snapshot of the current state of XCSF.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The checkpoint.
+ */
+static void
+checkpoint_snapshot(struct XCSF *xcsf, struct Checkpoint *c)
+{
+    const size_t len = strlen(xcsf->CHECKPOINT_FILE);
+    c->filename = realloc(c->filename, len + 1);
+    memcpy(c->filename, xcsf->CHECKPOINT_FILE, len + 1);
+#ifdef CHECKPOINT_THREAD
+    if (checkpoint_shareable(xcsf)) {
+        checkpoint_share(xcsf, c);
+        return;
+    }
+#endif
+    xcsf_serialise(xcsf, &c->buffer, &c->size);
+}
+
+/**
+ * @brief Writes a checkpoint if one is due after the current trial.
+ * @details Any previous checkpoint still being written is waited for first.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] cnt The number of the trial just completed, counting from 0.
+ */
+void
+checkpoint_trial(struct XCSF *xcsf, const int cnt)
+{
+    if (xcsf->CHECKPOINT_TRIALS < 1 || (cnt + 1) % xcsf->CHECKPOINT_TRIALS) {
+        return;
+    }
+    checkpoint_wait(xcsf);
+    if (xcsf->checkpoint == NULL) {
+        xcsf->checkpoint = calloc(1, sizeof(struct Checkpoint));
+#ifdef CHECKPOINT_THREAD
+        pthread_mutex_init(&xcsf->checkpoint->lock, NULL);
+#endif
+    }
+    struct Checkpoint *c = xcsf->checkpoint;
+    checkpoint_snapshot(xcsf, c);
+#ifdef CHECKPOINT_THREAD
+    if (pthread_create(&c->thread, NULL, checkpoint_write, c) == 0) {
+        c->running = true;
+        return;
+    }
+#endif
+    checkpoint_write(c);
+#ifdef CHECKPOINT_THREAD
+    checkpoint_unshare(c);
+#endif
+}
+
+/**
+ * @brief Waits for any checkpoint being written to be completed.
+ * @details Any snapshot sharing the population is then freed, ending the
+ * sharing of its components.
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+checkpoint_wait(struct XCSF *xcsf)
+{
+    struct Checkpoint *c = xcsf->checkpoint;
+    if (c != NULL && c->running) {
+#ifdef CHECKPOINT_THREAD
+        pthread_join(c->thread, NULL);
+        checkpoint_unshare(c);
+#endif
+        c->running = false;
+    }
+}
+
+/**
+ * @brief Completes any checkpoint being written and frees the writer.
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+checkpoint_free(struct XCSF *xcsf)
+{
+    checkpoint_wait(xcsf);
+    if (xcsf->checkpoint != NULL) {
+#ifdef CHECKPOINT_THREAD
+        pthread_mutex_destroy(&xcsf->checkpoint->lock);
+#endif
+        free(xcsf->checkpoint->buffer);
+        free(xcsf->checkpoint->filename);
+        free(xcsf->checkpoint);
+        xcsf->checkpoint = NULL;
+    }
+}
+
+/**
+ * @brief Acquires the lock on components shared with a snapshot.
+ * @details Does nothing unless a snapshot sharing components is being
+ * written.
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+checkpoint_lock(const struct XCSF *xcsf)
+{
+#ifdef CHECKPOINT_THREAD
+    if (xcsf->checkpoint != NULL && xcsf->checkpoint->shared) {
+        pthread_mutex_lock(&xcsf->checkpoint->lock);
+    }
+#else
+    (void) xcsf;
+#endif
+}
+
+/**
+ * @brief Releases the lock on components shared with a snapshot.
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+checkpoint_unlock(const struct XCSF *xcsf)
+{
+#ifdef CHECKPOINT_THREAD
+    if (xcsf->checkpoint != NULL && xcsf->checkpoint->shared) {
+        pthread_mutex_unlock(&xcsf->checkpoint->lock);
+    }
+#else
+    (void) xcsf;
+#endif
+}
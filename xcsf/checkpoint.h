@@ -0,0 +1,62 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file checkpoint.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Periodic checkpointing written on a background thread.
+ */
+
+#pragma once
+
+#include "xcsf.h"
+
+#ifndef _WIN32
+    #include <pthread.h>
+    #define CHECKPOINT_THREAD //!< Whether snapshots are written in background
+#endif
+
+/**
+ * @brief A snapshot of XCSF awaiting or undergoing writing.
+ */
+struct Checkpoint {
+    char *filename; //!< Name of the file to be written
+    char *buffer; //!< Serialised model, or NULL if the snapshot is shared
+    size_t size; //!< Number of bytes in the serialised model
+    struct XCSF model; //!< Snapshot sharing components with the population
+    bool shared; //!< Whether the snapshot shares components
+    bool running; //!< Whether a snapshot is being written
+#ifdef CHECKPOINT_THREAD
+    pthread_t thread; //!< Background writer
+    pthread_mutex_t lock; //!< Guards components shared with the snapshot
+#endif
+};
+
+void
+checkpoint_trial(struct XCSF *xcsf, const int cnt);
+
+void
+checkpoint_wait(struct XCSF *xcsf);
+
+void
+checkpoint_free(struct XCSF *xcsf);
+
+void
+checkpoint_lock(const struct XCSF *xcsf);
+
+void
+checkpoint_unlock(const struct XCSF *xcsf);
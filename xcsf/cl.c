@@ -23,10 +23,12 @@
 
 #include "cl.h"
 #include "action.h"
+#include "checkpoint.h"
 #include "condition.h"
 #include "ea.h"
 #include "loss.h"
 #include "prediction.h"
+#include "profile.h"
 #include "utils.h"
 
 /**
@@ -40,6 +42,7 @@ void
 cl_init(const struct XCSF *xcsf, struct Cl *c, const double size,
         const int time)
 {
+    PROFILE_COUNT(PROF_ALLOCATED, 1);
     c->fit = xcsf->INIT_FITNESS;
     c->err = xcsf->INIT_ERROR;
     c->num = 1;
@@ -51,6 +54,7 @@ cl_init(const struct XCSF *xcsf, struct Cl *c, const double size,
     c->m = false;
     c->age = 0;
     c->mtotal = 0;
+    c->share = NULL;
 }
 
 /**
@@ -83,6 +87,7 @@ cl_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
 void
 cl_init_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
 {
+    PROFILE_COUNT(PROF_ALLOCATED, 1);
     dest->prediction = calloc(xcsf->y_dim, sizeof(double));
     dest->fit = src->fit;
     dest->err = src->err;
@@ -94,6 +99,7 @@ cl_init_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
     dest->m = src->m;
     dest->age = src->age;
     dest->mtotal = src->mtotal;
+    dest->share = NULL;
     dest->cond_vptr = src->cond_vptr;
     dest->pred_vptr = src->pred_vptr;
     dest->act_vptr = src->act_vptr;
@@ -108,16 +114,19 @@ cl_init_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
  * @param [in] c The classifier being covered.
  * @param [in] x The input state to cover.
  * @param [in] action The action to cover.
+ * @return Whether the condition matches the input and the action matches the
+ * specified value.
  */
-void
+bool
 cl_cover(const struct XCSF *xcsf, struct Cl *c, const double *x,
          const int action)
 {
     cl_rand(xcsf, c);
-    cond_cover(xcsf, c, x);
-    act_cover(xcsf, c, x, action);
+    const bool cond_covered = cond_cover(xcsf, c, x);
+    const bool act_covered = act_cover(xcsf, c, x, action);
     c->m = true;
     c->action = action;
+    return cond_covered && act_covered;
 }
 
 /**
@@ -170,23 +179,17 @@ cl_acc(const struct XCSF *xcsf, const struct Cl *c)
 
 /**
  * @brief Updates a classifier's experience, error, and set size.
- * @details Condition, action, and prediction are updated depending on the
- * knowledge representation.
+ * @pre The classifier's current prediction has been computed.
  * @param [in] xcsf The XCSF data structure.
  * @param [in] c The classifier to update.
- * @param [in] x The input state.
  * @param [in] y The true (payoff) value.
  * @param [in] set_num The number of micro-classifiers in the set.
- * @param [in] cur Whether the payoff is for the current or previous state.
  */
 void
-cl_update(const struct XCSF *xcsf, struct Cl *c, const double *x,
-          const double *y, const int set_num, const bool cur)
+cl_update_err_size(const struct XCSF *xcsf, struct Cl *c, const double *y,
+                   const int set_num)
 {
     ++(c->exp);
-    if (!cur) { // propagate inputs for the previous state update
-        cl_predict(xcsf, c, x);
-    }
     const double error = (xcsf->loss_ptr)(xcsf, c->prediction, y);
     if (c->exp * xcsf->BETA < 1) {
         c->err = (c->err * (c->exp - 1) + error) / c->exp;
@@ -195,6 +198,28 @@ cl_update(const struct XCSF *xcsf, struct Cl *c, const double *x,
         c->err += xcsf->BETA * (error - c->err);
         c->size += xcsf->BETA * (set_num - c->size);
     }
+}
+
+/**
+ * @brief Updates a classifier's experience, error, and set size.
+ * @details Condition, action, and prediction are updated depending on the
+ * knowledge representation.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier to update.
+ * @param [in] x The input state.
+ * @param [in] y The true (payoff) value.
+ * @param [in] set_num The number of micro-classifiers in the set.
+ * @param [in] cur Whether the payoff is for the current or previous state.
+ */
+void
+cl_update(const struct XCSF *xcsf, struct Cl *c, const double *x,
+          const double *y, const int set_num, const bool cur)
+{
+    cl_unshare(xcsf, c);
+    if (!cur) { // propagate inputs for the previous state update
+        cl_predict(xcsf, c, x);
+    }
+    cl_update_err_size(xcsf, c, y, set_num);
     cond_update(xcsf, c, x, y);
     pred_update(xcsf, c, x, y);
     act_update(xcsf, c, x, y);
@@ -214,8 +239,92 @@ cl_update_fit(const struct XCSF *xcsf, struct Cl *c, const double acc_sum,
     c->fit += xcsf->BETA * ((acc * c->num) / acc_sum - c->fit);
 }
 
+/**
+ * @brief Creates a classifier sharing the condition, prediction, and action
+ * of another.
+ * @details The classifiers remain linked until either is modified by
+ * cl_unshare() or freed, so that each component is copied at most once and
+ * only if it is written.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] dest The destination classifier.
+ * @param [in] src The source classifier, which must not already be shared.
+ */
+void
+cl_share(const struct XCSF *xcsf, struct Cl *dest, struct Cl *src)
+{
+    *dest = *src;
+    dest->prediction = malloc(sizeof(double) * xcsf->y_dim);
+    memcpy(dest->prediction, src->prediction, sizeof(double) * xcsf->y_dim);
+    dest->share = src;
+    src->share = dest;
+}
+
+/**
+ * @brief Gives a classifier copies of everything saved with the components
+ * of another.
+ * @details Unlike the component copy functions, which start offspring
+ * afresh, the copies are read back from the saved components and so carry
+ * any state that is saved, such as the momentum of gradient descent.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] dest The classifier to receive the copies.
+ * @param [in] src The classifier whose components are copied.
+ */
+static void
+cl_copy_saved(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
+{
+#ifdef _WIN32
+    FILE *fp = tmpfile();
+#else
+    char *buffer = NULL;
+    size_t size = 0;
+    FILE *fp = open_memstream(&buffer, &size);
+#endif
+    act_save(xcsf, src, fp);
+    pred_save(xcsf, src, fp);
+    cond_save(xcsf, src, fp);
+#ifdef _WIN32
+    rewind(fp);
+#else
+    fclose(fp);
+    fp = fmemopen(buffer, size, "rb");
+#endif
+    act_load(xcsf, dest, fp);
+    pred_load(xcsf, dest, fp);
+    cond_load(xcsf, dest, fp);
+    fclose(fp);
+#ifndef _WIN32
+    free(buffer);
+#endif
+}
+
+/**
+ * @brief Ends the sharing of components before a classifier is modified.
+ * @details Must be called before a classifier's condition, prediction, or
+ * action is modified. The classifier keeps the originals, including any
+ * activations and accumulated updates held by them, and the classifier it
+ * shared with receives copies of everything saved with them, so that a
+ * stored or checkpointed population is saved exactly as it was shared. The
+ * copies are made under the checkpoint lock in case the partner belongs to a
+ * snapshot being written.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier to be modified.
+ */
+void
+cl_unshare(const struct XCSF *xcsf, struct Cl *c)
+{
+    if (c->share != NULL) {
+        checkpoint_lock(xcsf);
+        struct Cl *copy = c->share;
+        copy->share = NULL;
+        c->share = NULL;
+        cl_copy_saved(xcsf, copy, c);
+        checkpoint_unlock(xcsf);
+    }
+}
+
 /**
  * @brief Frees the memory used by a classifier.
+ * @details Shared components are left to the classifier sharing them.
  * @param [in] xcsf The XCSF data structure.
  * @param [in] c The classifier to free.
  */
@@ -223,9 +332,13 @@ void
 cl_free(const struct XCSF *xcsf, struct Cl *c)
 {
     free(c->prediction);
-    cond_free(xcsf, c);
-    act_free(xcsf, c);
-    pred_free(xcsf, c);
+    if (c->share != NULL) {
+        c->share->share = NULL;
+    } else {
+        cond_free(xcsf, c);
+        act_free(xcsf, c);
+        pred_free(xcsf, c);
+    }
     free(c);
 }
 
@@ -429,8 +542,60 @@ cl_pred_size(const struct XCSF *xcsf, const struct Cl *c)
     return pred_size(xcsf, c);
 }
 
+/**
+ * @brief Returns the heap memory used by a classifier's own data structure.
+ * @details The condition, prediction, and action are excluded.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose memory usage to return.
+ * @return The number of bytes allocated for the classifier and its prediction.
+ */
+size_t
+cl_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    (void) c;
+    return sizeof(struct Cl) + sizeof(double) * xcsf->y_dim;
+}
+
+/**
+ * @brief Returns the heap memory used by a classifier's condition.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose condition memory usage to return.
+ * @return The number of bytes allocated for the condition.
+ */
+size_t
+cl_cond_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    return cond_bytes(xcsf, c);
+}
+
+/**
+ * @brief Returns the heap memory used by a classifier's prediction.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose prediction memory usage to return.
+ * @return The number of bytes allocated for the prediction.
+ */
+size_t
+cl_pred_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    return pred_bytes(xcsf, c);
+}
+
+/**
+ * @brief Returns the heap memory used by a classifier's action.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose action memory usage to return.
+ * @return The number of bytes allocated for the action.
+ */
+size_t
+cl_act_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    return act_bytes(xcsf, c);
+}
+
 /**
  * @brief Writes a classifier to a file.
+ * @details Holds the checkpoint lock so that components shared with a
+ * snapshot are not handed over while being written.
  * @param [in] xcsf The XCSF data structure.
  * @param [in] c The classifier to save.
  * @param [in] fp Pointer to the file to be written.
@@ -439,6 +604,7 @@ cl_pred_size(const struct XCSF *xcsf, const struct Cl *c)
 size_t
 cl_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp)
 {
+    checkpoint_lock(xcsf);
     size_t s = 0;
     s += fwrite(&c->err, sizeof(double), 1, fp);
     s += fwrite(&c->fit, sizeof(double), 1, fp);
@@ -454,6 +620,7 @@ cl_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp)
     s += act_save(xcsf, c, fp);
     s += pred_save(xcsf, c, fp);
     s += cond_save(xcsf, c, fp);
+    checkpoint_unlock(xcsf);
     return s;
 }
 
@@ -480,6 +647,7 @@ cl_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
     c->prediction = malloc(sizeof(double) * xcsf->y_dim);
     s += fread(c->prediction, sizeof(double), xcsf->y_dim, fp);
     s += fread(&c->action, sizeof(int), 1, fp);
+    c->share = NULL;
     action_set(xcsf, c);
     prediction_set(xcsf, c);
     condition_set(xcsf, c);
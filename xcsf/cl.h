@@ -64,6 +64,18 @@ cl_cond_size(const struct XCSF *xcsf, const struct Cl *c);
 double
 cl_pred_size(const struct XCSF *xcsf, const struct Cl *c);
 
+size_t
+cl_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
+size_t
+cl_cond_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
+size_t
+cl_pred_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
+size_t
+cl_act_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
 size_t
 cl_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
 
@@ -73,13 +85,19 @@ cl_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp);
 void
 cl_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src);
 
-void
+bool
 cl_cover(const struct XCSF *xcsf, struct Cl *c, const double *x,
          const int action);
 
 void
 cl_free(const struct XCSF *xcsf, struct Cl *c);
 
+void
+cl_share(const struct XCSF *xcsf, struct Cl *dest, struct Cl *src);
+
+void
+cl_unshare(const struct XCSF *xcsf, struct Cl *c);
+
 void
 cl_init(const struct XCSF *xcsf, struct Cl *c, const double size,
         const int time);
@@ -98,6 +116,10 @@ void
 cl_update(const struct XCSF *xcsf, struct Cl *c, const double *x,
           const double *y, const int set_num, const bool cur);
 
+void
+cl_update_err_size(const struct XCSF *xcsf, struct Cl *c, const double *y,
+                   const int set_num);
+
 void
 cl_update_fit(const struct XCSF *xcsf, struct Cl *c, const double acc_sum,
               const double acc);
@@ -23,9 +23,15 @@
 
 #include "clset.h"
 #include "cl.h"
+#include "condition.h"
+#include "neural_batch.h"
+#include "pipeline.h"
+#include "prediction.h"
+#include "profile.h"
 #include "utils.h"
 
 #define MAX_COVER (1000000) //!< Maximum number of covering attempts
+#define MAX_COVER_FAILS (1000) //!< Maximum number of failed classifier covers
 
 /**
  * @brief Finds a rule in the population that never matches an input.
@@ -111,6 +117,7 @@ clset_pset_del(struct XCSF *xcsf)
     if (del == NULL) {
         clset_pset_roulette(xcsf, &del, &delprev);
     }
+    PROFILE_COUNT(PROF_DELETED, 1);
     // decrement numerosity
     --(del->cl->num);
     --(xcsf->pset.num);
@@ -152,13 +159,17 @@ clset_action_coverage(const struct XCSF *xcsf, bool *act_covered)
 
 /**
  * @brief Ensures all possible actions are covered by the match set.
+ * @details A new classifier that fails to cover the input is discarded and
+ * another is generated.
  * @param [in] xcsf The XCSF data structure.
  * @param [in] x The input state.
  */
 static void
 clset_cover(struct XCSF *xcsf, const double *x)
 {
+    PROFILE_START(PROF_COVER);
     int attempts = 0;
+    int fails = 0;
     bool *act_covered = malloc(sizeof(bool) * xcsf->n_actions);
     bool covered = clset_action_coverage(xcsf, act_covered);
     while (!covered) {
@@ -168,9 +179,19 @@ clset_cover(struct XCSF *xcsf, const double *x)
                 // create a new classifier with matching condition and action
                 struct Cl *new = malloc(sizeof(struct Cl));
                 cl_init(xcsf, new, (xcsf->mset.num) + 1, xcsf->time);
-                cl_cover(xcsf, new, x, i);
+                if (!cl_cover(xcsf, new, x, i)) {
+                    cl_free(xcsf, new);
+                    covered = false;
+                    if (++fails > MAX_COVER_FAILS) {
+                        printf("Error: unable to cover the input\n");
+                        exit(EXIT_FAILURE);
+                    }
+                    continue;
+                }
                 clset_add(&xcsf->pset, new);
                 clset_add(&xcsf->mset, new);
+                ++(xcsf->n_covered);
+                PROFILE_COUNT(PROF_COVERED, 1);
             }
         }
         // enforce population size
@@ -194,6 +215,7 @@ clset_cover(struct XCSF *xcsf, const double *x)
         }
     }
     free(act_covered);
+    PROFILE_STOP(PROF_COVER);
 }
 
 /**
@@ -229,6 +251,7 @@ clset_update_fit(const struct XCSF *xcsf, const struct Set *set)
 static void
 clset_subsumption(struct XCSF *xcsf, struct Set *set)
 {
+    PROFILE_START(PROF_SUBSUMPTION);
     // find the most general subsumer in the set
     struct Cl *s = NULL;
     const struct Clist *iter = set->list;
@@ -258,6 +281,7 @@ clset_subsumption(struct XCSF *xcsf, struct Set *set)
             clset_validate(&xcsf->pset);
         }
     }
+    PROFILE_STOP(PROF_SUBSUMPTION);
 }
 
 /**
@@ -313,9 +337,11 @@ clset_init(struct Set *set)
 void
 clset_pset_enforce_limit(struct XCSF *xcsf)
 {
+    PROFILE_START(PROF_ENFORCE_LIMIT);
     while (xcsf->pset.num > xcsf->POP_SIZE) {
         clset_pset_del(xcsf);
     }
+    PROFILE_STOP(PROF_ENFORCE_LIMIT);
 }
 
 /**
@@ -329,37 +355,20 @@ clset_pset_enforce_limit(struct XCSF *xcsf)
 void
 clset_match(struct XCSF *xcsf, const double *x)
 {
-#ifdef PARALLEL_MATCH
-    // prepare for parallel processing of matching conditions
-    struct Clist *blist[xcsf->pset.size];
-    struct Clist *iter = xcsf->pset.list;
-    for (int i = 0; iter != NULL && i < xcsf->pset.size; ++i) {
-        blist[i] = iter;
-        iter = iter->next;
-    }
-    // process conditions and actions setting m flags in parallel
-    #pragma omp parallel for
-    for (int i = 0; i < xcsf->pset.size; ++i) {
-        cl_match(xcsf, blist[i]->cl, x);
-        cl_action(xcsf, blist[i]->cl, x);
-    }
-    // build match set list in series
-    for (int i = 0; i < xcsf->pset.size; ++i) {
-        if (cl_m(xcsf, blist[i]->cl)) {
-            clset_add(&xcsf->mset, blist[i]->cl);
-        }
-    }
-#else
-    // process conditions and actions and build match set list in series
-    struct Clist *iter = xcsf->pset.list;
-    while (iter != NULL) {
-        if (cl_match(xcsf, iter->cl, x)) {
-            clset_add(&xcsf->mset, iter->cl);
-            cl_action(xcsf, iter->cl, x);
+    PROFILE_START(PROF_MATCH);
+    if (xcsf->pset.size > 0) {
+        // process conditions and actions setting m flags
+        struct Cl *clist[xcsf->pset.size];
+        const int n = clset_to_array(&xcsf->pset, clist);
+        pipeline_match(xcsf, clist, n, x);
+        // build match set list in series
+        for (int i = 0; i < n; ++i) {
+            if (cl_m(xcsf, clist[i])) {
+                clset_add(&xcsf->mset, clist[i]);
+            }
         }
-        iter = iter->next;
+        PROFILE_COUNT(PROF_MATCHED, xcsf->mset.size);
     }
-#endif
     // perform covering if all actions are not represented
     if (xcsf->n_actions > 1 || xcsf->mset.size < 1) {
         clset_cover(xcsf, x);
@@ -367,6 +376,7 @@ clset_match(struct XCSF *xcsf, const double *x)
     // update statistics
     xcsf->mset_size += (xcsf->mset.size - xcsf->mset_size) * xcsf->BETA;
     xcsf->mfrac += (clset_mfrac(xcsf) - xcsf->mfrac) * xcsf->BETA;
+    PROFILE_STOP(PROF_MATCH);
 }
 
 /**
@@ -422,28 +432,36 @@ void
 clset_update(struct XCSF *xcsf, struct Set *set, const double *x,
              const double *y, const bool cur)
 {
-#ifdef PARALLEL_UPDATE
-    struct Clist *blist[set->size];
-    struct Clist *iter = set->list;
-    for (int i = 0; iter != NULL && i < set->size; ++i) {
-        blist[i] = iter;
-        iter = iter->next;
-    }
-    #pragma omp parallel for
-    for (int i = 0; i < set->size; ++i) {
-        cl_update(xcsf, blist[i]->cl, x, y, set->num, cur);
-    }
-#else
-    struct Clist *iter = set->list;
-    while (iter != NULL) {
-        cl_update(xcsf, iter->cl, x, y, set->num, cur);
-        iter = iter->next;
+    PROFILE_START(PROF_UPDATE);
+    if (set->size > 0) {
+        struct Cl *clist[set->size];
+        const int n = clset_to_array(set, clist);
+        pipeline_update(xcsf, clist, n, x, y, set->num, cur);
     }
-#endif
     clset_update_fit(xcsf, set);
     if (xcsf->SET_SUBSUMPTION) {
         clset_subsumption(xcsf, set);
     }
+    PROFILE_STOP(PROF_UPDATE);
+}
+
+/**
+ * @brief Copies the classifier pointers in a set to an array.
+ * @param [in] set The set of classifiers.
+ * @param [out] clist The array of classifiers (at least set->size in length).
+ * @return The number of classifiers copied.
+ */
+int
+clset_to_array(const struct Set *set, struct Cl **clist)
+{
+    int n = 0;
+    const struct Clist *iter = set->list;
+    while (iter != NULL && n < set->size) {
+        clist[n] = iter->cl;
+        iter = iter->next;
+        ++n;
+    }
+    return n;
 }
 
 /**
@@ -658,6 +676,58 @@ clset_mean_pred_size(const struct XCSF *xcsf, const struct Set *set)
     return sum / cnt;
 }
 
+/**
+ * @brief Calculates the heap memory used by the classifiers in a set.
+ * @details Components shared with a stored population snapshot are counted in
+ * full. Temporary storage shared by all classifiers, such as packed neural
+ * network input layers, is only attributed to the population set.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] set The set whose memory usage is to be calculated.
+ * @param [out] bytes The number of bytes used by each component.
+ */
+void
+clset_bytes(const struct XCSF *xcsf, const struct Set *set,
+            struct SetBytes *bytes)
+{
+    memset(bytes, 0, sizeof(struct SetBytes));
+    const struct Clist *iter = set->list;
+    while (iter != NULL) {
+        bytes->cl += sizeof(struct Clist) + cl_bytes(xcsf, iter->cl);
+        bytes->cond += cl_cond_bytes(xcsf, iter->cl);
+        bytes->pred += cl_pred_bytes(xcsf, iter->cl);
+        bytes->act += cl_act_bytes(xcsf, iter->cl);
+        iter = iter->next;
+    }
+    if (set == &xcsf->pset) {
+        bytes->shared = neural_batch_bytes(xcsf->cond->batch) +
+            neural_batch_bytes(xcsf->pred->batch);
+    }
+}
+
+/**
+ * @brief Prints the heap memory used by the classifiers in a set.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] set The set whose memory usage is to be printed.
+ */
+void
+clset_print_bytes(const struct XCSF *xcsf, const struct Set *set)
+{
+    struct SetBytes bytes;
+    clset_bytes(xcsf, set, &bytes);
+    const size_t total =
+        bytes.cl + bytes.cond + bytes.pred + bytes.act + bytes.shared;
+    printf("SET_BYTES=%zu", total);
+    printf(", CL_BYTES=%zu", bytes.cl);
+    printf(", COND_BYTES=%zu", bytes.cond);
+    printf(", PRED_BYTES=%zu", bytes.pred);
+    printf(", ACT_BYTES=%zu", bytes.act);
+    printf(", SHARED_BYTES=%zu", bytes.shared);
+    if (set->size > 0) {
+        printf(", BYTES_PER_CL=%zu", total / set->size);
+    }
+    printf("\n");
+}
+
 /**
  * @brief Returns the fraction of inputs matched by the most general rule with
  * error below E0. If no rules below E0, the lowest error rule is used.
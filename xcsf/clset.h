@@ -25,6 +25,17 @@
 
 #include "xcsf.h"
 
+/**
+ * @brief Heap memory used by a set of classifiers, by component.
+ */
+struct SetBytes {
+    size_t cl; //!< Classifiers, their current predictions, and list elements
+    size_t cond; //!< Conditions
+    size_t pred; //!< Predictions
+    size_t act; //!< Actions
+    size_t shared; //!< Temporary storage shared by the population
+};
+
 double
 clset_mean_cond_size(const struct XCSF *xcsf, const struct Set *set);
 
@@ -40,6 +51,9 @@ clset_mfrac(const struct XCSF *xcsf);
 double
 clset_total_fit(const struct Set *set);
 
+int
+clset_to_array(const struct Set *set, struct Cl **clist);
+
 size_t
 clset_pset_load(struct XCSF *xcsf, FILE *fp);
 
@@ -49,6 +63,13 @@ clset_pset_save(const struct XCSF *xcsf, FILE *fp);
 void
 clset_action(struct XCSF *xcsf, const int action);
 
+void
+clset_bytes(const struct XCSF *xcsf, const struct Set *set,
+            struct SetBytes *bytes);
+
+void
+clset_print_bytes(const struct XCSF *xcsf, const struct Set *set);
+
 void
 clset_add(struct Set *set, struct Cl *c);
 
@@ -0,0 +1,259 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file clset_export.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Functions copying set-wide classifier parameters into arrays.
+ * @details Each function walks the set once, writing one row per classifier
+ * in list order, so that a whole population can be inspected with a single
+ * bulk copy rather than by parsing printed output. Passing NULL destinations
+ * returns the number of values that would be written.
+ */
+
+#include "clset_export.h"
+#include "cond_ellipsoid.h"
+#include "cond_neural.h"
+#include "cond_rectangle.h"
+#include "condition.h"
+#include "neural_layer.h"
+#include "pred_neural.h"
+#include "pred_nlms.h"
+#include "pred_rls.h"
+#include "prediction.h"
+#include "rule_neural.h"
+
+/**
+ * @brief Copies the error, fitness, numerosity and experience of a set.
+ * @param [in] set The set to copy.
+ * @param [out] err The error of each classifier, or NULL.
+ * @param [out] fit The fitness of each classifier, or NULL.
+ * @param [out] num The numerosity of each classifier, or NULL.
+ * @param [out] exp The experience of each classifier, or NULL.
+ */
+void
+clset_export_cl(const struct Set *set, double *err, double *fit, int *num,
+                int *exp)
+{
+    int i = 0;
+    for (const struct Clist *iter = set->list; iter != NULL;
+         iter = iter->next) {
+        const struct Cl *c = iter->cl;
+        if (err != NULL) {
+            err[i] = c->err;
+        }
+        if (fit != NULL) {
+            fit[i] = c->fit;
+        }
+        if (num != NULL) {
+            num[i] = c->num;
+        }
+        if (exp != NULL) {
+            exp[i] = c->exp;
+        }
+        ++i;
+    }
+}
+
+/**
+ * @brief Copies the centers and spreads of interval conditions in a set.
+ * @details Each row holds x_dim values. Only hyperrectangle and
+ * hyperellipsoid conditions are copied.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] set The set to copy.
+ * @param [out] center The condition centers, or NULL.
+ * @param [out] spread The condition spreads, or NULL.
+ * @return The number of values per classifier, or 0 if not supported.
+ */
+int
+clset_export_cond(const struct XCSF *xcsf, const struct Set *set,
+                  double *center, double *spread)
+{
+    if (xcsf->cond->type != COND_TYPE_HYPERRECTANGLE &&
+        xcsf->cond->type != COND_TYPE_HYPERELLIPSOID) {
+        return 0;
+    }
+    const int n = xcsf->x_dim;
+    int i = 0;
+    for (const struct Clist *iter = set->list; iter != NULL;
+         iter = iter->next) {
+        const real *c = NULL;
+        const real *s = NULL;
+        if (xcsf->cond->type == COND_TYPE_HYPERRECTANGLE) {
+            const struct CondRectangle *cond = iter->cl->cond;
+            c = cond->center;
+            s = cond->spread;
+        } else {
+            const struct CondEllipsoid *cond = iter->cl->cond;
+            c = cond->center;
+            s = cond->spread;
+        }
+        for (int j = 0; j < n; ++j) {
+            if (center != NULL) {
+                center[i * n + j] = c[j];
+            }
+            if (spread != NULL) {
+                spread[i * n + j] = s[j];
+            }
+        }
+        ++i;
+    }
+    return n;
+}
+
+/**
+ * @brief Copies the weights of least squares predictions in a set.
+ * @details Each row holds the y_dim blocks of weights of one classifier.
+ * Only NLMS and RLS predictions are copied.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] set The set to copy.
+ * @param [out] weights The prediction weights, or NULL.
+ * @return The number of weights per classifier, or 0 if not supported.
+ */
+int
+clset_export_pred(const struct XCSF *xcsf, const struct Set *set,
+                  double *weights)
+{
+    const int type = xcsf->pred->type;
+    const bool nlms =
+        type == PRED_TYPE_NLMS_LINEAR || type == PRED_TYPE_NLMS_QUADRATIC;
+    const bool rls =
+        type == PRED_TYPE_RLS_LINEAR || type == PRED_TYPE_RLS_QUADRATIC;
+    if ((!nlms && !rls) || set->list == NULL) {
+        return 0;
+    }
+    const void *first = set->list->cl->pred;
+    const int n = nlms ? ((const struct PredNLMS *) first)->n_weights
+                       : ((const struct PredRLS *) first)->n_weights;
+    if (weights == NULL) {
+        return n;
+    }
+    int i = 0;
+    for (const struct Clist *iter = set->list; iter != NULL;
+         iter = iter->next) {
+        double *dest = weights + (size_t) i * n;
+        if (nlms) {
+            const struct PredNLMS *pred = iter->cl->pred;
+            for (int j = 0; j < n; ++j) {
+                dest[j] = pred->weights[j];
+            }
+        } else {
+            const struct PredRLS *pred = iter->cl->pred;
+            memcpy(dest, pred->weights, sizeof(double) * n);
+        }
+        ++i;
+    }
+    return n;
+}
+
+/**
+ * @brief Returns the neural network of a classifier condition or prediction.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier.
+ * @param [in] cond Whether to return the condition rather than prediction.
+ * @return The neural network, or NULL if the component is not neural.
+ */
+static const struct Net *
+clset_export_net(const struct XCSF *xcsf, const struct Cl *c, const bool cond)
+{
+    if (cond) {
+        if (xcsf->cond->type == COND_TYPE_NEURAL) {
+            return &((const struct CondNeural *) c->cond)->net;
+        }
+        if (xcsf->cond->type == RULE_TYPE_NEURAL) {
+            return &((const struct RuleNeural *) c->cond)->net;
+        }
+    } else if (xcsf->pred->type == PRED_TYPE_NEURAL) {
+        return &((const struct PredNeural *) c->pred)->net;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Copies the weights of a neural network layer.
+ * @details Recurrent and LSTM layers hold their weights in sublayers, which
+ * are copied in the order they are saved.
+ * @param [in] l The layer to copy.
+ * @param [out] weights The layer weights.
+ * @return The number of weights copied.
+ */
+static int
+clset_export_layer_weights(const struct Layer *l, double *weights)
+{
+    switch (l->type) {
+        case RECURRENT: {
+            int n = clset_export_layer_weights(l->input_layer, weights);
+            n += clset_export_layer_weights(l->self_layer, weights + n);
+            n += clset_export_layer_weights(l->output_layer, weights + n);
+            return n;
+        }
+        case LSTM: {
+            const struct Layer *sub[8] = { l->uf, l->ui, l->ug, l->uo,
+                                           l->wf, l->wi, l->wg, l->wo };
+            int n = 0;
+            for (int i = 0; i < 8; ++i) {
+                n += clset_export_layer_weights(sub[i], weights + n);
+            }
+            return n;
+        }
+        default:
+            for (int i = 0; i < l->n_weights; ++i) {
+                weights[i] = l->weights[i];
+            }
+            return l->n_weights;
+    }
+}
+
+/**
+ * @brief Copies the weights of a neural network layer throughout a set.
+ * @details Layers are numbered from the input layer. The weights of each
+ * classifier are written consecutively; classifiers without the layer
+ * contribute none.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] set The set to copy.
+ * @param [in] cond Whether to copy condition rather than prediction layers.
+ * @param [in] layer The position of the layer.
+ * @param [out] weights The layer weights, or NULL.
+ * @param [out] n_weights The number of weights of each classifier, or NULL.
+ * @return The total number of weights.
+ */
+size_t
+clset_export_layer(const struct XCSF *xcsf, const struct Set *set,
+                   const bool cond, const int layer, double *weights,
+                   int *n_weights)
+{
+    size_t total = 0;
+    int i = 0;
+    for (const struct Clist *iter = set->list; iter != NULL;
+         iter = iter->next) {
+        const struct Net *net = clset_export_net(xcsf, iter->cl, cond);
+        const struct Llist *l = (net != NULL) ? net->tail : NULL;
+        for (int j = 0; l != NULL && j < layer; ++j) {
+            l = l->prev;
+        }
+        const int n = (l != NULL) ? l->layer->n_weights : 0;
+        if (weights != NULL && n > 0) {
+            clset_export_layer_weights(l->layer, weights + total);
+        }
+        if (n_weights != NULL) {
+            n_weights[i] = n;
+        }
+        total += n;
+        ++i;
+    }
+    return total;
+}
@@ -0,0 +1,43 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file clset_export.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Functions copying set-wide classifier parameters into arrays.
+ */
+
+#pragma once
+
+#include "xcsf.h"
+
+void
+clset_export_cl(const struct Set *set, double *err, double *fit, int *num,
+                int *exp);
+
+int
+clset_export_cond(const struct XCSF *xcsf, const struct Set *set,
+                  double *center, double *spread);
+
+int
+clset_export_pred(const struct XCSF *xcsf, const struct Set *set,
+                  double *weights);
+
+size_t
+clset_export_layer(const struct XCSF *xcsf, const struct Set *set,
+                   const bool cond, const int layer, double *weights,
+                   int *n_weights);
@@ -22,9 +22,30 @@
  */
 
 #include "cond_dgp.h"
+#include "clset.h"
 #include "sam.h"
 #include "utils.h"
 
+#ifdef PARALLEL_MATCH
+    #define COND_DGP_OMP_FOR _Pragma("omp parallel for")
+#else
+    #define COND_DGP_OMP_FOR
+#endif
+
+/**
+ * @brief Allocates a DGP condition without an evaluated block of inputs.
+ * @return A pointer to the new condition, whose graph is uninitialised.
+ */
+static struct CondDGP *
+cond_dgp_alloc(void)
+{
+    struct CondDGP *new = malloc(sizeof(struct CondDGP));
+    new->block = NULL;
+    new->block_n = 0;
+    new->block_out = NULL;
+    return new;
+}
+
 /**
  * @brief Creates and initialises a dynamical GP graph condition.
  * @param [in] xcsf The XCSF data structure.
@@ -33,7 +54,7 @@
 void
 cond_dgp_init(const struct XCSF *xcsf, struct Cl *c)
 {
-    struct CondDGP *new = malloc(sizeof(struct CondDGP));
+    struct CondDGP *new = cond_dgp_alloc();
     graph_init(&new->dgp, xcsf->cond->dargs);
     graph_rand(&new->dgp);
     c->cond = new;
@@ -50,6 +71,7 @@ cond_dgp_free(const struct XCSF *xcsf, const struct Cl *c)
     (void) xcsf;
     const struct CondDGP *cond = c->cond;
     graph_free(&cond->dgp);
+    free(cond->block_out);
     free(c->cond);
 }
 
@@ -62,7 +84,7 @@ cond_dgp_free(const struct XCSF *xcsf, const struct Cl *c)
 void
 cond_dgp_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
 {
-    struct CondDGP *new = malloc(sizeof(struct CondDGP));
+    struct CondDGP *new = cond_dgp_alloc();
     const struct CondDGP *src_cond = src->cond;
     graph_init(&new->dgp, xcsf->cond->dargs);
     graph_copy(&new->dgp, &src_cond->dgp);
@@ -71,18 +93,26 @@ cond_dgp_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
 
 /**
  * @brief Generates a dynamical GP graph that matches the current input.
+ * @details If no random graph matches within a bounded number of attempts,
+ * the output node of the last graph is rewired to match.
  * @param [in] xcsf XCSF data structure.
  * @param [in] c Classifier whose condition is being covered.
  * @param [in] x Input state to cover.
+ * @return Whether the graph matches the input, which fails only if no
+ * single-input node can match.
  */
-void
+bool
 cond_dgp_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x)
 {
-    (void) xcsf;
     struct CondDGP *cond = c->cond;
-    do {
+    cond->block = NULL;
+    for (int i = 0; i < COND_COVER_ATTEMPTS; ++i) {
         graph_rand(&cond->dgp);
-    } while (!cond_dgp_match(xcsf, c, x));
+        if (cond_dgp_match(xcsf, c, x)) {
+            return true;
+        }
+    }
+    return graph_cover(&cond->dgp, x, 0, true) && cond_dgp_match(xcsf, c, x);
 }
 
 /**
@@ -104,6 +134,8 @@ cond_dgp_update(const struct XCSF *xcsf, const struct Cl *c, const double *x,
 
 /**
  * @brief Calculates whether a dynamical GP graph condition matches an input.
+ * @details Inputs within the block last evaluated by cond_dgp_match_block()
+ * are looked up rather than updating the graph again.
  * @param [in] xcsf XCSF data structure.
  * @param [in] c Classifier whose condition to match.
  * @param [in] x Input state.
@@ -113,6 +145,13 @@ bool
 cond_dgp_match(const struct XCSF *xcsf, const struct Cl *c, const double *x)
 {
     const struct CondDGP *cond = c->cond;
+    if (cond->block != NULL) {
+        const uintptr_t pos = (uintptr_t) x - (uintptr_t) cond->block;
+        const uintptr_t row = sizeof(double) * xcsf->x_dim;
+        if (pos < row * cond->block_n && pos % row == 0) {
+            return cond->block_out[pos / row] > 0.5;
+        }
+    }
     graph_update(&cond->dgp, x, !xcsf->STATEFUL);
     if (graph_output(&cond->dgp, 0) > 0.5) {
         return true;
@@ -120,6 +159,43 @@ cond_dgp_match(const struct XCSF *xcsf, const struct Cl *c, const double *x)
     return false;
 }
 
+/**
+ * @brief Updates the DGP graph conditions of a set over a block of inputs.
+ * @details Each graph is updated from its initial states for every input of
+ * the block with graph_update_batch() so that subsequent matching of those
+ * inputs, e.g., when scoring or predicting a test set, is a lookup. Only
+ * valid when the graphs are reset for each input, i.e., STATEFUL is false;
+ * otherwise the block is not evaluated. Classifiers created after the call
+ * are updated as normal. The block must be cleared by calling again with x
+ * set to NULL before the inputs are modified or freed.
+ * @param [in] xcsf XCSF data structure.
+ * @param [in] set The set of classifiers with DGP graph conditions.
+ * @param [in] x The input states (n x x_dim), or NULL to clear the block.
+ * @param [in] n The number of input states, at most COND_DGP_BLOCK.
+ */
+void
+cond_dgp_match_block(const struct XCSF *xcsf, const struct Set *set,
+                     const double *x, const int n)
+{
+    if (set->size < 1 || (x != NULL && xcsf->STATEFUL)) {
+        return;
+    }
+    struct Cl *clist[set->size];
+    const int size = clset_to_array(set, clist);
+    COND_DGP_OMP_FOR
+    for (int i = 0; i < size; ++i) {
+        struct CondDGP *cond = clist[i]->cond;
+        cond->block = x;
+        cond->block_n = (x != NULL) ? n : 0;
+        if (x != NULL) {
+            if (cond->block_out == NULL) {
+                cond->block_out = malloc(sizeof(double) * COND_DGP_BLOCK);
+            }
+            graph_update_batch(&cond->dgp, x, n, 0, cond->block_out);
+        }
+    }
+}
+
 /**
  * @brief Mutates a dynamical GP graph condition with the self-adaptive rates.
  * @param [in] xcsf XCSF data structure.
@@ -131,6 +207,7 @@ cond_dgp_mutate(const struct XCSF *xcsf, const struct Cl *c)
 {
     (void) xcsf;
     struct CondDGP *cond = c->cond;
+    cond->block = NULL;
     return graph_mutate(&cond->dgp);
 }
 
@@ -221,9 +298,27 @@ cond_dgp_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp)
 size_t
 cond_dgp_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
 {
-    (void) xcsf;
-    struct CondDGP *new = malloc(sizeof(struct CondDGP));
-    size_t s = graph_load(&new->dgp, fp);
+    struct CondDGP *new = cond_dgp_alloc();
+    size_t s =
+        graph_load(&new->dgp, xcsf->cond->dargs, xcsf->load_build, fp);
     c->cond = new;
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by a DGP condition.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose condition memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+cond_dgp_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    (void) xcsf;
+    const struct CondDGP *cond = c->cond;
+    size_t bytes = sizeof(struct CondDGP) + graph_bytes(&cond->dgp);
+    if (cond->block_out != NULL) {
+        bytes += sizeof(double) * COND_DGP_BLOCK;
+    }
+    return bytes;
+}
@@ -27,11 +27,16 @@
 #include "dgp.h"
 #include "xcsf.h"
 
+#define COND_DGP_BLOCK (64) //!< Maximum number of inputs evaluated as a block
+
 /**
  * @brief Dynamical GP graph condition data structure.
  */
 struct CondDGP {
     struct Graph dgp; //!< DGP graph
+    const double *block; //!< Inputs of the evaluated block, or NULL
+    int block_n; //!< Number of inputs in the evaluated block
+    double *block_out; //!< Graph output for each input in the block
 };
 
 bool
@@ -51,7 +56,7 @@ cond_dgp_mutate(const struct XCSF *xcsf, const struct Cl *c);
 void
 cond_dgp_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src);
 
-void
+bool
 cond_dgp_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x);
 
 void
@@ -76,6 +81,13 @@ cond_dgp_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp);
 size_t
 cond_dgp_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
 
+size_t
+cond_dgp_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
+void
+cond_dgp_match_block(const struct XCSF *xcsf, const struct Set *set,
+                     const double *x, const int n);
+
 /**
  * @brief Dynamical GP graph condition implemented functions.
  */
@@ -83,5 +95,5 @@ static struct CondVtbl const cond_dgp_vtbl = {
     &cond_dgp_crossover, &cond_dgp_general, &cond_dgp_match, &cond_dgp_mutate,
     &cond_dgp_copy,      &cond_dgp_cover,   &cond_dgp_free,  &cond_dgp_init,
     &cond_dgp_print,     &cond_dgp_update,  &cond_dgp_size,  &cond_dgp_save,
-    &cond_dgp_load
+    &cond_dgp_load,      &cond_dgp_bytes
 };
@@ -66,13 +66,15 @@ cond_dummy_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
  * @param [in] xcsf XCSF data structure.
  * @param [in] c Classifier whose condition is being covered.
  * @param [in] x Input state to cover.
+ * @return Whether the condition matches the input (always).
  */
-void
+bool
 cond_dummy_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x)
 {
     (void) xcsf;
     (void) c;
     (void) x;
+    return true;
 }
 
 /**
@@ -213,3 +215,17 @@ cond_dummy_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
     (void) fp;
     return 0;
 }
+
+/**
+ * @brief Dummy function since dummy conditions have no data structure.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose condition memory usage to return.
+ * @return Zero.
+ */
+size_t
+cond_dummy_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    (void) xcsf;
+    (void) c;
+    return 0;
+}
@@ -33,6 +33,27 @@
  */
 static const int MU_TYPE[N_MU] = { SAM_LOG_NORMAL };
 
+/**
+ * @brief Returns the relative distance to a hyperellipsoid of dimension n.
+ * @details Inlined with a constant dimension the loop is fully unrolled.
+ * @param [in] center The hyperellipsoid centers.
+ * @param [in] spread The hyperellipsoid spreads.
+ * @param [in] x Input to compute the relative distance.
+ * @param [in] n The number of input dimensions.
+ * @return The relative distance of an input to the hyperellipsoid.
+ */
+static inline double
+cond_ellipsoid_dist_n(const real *center, const real *spread,
+                      const double *x, const int n)
+{
+    double dist = 0;
+    for (int i = 0; i < n; ++i) {
+        const double d = (x[i] - center[i]) / spread[i];
+        dist += d * d;
+    }
+    return dist;
+}
+
 /**
  * @brief Returns the relative distance to a hyperellipsoid.
  * @details Distance is zero at the center; one on the border; and greater than
@@ -47,12 +68,22 @@ cond_ellipsoid_dist(const struct XCSF *xcsf, const struct Cl *c,
                     const double *x)
 {
     const struct CondEllipsoid *cond = c->cond;
-    double dist = 0;
-    for (int i = 0; i < xcsf->x_dim; ++i) {
-        const double d = (x[i] - cond->center[i]) / cond->spread[i];
-        dist += d * d;
+    const real *center = cond->center;
+    const real *spread = cond->spread;
+    switch (xcsf->x_dim) {
+        case 1:
+            return cond_ellipsoid_dist_n(center, spread, x, 1);
+        case 2:
+            return cond_ellipsoid_dist_n(center, spread, x, 2);
+        case 4:
+            return cond_ellipsoid_dist_n(center, spread, x, 4);
+        case 8:
+            return cond_ellipsoid_dist_n(center, spread, x, 8);
+        case 16:
+            return cond_ellipsoid_dist_n(center, spread, x, 16);
+        default:
+            return cond_ellipsoid_dist_n(center, spread, x, xcsf->x_dim);
     }
-    return dist;
 }
 
 /**
@@ -65,8 +96,8 @@ void
 cond_ellipsoid_init(const struct XCSF *xcsf, struct Cl *c)
 {
     struct CondEllipsoid *new = malloc(sizeof(struct CondEllipsoid));
-    new->center = malloc(sizeof(double) * xcsf->x_dim);
-    new->spread = malloc(sizeof(double) * xcsf->x_dim);
+    new->center = malloc(sizeof(real) * xcsf->x_dim);
+    new->spread = malloc(sizeof(real) * xcsf->x_dim);
     new->mu = malloc(sizeof(double) * N_MU);
     const double spread_max = fabs(xcsf->cond->max - xcsf->cond->min);
     for (int i = 0; i < xcsf->x_dim; ++i) {
@@ -105,11 +136,11 @@ cond_ellipsoid_copy(const struct XCSF *xcsf, struct Cl *dest,
 {
     struct CondEllipsoid *new = malloc(sizeof(struct CondEllipsoid));
     const struct CondEllipsoid *src_cond = src->cond;
-    new->center = malloc(sizeof(double) * xcsf->x_dim);
-    new->spread = malloc(sizeof(double) * xcsf->x_dim);
+    new->center = malloc(sizeof(real) * xcsf->x_dim);
+    new->spread = malloc(sizeof(real) * xcsf->x_dim);
     new->mu = malloc(sizeof(double) * N_MU);
-    memcpy(new->center, src_cond->center, sizeof(double) * xcsf->x_dim);
-    memcpy(new->spread, src_cond->spread, sizeof(double) * xcsf->x_dim);
+    memcpy(new->center, src_cond->center, sizeof(real) * xcsf->x_dim);
+    memcpy(new->spread, src_cond->spread, sizeof(real) * xcsf->x_dim);
     memcpy(new->mu, src_cond->mu, sizeof(double) * N_MU);
     dest->cond = new;
 }
@@ -119,8 +150,9 @@ cond_ellipsoid_copy(const struct XCSF *xcsf, struct Cl *dest,
  * @param [in] xcsf XCSF data structure.
  * @param [in] c Classifier whose condition is being covered.
  * @param [in] x Input state to cover.
+ * @return Whether the condition matches the input (always).
  */
-void
+bool
 cond_ellipsoid_cover(const struct XCSF *xcsf, const struct Cl *c,
                      const double *x)
 {
@@ -130,6 +162,7 @@ cond_ellipsoid_cover(const struct XCSF *xcsf, const struct Cl *c,
         cond->center[i] = x[i];
         cond->spread[i] = rand_uniform(xcsf->cond->spread_min, spread_max);
     }
+    return true;
 }
 
 /**
@@ -210,8 +243,8 @@ cond_ellipsoid_mutate(const struct XCSF *xcsf, const struct Cl *c)
 {
     bool changed = false;
     const struct CondEllipsoid *cond = c->cond;
-    double *center = cond->center;
-    double *spread = cond->spread;
+    real *center = cond->center;
+    real *spread = cond->spread;
     sam_adapt(cond->mu, N_MU, MU_TYPE);
     for (int i = 0; i < xcsf->x_dim; ++i) {
         double orig = center[i];
@@ -244,7 +277,9 @@ cond_ellipsoid_general(const struct XCSF *xcsf, const struct Cl *c1,
     const struct CondEllipsoid *cond1 = c1->cond;
     const struct CondEllipsoid *cond2 = c2->cond;
     double *temp = malloc(sizeof(double) * xcsf->x_dim);
-    memcpy(temp, cond2->center, sizeof(double) * xcsf->x_dim);
+    for (int i = 0; i < xcsf->x_dim; ++i) {
+        temp[i] = cond2->center[i];
+    }
     for (int i = 0; i < xcsf->x_dim; ++i) {
         if (cond1->center[i] != cond2->center[i] ||
             cond1->spread[i] != cond2->spread[i]) {
@@ -307,8 +342,8 @@ cond_ellipsoid_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp)
 {
     size_t s = 0;
     const struct CondEllipsoid *cond = c->cond;
-    s += fwrite(cond->center, sizeof(double), xcsf->x_dim, fp);
-    s += fwrite(cond->spread, sizeof(double), xcsf->x_dim, fp);
+    s += fwrite(cond->center, sizeof(real), xcsf->x_dim, fp);
+    s += fwrite(cond->spread, sizeof(real), xcsf->x_dim, fp);
     s += fwrite(cond->mu, sizeof(double), N_MU, fp);
     return s;
 }
@@ -325,12 +360,26 @@ cond_ellipsoid_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
 {
     size_t s = 0;
     struct CondEllipsoid *new = malloc(sizeof(struct CondEllipsoid));
-    new->center = malloc(sizeof(double) * xcsf->x_dim);
-    new->spread = malloc(sizeof(double) * xcsf->x_dim);
+    new->center = malloc(sizeof(real) * xcsf->x_dim);
+    new->spread = malloc(sizeof(real) * xcsf->x_dim);
     new->mu = malloc(sizeof(double) * N_MU);
-    s += fread(new->center, sizeof(double), xcsf->x_dim, fp);
-    s += fread(new->spread, sizeof(double), xcsf->x_dim, fp);
+    s += fread(new->center, sizeof(real), xcsf->x_dim, fp);
+    s += fread(new->spread, sizeof(real), xcsf->x_dim, fp);
     s += fread(new->mu, sizeof(double), N_MU, fp);
     c->cond = new;
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by a hyperellipsoid condition.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose condition memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+cond_ellipsoid_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    (void) c;
+    return sizeof(struct CondEllipsoid) + sizeof(real) * 2 * xcsf->x_dim +
+        sizeof(double) * N_MU;
+}
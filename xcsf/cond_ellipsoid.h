@@ -24,14 +24,15 @@
 #pragma once
 
 #include "condition.h"
+#include "precision.h"
 #include "xcsf.h"
 
 /**
  * @brief Hyperellipsoid condition data structure.
  */
 struct CondEllipsoid {
-    double *center; //!< Centers
-    double *spread; //!< Spreads
+    real *center; //!< Centers
+    real *spread; //!< Spreads
     double *mu; //!< Mutation rates
 };
 
@@ -54,7 +55,7 @@ void
 cond_ellipsoid_copy(const struct XCSF *xcsf, struct Cl *dest,
                     const struct Cl *src);
 
-void
+bool
 cond_ellipsoid_cover(const struct XCSF *xcsf, const struct Cl *c,
                      const double *x);
 
@@ -80,6 +81,9 @@ cond_ellipsoid_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp);
 size_t
 cond_ellipsoid_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
 
+size_t
+cond_ellipsoid_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
 /**
  * @brief Hyperellipsoid condition implemented functions.
  */
@@ -88,5 +92,5 @@ static struct CondVtbl const cond_ellipsoid_vtbl = {
     &cond_ellipsoid_mutate,    &cond_ellipsoid_copy,    &cond_ellipsoid_cover,
     &cond_ellipsoid_free,      &cond_ellipsoid_init,    &cond_ellipsoid_print,
     &cond_ellipsoid_update,    &cond_ellipsoid_size,    &cond_ellipsoid_save,
-    &cond_ellipsoid_load
+    &cond_ellipsoid_load,      &cond_ellipsoid_bytes
 };
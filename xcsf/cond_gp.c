@@ -22,10 +22,31 @@
  */
 
 #include "cond_gp.h"
+#include "clset.h"
 #include "ea.h"
 #include "sam.h"
 #include "utils.h"
 
+#ifdef PARALLEL_MATCH
+    #define COND_GP_OMP_FOR _Pragma("omp parallel for")
+#else
+    #define COND_GP_OMP_FOR
+#endif
+
+/**
+ * @brief Allocates a tree-GP condition without an evaluated block of inputs.
+ * @return A pointer to the new condition, whose tree is uninitialised.
+ */
+static struct CondGP *
+cond_gp_alloc(void)
+{
+    struct CondGP *new = malloc(sizeof(struct CondGP));
+    new->block = NULL;
+    new->block_n = 0;
+    new->block_out = NULL;
+    return new;
+}
+
 /**
  * @brief Creates and initialises a tree-GP condition.
  * @param [in] xcsf The XCSF data structure.
@@ -34,7 +55,7 @@
 void
 cond_gp_init(const struct XCSF *xcsf, struct Cl *c)
 {
-    struct CondGP *new = malloc(sizeof(struct CondGP));
+    struct CondGP *new = cond_gp_alloc();
     tree_rand(&new->gp, xcsf->cond->targs);
     c->cond = new;
 }
@@ -50,6 +71,7 @@ cond_gp_free(const struct XCSF *xcsf, const struct Cl *c)
     (void) xcsf;
     const struct CondGP *cond = c->cond;
     tree_free(&cond->gp);
+    free(cond->block_out);
     free(c->cond);
 }
 
@@ -63,7 +85,7 @@ void
 cond_gp_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
 {
     (void) xcsf;
-    struct CondGP *new = malloc(sizeof(struct CondGP));
+    struct CondGP *new = cond_gp_alloc();
     const struct CondGP *src_cond = src->cond;
     tree_copy(&new->gp, &src_cond->gp);
     dest->cond = new;
@@ -71,18 +93,28 @@ cond_gp_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
 
 /**
  * @brief Generates a GP tree that matches the current input.
+ * @details If no random GP tree matches within a bounded number of attempts,
+ * a new root expression is inserted into the last tree so that it matches.
  * @param [in] xcsf XCSF data structure.
  * @param [in] c Classifier whose condition is being covered.
  * @param [in] x Input state to cover.
+ * @return Whether the tree matches the input, which fails only if every
+ * constant and input is zero or the tree does not evaluate to a number.
  */
-void
+bool
 cond_gp_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x)
 {
     struct CondGP *cond = c->cond;
-    do {
+    cond->block = NULL;
+    for (int i = 0; i < COND_COVER_ATTEMPTS; ++i) {
         tree_free(&cond->gp);
         tree_rand(&cond->gp, xcsf->cond->targs);
-    } while (!cond_gp_match(xcsf, c, x));
+        if (cond_gp_match(xcsf, c, x)) {
+            return true;
+        }
+    }
+    return tree_cover(&cond->gp, xcsf->cond->targs, x) &&
+        cond_gp_match(xcsf, c, x);
 }
 
 /**
@@ -104,6 +136,8 @@ cond_gp_update(const struct XCSF *xcsf, const struct Cl *c, const double *x,
 
 /**
  * @brief Calculates whether a GP tree condition matches an input.
+ * @details Inputs within the block last evaluated by cond_gp_match_block()
+ * are looked up rather than evaluated again.
  * @param [in] xcsf XCSF data structure.
  * @param [in] c Classifier whose condition to match.
  * @param [in] x Input state.
@@ -112,14 +146,56 @@ cond_gp_update(const struct XCSF *xcsf, const struct Cl *c, const double *x,
 bool
 cond_gp_match(const struct XCSF *xcsf, const struct Cl *c, const double *x)
 {
-    struct CondGP *cond = c->cond;
-    cond->gp.pos = 0;
-    if (tree_eval(&cond->gp, xcsf->cond->targs, x) > 0.5) {
+    const struct CondGP *cond = c->cond;
+    if (cond->block != NULL) {
+        const uintptr_t pos = (uintptr_t) x - (uintptr_t) cond->block;
+        const uintptr_t row = sizeof(double) * xcsf->x_dim;
+        if (pos < row * cond->block_n && pos % row == 0) {
+            return cond->block_out[pos / row] > 0.5;
+        }
+    }
+    if (tree_eval(&cond->gp, x) > 0.5) {
         return true;
     }
     return false;
 }
 
+/**
+ * @brief Evaluates the GP tree conditions of a set over a block of inputs.
+ * @details Each tree is evaluated for every input of the block with
+ * tree_eval_batch() so that subsequent matching of those inputs, e.g., when
+ * scoring or predicting a test set, is a lookup. Classifiers created after
+ * the call are evaluated as normal. The block must be cleared by calling
+ * again with x set to NULL before the inputs are modified or freed.
+ * @param [in] xcsf XCSF data structure.
+ * @param [in] set The set of classifiers with GP tree conditions.
+ * @param [in] x The input states (n x x_dim), or NULL to clear the block.
+ * @param [in] n The number of input states, at most COND_GP_BLOCK.
+ */
+void
+cond_gp_match_block(const struct XCSF *xcsf, const struct Set *set,
+                    const double *x, const int n)
+{
+    if (set->size < 1) {
+        return;
+    }
+    struct Cl *clist[set->size];
+    const int size = clset_to_array(set, clist);
+    COND_GP_OMP_FOR
+    for (int i = 0; i < size; ++i) {
+        struct CondGP *cond = clist[i]->cond;
+        cond->block = x;
+        cond->block_n = (x != NULL) ? n : 0;
+        if (x != NULL) {
+            if (cond->block_out == NULL) {
+                cond->block_out = malloc(sizeof(double) * COND_GP_BLOCK);
+            }
+            tree_eval_batch(&cond->gp, xcsf->cond->targs, x, n,
+                            cond->block_out);
+        }
+    }
+}
+
 /**
  * @brief Mutates a tree-GP condition with the self-adaptive rate.
  * @param [in] xcsf XCSF data structure.
@@ -129,8 +205,8 @@ cond_gp_match(const struct XCSF *xcsf, const struct Cl *c, const double *x)
 bool
 cond_gp_mutate(const struct XCSF *xcsf, const struct Cl *c)
 {
-    (void) xcsf;
     struct CondGP *cond = c->cond;
+    cond->block = NULL;
     return tree_mutate(&cond->gp, xcsf->cond->targs);
 }
 
@@ -148,8 +224,10 @@ cond_gp_crossover(const struct XCSF *xcsf, const struct Cl *c1,
     (void) xcsf;
     struct CondGP *cond1 = c1->cond;
     struct CondGP *cond2 = c2->cond;
+    cond1->block = NULL;
+    cond2->block = NULL;
     if (rand_uniform(0, 1) < xcsf->ea->p_crossover) {
-        tree_crossover(&cond1->gp, &cond2->gp);
+        tree_crossover(&cond1->gp, &cond2->gp, xcsf->cond->targs);
         return true;
     }
     return false;
@@ -227,9 +305,26 @@ cond_gp_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp)
 size_t
 cond_gp_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
 {
-    (void) xcsf;
-    struct CondGP *new = malloc(sizeof(struct CondGP));
-    size_t s = tree_load(&new->gp, fp);
+    struct CondGP *new = cond_gp_alloc();
+    size_t s = tree_load(&new->gp, xcsf->cond->targs, xcsf->load_build, fp);
     c->cond = new;
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by a tree-GP condition.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose condition memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+cond_gp_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    (void) xcsf;
+    const struct CondGP *cond = c->cond;
+    size_t bytes = sizeof(struct CondGP) + tree_bytes(&cond->gp);
+    if (cond->block_out != NULL) {
+        bytes += sizeof(double) * COND_GP_BLOCK;
+    }
+    return bytes;
+}
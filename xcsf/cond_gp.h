@@ -27,11 +27,16 @@
 #include "gp.h"
 #include "xcsf.h"
 
+#define COND_GP_BLOCK (64) //!< Maximum number of inputs evaluated as a block
+
 /**
  * @brief Tree GP condition data structure.
  */
 struct CondGP {
     struct GPTree gp; //!< GP tree
+    const double *block; //!< Inputs of the evaluated block, or NULL
+    int block_n; //!< Number of inputs in the evaluated block
+    double *block_out; //!< Tree output for each input in the block
 };
 
 bool
@@ -51,7 +56,7 @@ cond_gp_mutate(const struct XCSF *xcsf, const struct Cl *c);
 void
 cond_gp_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src);
 
-void
+bool
 cond_gp_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x);
 
 void
@@ -76,6 +81,13 @@ cond_gp_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp);
 size_t
 cond_gp_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
 
+size_t
+cond_gp_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
+void
+cond_gp_match_block(const struct XCSF *xcsf, const struct Set *set,
+                    const double *x, const int n);
+
 /**
  * @brief Tree GP condition implemented functions.
  */
@@ -83,5 +95,5 @@ static struct CondVtbl const cond_gp_vtbl = {
     &cond_gp_crossover, &cond_gp_general, &cond_gp_match, &cond_gp_mutate,
     &cond_gp_copy,      &cond_gp_cover,   &cond_gp_free,  &cond_gp_init,
     &cond_gp_print,     &cond_gp_update,  &cond_gp_size,  &cond_gp_save,
-    &cond_gp_load
+    &cond_gp_load,      &cond_gp_bytes
 };
@@ -77,17 +77,26 @@ cond_neural_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
 
 /**
  * @brief Generates a neural network that matches the current input.
+ * @details If no random network matches within a bounded number of attempts,
+ * the output bias of the last network is shifted to match.
  * @param [in] xcsf XCSF data structure.
  * @param [in] c Classifier whose condition is being covered.
  * @param [in] x Input state to cover.
+ * @return Whether the network matches the input, which fails only if the
+ * output layer is not fully-connected or its inputs are not finite.
  */
-void
+bool
 cond_neural_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x)
 {
-    const struct CondNeural *cond = c->cond;
-    do {
+    struct CondNeural *cond = c->cond;
+    for (int i = 0; i < COND_COVER_ATTEMPTS; ++i) {
         neural_rand(&cond->net);
-    } while (!cond_neural_match(xcsf, c, x));
+        if (cond_neural_match(xcsf, c, x)) {
+            return true;
+        }
+    }
+    return neural_cover_output(&cond->net, x, 0, true) &&
+        cond_neural_match(xcsf, c, x);
 }
 
 /**
@@ -124,6 +133,53 @@ cond_neural_match(const struct XCSF *xcsf, const struct Cl *c, const double *x)
     return false;
 }
 
+/**
+ * @brief Computes the input layers of the neural network conditions of a set
+ * of classifiers with a single batched operation.
+ * @details Each match is then completed with cond_neural_match_batched.
+ * @param [in] xcsf XCSF data structure.
+ * @param [in] clist The classifiers with neural network conditions.
+ * @param [in] n The number of classifiers.
+ * @param [in] x Input state.
+ */
+void
+cond_neural_forward_batch(const struct XCSF *xcsf, struct Cl **clist,
+                          const int n, const double *x)
+{
+    if (n < 1) {
+        return;
+    }
+    if (xcsf->cond->batch == NULL) {
+        xcsf->cond->batch = neural_batch_init();
+    }
+    struct Net *nets[n];
+    for (int i = 0; i < n; ++i) {
+        struct CondNeural *cond = clist[i]->cond;
+        nets[i] = &cond->net;
+    }
+    neural_batch_forward(xcsf->cond->batch, nets, n, x);
+}
+
+/**
+ * @brief Completes matching a neural network condition after the input layer
+ * has been computed by cond_neural_forward_batch.
+ * @param [in] xcsf XCSF data structure.
+ * @param [in] c Classifier whose condition to match.
+ * @param [in] x Input state.
+ * @return Whether the neural network condition matches the input.
+ */
+bool
+cond_neural_match_batched(const struct XCSF *xcsf, const struct Cl *c,
+                          const double *x)
+{
+    struct CondNeural *cond = c->cond;
+    neural_batch_propagate(xcsf->cond->batch, &cond->net, x, xcsf->explore);
+    if (neural_output(&cond->net, 0) > 0.5) {
+        return true;
+    }
+    return false;
+}
+
 /**
  * @brief Mutates a neural network condition with the self-adaptive rates.
  * @param [in] xcsf XCSF data structure.
@@ -134,7 +190,7 @@ bool
 cond_neural_mutate(const struct XCSF *xcsf, const struct Cl *c)
 {
     (void) xcsf;
-    const struct CondNeural *cond = c->cond;
+    struct CondNeural *cond = c->cond;
     return neural_mutate(&cond->net);
 }
 
@@ -233,6 +289,20 @@ cond_neural_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
     return s;
 }
 
+/**
+ * @brief Returns the heap memory used by a neural condition.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose condition memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+cond_neural_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    (void) xcsf;
+    const struct CondNeural *cond = c->cond;
+    return sizeof(struct CondNeural) + neural_bytes(&cond->net);
+}
+
 /**
  * @brief Returns the number of neurons in a neural condition layer.
  * @param [in] xcsf XCSF data structure.
@@ -26,6 +26,7 @@
 #include "condition.h"
 #include "neural.h"
 #include "neural_activations.h"
+#include "neural_batch.h"
 #include "neural_layer.h"
 #include "xcsf.h"
 
@@ -47,6 +48,14 @@ cond_neural_general(const struct XCSF *xcsf, const struct Cl *c1,
 bool
 cond_neural_match(const struct XCSF *xcsf, const struct Cl *c, const double *x);
 
+bool
+cond_neural_match_batched(const struct XCSF *xcsf, const struct Cl *c,
+                          const double *x);
+
+void
+cond_neural_forward_batch(const struct XCSF *xcsf, struct Cl **clist,
+                          const int n, const double *x);
+
 bool
 cond_neural_mutate(const struct XCSF *xcsf, const struct Cl *c);
 
@@ -54,7 +63,7 @@ void
 cond_neural_copy(const struct XCSF *xcsf, struct Cl *dest,
                  const struct Cl *src);
 
-void
+bool
 cond_neural_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x);
 
 void
@@ -79,6 +88,9 @@ cond_neural_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp);
 size_t
 cond_neural_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
 
+size_t
+cond_neural_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
 int
 cond_neural_neurons(const struct XCSF *xcsf, const struct Cl *c, int layer);
 
@@ -96,5 +108,5 @@ static struct CondVtbl const cond_neural_vtbl = {
     &cond_neural_mutate,    &cond_neural_copy,    &cond_neural_cover,
     &cond_neural_free,      &cond_neural_init,    &cond_neural_print,
     &cond_neural_update,    &cond_neural_size,    &cond_neural_save,
-    &cond_neural_load
+    &cond_neural_load,      &cond_neural_bytes
 };
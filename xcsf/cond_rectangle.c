@@ -33,10 +33,34 @@
  */
 static const int MU_TYPE[N_MU] = { SAM_LOG_NORMAL };
 
+/**
+ * @brief Returns the relative distance to a hyperrectangle of dimension n.
+ * @details Inlined with a constant dimension the loop is fully unrolled.
+ * @param [in] center The hyperrectangle centers.
+ * @param [in] spread The hyperrectangle spreads.
+ * @param [in] x Input to compute the relative distance.
+ * @param [in] n The number of input dimensions.
+ * @return The relative distance of an input to the hyperrectangle.
+ */
+static inline double
+cond_rectangle_dist_n(const real *center, const real *spread,
+                      const double *x, const int n)
+{
+    double dist = 0;
+    for (int i = 0; i < n; ++i) {
+        const double d = fabs((x[i] - center[i]) / spread[i]);
+        if (d > dist) {
+            dist = d;
+        }
+    }
+    return dist;
+}
+
 /**
  * @brief Returns the relative distance to a hyperrectangle.
  * @details Distance is zero at the center; one on the border; and greater than
- * one outside of the hyperrectangle.
+ * one outside of the hyperrectangle. Fixed-dimension kernels are used for
+ * common low-dimensional inputs.
  * @param [in] xcsf XCSF data structure.
  * @param [in] c Classifier whose hyperrectangle distance is to be computed.
  * @param [in] x Input to compute the relative distance.
@@ -47,14 +71,22 @@ cond_rectangle_dist(const struct XCSF *xcsf, const struct Cl *c,
                     const double *x)
 {
     const struct CondRectangle *cond = c->cond;
-    double dist = 0;
-    for (int i = 0; i < xcsf->x_dim; ++i) {
-        const double d = fabs((x[i] - cond->center[i]) / cond->spread[i]);
-        if (d > dist) {
-            dist = d;
-        }
+    const real *center = cond->center;
+    const real *spread = cond->spread;
+    switch (xcsf->x_dim) {
+        case 1:
+            return cond_rectangle_dist_n(center, spread, x, 1);
+        case 2:
+            return cond_rectangle_dist_n(center, spread, x, 2);
+        case 4:
+            return cond_rectangle_dist_n(center, spread, x, 4);
+        case 8:
+            return cond_rectangle_dist_n(center, spread, x, 8);
+        case 16:
+            return cond_rectangle_dist_n(center, spread, x, 16);
+        default:
+            return cond_rectangle_dist_n(center, spread, x, xcsf->x_dim);
     }
-    return dist;
 }
 
 /**
@@ -67,8 +99,8 @@ void
 cond_rectangle_init(const struct XCSF *xcsf, struct Cl *c)
 {
     struct CondRectangle *new = malloc(sizeof(struct CondRectangle));
-    new->center = malloc(sizeof(double) * xcsf->x_dim);
-    new->spread = malloc(sizeof(double) * xcsf->x_dim);
+    new->center = malloc(sizeof(real) * xcsf->x_dim);
+    new->spread = malloc(sizeof(real) * xcsf->x_dim);
     const double spread_max = fabs(xcsf->cond->max - xcsf->cond->min);
     for (int i = 0; i < xcsf->x_dim; ++i) {
         new->center[i] = rand_uniform(xcsf->cond->min, xcsf->cond->max);
@@ -107,11 +139,11 @@ cond_rectangle_copy(const struct XCSF *xcsf, struct Cl *dest,
 {
     struct CondRectangle *new = malloc(sizeof(struct CondRectangle));
     const struct CondRectangle *src_cond = src->cond;
-    new->center = malloc(sizeof(double) * xcsf->x_dim);
-    new->spread = malloc(sizeof(double) * xcsf->x_dim);
+    new->center = malloc(sizeof(real) * xcsf->x_dim);
+    new->spread = malloc(sizeof(real) * xcsf->x_dim);
     new->mu = malloc(sizeof(double) * N_MU);
-    memcpy(new->center, src_cond->center, sizeof(double) * xcsf->x_dim);
-    memcpy(new->spread, src_cond->spread, sizeof(double) * xcsf->x_dim);
+    memcpy(new->center, src_cond->center, sizeof(real) * xcsf->x_dim);
+    memcpy(new->spread, src_cond->spread, sizeof(real) * xcsf->x_dim);
     memcpy(new->mu, src_cond->mu, sizeof(double) * N_MU);
     dest->cond = new;
 }
@@ -121,8 +153,9 @@ cond_rectangle_copy(const struct XCSF *xcsf, struct Cl *dest,
  * @param [in] xcsf XCSF data structure.
  * @param [in] c Classifier whose condition is being covered.
  * @param [in] x Input state to cover.
+ * @return Whether the condition matches the input (always).
  */
-void
+bool
 cond_rectangle_cover(const struct XCSF *xcsf, const struct Cl *c,
                      const double *x)
 {
@@ -132,6 +165,7 @@ cond_rectangle_cover(const struct XCSF *xcsf, const struct Cl *c,
         cond->center[i] = x[i];
         cond->spread[i] = rand_uniform(xcsf->cond->spread_min, spread_max);
     }
+    return true;
 }
 
 /**
@@ -212,8 +246,8 @@ cond_rectangle_mutate(const struct XCSF *xcsf, const struct Cl *c)
 {
     bool changed = false;
     const struct CondRectangle *cond = c->cond;
-    double *center = cond->center;
-    double *spread = cond->spread;
+    real *center = cond->center;
+    real *spread = cond->spread;
     sam_adapt(cond->mu, N_MU, MU_TYPE);
     for (int i = 0; i < xcsf->x_dim; ++i) {
         double orig = center[i];
@@ -299,8 +333,8 @@ cond_rectangle_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp)
 {
     size_t s = 0;
     const struct CondRectangle *cond = c->cond;
-    s += fwrite(cond->center, sizeof(double), xcsf->x_dim, fp);
-    s += fwrite(cond->spread, sizeof(double), xcsf->x_dim, fp);
+    s += fwrite(cond->center, sizeof(real), xcsf->x_dim, fp);
+    s += fwrite(cond->spread, sizeof(real), xcsf->x_dim, fp);
     s += fwrite(cond->mu, sizeof(double), N_MU, fp);
     return s;
 }
@@ -317,12 +351,26 @@ cond_rectangle_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
 {
     size_t s = 0;
     struct CondRectangle *new = malloc(sizeof(struct CondRectangle));
-    new->center = malloc(sizeof(double) * xcsf->x_dim);
-    new->spread = malloc(sizeof(double) * xcsf->x_dim);
+    new->center = malloc(sizeof(real) * xcsf->x_dim);
+    new->spread = malloc(sizeof(real) * xcsf->x_dim);
     new->mu = malloc(sizeof(double) * N_MU);
-    s += fread(new->center, sizeof(double), xcsf->x_dim, fp);
-    s += fread(new->spread, sizeof(double), xcsf->x_dim, fp);
+    s += fread(new->center, sizeof(real), xcsf->x_dim, fp);
+    s += fread(new->spread, sizeof(real), xcsf->x_dim, fp);
     s += fread(new->mu, sizeof(double), N_MU, fp);
     c->cond = new;
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by a hyperrectangle condition.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose condition memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+cond_rectangle_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    (void) c;
+    return sizeof(struct CondRectangle) + sizeof(real) * 2 * xcsf->x_dim +
+        sizeof(double) * N_MU;
+}
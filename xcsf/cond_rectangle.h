@@ -24,14 +24,15 @@
 #pragma once
 
 #include "condition.h"
+#include "precision.h"
 #include "xcsf.h"
 
 /**
  * @brief Hyperrectangle condition data structure.
  */
 struct CondRectangle {
-    double *center; //!< Centers
-    double *spread; //!< Spreads
+    real *center; //!< Centers
+    real *spread; //!< Spreads
     double *mu; //!< Mutation rates
 };
 
@@ -54,7 +55,7 @@ void
 cond_rectangle_copy(const struct XCSF *xcsf, struct Cl *dest,
                     const struct Cl *src);
 
-void
+bool
 cond_rectangle_cover(const struct XCSF *xcsf, const struct Cl *c,
                      const double *x);
 
@@ -80,6 +81,9 @@ cond_rectangle_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp);
 size_t
 cond_rectangle_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
 
+size_t
+cond_rectangle_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
 /**
  * @brief Hyperrectangle condition implemented functions.
  */
@@ -88,5 +92,5 @@ static struct CondVtbl const cond_rectangle_vtbl = {
     &cond_rectangle_mutate,    &cond_rectangle_copy,    &cond_rectangle_cover,
     &cond_rectangle_free,      &cond_rectangle_init,    &cond_rectangle_print,
     &cond_rectangle_update,    &cond_rectangle_size,    &cond_rectangle_save,
-    &cond_rectangle_load
+    &cond_rectangle_load,      &cond_rectangle_bytes
 };
@@ -115,8 +115,9 @@ cond_ternary_copy(const struct XCSF *xcsf, struct Cl *dest,
  * @param [in] xcsf The XCSF data structure.
  * @param [in] c The classifier whose condition is being covered.
  * @param [in] x The input state to cover.
+ * @return Whether the condition matches the input (always).
  */
-void
+bool
 cond_ternary_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x)
 {
     const struct CondTernary *cond = c->cond;
@@ -131,6 +132,7 @@ cond_ternary_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x)
             }
         }
     }
+    return true;
 }
 
 /**
@@ -331,3 +333,17 @@ cond_ternary_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
     c->cond = new;
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by a ternary condition.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose condition memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+cond_ternary_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    const struct CondTernary *cond = c->cond;
+    return sizeof(struct CondTernary) + sizeof(char) * cond->length +
+        sizeof(char) * xcsf->cond->bits + sizeof(double) * N_MU;
+}
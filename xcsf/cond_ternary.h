@@ -55,7 +55,7 @@ void
 cond_ternary_copy(const struct XCSF *xcsf, struct Cl *dest,
                   const struct Cl *src);
 
-void
+bool
 cond_ternary_cover(const struct XCSF *xcsf, const struct Cl *c,
                    const double *x);
 
@@ -81,6 +81,9 @@ cond_ternary_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp);
 size_t
 cond_ternary_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
 
+size_t
+cond_ternary_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
 /**
  * @brief Ternary condition implemented functions.
  */
@@ -89,5 +92,5 @@ static struct CondVtbl const cond_ternary_vtbl = {
     &cond_ternary_mutate,    &cond_ternary_copy,    &cond_ternary_cover,
     &cond_ternary_free,      &cond_ternary_init,    &cond_ternary_print,
     &cond_ternary_update,    &cond_ternary_size,    &cond_ternary_save,
-    &cond_ternary_load
+    &cond_ternary_load,      &cond_ternary_bytes
 };
@@ -28,6 +28,8 @@
 #include "cond_neural.h"
 #include "cond_rectangle.h"
 #include "cond_ternary.h"
+#include "neural_batch.h"
+#include "pipeline.h"
 #include "rule_dgp.h"
 #include "rule_neural.h"
 
@@ -363,9 +365,9 @@ cond_param_load(struct XCSF *xcsf, FILE *fp)
     s += fread(&cond->spread_min, sizeof(double), 1, fp);
     s += fread(&cond->p_dontcare, sizeof(double), 1, fp);
     s += fread(&cond->bits, sizeof(int), 1, fp);
-    s += graph_args_load(cond->dargs, fp);
+    s += graph_args_load(cond->dargs, xcsf->load_build, fp);
     s += tree_args_load(cond->targs, fp);
-    s += layer_args_load(&cond->largs, fp);
+    s += layer_args_load(&cond->largs, xcsf->load_build, fp);
     return s;
 }
 
@@ -382,6 +384,8 @@ cond_param_free(struct XCSF *xcsf)
     xcsf->cond->targs = NULL;
     xcsf->cond->dargs = NULL;
     layer_args_free(&xcsf->cond->largs);
+    neural_batch_free(xcsf->cond->batch);
+    xcsf->cond->batch = NULL;
 }
 
 /* parameter setters */
@@ -452,6 +456,7 @@ void
 cond_param_set_type_string(struct XCSF *xcsf, const char *a)
 {
     xcsf->cond->type = condition_type_as_int(a);
+    pipeline_set(xcsf);
 }
 
 void
@@ -463,4 +468,5 @@ cond_param_set_type(struct XCSF *xcsf, const int a)
     } else {
         xcsf->cond->type = a;
     }
+    pipeline_set(xcsf);
 }
@@ -47,6 +47,8 @@
 #define COND_STRING_RULE_NEURAL ("rule-neural\0") //!< Rule neural
 #define COND_STRING_RULE_NETWORK ("rule-network\0") //!< Rule network
 
+#define COND_COVER_ATTEMPTS (100) //!< Random covering attempts before repair
+
 /**
  * @brief Parameters for initialising and operating conditions.
  */
@@ -61,6 +63,7 @@ struct ArgsCond {
     struct ArgsLayer *largs; //!< Linked-list of layer parameters
     struct ArgsDGP *dargs; //!< DGP parameters
     struct ArgsGPTree *targs; //!< Tree GP parameters
+    struct NeuralBatch *batch; //!< Packed neural network input layers
 };
 
 void
@@ -101,7 +104,7 @@ struct CondVtbl {
     bool (*cond_impl_mutate)(const struct XCSF *xcsf, const struct Cl *c);
     void (*cond_impl_copy)(const struct XCSF *xcsf, struct Cl *dest,
                            const struct Cl *src);
-    void (*cond_impl_cover)(const struct XCSF *xcsf, const struct Cl *c,
+    bool (*cond_impl_cover)(const struct XCSF *xcsf, const struct Cl *c,
                             const double *x);
     void (*cond_impl_free)(const struct XCSF *xcsf, const struct Cl *c);
     void (*cond_impl_init)(const struct XCSF *xcsf, struct Cl *c);
@@ -112,6 +115,7 @@ struct CondVtbl {
     size_t (*cond_impl_save)(const struct XCSF *xcsf, const struct Cl *c,
                              FILE *fp);
     size_t (*cond_impl_load)(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
+    size_t (*cond_impl_bytes)(const struct XCSF *xcsf, const struct Cl *c);
 };
 
 /**
@@ -152,6 +156,18 @@ cond_size(const struct XCSF *xcsf, const struct Cl *c)
     return (*c->cond_vptr->cond_impl_size)(xcsf, c);
 }
 
+/**
+ * @brief Returns the number of bytes of heap memory used by the condition.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose condition memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+static inline size_t
+cond_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    return (*c->cond_vptr->cond_impl_bytes)(xcsf, c);
+}
+
 /**
  * @brief Updates the classifier's condition.
  * @param [in] xcsf The XCSF data structure.
@@ -235,11 +251,12 @@ cond_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
  * @param [in] xcsf The XCSF data structure.
  * @param [in] c The classifier whose condition is being covered.
  * @param [in] x The input state to cover.
+ * @return Whether the condition now matches the input.
  */
-static inline void
+static inline bool
 cond_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x)
 {
-    (*c->cond_vptr->cond_impl_cover)(xcsf, c, x);
+    return (*c->cond_vptr->cond_impl_cover)(xcsf, c, x);
 }
 
 /**
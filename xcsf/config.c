@@ -59,6 +59,14 @@ config_general(struct XCSF *xcsf, const char *n, const char *v, const int i,
         param_set_pop_init(xcsf, i);
     } else if (strncmp(n, "PERF_TRIALS\0", 12) == 0) {
         param_set_perf_trials(xcsf, i);
+    } else if (strncmp(n, "CHECKPOINT_TRIALS\0", 18) == 0) {
+        param_set_checkpoint_trials(xcsf, i);
+    } else if (strncmp(n, "CHECKPOINT_FILE\0", 16) == 0) {
+        param_set_checkpoint_file(xcsf, v);
+    } else if (strncmp(n, "METRICS_FORMAT\0", 15) == 0) {
+        param_set_metrics_format_string(xcsf, v);
+    } else if (strncmp(n, "METRICS_FILE\0", 13) == 0) {
+        param_set_metrics_file(xcsf, v);
     } else if (strncmp(n, "LOSS_FUNC\0", 10) == 0) {
         param_set_loss_func_string(xcsf, v);
     } else if (strncmp(n, "HUBER_DELTA\0", 12) == 0) {
@@ -212,6 +220,8 @@ config_layer(const char *n, const char *v, const int i, const double f)
         current_layer->evolve_eta = i;
     } else if (strncmp(n, "LAYER_SGD_WEIGHTS\0", 18) == 0) {
         current_layer->sgd_weights = i;
+    } else if (strncmp(n, "LAYER_SPARSE_MUTATE\0", 20) == 0) {
+        current_layer->sparse_mutate = i;
     } else if (strncmp(n, "LAYER_ETA\0", 10) == 0) {
         current_layer->eta = f;
     } else if (strncmp(n, "LAYER_ETA_MIN\0", 14) == 0) {
@@ -290,6 +300,8 @@ config_cl_cond_dgp(struct XCSF *xcsf, const char *n, const char *v, const int i,
         graph_param_set_n(xcsf->cond->dargs, i);
     } else if (strncmp(n, "COND_DGP_EVOLVE_CYCLES\0", 23) == 0) {
         graph_param_set_evolve_cycles(xcsf->cond->dargs, i);
+    } else if (strncmp(n, "COND_DGP_SPARSE_MUTATE\0", 23) == 0) {
+        graph_param_set_sparse_mutate(xcsf->cond->dargs, i);
     }
 }
 
@@ -455,6 +467,8 @@ config_cl_pred(struct XCSF *xcsf, const char *n, const char *v, const int i,
 {
     if (strncmp(n, "PRED_TYPE\0", 10) == 0) {
         pred_param_set_type_string(xcsf, v);
+    } else if (strncmp(n, "PRED_BATCH_SIZE\0", 16) == 0) {
+        pred_param_set_batch_size(xcsf, i);
     }
     config_cl_pred_ls(xcsf, n, v, i, f);
     config_cl_pred_neural(xcsf, n, v);
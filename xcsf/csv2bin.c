@@ -0,0 +1,54 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file csv2bin.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Converts csv training and testing data to binary dataset files.
+ */
+
+#include "dataset.h"
+#include "env_csv.h"
+#include "xcsf.h"
+
+#define MAX_NAME (200) //!< Maximum file name length
+
+int
+main(int argc, char **argv)
+{
+    if (argc != 2) {
+        printf("Usage: csv2bin problem\n");
+        printf("Converts problem_{train|test}_{x|y}.csv to ");
+        printf("problem_{train|test}.bin\n");
+        exit(EXIT_FAILURE);
+    }
+    struct Input train_data;
+    struct Input test_data;
+    env_csv_input_read(argv[1], &train_data, &test_data);
+    char name[MAX_NAME];
+    snprintf(name, MAX_NAME, "%s_train.bin", argv[1]);
+    dataset_save(&train_data, name);
+    printf("Saved: %s\n", name);
+    snprintf(name, MAX_NAME, "%s_test.bin", argv[1]);
+    dataset_save(&test_data, name);
+    printf("Saved: %s\n", name);
+    free(train_data.x);
+    free(train_data.y);
+    free(test_data.x);
+    free(test_data.y);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,221 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file dataset.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Memory-mapped binary dataset files.
+ * @details A dataset is mapped read-only and the feature and target pointers
+ * of the input structure are set directly into the mapping, so that loading
+ * does not copy or parse any values and concurrent runs share the same
+ * pages. Where memory mapping is unavailable the file is read into a single
+ * buffer with the same layout.
+ */
+
+#include "dataset.h"
+
+#include <sys/stat.h>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+_Static_assert(sizeof(struct DatasetHeader) == 32, "unaligned header");
+
+/**
+ * @brief Returns the number of bytes in a binary dataset file.
+ * @param [in] x_dim The number of feature variables.
+ * @param [in] y_dim The number of target variables.
+ * @param [in] n_samples The number of instances.
+ * @return The file size.
+ */
+static size_t
+dataset_size(const int x_dim, const int y_dim, const int n_samples)
+{
+    return sizeof(struct DatasetHeader) +
+        sizeof(double) * (size_t) n_samples * (size_t) (x_dim + y_dim);
+}
+
+/**
+ * @brief Writes a dataset to a binary file.
+ * @param [in] data The dataset to write.
+ * @param [in] filename The name of the file.
+ * @return The number of elements written.
+ */
+size_t
+dataset_save(const struct Input *data, const char *filename)
+{
+    FILE *fp = fopen(filename, "wb");
+    if (fp == 0) {
+        printf("Error opening file: %s. %s.\n", filename, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    struct DatasetHeader header;
+    memcpy(header.magic, DATASET_MAGIC, sizeof(header.magic));
+    header.version = DATASET_VERSION;
+    header.dtype = DATASET_FLOAT64;
+    header.x_dim = data->x_dim;
+    header.y_dim = data->y_dim;
+    header.n_samples = data->n_samples;
+    const size_t n_x = (size_t) data->n_samples * data->x_dim;
+    const size_t n_y = (size_t) data->n_samples * data->y_dim;
+    size_t s = 0;
+    s += fwrite(&header, sizeof(struct DatasetHeader), 1, fp);
+    s += fwrite(data->x, sizeof(double), n_x, fp);
+    s += fwrite(data->y, sizeof(double), n_y, fp);
+    fclose(fp);
+    if (s != n_x + n_y + 1) {
+        printf("Error writing file: %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    return s;
+}
+
+/**
+ * @brief Checks the header of a binary dataset file.
+ * @param [in] header The header read from the file.
+ * @param [in] size The number of bytes in the file.
+ * @param [in] filename The name of the file.
+ */
+static void
+dataset_check(const struct DatasetHeader *header, const size_t size,
+              const char *filename)
+{
+    if (size < sizeof(struct DatasetHeader) ||
+        memcmp(header->magic, DATASET_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != DATASET_VERSION) {
+        printf("Error reading file: %s. Not a dataset file\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    if (header->dtype != DATASET_FLOAT64) {
+        printf("Error reading file: %s. Unsupported dtype: %d\n", filename,
+               (int) header->dtype);
+        exit(EXIT_FAILURE);
+    }
+    if (header->x_dim < 1 || header->y_dim < 1 || header->n_samples < 1 ||
+        header->n_samples > INT_MAX ||
+        size != dataset_size(header->x_dim, header->y_dim,
+                             (int) header->n_samples)) {
+        printf("Error reading file: %s. Invalid size\n", filename);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Maps a binary dataset file into an input structure.
+ * @details The feature and target variables point into the mapped file and
+ * must be released with dataset_free().
+ * @param [out] data The dataset to set.
+ * @param [in] filename The name of the file.
+ */
+void
+dataset_load(struct Input *data, const char *filename)
+{
+    const char *base = NULL;
+    size_t size = 0;
+#ifndef _WIN32
+    const int fd = open(filename, O_RDONLY);
+    struct stat sb;
+    if (fd < 0 || fstat(fd, &sb) != 0) {
+        printf("Error opening file: %s. %s.\n", filename, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    size = (size_t) sb.st_size;
+    void *map = (size > 0) ? mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0)
+                           : MAP_FAILED;
+    close(fd);
+    if (map == MAP_FAILED) {
+        printf("Error mapping file: %s. %s.\n", filename, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    base = map;
+#else
+    FILE *fp = fopen(filename, "rb");
+    if (fp == 0) {
+        printf("Error opening file: %s. %s.\n", filename, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    fseek(fp, 0, SEEK_END);
+    size = (size_t) ftell(fp);
+    rewind(fp);
+    char *buffer = malloc(size);
+    size = fread(buffer, sizeof(char), size, fp);
+    fclose(fp);
+    base = buffer;
+#endif
+    struct DatasetHeader header;
+    memcpy(&header, base, (size < sizeof(header)) ? size : sizeof(header));
+    dataset_check(&header, size, filename);
+    data->x_dim = header.x_dim;
+    data->y_dim = header.y_dim;
+    data->n_samples = (int) header.n_samples;
+    data->x = (double *) (uintptr_t) (base + sizeof(struct DatasetHeader));
+    data->y = data->x + (size_t) data->n_samples * data->x_dim;
+    printf("Loaded: %s: samples=%d, x_dim=%d, y_dim=%d\n", filename,
+           data->n_samples, data->x_dim, data->y_dim);
+}
+
+/**
+ * @brief Releases a dataset set by dataset_load().
+ * @param [in] data The dataset to release.
+ */
+void
+dataset_free(const struct Input *data)
+{
+    char *base = (char *) data->x - sizeof(struct DatasetHeader);
+#ifndef _WIN32
+    munmap(base, dataset_size(data->x_dim, data->y_dim, data->n_samples));
+#else
+    free(base);
+#endif
+}
+
+/**
+ * @brief Returns whether a file exists.
+ * @param [in] filename The name of the file.
+ * @return Whether the file can be opened for reading.
+ */
+bool
+dataset_exists(const char *filename)
+{
+    FILE *fp = fopen(filename, "rb");
+    if (fp == 0) {
+        return false;
+    }
+    fclose(fp);
+    return true;
+}
+
+/**
+ * @brief Returns whether a dataset file is up to date with its source.
+ * @param [in] filename The name of the binary dataset file.
+ * @param [in] source The name of the file the dataset was converted from.
+ * @return Whether the dataset exists and was modified no earlier than the
+ * source, or the source does not exist.
+ */
+bool
+dataset_current(const char *filename, const char *source)
+{
+    struct stat sb;
+    if (stat(filename, &sb) != 0) {
+        return false;
+    }
+    const time_t mtime = sb.st_mtime;
+    return stat(source, &sb) != 0 || sb.st_mtime <= mtime;
+}
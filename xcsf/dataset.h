@@ -0,0 +1,61 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file dataset.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Memory-mapped binary dataset files.
+ */
+
+#pragma once
+
+#include "xcsf.h"
+
+#define DATASET_MAGIC ("XCSFDATA") //!< Identifies a binary dataset file
+#define DATASET_VERSION (1) //!< Version of the binary dataset format
+#define DATASET_FLOAT64 (0) //!< Data type of 64-bit floating point values
+
+/**
+ * @brief Header of a binary dataset file.
+ * @details The header is followed by the row-major feature variables
+ * (n_samples x x_dim) and then the row-major target variables
+ * (n_samples x y_dim). Values are stored in native byte order. The header is
+ * 32 bytes so that the values following it are aligned.
+ */
+struct DatasetHeader {
+    char magic[8]; //!< File identifier
+    int32_t version; //!< Format version
+    int32_t dtype; //!< Data type of the values
+    int32_t x_dim; //!< Number of feature variables
+    int32_t y_dim; //!< Number of target variables
+    int64_t n_samples; //!< Number of instances
+};
+
+size_t
+dataset_save(const struct Input *data, const char *filename);
+
+void
+dataset_load(struct Input *data, const char *filename);
+
+void
+dataset_free(const struct Input *data);
+
+bool
+dataset_exists(const char *filename);
+
+bool
+dataset_current(const char *filename, const char *source);
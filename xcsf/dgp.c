@@ -28,8 +28,10 @@
 #define FUZZY_NOT (0) //!< Fuzzy NOT function
 #define FUZZY_CFMQVS_AND (1) //!< Fuzzy AND (CFMQVS) function
 #define FUZZY_CFMQVS_OR (2) //!< Fuzzy OR (CFMQVS) function
-#define NUM_FUNC (3) //!< Number of selectable node functions
 #define N_MU (3) //!< Number of DGP graph mutation rates
+#define N_LANES (8) //!< Number of inputs updated together in a batch
+#define GRAPH_SPARSE_BUILD (2) //!< First build saving sparse mutation
+#define GRAPH_INPUTS_BUILD (2) //!< First build saving the number of inputs
 
 /**
  * @brief Self-adaptation method for mutating DGP graphs.
@@ -58,6 +60,7 @@ random_connection(const int n_nodes, const int n_inputs)
 
 /**
  * @brief Mutates the node functions within a DGP graph.
+ * @details Sparse mutation visits only the nodes selected for mutation.
  * @param [in] dgp The DGP graph to be mutated.
  * @return Whether any alterations were made.
  */
@@ -65,10 +68,22 @@ static bool
 graph_mutate_functions(struct Graph *dgp)
 {
     bool mod = false;
+    if (dgp->sparse_mutate) {
+        const double p = dgp->mu[0];
+        for (int i = rand_skip(p, dgp->n); i < dgp->n;
+             i += rand_skip(p, dgp->n) + 1) {
+            const int orig = dgp->function[i];
+            dgp->function[i] = rand_uniform_int(0, DGP_NUM_FUNC);
+            if (orig != dgp->function[i]) {
+                mod = true;
+            }
+        }
+        return mod;
+    }
     for (int i = 0; i < dgp->n; ++i) {
         if (rand_uniform(0, 1) < dgp->mu[0]) {
             const int orig = dgp->function[i];
-            dgp->function[i] = rand_uniform_int(0, NUM_FUNC);
+            dgp->function[i] = rand_uniform_int(0, DGP_NUM_FUNC);
             if (orig != dgp->function[i]) {
                 mod = true;
             }
@@ -79,6 +94,7 @@ graph_mutate_functions(struct Graph *dgp)
 
 /**
  * @brief Mutates the connectivity of a DGP graph.
+ * @details Sparse mutation visits only the connections selected for mutation.
  * @param [in] dgp The DGP graph to be mutated.
  * @return Whether any alterations were made.
  */
@@ -86,6 +102,18 @@ static bool
 graph_mutate_connectivity(struct Graph *dgp)
 {
     bool mod = false;
+    if (dgp->sparse_mutate) {
+        const double p = dgp->mu[1];
+        for (int i = rand_skip(p, dgp->klen); i < dgp->klen;
+             i += rand_skip(p, dgp->klen) + 1) {
+            const int orig = dgp->connectivity[i];
+            dgp->connectivity[i] = random_connection(dgp->n, dgp->n_inputs);
+            if (orig != dgp->connectivity[i]) {
+                mod = true;
+            }
+        }
+        return mod;
+    }
     for (int i = 0; i < dgp->klen; ++i) {
         if (rand_uniform(0, 1) < dgp->mu[1]) {
             const int orig = dgp->connectivity[i];
@@ -114,41 +142,6 @@ graph_mutate_cycles(struct Graph *dgp)
     return true;
 }
 
-/**
- * @brief Returns the result from applying a specified activation function.
- * @param [in] function The activation function to apply.
- * @param [in] inputs The input to the activation function.
- * @param [in] K The number of inputs to the activation function.
- * @return The result from applying the activation function.
- */
-static double
-node_activate(int function, const double *inputs, const int K)
-{
-    double state = 0;
-    switch (function) {
-        case FUZZY_NOT:
-            state = 1 - inputs[0];
-            break;
-        case FUZZY_CFMQVS_AND:
-            state = inputs[0];
-            for (int i = 1; i < K; ++i) {
-                state *= inputs[i];
-            }
-            break;
-        case FUZZY_CFMQVS_OR:
-            state = inputs[0];
-            for (int i = 1; i < K; ++i) {
-                state += inputs[i];
-            }
-            break;
-        default: // Invalid function
-            printf("Error updating node: Invalid function: %d\n", function);
-            exit(EXIT_FAILURE);
-    }
-    state = clamp(state, 0, 1);
-    return state;
-}
-
 /**
  * @brief Returns the name of a specified node function.
  * @param [in] function The node function.
@@ -171,26 +164,78 @@ function_string(const int function)
 }
 
 /**
- * @brief Performs a synchronous update.
- * @param [in] dgp The DGP graph to update.
- * @param [in] inputs The inputs to the graph.
+ * @brief Groups the nodes of a DGP graph by function.
+ * @details Must be called whenever the node functions or connectivity change.
+ * @param [in] dgp The DGP graph to compile.
  */
 static void
-synchronous_update(const struct Graph *dgp, const double *inputs)
+graph_compile(struct Graph *dgp)
 {
-    for (int i = 0; i < dgp->n; ++i) {
-        for (int k = 0; k < dgp->max_k; ++k) {
-            const int c = dgp->connectivity[i * dgp->max_k + k];
-            if (c < dgp->n_inputs) { // external input
-                dgp->tmp_input[k] = inputs[c];
-            } else { // another node within the graph
-                dgp->tmp_input[k] = dgp->state[c - dgp->n_inputs];
+    int n = 0;
+    for (int f = 0; f < DGP_NUM_FUNC; ++f) {
+        for (int i = 0; i < dgp->n; ++i) {
+            if (dgp->function[i] == f) {
+                dgp->order[n] = i;
+                memcpy(&dgp->sources[n * dgp->max_k],
+                       &dgp->connectivity[i * dgp->max_k],
+                       sizeof(int) * dgp->max_k);
+                ++n;
+            }
+        }
+        dgp->group_end[f] = n;
+    }
+    if (n != dgp->n) {
+        printf("graph_compile(): invalid node function\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Performs one synchronous update cycle for a number of lanes.
+ * @details Each lane holds an independent set of inputs and node states, with
+ * element j of lane l stored at j x lanes + l. Nodes are visited one function
+ * group at a time, so the innermost loop applies the same function across the
+ * lanes of each node and may be vectorised by the compiler.
+ * @param [in] dgp The DGP graph to update.
+ * @param [in] src The inputs followed by the current node states.
+ * @param [out] dst The updated node states.
+ * @param [in] lanes The number of lanes.
+ */
+static inline void
+graph_cycle(const struct Graph *dgp, const double *src, double *dst,
+            const int lanes)
+{
+    const int K = dgp->max_k;
+    int j = 0;
+    for (; j < dgp->group_end[FUZZY_NOT]; ++j) {
+        const int *s = &dgp->sources[j * K];
+        double *d = &dst[dgp->order[j] * lanes];
+        for (int l = 0; l < lanes; ++l) {
+            d[l] = clamp(1 - src[s[0] * lanes + l], 0, 1);
+        }
+    }
+    for (; j < dgp->group_end[FUZZY_CFMQVS_AND]; ++j) {
+        const int *s = &dgp->sources[j * K];
+        double *d = &dst[dgp->order[j] * lanes];
+        for (int l = 0; l < lanes; ++l) {
+            double state = src[s[0] * lanes + l];
+            for (int k = 1; k < K; ++k) {
+                state *= src[s[k] * lanes + l];
+            }
+            d[l] = clamp(state, 0, 1);
+        }
+    }
+    for (; j < dgp->group_end[FUZZY_CFMQVS_OR]; ++j) {
+        const int *s = &dgp->sources[j * K];
+        double *d = &dst[dgp->order[j] * lanes];
+        for (int l = 0; l < lanes; ++l) {
+            double state = src[s[0] * lanes + l];
+            for (int k = 1; k < K; ++k) {
+                state += src[s[k] * lanes + l];
             }
+            d[l] = clamp(state, 0, 1);
         }
-        dgp->tmp_state[i] =
-            node_activate(dgp->function[i], dgp->tmp_input, dgp->max_k);
     }
-    memcpy(dgp->state, dgp->tmp_state, sizeof(double) * dgp->n);
 }
 
 /**
@@ -207,13 +252,16 @@ graph_init(struct Graph *dgp, const struct ArgsDGP *args)
     dgp->max_t = args->max_t;
     dgp->max_k = args->max_k;
     dgp->evolve_cycles = args->evolve_cycles;
+    dgp->sparse_mutate = args->sparse_mutate;
     dgp->klen = dgp->n * dgp->max_k;
     dgp->state = malloc(sizeof(double) * dgp->n);
     dgp->initial_state = malloc(sizeof(double) * dgp->n);
     dgp->tmp_state = malloc(sizeof(double) * dgp->n);
-    dgp->tmp_input = malloc(sizeof(double) * dgp->max_k);
+    dgp->tmp_input = malloc(sizeof(double) * (dgp->n_inputs + dgp->n));
     dgp->function = malloc(sizeof(int) * dgp->n);
     dgp->connectivity = malloc(sizeof(int) * dgp->klen);
+    dgp->order = malloc(sizeof(int) * dgp->n);
+    dgp->sources = malloc(sizeof(int) * dgp->klen);
     dgp->mu = malloc(sizeof(double) * N_MU);
     sam_init(dgp->mu, N_MU, MU_TYPE);
 }
@@ -233,10 +281,14 @@ graph_copy(struct Graph *dest, const struct Graph *src)
     dest->max_t = src->max_t;
     dest->n_inputs = src->n_inputs;
     dest->evolve_cycles = src->evolve_cycles;
+    dest->sparse_mutate = src->sparse_mutate;
     memcpy(dest->state, src->state, sizeof(double) * src->n);
     memcpy(dest->initial_state, src->initial_state, sizeof(double) * src->n);
     memcpy(dest->function, src->function, sizeof(int) * src->n);
     memcpy(dest->connectivity, src->connectivity, sizeof(int) * src->klen);
+    memcpy(dest->order, src->order, sizeof(int) * src->n);
+    memcpy(dest->sources, src->sources, sizeof(int) * src->klen);
+    memcpy(dest->group_end, src->group_end, sizeof(int) * DGP_NUM_FUNC);
     memcpy(dest->mu, src->mu, sizeof(double) * N_MU);
 }
 
@@ -275,17 +327,19 @@ graph_rand(struct Graph *dgp)
         dgp->t = rand_uniform_int(1, dgp->max_t);
     }
     for (int i = 0; i < dgp->n; ++i) {
-        dgp->function[i] = rand_uniform_int(0, NUM_FUNC);
+        dgp->function[i] = rand_uniform_int(0, DGP_NUM_FUNC);
         dgp->initial_state[i] = rand_uniform(0, 1);
         dgp->state[i] = rand_uniform(0, 1);
     }
     for (int i = 0; i < dgp->klen; ++i) {
         dgp->connectivity[i] = random_connection(dgp->n, dgp->n_inputs);
     }
+    graph_compile(dgp);
 }
 
 /**
  * @brief Updates a DGP graph T cycles.
+ * @details Updating stops early once the node states reach a fixed point.
  * @param [in] dgp The DGP graph to update.
  * @param [in] inputs The inputs to the graph.
  * @param [in] reset Whether to reset states to initial values.
@@ -296,9 +350,67 @@ graph_update(const struct Graph *dgp, const double *inputs, const bool reset)
     if (reset) {
         graph_reset(dgp);
     }
+    double *state = dgp->tmp_input + dgp->n_inputs;
+    memcpy(dgp->tmp_input, inputs, sizeof(double) * dgp->n_inputs);
+    memcpy(state, dgp->state, sizeof(double) * dgp->n);
     for (int t = 0; t < dgp->t; ++t) {
-        synchronous_update(dgp, inputs);
+        graph_cycle(dgp, dgp->tmp_input, dgp->tmp_state, 1);
+        if (memcmp(dgp->tmp_state, state, sizeof(double) * dgp->n) == 0) {
+            break;
+        }
+        memcpy(state, dgp->tmp_state, sizeof(double) * dgp->n);
+    }
+    memcpy(dgp->state, state, sizeof(double) * dgp->n);
+}
+
+/**
+ * @brief Updates a DGP graph T cycles from its initial states for each of a
+ * number of inputs and returns the final state of one node.
+ * @details Inputs are processed in blocks of lanes so that each node update
+ * is applied to every lane of a block. A block stops early once the node
+ * states of all lanes reach a fixed point; since further cycles leave a fixed
+ * point unchanged, the results are identical to graph_update() with reset.
+ * The graph itself is not modified.
+ * @param [in] dgp The DGP graph to update.
+ * @param [in] inputs The inputs to the graph (n_samples x n_inputs).
+ * @param [in] n_samples The number of inputs.
+ * @param [in] IDX Which node within the graph to output.
+ * @param [out] outputs The final state of the node for each input.
+ */
+void
+graph_update_batch(const struct Graph *dgp, const double *inputs,
+                   const int n_samples, const int IDX, double *outputs)
+{
+    const int n_src = dgp->n_inputs + dgp->n;
+    double *src = malloc(sizeof(double) * n_src * N_LANES);
+    double *dst = malloc(sizeof(double) * dgp->n * N_LANES);
+    double *state = src + dgp->n_inputs * N_LANES;
+    const size_t state_size = sizeof(double) * dgp->n * N_LANES;
+    for (int start = 0; start < n_samples; start += N_LANES) {
+        const int m = (n_samples - start < N_LANES) ? n_samples - start
+                                                    : N_LANES;
+        for (int l = 0; l < N_LANES; ++l) {
+            // unused lanes repeat the last input
+            const int sample = start + ((l < m) ? l : m - 1);
+            const double *x = &inputs[sample * dgp->n_inputs];
+            for (int i = 0; i < dgp->n_inputs; ++i) {
+                src[i * N_LANES + l] = x[i];
+            }
+            for (int i = 0; i < dgp->n; ++i) {
+                state[i * N_LANES + l] = dgp->initial_state[i];
+            }
+        }
+        for (int t = 0; t < dgp->t; ++t) {
+            graph_cycle(dgp, src, dst, N_LANES);
+            if (memcmp(dst, state, state_size) == 0) {
+                break;
+            }
+            memcpy(state, dst, state_size);
+        }
+        memcpy(&outputs[start], &state[IDX * N_LANES], sizeof(double) * m);
     }
+    free(src);
+    free(dst);
 }
 
 /**
@@ -334,9 +446,77 @@ graph_free(const struct Graph *dgp)
     free(dgp->tmp_state);
     free(dgp->tmp_input);
     free(dgp->function);
+    free(dgp->order);
+    free(dgp->sources);
     free(dgp->mu);
 }
 
+/**
+ * @brief Returns the number of bytes of heap memory used by a DGP graph.
+ * @param [in] dgp The DGP graph.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+graph_bytes(const struct Graph *dgp)
+{
+    return sizeof(double) * (4 * dgp->n + dgp->n_inputs + N_MU) +
+        sizeof(int) * 2 * (dgp->n + dgp->klen);
+}
+
+/**
+ * @brief Rewires a node to compute a function of a single external input so
+ * that its state lies on a specified side of 0.5 for an input.
+ * @details The node is connected only to the largest or smallest input and
+ * its state therefore reaches the covering value after the first update
+ * cycle, regardless of the initial states.
+ * @param [in] dgp The DGP graph to alter.
+ * @param [in] inputs The inputs to cover.
+ * @param [in] IDX Which node within the graph to alter.
+ * @param [in] high Whether the state should be above 0.5, otherwise below.
+ * @return Whether the node was successfully set.
+ */
+bool
+graph_cover(struct Graph *dgp, const double *inputs, const int IDX,
+            const bool high)
+{
+    int lo = 0;
+    int hi = 0;
+    for (int i = 1; i < dgp->n_inputs; ++i) {
+        if (inputs[i] < inputs[lo]) {
+            lo = i;
+        }
+        if (inputs[i] > inputs[hi]) {
+            hi = i;
+        }
+    }
+    const int functions[4] = { FUZZY_CFMQVS_OR, FUZZY_NOT, FUZZY_NOT,
+                               FUZZY_CFMQVS_AND };
+    const int sources[4] = { hi, lo, hi, lo };
+    for (int i = 0; i < 4; ++i) {
+        const double x = inputs[sources[i]];
+        double state = x;
+        if (functions[i] == FUZZY_NOT) {
+            state = 1 - x;
+        } else {
+            for (int k = 1; k < dgp->max_k; ++k) {
+                state = (functions[i] == FUZZY_CFMQVS_OR) ? state + x
+                                                          : state * x;
+            }
+        }
+        state = clamp(state, 0, 1);
+        if ((state > 0.5) == high) {
+            dgp->function[IDX] = functions[i];
+            for (int k = 0; k < dgp->max_k; ++k) {
+                dgp->connectivity[IDX * dgp->max_k + k] = sources[i];
+            }
+            dgp->state[IDX] = state;
+            graph_compile(dgp);
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * @brief Mutates a specified DGP graph.
  * @param [in] dgp The DGP graph to be mutated.
@@ -356,6 +536,9 @@ graph_mutate(struct Graph *dgp)
     if (dgp->evolve_cycles && graph_mutate_cycles(dgp)) {
         mod = true;
     }
+    if (mod) {
+        graph_compile(dgp);
+    }
     return mod;
 }
 
@@ -370,11 +553,13 @@ graph_save(const struct Graph *dgp, FILE *fp)
 {
     size_t s = 0;
     s += fwrite(&dgp->evolve_cycles, sizeof(bool), 1, fp);
+    s += fwrite(&dgp->sparse_mutate, sizeof(bool), 1, fp);
     s += fwrite(&dgp->n, sizeof(int), 1, fp);
     s += fwrite(&dgp->t, sizeof(int), 1, fp);
     s += fwrite(&dgp->klen, sizeof(int), 1, fp);
     s += fwrite(&dgp->max_t, sizeof(int), 1, fp);
     s += fwrite(&dgp->max_k, sizeof(int), 1, fp);
+    s += fwrite(&dgp->n_inputs, sizeof(int), 1, fp);
     s += fwrite(dgp->state, sizeof(double), dgp->n, fp);
     s += fwrite(dgp->initial_state, sizeof(double), dgp->n, fp);
     s += fwrite(dgp->function, sizeof(int), dgp->n, fp);
@@ -386,36 +571,53 @@ graph_save(const struct Graph *dgp, FILE *fp)
 /**
  * @brief Reads DGP graph from a file.
  * @param [in] dgp The DGP graph to load.
+ * @param [in] args Parameters for initialising and operating DGP graphs.
+ * @param [in] build The build version number of the saved graph.
  * @param [in] fp Pointer to the file to be written.
  * @return The number of elements written.
  */
 size_t
-graph_load(struct Graph *dgp, FILE *fp)
+graph_load(struct Graph *dgp, const struct ArgsDGP *args, const int build,
+           FILE *fp)
 {
     size_t s = 0;
     s += fread(&dgp->evolve_cycles, sizeof(bool), 1, fp);
+    dgp->sparse_mutate = false;
+    if (build >= GRAPH_SPARSE_BUILD) {
+        s += fread(&dgp->sparse_mutate, sizeof(bool), 1, fp);
+    }
     s += fread(&dgp->n, sizeof(int), 1, fp);
     s += fread(&dgp->t, sizeof(int), 1, fp);
     s += fread(&dgp->klen, sizeof(int), 1, fp);
     s += fread(&dgp->max_t, sizeof(int), 1, fp);
     s += fread(&dgp->max_k, sizeof(int), 1, fp);
-    if (dgp->n < 1 || dgp->klen < 1) {
+    if (build >= GRAPH_INPUTS_BUILD) {
+        s += fread(&dgp->n_inputs, sizeof(int), 1, fp);
+    } else {
+        dgp->n_inputs = args->n_inputs;
+    }
+    if (dgp->n < 1 || dgp->klen < 1 || dgp->n_inputs < 1) {
         printf("graph_load(): read error\n");
         dgp->n = 1;
         dgp->klen = 1;
+        dgp->n_inputs = 1;
         exit(EXIT_FAILURE);
     }
     dgp->state = malloc(sizeof(double) * dgp->n);
     dgp->initial_state = malloc(sizeof(double) * dgp->n);
     dgp->tmp_state = malloc(sizeof(double) * dgp->n);
-    dgp->tmp_input = malloc(sizeof(double) * dgp->max_k);
+    dgp->tmp_input = malloc(sizeof(double) * (dgp->n_inputs + dgp->n));
     dgp->function = malloc(sizeof(int) * dgp->n);
     dgp->connectivity = malloc(sizeof(int) * dgp->klen);
+    dgp->order = malloc(sizeof(int) * dgp->n);
+    dgp->sources = malloc(sizeof(int) * dgp->klen);
+    dgp->mu = malloc(sizeof(double) * N_MU);
     s += fread(dgp->state, sizeof(double), dgp->n, fp);
     s += fread(dgp->initial_state, sizeof(double), dgp->n, fp);
     s += fread(dgp->function, sizeof(int), dgp->n, fp);
     s += fread(dgp->connectivity, sizeof(int), dgp->klen, fp);
     s += fread(dgp->mu, sizeof(double), N_MU, fp);
+    graph_compile(dgp);
     return s;
 }
 
@@ -431,6 +633,7 @@ graph_args_init(struct ArgsDGP *args)
     args->n = 0;
     args->n_inputs = 0;
     args->evolve_cycles = false;
+    args->sparse_mutate = false;
 }
 
 /**
@@ -446,6 +649,9 @@ graph_args_print(const struct ArgsDGP *args)
     if (args->evolve_cycles) {
         printf(", evolve_cycles=true");
     }
+    if (args->sparse_mutate) {
+        printf(", sparse_mutate=true");
+    }
 }
 
 /**
@@ -459,6 +665,7 @@ graph_args_save(const struct ArgsDGP *args, FILE *fp)
 {
     size_t s = 0;
     s += fwrite(&args->evolve_cycles, sizeof(bool), 1, fp);
+    s += fwrite(&args->sparse_mutate, sizeof(bool), 1, fp);
     s += fwrite(&args->max_k, sizeof(int), 1, fp);
     s += fwrite(&args->max_t, sizeof(int), 1, fp);
     s += fwrite(&args->n, sizeof(int), 1, fp);
@@ -469,14 +676,19 @@ graph_args_save(const struct ArgsDGP *args, FILE *fp)
 /**
  * @brief Loads DGP parameters.
  * @param [in] args Parameters for initialising and operating DGP graphs.
+ * @param [in] build The build version number of the saved parameters.
  * @param [in] fp Pointer to the output file.
  * @return The total number of elements written.
  */
 size_t
-graph_args_load(struct ArgsDGP *args, FILE *fp)
+graph_args_load(struct ArgsDGP *args, const int build, FILE *fp)
 {
     size_t s = 0;
     s += fread(&args->evolve_cycles, sizeof(bool), 1, fp);
+    args->sparse_mutate = false;
+    if (build >= GRAPH_SPARSE_BUILD) {
+        s += fread(&args->sparse_mutate, sizeof(bool), 1, fp);
+    }
     s += fread(&args->max_k, sizeof(int), 1, fp);
     s += fread(&args->max_t, sizeof(int), 1, fp);
     s += fread(&args->n, sizeof(int), 1, fp);
@@ -535,3 +747,9 @@ graph_param_set_evolve_cycles(struct ArgsDGP *args, const bool a)
 {
     args->evolve_cycles = a;
 }
+
+void
+graph_param_set_sparse_mutate(struct ArgsDGP *args, const bool a)
+{
+    args->sparse_mutate = a;
+}
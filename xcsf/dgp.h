@@ -25,11 +25,14 @@
 
 #include "xcsf.h"
 
+#define DGP_NUM_FUNC (3) //!< Number of selectable node functions
+
 /**
  * @brief Parameters for initialising DGP graphs.
  */
 struct ArgsDGP {
     bool evolve_cycles; //!< Whether to evolve the number of update cycles
+    bool sparse_mutate; //!< Whether to mutate only sampled nodes
     int max_k; //!< Maximum number of connections a node may have
     int max_t; //!< Maximum number of update cycles
     int n; //!< Number of nodes in the graph
@@ -38,15 +41,23 @@ struct ArgsDGP {
 
 /**
  * @brief Dynamical GP graph data structure.
+ * @details Nodes are grouped by function and their connections gathered into
+ * the same order whenever the graph changes, so that an update cycle applies
+ * each function to a contiguous run of nodes. Connections index a buffer
+ * holding the external inputs followed by the node states.
  */
 struct Graph {
     bool evolve_cycles; //!< Whether to evolve the number of update cycles
+    bool sparse_mutate; //!< Whether to mutate only sampled nodes
     double *initial_state; //!< Initial node states
     double *state; //!< Current state of each node
-    double *tmp_input; //!< Temporary storage for updating the graph
+    double *tmp_input; //!< Inputs followed by node states during an update
     double *tmp_state; //!< Temporary storage for synchronous update
     int *connectivity; //!< Connectivity map
     int *function; //!< Node activation functions
+    int *order; //!< Node indices grouped by function
+    int *sources; //!< Connectivity map of the nodes in grouped order
+    int group_end[DGP_NUM_FUNC]; //!< End of each function group in order
     int klen; //!< Length of connectivity map
     int max_k; //!< Maximum number of connections a node may have
     int max_t; //!< Maximum number of update cycles
@@ -59,11 +70,16 @@ struct Graph {
 bool
 graph_mutate(struct Graph *dgp);
 
+bool
+graph_cover(struct Graph *dgp, const double *inputs, const int IDX,
+            const bool high);
+
 double
 graph_output(const struct Graph *dgp, const int IDX);
 
 size_t
-graph_load(struct Graph *dgp, FILE *fp);
+graph_load(struct Graph *dgp, const struct ArgsDGP *args, const int build,
+           FILE *fp);
 
 size_t
 graph_save(const struct Graph *dgp, FILE *fp);
@@ -74,6 +90,9 @@ graph_copy(struct Graph *dest, const struct Graph *src);
 void
 graph_free(const struct Graph *dgp);
 
+size_t
+graph_bytes(const struct Graph *dgp);
+
 void
 graph_init(struct Graph *dgp, const struct ArgsDGP *args);
 
@@ -89,6 +108,10 @@ graph_reset(const struct Graph *dgp);
 void
 graph_update(const struct Graph *dgp, const double *inputs, const bool reset);
 
+void
+graph_update_batch(const struct Graph *dgp, const double *inputs,
+                   const int n_samples, const int IDX, double *outputs);
+
 void
 graph_args_init(struct ArgsDGP *args);
 
@@ -99,7 +122,7 @@ size_t
 graph_args_save(const struct ArgsDGP *args, FILE *fp);
 
 size_t
-graph_args_load(struct ArgsDGP *args, FILE *fp);
+graph_args_load(struct ArgsDGP *args, const int build, FILE *fp);
 
 /* parameter setters */
 
@@ -117,3 +140,6 @@ graph_param_set_n_inputs(struct ArgsDGP *args, const int a);
 
 void
 graph_param_set_evolve_cycles(struct ArgsDGP *args, const bool a);
+
+void
+graph_param_set_sparse_mutate(struct ArgsDGP *args, const bool a);
@@ -24,6 +24,7 @@
 #include "ea.h"
 #include "cl.h"
 #include "clset.h"
+#include "profile.h"
 #include "utils.h"
 
 /**
@@ -67,15 +68,18 @@ static void
 ea_subsume(struct XCSF *xcsf, struct Cl *c, struct Cl *c1p, struct Cl *c2p,
            const struct Set *set)
 {
+    PROFILE_START(PROF_SUBSUMPTION);
     // check if either parent subsumes the offspring
     if (cl_subsumer(xcsf, c1p) && cl_general(xcsf, c1p, c)) {
         ++(c1p->num);
         ++(xcsf->pset.num);
         cl_free(xcsf, c);
+        PROFILE_COUNT(PROF_SUBSUMED, 1);
     } else if (cl_subsumer(xcsf, c2p) && cl_general(xcsf, c2p, c)) {
         ++(c2p->num);
         ++(xcsf->pset.num);
         cl_free(xcsf, c);
+        PROFILE_COUNT(PROF_SUBSUMED, 1);
     }
     // attempt to find a random subsumer from the set
     else {
@@ -91,12 +95,14 @@ ea_subsume(struct XCSF *xcsf, struct Cl *c, struct Cl *c1p, struct Cl *c2p,
             ++(candidates[rand_uniform_int(0, choices)]->cl->num);
             ++(xcsf->pset.num);
             cl_free(xcsf, c);
+            PROFILE_COUNT(PROF_SUBSUMED, 1);
         }
         // if no subsumers are found the offspring is added to the population
         else {
             clset_add(&xcsf->pset, c);
         }
     }
+    PROFILE_STOP(PROF_SUBSUMPTION);
 }
 
 /**
@@ -202,6 +208,8 @@ ea(struct XCSF *xcsf, const struct Set *set)
     if (set->size == 0 || xcsf->time - clset_mean_time(set) < xcsf->ea->theta) {
         return; // not yet time to run the EA
     }
+    PROFILE_START(PROF_EA);
+    ++(xcsf->n_ea);
     clset_set_times(xcsf, set);
     // select parents
     struct Cl *c1p = NULL;
@@ -225,8 +233,10 @@ ea(struct XCSF *xcsf, const struct Set *set)
         // add to population
         ea_add(xcsf, set, c1p, c2p, c1, cmod, m1mod);
         ea_add(xcsf, set, c2p, c1p, c2, cmod, m2mod);
+        PROFILE_COUNT(PROF_OFFSPRING, 2);
     }
     clset_pset_enforce_limit(xcsf);
+    PROFILE_STOP(PROF_EA);
 }
 
 /**
@@ -43,9 +43,12 @@ env_init(struct XCSF *xcsf, char **argv)
     } else if (strcmp(argv[1], "csv") == 0) {
         xcsf->env_vptr = &env_csv_vtbl;
         env_csv_init(xcsf, argv[2]);
+    } else if (strcmp(argv[1], "stream") == 0) {
+        xcsf->env_vptr = &env_csv_vtbl;
+        env_csv_stream_init(xcsf, argv[2]);
     } else {
         printf("Invalid environment specified: %s\n", argv[1]);
-        printf("Available environments: {mp, maze, csv}\n");
+        printf("Available environments: {mp, maze, csv, stream}\n");
         exit(EXIT_FAILURE);
     }
 }
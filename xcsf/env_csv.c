@@ -22,85 +22,332 @@
  */
 
 #include "env_csv.h"
+#include "dataset.h"
 #include "param.h"
 
-#define MAX_ROWS (100000) //!< Maximum number of instances
-#define MAX_COLS (200) //!< Maximum line length
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#ifdef PARALLEL
+    #define CSV_OMP_FOR _Pragma("omp parallel for schedule(dynamic)")
+#else
+    #define CSV_OMP_FOR
+#endif
+
 #define MAX_NAME (200) //!< Maximum file name length
-#define DELIM (",") //!< File delimiter
+#define STREAM_CHUNK (65536) //!< Number of samples in each stream buffer
+#define DELIM (',') //!< File delimiter
+#define CHUNK_SIZE (1 << 20) //!< Number of bytes parsed by each task
+#define MAX_TOKEN (64) //!< Maximum length of a number parsed by strtod
+#define MAX_MANTISSA (1ULL << 53) //!< Largest exactly representable integer
 
 /**
- * @brief Returns the number of samples in a csv file.
- * @param [in] fin The csv file.
- * @return The number of samples.
+ * @brief Exactly representable powers of ten.
  */
-static int
-env_csv_samples(FILE *fin)
+static const double POW10[23] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                  1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                  1e18, 1e19, 1e20, 1e21, 1e22 };
+
+/**
+ * @brief The contents of a csv file held in memory.
+ */
+struct CSVFile {
+    const char *data; //!< File contents
+    size_t size; //!< Number of bytes
+    bool mapped; //!< Whether the contents are memory mapped
+};
+
+/**
+ * @brief Maps the contents of a csv file into memory.
+ * @details Falls back to reading the whole file where mapping is unavailable.
+ * @param [in] filename The name of the csv file.
+ * @param [out] file The file contents.
+ */
+static void
+env_csv_open(const char *filename, struct CSVFile *file)
+{
+    file->data = NULL;
+    file->size = 0;
+    file->mapped = false;
+#ifndef _WIN32
+    const int fd = open(filename, O_RDONLY);
+    struct stat sb;
+    if (fd < 0 || fstat(fd, &sb) != 0) {
+        printf("Error opening file: %s. %s.\n", filename, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    file->size = (size_t) sb.st_size;
+    if (file->size > 0) {
+        void *data = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            posix_madvise(data, file->size, POSIX_MADV_SEQUENTIAL);
+            file->data = data;
+            file->mapped = true;
+        }
+    }
+    close(fd);
+    if (file->mapped || file->size == 0) {
+        return;
+    }
+#endif
+    FILE *fin = fopen(filename, "rb");
+    if (fin == 0) {
+        printf("Error opening file: %s. %s.\n", filename, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    fseek(fin, 0, SEEK_END);
+    const long size = ftell(fin);
+    rewind(fin);
+    char *data = malloc(size > 0 ? size : 1);
+    file->size = (size > 0) ? fread(data, sizeof(char), size, fin) : 0;
+    file->data = data;
+    fclose(fin);
+}
+
+/**
+ * @brief Releases the contents of a csv file.
+ * @param [in] file The file contents.
+ */
+static void
+env_csv_close(struct CSVFile *file)
 {
-    int n_samples = 0;
-    char line[MAX_COLS];
-    while (fgets(line, MAX_COLS, fin) != NULL) {
-        ++n_samples;
+#ifndef _WIN32
+    if (file->mapped) {
+        munmap((void *) (uintptr_t) file->data, file->size);
+        return;
     }
-    return n_samples;
+#endif
+    free((void *) (uintptr_t) file->data);
+}
+
+/**
+ * @brief Returns the start of the line following a position.
+ * @param [in] p The current position.
+ * @param [in] end The end of the data.
+ * @return The start of the next line, or the end of the data.
+ */
+static inline const char *
+env_csv_next_line(const char *p, const char *end)
+{
+    const char *nl = memchr(p, '\n', end - p);
+    return (nl == NULL) ? end : nl + 1;
 }
 
 /**
- * @brief Returns the number of dimensions in a csv file.
- * @param [in] fin The csv file.
- * @return The number of dimensions.
+ * @brief Returns whether a character is white space within a line.
+ * @param [in] c The character.
+ * @return Whether the character is a space, tab, or carriage return.
+ */
+static inline bool
+env_csv_space(const char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/**
+ * @brief Returns whether a line contains only white space.
+ * @param [in] p The start of the line.
+ * @param [in] end The end of the data.
+ * @return Whether the line is blank.
+ */
+static bool
+env_csv_blank(const char *p, const char *end)
+{
+    while (p < end && *p != '\n') {
+        if (!env_csv_space(*p)) {
+            return false;
+        }
+        ++p;
+    }
+    return true;
+}
+
+/**
+ * @brief Parses a number with strtod.
+ * @details The number is first copied so that parsing cannot read beyond the
+ * end of the data, which need not be null terminated.
+ * @param [in] p The start of the number.
+ * @param [in] end The end of the data.
+ * @param [out] value The parsed number.
+ * @return The position after the number, or NULL if no number was parsed.
+ */
+static const char *
+env_csv_strtod(const char *p, const char *end, double *value)
+{
+    char token[MAX_TOKEN];
+    int len = 0;
+    while (p + len < end && len < MAX_TOKEN - 1 && p[len] != DELIM &&
+           p[len] != '\n') {
+        token[len] = p[len];
+        ++len;
+    }
+    token[len] = '\0';
+    char *endptr = NULL;
+    *value = strtod(token, &endptr);
+    if (endptr == token) {
+        return NULL;
+    }
+    return p + (endptr - token);
+}
+
+/**
+ * @brief Parses a decimal number.
+ * @details Numbers with at most 19 significant digits whose mantissa and
+ * power of ten are exactly representable are computed with a single
+ * correctly rounded multiplication or division, giving the same result as
+ * strtod. All other numbers are parsed with strtod.
+ * @param [in] p The start of the number.
+ * @param [in] end The end of the data.
+ * @param [out] value The parsed number.
+ * @return The position after the number, or NULL if no number was parsed.
+ */
+static const char *
+env_csv_parse_double(const char *p, const char *end, double *value)
+{
+    while (p < end && env_csv_space(*p)) {
+        ++p;
+    }
+    const char *start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+    unsigned long long mantissa = 0;
+    int n_digits = 0;
+    int exponent = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        mantissa = mantissa * 10 + (unsigned long long) (*p - '0');
+        ++n_digits;
+        ++p;
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        while (p < end && *p >= '0' && *p <= '9') {
+            mantissa = mantissa * 10 + (unsigned long long) (*p - '0');
+            ++n_digits;
+            --exponent;
+            ++p;
+        }
+    }
+    if (n_digits == 0 || n_digits > 19) {
+        return env_csv_strtod(start, end, value);
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool exp_negative = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            exp_negative = (*p == '-');
+            ++p;
+        }
+        int e = 0;
+        int n_exp = 0;
+        while (p < end && *p >= '0' && *p <= '9' && n_exp < 5) {
+            e = e * 10 + (*p - '0');
+            ++n_exp;
+            ++p;
+        }
+        if (n_exp == 0 || n_exp >= 5) {
+            return env_csv_strtod(start, end, value);
+        }
+        exponent += exp_negative ? -e : e;
+    }
+    if (mantissa > MAX_MANTISSA || exponent < -22 || exponent > 22) {
+        return env_csv_strtod(start, end, value);
+    }
+    double v = (double) mantissa;
+    v = (exponent < 0) ? v / POW10[-exponent] : v * POW10[exponent];
+    *value = negative ? -v : v;
+    return p;
+}
+
+/**
+ * @brief Returns the number of non-empty fields in a line.
+ * @param [in] p The start of the line.
+ * @param [in] end The end of the data.
+ * @return The number of fields.
  */
 static int
-env_csv_dim(FILE *fin)
+env_csv_count_fields(const char *p, const char *end)
 {
-    rewind(fin);
-    int n_dim = 0;
-    char line[MAX_COLS];
-    char *saveptr = NULL;
-    if (fgets(line, MAX_COLS, fin) != NULL) {
-        const char *ptok = strtok_r(line, DELIM, &saveptr);
-        while (ptok != NULL) {
-            if (strnlen(ptok, MAX_COLS) > 0) {
-                ++n_dim;
-            }
-            ptok = strtok_r(NULL, DELIM, &saveptr);
+    int n_fields = 0;
+    bool empty = true;
+    while (p < end && *p != '\n') {
+        if (*p == DELIM) {
+            n_fields += empty ? 0 : 1;
+            empty = true;
+        } else if (!env_csv_space(*p)) {
+            empty = false;
         }
+        ++p;
     }
-    return n_dim;
+    return n_fields + (empty ? 0 : 1);
 }
 
 /**
- * @brief Reads the data from a csv file.
- * @param [in] fin The csv file.
- * @param [out] data The read data.
- * @param [in] n_samples The number of samples.
- * @param [in] n_dim The number of dimensions.
+ * @brief Parses a line of a specified number of numeric fields.
+ * @param [in] p The start of the line.
+ * @param [in] end The end of the data.
+ * @param [out] row The parsed fields.
+ * @param [in] n_dim The number of fields expected.
+ * @return Whether the line was successfully parsed.
  */
-static void
-env_csv_read_data(FILE *fin, double **data, const int n_samples,
+static bool
+env_csv_parse_row(const char *p, const char *end, double *row,
                   const int n_dim)
 {
-    rewind(fin);
-    *data = malloc(sizeof(double) * n_dim * n_samples);
-    char line[MAX_COLS];
-    const char *str = NULL;
-    char *saveptr = NULL;
-    char *endptr = NULL;
-    int i = 0;
-    while (fgets(line, MAX_COLS, fin) != NULL && i < n_samples) {
-        str = strtok_r(line, DELIM, &saveptr);
-        (*data)[i * n_dim] = strtod(str, &endptr);
-        for (int j = 1; j < n_dim; ++j) {
-            str = strtok_r(NULL, DELIM, &saveptr);
-            (*data)[i * n_dim + j] = strtod(str, &endptr);
+    for (int j = 0; j < n_dim; ++j) {
+        if (j > 0) {
+            if (p >= end || *p != DELIM) {
+                return false;
+            }
+            ++p;
+        }
+        p = env_csv_parse_double(p, end, &row[j]);
+        if (p == NULL) {
+            return false;
+        }
+        while (p < end && env_csv_space(*p)) {
+            ++p;
         }
-        ++i;
     }
+    if (p < end && *p == DELIM) { // trailing delimiter
+        ++p;
+    }
+    return env_csv_blank(p, end);
+}
+
+/**
+ * @brief Returns the start of the first line beginning at or after a byte.
+ * @param [in] begin The start of the data rows.
+ * @param [in] end The end of the data.
+ * @param [in] offset The byte offset from the start of the data rows.
+ * @return The start of the line.
+ */
+static const char *
+env_csv_chunk_start(const char *begin, const char *end, const size_t offset)
+{
+    if (offset == 0) {
+        return begin;
+    }
+    if (offset >= (size_t) (end - begin)) {
+        return end;
+    }
+    return env_csv_next_line(begin + offset - 1, end);
 }
 
 /**
  * @brief Parses a specified csv file.
- * @details Provided a file name will set the data, n_samples, and n_dim.
+ * @details Provided a file name will set the data, n_samples, and n_dim. The
+ * file is mapped into memory and divided into chunks of whole lines that are
+ * counted and then parsed in parallel. A first line that does not begin with
+ * a number is treated as a header and skipped. Blank lines are ignored and
+ * there is no limit on the length or number of lines.
  * @param [in] filename The name of the csv file to read.
  * @param [out] data A data structure to store the data.
  * @param [out] n_samples The number of samples in the dataset.
@@ -109,19 +356,71 @@ env_csv_read_data(FILE *fin, double **data, const int n_samples,
 static void
 env_csv_read(const char *filename, double **data, int *n_samples, int *n_dim)
 {
-    FILE *fin = fopen(filename, "rt");
-    if (fin == 0) {
-        printf("Error opening file: %s. %s.\n", filename, strerror(errno));
-        exit(EXIT_FAILURE);
+    struct CSVFile file;
+    env_csv_open(filename, &file);
+    const char *end = file.data + file.size;
+    const char *begin = file.data;
+    while (begin < end && env_csv_blank(begin, end)) {
+        begin = env_csv_next_line(begin, end);
     }
-    *n_samples = env_csv_samples(fin);
-    *n_dim = env_csv_dim(fin);
-    if (*n_samples > 0 && *n_dim > 0) {
-        env_csv_read_data(fin, data, *n_samples, *n_dim);
-        fclose(fin);
-    } else {
+    double first = 0;
+    if (begin < end && env_csv_parse_double(begin, end, &first) == NULL) {
+        begin = env_csv_next_line(begin, end); // header
+        while (begin < end && env_csv_blank(begin, end)) {
+            begin = env_csv_next_line(begin, end);
+        }
+    }
+    *n_dim = (begin < end) ? env_csv_count_fields(begin, end) : 0;
+    const size_t size = end - begin;
+    const int n_chunks = (int) (size / CHUNK_SIZE) + 1;
+    size_t *rows = calloc(n_chunks + 1, sizeof(size_t));
+    CSV_OMP_FOR
+    for (int c = 0; c < n_chunks; ++c) {
+        const char *p = env_csv_chunk_start(begin, end, (size_t) c * CHUNK_SIZE);
+        const char *stop =
+            env_csv_chunk_start(begin, end, (size_t) (c + 1) * CHUNK_SIZE);
+        while (p < stop) {
+            rows[c + 1] += env_csv_blank(p, stop) ? 0 : 1;
+            p = env_csv_next_line(p, stop);
+        }
+    }
+    for (int c = 0; c < n_chunks; ++c) {
+        rows[c + 1] += rows[c];
+    }
+    if (rows[n_chunks] < 1 || *n_dim < 1 || rows[n_chunks] > INT_MAX) {
         printf("Error reading file: %s. No samples found\n", filename);
-        fclose(fin);
+        exit(EXIT_FAILURE);
+    }
+    *n_samples = (int) rows[n_chunks];
+    *data = malloc(sizeof(double) * *n_dim * rows[n_chunks]);
+    size_t bad = rows[n_chunks];
+    CSV_OMP_FOR
+    for (int c = 0; c < n_chunks; ++c) {
+        const char *p = env_csv_chunk_start(begin, end, (size_t) c * CHUNK_SIZE);
+        const char *stop =
+            env_csv_chunk_start(begin, end, (size_t) (c + 1) * CHUNK_SIZE);
+        size_t row = rows[c];
+        while (p < stop) {
+            if (!env_csv_blank(p, stop)) {
+                double *x = *data + row * *n_dim;
+                if (!env_csv_parse_row(p, stop, x, *n_dim)) {
+#ifdef PARALLEL
+    #pragma omp critical
+#endif
+                    bad = (row < bad) ? row : bad;
+                    break;
+                }
+                ++row;
+            }
+            p = env_csv_next_line(p, stop);
+        }
+    }
+    free(rows);
+    env_csv_close(&file);
+    if (bad < (size_t) *n_samples) {
+        printf("Error reading file: %s. Invalid sample %zu: expected %d "
+               "numeric values\n",
+               filename, bad + 1, *n_dim);
         exit(EXIT_FAILURE);
     }
     printf("Loaded: %s: samples=%d, dim=%d\n", filename, *n_samples, *n_dim);
@@ -134,7 +433,7 @@ env_csv_read(const char *filename, double **data, int *n_samples, int *n_dim)
  * @param [out] train_data The data structure to load the training data.
  * @param [out] test_data The data structure to load the testing data.
  */
-static void
+void
 env_csv_input_read(const char *infile, struct Input *train_data,
                    struct Input *test_data)
 {
@@ -151,8 +450,32 @@ env_csv_input_read(const char *infile, struct Input *train_data,
     env_csv_read(name, &test_data->y, &test_data->n_samples, &test_data->y_dim);
 }
 
+/**
+ * @brief Returns whether a binary dataset can replace a pair of csv files.
+ * @param [in] filename The file name of the csv data.
+ * @param [in] split Either "train" or "test".
+ * @return Whether {filename}_{split}.bin exists and is at least as new as
+ * both of the {filename}_{split}_x.csv and {filename}_{split}_y.csv files.
+ */
+static bool
+env_csv_binary_current(const char *filename, const char *split)
+{
+    char bin[MAX_NAME];
+    char csv[MAX_NAME];
+    snprintf(bin, MAX_NAME, "%s_%s.bin", filename, split);
+    snprintf(csv, MAX_NAME, "%s_%s_x.csv", filename, split);
+    if (!dataset_current(bin, csv)) {
+        return false;
+    }
+    snprintf(csv, MAX_NAME, "%s_%s_y.csv", filename, split);
+    return dataset_current(bin, csv);
+}
+
 /**
  * @brief Initialises a CSV input environment from a specified filename.
+ * @details Binary dataset files named {filename}_train.bin and
+ * {filename}_test.bin are mapped in preference to the csv files if both
+ * exist and neither is older than the csv files they were converted from.
  * @param [in] xcsf The XCSF data structure.
  * @param [in] filename The file name of the csv data.
  */
@@ -162,13 +485,56 @@ env_csv_init(struct XCSF *xcsf, const char *filename)
     struct EnvCSV *env = malloc(sizeof(struct EnvCSV));
     env->train_data = malloc(sizeof(struct Input));
     env->test_data = malloc(sizeof(struct Input));
-    env_csv_input_read(filename, env->train_data, env->test_data);
+    env->train_stream = NULL;
+    char train[MAX_NAME];
+    char test[MAX_NAME];
+    snprintf(train, MAX_NAME, "%s_train.bin", filename);
+    snprintf(test, MAX_NAME, "%s_test.bin", filename);
+    env->binary = env_csv_binary_current(filename, "train") &&
+        env_csv_binary_current(filename, "test");
+    if (env->binary) {
+        dataset_load(env->train_data, train);
+        dataset_load(env->test_data, test);
+    } else {
+        env_csv_input_read(filename, env->train_data, env->test_data);
+    }
     xcsf->env = env;
     const int x_dim = env->train_data->x_dim;
     const int y_dim = env->train_data->y_dim;
     param_init(xcsf, x_dim, y_dim, 1);
 }
 
+/**
+ * @brief Initialises a CSV input environment that streams the training data.
+ * @details The training samples are streamed in shuffled chunks from the
+ * binary dataset file {filename}_train.bin so that they need not fit in
+ * memory. The test samples are mapped from {filename}_test.bin.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] filename The file name of the binary data.
+ */
+void
+env_csv_stream_init(struct XCSF *xcsf, const char *filename)
+{
+    struct EnvCSV *env = malloc(sizeof(struct EnvCSV));
+    env->train_data = NULL;
+    env->test_data = malloc(sizeof(struct Input));
+    char train[MAX_NAME];
+    char test[MAX_NAME];
+    snprintf(train, MAX_NAME, "%s_train.bin", filename);
+    snprintf(test, MAX_NAME, "%s_test.bin", filename);
+    env->binary = true;
+    env->train_stream = stream_open(train, STREAM_CHUNK, true);
+    dataset_load(env->test_data, test);
+    const int x_dim = env->train_stream->src.x_dim;
+    const int y_dim = env->train_stream->src.y_dim;
+    if (env->test_data->x_dim != x_dim || env->test_data->y_dim != y_dim) {
+        printf("env_csv_stream_init(): mismatched dimensions\n");
+        exit(EXIT_FAILURE);
+    }
+    xcsf->env = env;
+    param_init(xcsf, x_dim, y_dim, 1);
+}
+
 /**
  * @brief Frees the csv environment.
  * @param [in] xcsf The XCSF data structure.
@@ -177,10 +543,18 @@ void
 env_csv_free(const struct XCSF *xcsf)
 {
     struct EnvCSV *env = xcsf->env;
-    free(env->train_data->x);
-    free(env->train_data->y);
-    free(env->test_data->x);
-    free(env->test_data->y);
+    if (env->train_stream != NULL) {
+        stream_free(env->train_stream);
+        dataset_free(env->test_data);
+    } else if (env->binary) {
+        dataset_free(env->train_data);
+        dataset_free(env->test_data);
+    } else {
+        free(env->train_data->x);
+        free(env->train_data->y);
+        free(env->test_data->x);
+        free(env->test_data->y);
+    }
     free(env->train_data);
     free(env->test_data);
     free(env);
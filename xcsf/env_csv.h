@@ -24,6 +24,7 @@
 #pragma once
 
 #include "env.h"
+#include "stream.h"
 #include "xcsf.h"
 
 /**
@@ -32,6 +33,8 @@
 struct EnvCSV {
     struct Input *train_data;
     struct Input *test_data;
+    bool binary; //!< Whether the data are mapped from binary dataset files
+    struct Stream *train_stream; //!< Streamed training data, or NULL
 };
 
 bool
@@ -55,6 +58,13 @@ env_csv_free(const struct XCSF *xcsf);
 void
 env_csv_init(struct XCSF *xcsf, const char *filename);
 
+void
+env_csv_stream_init(struct XCSF *xcsf, const char *filename);
+
+void
+env_csv_input_read(const char *infile, struct Input *train_data,
+                   struct Input *test_data);
+
 void
 env_csv_reset(const struct XCSF *xcsf);
 
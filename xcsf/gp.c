@@ -31,10 +31,14 @@
 #define SUB (1) //!< Subtraction function
 #define MUL (2) //!< Multiplication function
 #define DIV (3) //!< Division function
+#define OP_CONST (GP_NUM_FUNC) //!< Compiled operation pushing a constant
+#define OP_INPUT (GP_NUM_FUNC + 1) //!< Compiled operation pushing an input
 
 #define N_MU (1) //!< Number of tree-GP mutation rates
 #define RET_MIN (-1000) //!< Minimum tree return value
 #define RET_MAX (1000) //!< Maximum tree return value
+#define N_LANES (8) //!< Number of inputs evaluated together in a batch
+#define TREE_NO_POS_BUILD (2) //!< First build not saving the tree position
 
 /**
  * @brief Self-adaptation method for mutating GP trees.
@@ -88,6 +92,63 @@ tree_grow(const struct ArgsGPTree *args, int *tree, const int pos,
     return tree_grow(args, tree, child, max, depth - 1);
 }
 
+/**
+ * @brief Compiles a GP sub-tree into postfix operations.
+ * @param [in] gp The GP tree being compiled.
+ * @param [in] args Tree GP parameters.
+ * @param [in] pos The position of the sub-tree root.
+ * @param [in,out] n The number of operations compiled.
+ * @return The position after traversal.
+ */
+static int
+tree_compile_node(struct GPTree *gp, const struct ArgsGPTree *args, int pos,
+                  int *n)
+{
+    const int node = gp->tree[pos];
+    ++pos;
+    struct GPOp op = { node, 0, 0 };
+    if (node >= GP_NUM_FUNC + args->n_constants) {
+        op.type = OP_INPUT;
+        op.index = node - GP_NUM_FUNC - args->n_constants;
+    } else if (node >= GP_NUM_FUNC) {
+        op.type = OP_CONST;
+        op.value = args->constants[node - GP_NUM_FUNC];
+    } else if (node >= 0) {
+        pos = tree_compile_node(gp, args, pos, n);
+        pos = tree_compile_node(gp, args, pos, n);
+    } else {
+        printf("tree_compile() invalid function: %d\n", node);
+        exit(EXIT_FAILURE);
+    }
+    gp->code[*n] = op;
+    ++(*n);
+    return pos;
+}
+
+/**
+ * @brief Compiles a GP tree into postfix operations for evaluation.
+ * @details Constants are resolved and terminals decoded once so that
+ * evaluation only executes arithmetic. Must be called whenever the tree is
+ * modified.
+ * @param [in] gp The GP tree to compile.
+ * @param [in] args Tree GP parameters.
+ */
+static void
+tree_compile(struct GPTree *gp, const struct ArgsGPTree *args)
+{
+    gp->code = realloc(gp->code, sizeof(struct GPOp) * gp->len);
+    int n = 0;
+    tree_compile_node(gp, args, 0, &n);
+    int depth = 0;
+    gp->stack_size = 0;
+    for (int i = 0; i < n; ++i) {
+        depth += (gp->code[i].type >= GP_NUM_FUNC) ? 1 : -1;
+        if (depth > gp->stack_size) {
+            gp->stack_size = depth;
+        }
+    }
+}
+
 /**
  * @brief Creates a random GP tree.
  * @param [in] gp The GP tree being randomised.
@@ -102,6 +163,8 @@ tree_rand(struct GPTree *gp, const struct ArgsGPTree *args)
         gp->len = tree_grow(args, gp->tree, 0, args->max_len, args->init_depth);
     }
     gp->tree = realloc(gp->tree, sizeof(int) * gp->len);
+    gp->code = NULL;
+    tree_compile(gp, args);
     gp->mu = malloc(sizeof(double) * N_MU);
     sam_init(gp->mu, N_MU, MU_TYPE);
 }
@@ -114,41 +177,124 @@ void
 tree_free(const struct GPTree *gp)
 {
     free(gp->tree);
+    free(gp->code);
     free(gp->mu);
 }
 
 /**
- * @brief Evaluates a GP tree.
- * @param [in] gp The GP tree to evaluate.
- * @param [in] args Tree GP parameters.
- * @param [in] x The input state.
- * @return The result from evaluating the GP tree.
+ * @brief Returns the number of bytes of heap memory used by a GP tree.
+ * @param [in] gp The GP tree.
+ * @return The number of bytes allocated for the tree, code, and mutation rates.
  */
-double
-tree_eval(struct GPTree *gp, const struct ArgsGPTree *args, const double *x)
+size_t
+tree_bytes(const struct GPTree *gp)
 {
-    const int node = gp->tree[gp->pos];
-    ++(gp->pos);
-    if (node >= GP_NUM_FUNC + args->n_constants) {
-        return x[node - GP_NUM_FUNC - args->n_constants];
+    size_t bytes = sizeof(int) * gp->len + sizeof(double) * N_MU;
+    if (gp->code != NULL) {
+        bytes += sizeof(struct GPOp) * gp->len;
     }
-    if (node >= GP_NUM_FUNC) {
-        return args->constants[node - GP_NUM_FUNC];
-    }
-    const double a = clamp(tree_eval(gp, args, x), RET_MIN, RET_MAX);
-    const double b = clamp(tree_eval(gp, args, x), RET_MIN, RET_MAX);
-    switch (node) {
+    return bytes;
+}
+
+/**
+ * @brief Applies a GP function to two arguments.
+ * @details Arguments are clamped before the function is applied.
+ * @param [in] function The GP function to apply.
+ * @param [in] a The first argument.
+ * @param [in] b The second argument.
+ * @return The result from applying the function.
+ */
+static inline double
+tree_apply(const int function, double a, double b)
+{
+    a = clamp(a, RET_MIN, RET_MAX);
+    b = clamp(b, RET_MIN, RET_MAX);
+    switch (function) {
         case ADD:
             return a + b;
         case SUB:
             return a - b;
         case MUL:
             return a * b;
-        case DIV:
-            return (b != 0) ? (a / b) : a;
         default:
-            printf("tree_eval() invalid function: %d\n", node);
-            exit(EXIT_FAILURE);
+            return (b != 0) ? (a / b) : a;
+    }
+}
+
+/**
+ * @brief Evaluates a GP tree.
+ * @param [in] gp The GP tree to evaluate.
+ * @param [in] x The input state.
+ * @return The result from evaluating the GP tree.
+ */
+double
+tree_eval(const struct GPTree *gp, const double *x)
+{
+    double stack[gp->stack_size];
+    int top = -1;
+    for (int i = 0; i < gp->len; ++i) {
+        const struct GPOp *op = &gp->code[i];
+        switch (op->type) {
+            case OP_INPUT:
+                stack[++top] = x[op->index];
+                break;
+            case OP_CONST:
+                stack[++top] = op->value;
+                break;
+            default:
+                --top;
+                stack[top] = tree_apply(op->type, stack[top], stack[top + 1]);
+                break;
+        }
+    }
+    return stack[0];
+}
+
+/**
+ * @brief Evaluates a GP tree for a batch of inputs.
+ * @details Inputs are processed in blocks of lanes so that each compiled
+ * operation is applied to every lane of a block before the next operation is
+ * dispatched, allowing the arithmetic to be vectorised.
+ * @param [in] gp The GP tree to evaluate.
+ * @param [in] args Tree GP parameters.
+ * @param [in] x The input states (n x n_inputs).
+ * @param [in] n The number of input states.
+ * @param [out] out The result from evaluating each input state.
+ */
+void
+tree_eval_batch(const struct GPTree *gp, const struct ArgsGPTree *args,
+                const double *x, const int n, double *out)
+{
+    double stack[gp->stack_size][N_LANES];
+    for (int start = 0; start < n; start += N_LANES) {
+        const int m = (n - start < N_LANES) ? n - start : N_LANES;
+        const double *xb = x + (size_t) start * args->n_inputs;
+        int top = -1;
+        for (int i = 0; i < gp->len; ++i) {
+            const struct GPOp *op = &gp->code[i];
+            switch (op->type) {
+                case OP_INPUT:
+                    ++top;
+                    for (int l = 0; l < m; ++l) {
+                        stack[top][l] = xb[l * args->n_inputs + op->index];
+                    }
+                    break;
+                case OP_CONST:
+                    ++top;
+                    for (int l = 0; l < m; ++l) {
+                        stack[top][l] = op->value;
+                    }
+                    break;
+                default:
+                    --top;
+                    for (int l = 0; l < m; ++l) {
+                        stack[top][l] = tree_apply(op->type, stack[top][l],
+                                                   stack[top + 1][l]);
+                    }
+                    break;
+            }
+        }
+        memcpy(out + start, stack[0], sizeof(double) * m);
     }
 }
 
@@ -208,7 +354,9 @@ tree_copy(struct GPTree *dest, const struct GPTree *src)
     dest->len = src->len;
     dest->tree = malloc(sizeof(int) * src->len);
     memcpy(dest->tree, src->tree, sizeof(int) * src->len);
-    dest->pos = src->pos;
+    dest->code = malloc(sizeof(struct GPOp) * src->len);
+    memcpy(dest->code, src->code, sizeof(struct GPOp) * src->len);
+    dest->stack_size = src->stack_size;
     dest->mu = malloc(sizeof(double) * N_MU);
     memcpy(dest->mu, src->mu, sizeof(double) * N_MU);
 }
@@ -217,9 +365,11 @@ tree_copy(struct GPTree *dest, const struct GPTree *src)
  * @brief Performs sub-tree crossover.
  * @param [in] p1 The first GP tree to perform crossover.
  * @param [in] p2 The second GP tree to perform crossover.
+ * @param [in] args Tree GP parameters.
  */
 void
-tree_crossover(struct GPTree *p1, struct GPTree *p2)
+tree_crossover(struct GPTree *p1, struct GPTree *p2,
+               const struct ArgsGPTree *args)
 {
     const int len1 = p1->len;
     const int len2 = p2->len;
@@ -245,6 +395,8 @@ tree_crossover(struct GPTree *p1, struct GPTree *p2)
     p2->tree = new2;
     p1->len = tree_traverse(p1->tree, 0);
     p2->len = tree_traverse(p2->tree, 0);
+    tree_compile(p1, args);
+    tree_compile(p2, args);
 }
 
 /**
@@ -274,9 +426,62 @@ tree_mutate(struct GPTree *gp, const struct ArgsGPTree *args)
             }
         }
     }
+    if (changed) {
+        tree_compile(gp, args);
+    }
     return changed;
 }
 
+/**
+ * @brief Inserts a new root into a GP tree so that it evaluates greater than
+ * 0.5 for a specified input.
+ * @details A terminal t with a non-zero value is used to build the sub-tree
+ * (t / t), which evaluates to one. The existing tree is subtracted from it if
+ * the tree evaluates less than 0.5, otherwise it is added.
+ * @param [in] gp The GP tree to alter.
+ * @param [in] args Tree GP parameters.
+ * @param [in] x The input state to cover.
+ * @return Whether the tree now evaluates greater than 0.5.
+ */
+bool
+tree_cover(struct GPTree *gp, const struct ArgsGPTree *args, const double *x)
+{
+    const double value = tree_eval(gp, x);
+    if (value > 0.5) {
+        return true;
+    }
+    int term = -1;
+    for (int i = 0; i < args->n_constants && term < 0; ++i) {
+        if (fabs(args->constants[i]) > 0) {
+            term = GP_NUM_FUNC + i;
+        }
+    }
+    for (int i = 0; i < args->n_inputs && term < 0; ++i) {
+        if (fabs(x[i]) > 0) {
+            term = GP_NUM_FUNC + args->n_constants + i;
+        }
+    }
+    if (term < 0) {
+        return false;
+    }
+    int *tree = malloc(sizeof(int) * (gp->len + 4));
+    const int one[3] = { DIV, term, term };
+    if (value < 0.5) {
+        tree[0] = SUB;
+        memcpy(&tree[1], one, sizeof(int) * 3);
+        memcpy(&tree[4], gp->tree, sizeof(int) * gp->len);
+    } else {
+        tree[0] = ADD;
+        memcpy(&tree[1], gp->tree, sizeof(int) * gp->len);
+        memcpy(&tree[gp->len + 1], one, sizeof(int) * 3);
+    }
+    free(gp->tree);
+    gp->tree = tree;
+    gp->len += 4;
+    tree_compile(gp, args);
+    return tree_eval(gp, x) > 0.5;
+}
+
 /**
  * @brief Writes the GP tree to a file.
  * @param [in] gp The GP tree to save.
@@ -287,7 +492,6 @@ size_t
 tree_save(const struct GPTree *gp, FILE *fp)
 {
     size_t s = 0;
-    s += fwrite(&gp->pos, sizeof(int), 1, fp);
     s += fwrite(&gp->len, sizeof(int), 1, fp);
     s += fwrite(gp->tree, sizeof(int), gp->len, fp);
     s += fwrite(gp->mu, sizeof(double), N_MU, fp);
@@ -297,14 +501,20 @@ tree_save(const struct GPTree *gp, FILE *fp)
 /**
  * @brief Reads a GP tree from a file.
  * @param [in] gp The GP tree to load.
+ * @param [in] args Tree GP parameters.
+ * @param [in] build The build version number of the saved tree.
  * @param [in] fp Pointer to the file to be read.
  * @return The number of elements read.
  */
 size_t
-tree_load(struct GPTree *gp, FILE *fp)
+tree_load(struct GPTree *gp, const struct ArgsGPTree *args, const int build,
+          FILE *fp)
 {
     size_t s = 0;
-    s += fread(&gp->pos, sizeof(int), 1, fp);
+    if (build < TREE_NO_POS_BUILD) {
+        int pos = 0; // traversal position saved by earlier builds
+        s += fread(&pos, sizeof(int), 1, fp);
+    }
     s += fread(&gp->len, sizeof(int), 1, fp);
     if (gp->len < 1) {
         printf("tree_load(): read error\n");
@@ -312,8 +522,11 @@ tree_load(struct GPTree *gp, FILE *fp)
         exit(EXIT_FAILURE);
     }
     gp->tree = malloc(sizeof(int) * gp->len);
+    gp->mu = malloc(sizeof(double) * N_MU);
     s += fread(gp->tree, sizeof(int), gp->len, fp);
     s += fread(gp->mu, sizeof(double), N_MU, fp);
+    gp->code = NULL;
+    tree_compile(gp, args);
     return s;
 }
 
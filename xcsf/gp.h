@@ -38,19 +38,36 @@ struct ArgsGPTree {
     double *constants; //!< Constants available for GP trees
 };
 
+/**
+ * @brief Compiled GP tree operation.
+ */
+struct GPOp {
+    int type; //!< Function, constant, or input operation
+    int index; //!< Index of the input to push
+    double value; //!< Value of the constant to push
+};
+
 /**
  * @brief GP tree data structure.
+ * @details The tree is stored in prefix order and compiled to a postfix
+ * sequence of operations whenever it changes. Evaluation executes the compiled
+ * operations with a small stack and does not modify the tree, allowing a tree
+ * to be evaluated by multiple threads concurrently.
  */
 struct GPTree {
     int *tree; //!< Flattened tree representation of functions and terminals
     int len; //!< Size of the tree
-    int pos; //!< Current position in the tree
+    struct GPOp *code; //!< Compiled postfix operations
+    int stack_size; //!< Maximum stack depth required to evaluate the tree
     double *mu; //!< Mutation rates
 };
 
 void
 tree_free(const struct GPTree *gp);
 
+size_t
+tree_bytes(const struct GPTree *gp);
+
 void
 tree_rand(struct GPTree *gp, const struct ArgsGPTree *args);
 
@@ -61,19 +78,28 @@ int
 tree_print(const struct GPTree *gp, const struct ArgsGPTree *args, int pos);
 
 double
-tree_eval(struct GPTree *gp, const struct ArgsGPTree *args, const double *x);
+tree_eval(const struct GPTree *gp, const double *x);
+
+void
+tree_eval_batch(const struct GPTree *gp, const struct ArgsGPTree *args,
+                const double *x, const int n, double *out);
 
 void
-tree_crossover(struct GPTree *p1, struct GPTree *p2);
+tree_crossover(struct GPTree *p1, struct GPTree *p2,
+               const struct ArgsGPTree *args);
 
 bool
 tree_mutate(struct GPTree *gp, const struct ArgsGPTree *args);
 
+bool
+tree_cover(struct GPTree *gp, const struct ArgsGPTree *args, const double *x);
+
 size_t
 tree_save(const struct GPTree *gp, FILE *fp);
 
 size_t
-tree_load(struct GPTree *gp, FILE *fp);
+tree_load(struct GPTree *gp, const struct ArgsGPTree *args, const int build,
+          FILE *fp);
 
 void
 tree_args_init(struct ArgsGPTree *args);
@@ -21,9 +21,11 @@
  * @brief Image handling functions.
  */
 
+#include "image.h"
+
 static void
-col2im_add_pixel(double *im, const int height, const int width, int row,
-                 int col, const int channel, const int pad, const double val)
+col2im_add_pixel(real *im, const int height, const int width, int row,
+                 int col, const int channel, const int pad, const real val)
 {
     row -= pad;
     col -= pad;
@@ -33,8 +35,8 @@ col2im_add_pixel(double *im, const int height, const int width, int row,
     im[col + width * (row + height * channel)] += val;
 }
 
-static double
-im2col_get_pixel(const double *im, const int height, const int width, int row,
+static real
+im2col_get_pixel(const real *im, const int height, const int width, int row,
                  int col, const int channel, const int pad)
 {
     row -= pad;
@@ -58,9 +60,9 @@ im2col_get_pixel(const double *im, const int height, const int width, int row,
  * @param [out] data_im The resulting image vector.
  */
 void
-col2im(const double *data_col, const int channels, const int height,
+col2im(const real *data_col, const int channels, const int height,
        const int width, const int ksize, const int stride, const int pad,
-       double *data_im)
+       real *data_im)
 {
     const int height_col = (height + 2 * pad - ksize) / stride + 1;
     const int width_col = (width + 2 * pad - ksize) / stride + 1;
@@ -74,7 +76,7 @@ col2im(const double *data_col, const int channels, const int height,
                 const int im_row = h_offset + h * stride;
                 const int im_col = w_offset + w * stride;
                 const int col_index = (c * height_col + h) * width_col + w;
-                const double val = data_col[col_index];
+                const real val = data_col[col_index];
                 col2im_add_pixel(data_im, height, width, im_row, im_col, c_im,
                                  pad, val);
             }
@@ -95,9 +97,9 @@ col2im(const double *data_col, const int channels, const int height,
  * @param [out] data_col The resulting column vector.
  */
 void
-im2col(const double *data_im, const int channels, const int height,
+im2col(const real *data_im, const int channels, const int height,
        const int width, const int ksize, const int stride, const int pad,
-       double *data_col)
+       real *data_col)
 {
     const int height_col = (height + 2 * pad - ksize) / stride + 1;
     const int width_col = (width + 2 * pad - ksize) / stride + 1;
@@ -26,6 +26,7 @@
 #include "env_csv.h"
 #include "pa.h"
 #include "param.h"
+#include "profile.h"
 #include "utils.h"
 #include "xcs_rl.h"
 #include "xcs_supervised.h"
@@ -35,7 +36,7 @@ int
 main(int argc, char **argv)
 {
     if (argc < 3 || argc > 5) {
-        printf("Usage: xcsf problemType{csv|mp|maze} ");
+        printf("Usage: xcsf problemType{csv|stream|mp|maze} ");
         printf("problem{.csv|size|maze} [config.ini] [xcs.bin]\n");
         exit(EXIT_FAILURE);
     }
@@ -56,12 +57,24 @@ main(int argc, char **argv)
     }
     pa_init(xcsf); // initialise prediction array
     param_print(xcsf); // print parameters used
+    if (profile_enabled() && !profile_hw_open()) {
+        printf("Hardware performance counters unavailable\n");
+    }
     if (strcmp(argv[1], "csv") == 0) { // supervised regression - csv file
         const struct EnvCSV *env = xcsf->env;
         xcs_supervised_fit(xcsf, env->train_data, env->test_data, true);
+    } else if (strcmp(argv[1], "stream") == 0) { // streamed binary dataset
+        const struct EnvCSV *env = xcsf->env;
+        xcs_supervised_fit_stream(xcsf, env->train_stream, env->test_data,
+                                  true);
     } else { // reinforcement learning - maze or mux
         xcs_rl_exp(xcsf);
     }
+    clset_print_bytes(xcsf, &xcsf->pset); // print memory usage
+    if (profile_enabled()) { // print instrumentation
+        profile_print();
+        profile_hw_close();
+    }
     pa_free(xcsf); // clean up
     env_free(xcsf);
     xcsf_free(xcsf);
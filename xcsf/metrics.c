@@ -0,0 +1,304 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file metrics.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Machine-readable performance and throughput logging.
+ * @details A record is appended to the log every PERF_TRIALS. Rates and
+ * phase times cover only the trials since the previous record. The log is
+ * fully buffered and flushed only when a fit completes or the log is closed,
+ * so writing it does not stall training. Phase times are recorded only when
+ * built with PROFILE.
+ */
+
+#include "metrics.h"
+
+#define METRICS_BUFFER_SIZE (65536) //!< Bytes buffered before writing
+
+/**
+ * @brief Writes the CSV header row.
+ * @param [in] fp Pointer to the file to be written.
+ * @param [in] profiled Whether phase times are recorded.
+ */
+static void
+metrics_csv_header(FILE *fp, const bool profiled)
+{
+    fprintf(fp, "trial,time,error,test_error,trials_per_sec,pset_size,"
+                "pset_num,mset_size,aset_size,mfrac,cover_rate,ea_events");
+    if (profiled) {
+        for (int i = 0; i < PROF_PHASES; ++i) {
+            fprintf(fp, ",%s_time", profile_phase_name(i));
+        }
+    }
+    fprintf(fp, "\n");
+}
+
+/**
+ * @brief Writes a record as a CSV row.
+ * @param [in] fp Pointer to the file to be written.
+ * @param [in] r The record to write.
+ */
+static void
+metrics_csv_write(FILE *fp, const struct MetricsRecord *r)
+{
+    fprintf(fp, "%d,%d,%.9g,%.9g,%.6g,%d,%d,%.6g,%.6g,%.6g,%.6g,%lu", r->trial,
+            r->time, r->error, r->terror, r->trials_per_sec, r->pset_size,
+            r->pset_num, r->mset_size, r->aset_size, r->mfrac, r->cover_rate,
+            r->ea_events);
+    if (r->profiled) {
+        for (int i = 0; i < PROF_PHASES; ++i) {
+            fprintf(fp, ",%.9g", r->phase[i]);
+        }
+    }
+    fprintf(fp, "\n");
+}
+
+/**
+ * @brief JSON lines logs have no header.
+ * @param [in] fp Pointer to the file to be written.
+ * @param [in] profiled Whether phase times are recorded.
+ */
+static void
+metrics_jsonl_header(FILE *fp, const bool profiled)
+{
+    (void) fp;
+    (void) profiled;
+}
+
+/**
+ * @brief Writes a record as a JSON object on a single line.
+ * @param [in] fp Pointer to the file to be written.
+ * @param [in] r The record to write.
+ */
+static void
+metrics_jsonl_write(FILE *fp, const struct MetricsRecord *r)
+{
+    fprintf(fp,
+            "{\"trial\":%d,\"time\":%d,\"error\":%.9g,\"test_error\":%.9g,"
+            "\"trials_per_sec\":%.6g,\"pset_size\":%d,\"pset_num\":%d,"
+            "\"mset_size\":%.6g,\"aset_size\":%.6g,\"mfrac\":%.6g,"
+            "\"cover_rate\":%.6g,\"ea_events\":%lu",
+            r->trial, r->time, r->error, r->terror, r->trials_per_sec,
+            r->pset_size, r->pset_num, r->mset_size, r->aset_size, r->mfrac,
+            r->cover_rate, r->ea_events);
+    if (r->profiled) {
+        fprintf(fp, ",\"phase_time\":{");
+        for (int i = 0; i < PROF_PHASES; ++i) {
+            fprintf(fp, "%s\"%s\":%.9g", i > 0 ? "," : "",
+                    profile_phase_name(i), r->phase[i]);
+        }
+        fprintf(fp, "}");
+    }
+    fprintf(fp, "}\n");
+}
+
+/**
+ * @brief CSV log implemented functions.
+ */
+static struct MetricsVtbl const metrics_csv_vtbl = { &metrics_csv_header,
+                                                     &metrics_csv_write };
+
+/**
+ * @brief JSON lines log implemented functions.
+ */
+static struct MetricsVtbl const metrics_jsonl_vtbl = { &metrics_jsonl_header,
+                                                       &metrics_jsonl_write };
+
+/**
+ * @brief Records the counters at the start of a reporting interval.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] m The performance log.
+ * @param [in] trial The number of learning trials executed.
+ */
+static void
+metrics_mark(const struct XCSF *xcsf, struct Metrics *m, const int trial)
+{
+    m->trial = trial;
+    m->ns = profile_now();
+    m->n_covered = xcsf->n_covered;
+    m->n_ea = xcsf->n_ea;
+    for (int i = 0; i < PROF_PHASES; ++i) {
+        m->phase[i] = profile_time(i);
+    }
+}
+
+/**
+ * @brief Opens the performance log named by the current parameters.
+ * @details Failures are reported without stopping training.
+ * @param [in] xcsf The XCSF data structure.
+ * @return The opened log, or NULL if the file could not be opened.
+ */
+static struct Metrics *
+metrics_open(const struct XCSF *xcsf)
+{
+    FILE *fp = fopen(xcsf->METRICS_FILE, "w");
+    if (fp == 0) {
+        printf("Warning: metrics %s not written. %s.\n", xcsf->METRICS_FILE,
+               strerror(errno));
+        return NULL;
+    }
+    struct Metrics *m = malloc(sizeof(struct Metrics));
+    m->fp = fp;
+    m->buffer = malloc(METRICS_BUFFER_SIZE);
+    setvbuf(fp, m->buffer, _IOFBF, METRICS_BUFFER_SIZE);
+    const size_t len = strlen(xcsf->METRICS_FILE);
+    m->filename = malloc(len + 1);
+    memcpy(m->filename, xcsf->METRICS_FILE, len + 1);
+    m->format = xcsf->METRICS_FORMAT;
+    m->metrics_vptr = (m->format == METRICS_CSV) ? &metrics_csv_vtbl
+                                                 : &metrics_jsonl_vtbl;
+    (*m->metrics_vptr->metrics_impl_header)(fp, profile_enabled());
+    return m;
+}
+
+/**
+ * @brief Prepares the performance log at the start of a fit.
+ * @details The log is opened on first use and reopened, truncating the file,
+ * whenever its name or format has changed. Successive fits otherwise append
+ * to the same log.
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+metrics_start(struct XCSF *xcsf)
+{
+    const struct Metrics *m = xcsf->metrics;
+    if (m != NULL &&
+        (m->format != xcsf->METRICS_FORMAT ||
+         strcmp(m->filename, xcsf->METRICS_FILE) != 0)) {
+        metrics_free(xcsf);
+    }
+    if (xcsf->METRICS_FORMAT == METRICS_NONE) {
+        return;
+    }
+    if (xcsf->metrics == NULL) {
+        xcsf->metrics = metrics_open(xcsf);
+    }
+    if (xcsf->metrics != NULL) {
+        metrics_mark(xcsf, xcsf->metrics, 0);
+    }
+}
+
+/**
+ * @brief Appends a record of the performance since the last report.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] trial The number of learning trials executed.
+ * @param [in] error The current training error.
+ * @param [in] terror The current testing error.
+ */
+void
+metrics_report(const struct XCSF *xcsf, const int trial, const double error,
+               const double terror)
+{
+    struct Metrics *m = xcsf->metrics;
+    if (m == NULL) {
+        return;
+    }
+    const double secs = (profile_now() - m->ns) * 1e-9;
+    const int trials = trial - m->trial;
+    struct MetricsRecord r;
+    r.trial = trial;
+    r.time = xcsf->time;
+    r.error = error;
+    r.terror = terror;
+    r.trials_per_sec = (secs > 0) ? trials / secs : 0;
+    r.pset_size = xcsf->pset.size;
+    r.pset_num = xcsf->pset.num;
+    r.mset_size = xcsf->mset_size;
+    r.aset_size = xcsf->aset_size;
+    r.mfrac = xcsf->mfrac;
+    r.cover_rate =
+        (trials > 0) ? (double) (xcsf->n_covered - m->n_covered) / trials : 0;
+    r.ea_events = xcsf->n_ea - m->n_ea;
+    r.profiled = profile_enabled();
+    for (int i = 0; i < PROF_PHASES; ++i) {
+        r.phase[i] = profile_time(i) - m->phase[i];
+    }
+    (*m->metrics_vptr->metrics_impl_write)(m->fp, &r);
+    metrics_mark(xcsf, m, trial);
+}
+
+/**
+ * @brief Writes any buffered records to the performance log.
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+metrics_flush(const struct XCSF *xcsf)
+{
+    if (xcsf->metrics != NULL) {
+        fflush(xcsf->metrics->fp);
+    }
+}
+
+/**
+ * @brief Closes the performance log.
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+metrics_free(struct XCSF *xcsf)
+{
+    struct Metrics *m = xcsf->metrics;
+    if (m != NULL) {
+        fclose(m->fp);
+        free(m->buffer);
+        free(m->filename);
+        free(m);
+        xcsf->metrics = NULL;
+    }
+}
+
+/**
+ * @brief Returns a string representation of a log format.
+ * @param [in] format Integer representation of a log format.
+ * @return String representing the name of the log format.
+ */
+const char *
+metrics_format_as_string(const int format)
+{
+    switch (format) {
+        case METRICS_NONE:
+            return METRICS_STRING_NONE;
+        case METRICS_CSV:
+            return METRICS_STRING_CSV;
+        case METRICS_JSONL:
+            return METRICS_STRING_JSONL;
+        default:
+            printf("metrics_format_as_string(): invalid format: %d\n", format);
+            exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Returns the integer representation of a log format given a name.
+ * @param [in] format String representation of a log format.
+ * @return Integer representing the log format.
+ */
+int
+metrics_format_as_int(const char *format)
+{
+    if (strncmp(format, METRICS_STRING_NONE, 5) == 0) {
+        return METRICS_NONE;
+    }
+    if (strncmp(format, METRICS_STRING_CSV, 4) == 0) {
+        return METRICS_CSV;
+    }
+    if (strncmp(format, METRICS_STRING_JSONL, 6) == 0) {
+        return METRICS_JSONL;
+    }
+    printf("metrics_format_as_int(): invalid format: %s\n", format);
+    exit(EXIT_FAILURE);
+}
@@ -0,0 +1,100 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file metrics.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Machine-readable performance and throughput logging.
+ */
+
+#pragma once
+
+#include "profile.h"
+#include "xcsf.h"
+
+#define METRICS_NONE (0) //!< No performance log is written
+#define METRICS_CSV (1) //!< Comma-separated values with a header row
+#define METRICS_JSONL (2) //!< One JSON object per line
+#define METRICS_NUM (3) //!< Total number of selectable log formats
+
+#define METRICS_STRING_NONE ("none\0") //!< No performance log is written
+#define METRICS_STRING_CSV ("csv\0") //!< Comma-separated values
+#define METRICS_STRING_JSONL ("jsonl\0") //!< One JSON object per line
+
+/**
+ * @brief Performance measured over one reporting interval.
+ */
+struct MetricsRecord {
+    int trial; //!< Number of learning trials executed
+    int time; //!< Current number of EA executions
+    double error; //!< Training error averaged over the interval
+    double terror; //!< Testing error averaged over the interval
+    double trials_per_sec; //!< Learning trials executed per second
+    int pset_size; //!< Number of macro-classifiers in the population
+    int pset_num; //!< Total numerosity of the population
+    double mset_size; //!< Average match set size
+    double aset_size; //!< Average action set size
+    double mfrac; //!< Generalisation measure
+    double cover_rate; //!< Classifiers created by covering per trial
+    unsigned long ea_events; //!< Number of times the EA ran
+    bool profiled; //!< Whether phase times were recorded
+    double phase[PROF_PHASES]; //!< Seconds spent in each phase
+};
+
+/**
+ * @brief Performance log writer interface data structure.
+ * @details Log formats must implement these functions.
+ */
+struct MetricsVtbl {
+    void (*metrics_impl_header)(FILE *fp, const bool profiled);
+    void (*metrics_impl_write)(FILE *fp, const struct MetricsRecord *r);
+};
+
+/**
+ * @brief An open performance log and the counters at the last report.
+ */
+struct Metrics {
+    struct MetricsVtbl const *metrics_vptr; //!< Functions writing the log
+    FILE *fp; //!< File being written
+    char *buffer; //!< Output buffer
+    char *filename; //!< Name of the file being written
+    int format; //!< Log format
+    int trial; //!< Number of trials executed at the last report
+    uint64_t ns; //!< Time of the last report
+    unsigned long n_covered; //!< Covering events at the last report
+    unsigned long n_ea; //!< EA executions at the last report
+    double phase[PROF_PHASES]; //!< Phase times at the last report
+};
+
+void
+metrics_start(struct XCSF *xcsf);
+
+void
+metrics_report(const struct XCSF *xcsf, const int trial, const double error,
+               const double terror);
+
+void
+metrics_flush(const struct XCSF *xcsf);
+
+void
+metrics_free(struct XCSF *xcsf);
+
+const char *
+metrics_format_as_string(const int format);
+
+int
+metrics_format_as_int(const char *format);
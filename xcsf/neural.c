@@ -22,11 +22,32 @@
  */
 
 #include "neural.h"
+#include "neural_activations.h"
 #include "neural_layer_connected.h"
 #include "neural_layer_dropout.h"
 #include "neural_layer_noise.h"
 #include "neural_layer_recurrent.h"
 #include "neural_layer_softmax.h"
+#include "profile.h"
+
+static unsigned long neural_stamp = 0; //!< Most recently assigned stamp
+
+/**
+ * @brief Assigns a new unique stamp to a neural network.
+ * @details Called whenever the layers or parameters of a network may have
+ * changed so that packed copies of the network can detect they are stale.
+ * @param [in] net The neural network that has been modified.
+ */
+static void
+neural_touch(struct Net *net)
+{
+    unsigned long stamp = 0;
+#ifdef PARALLEL
+    #pragma omp atomic capture
+#endif
+    stamp = ++neural_stamp;
+    net->stamp = stamp;
+}
 
 /**
  * @brief Initialises an empty neural network.
@@ -42,6 +63,9 @@ neural_init(struct Net *net)
     net->n_outputs = 0;
     net->output = NULL;
     net->train = false;
+    net->batch_slot = -1;
+    net->n_accumulated = 0;
+    neural_touch(net);
 }
 
 /**
@@ -128,6 +152,7 @@ neural_insert(struct Net *net, struct Layer *l, const int pos)
         }
     }
     ++(net->n_layers);
+    neural_touch(net);
 }
 
 /**
@@ -175,6 +200,7 @@ neural_remove(struct Net *net, const int pos)
     layer_free(iter->layer);
     free(iter->layer);
     free(iter);
+    neural_touch(net);
 }
 
 /**
@@ -238,13 +264,14 @@ neural_free(struct Net *net)
  * @param [in] net The neural network to randomise.
  */
 void
-neural_rand(const struct Net *net)
+neural_rand(struct Net *net)
 {
     const struct Llist *iter = net->tail;
     while (iter != NULL) {
         layer_rand(iter->layer);
         iter = iter->prev;
     }
+    neural_touch(net);
 }
 
 /**
@@ -253,7 +280,7 @@ neural_rand(const struct Net *net)
  * @return Whether any alterations were made.
  */
 bool
-neural_mutate(const struct Net *net)
+neural_mutate(struct Net *net)
 {
     bool mod = false;
     bool do_resize = false;
@@ -278,6 +305,7 @@ neural_mutate(const struct Net *net)
         prev = iter->layer;
         iter = iter->prev;
     }
+    neural_touch(net);
     return mod;
 }
 
@@ -286,7 +314,7 @@ neural_mutate(const struct Net *net)
  * @param [in] net The neural network to resize.
  */
 void
-neural_resize(const struct Net *net)
+neural_resize(struct Net *net)
 {
     const struct Layer *prev = NULL;
     const struct Llist *iter = net->tail;
@@ -297,6 +325,7 @@ neural_resize(const struct Net *net)
         prev = iter->layer;
         iter = iter->prev;
     }
+    neural_touch(net);
 }
 
 /**
@@ -308,53 +337,128 @@ neural_resize(const struct Net *net)
 void
 neural_propagate(struct Net *net, const double *input, const bool train)
 {
+    PROFILE_START(PROF_NEURAL_FORWARD);
     net->train = train;
+#ifdef SINGLE_PRECISION
+    real x[net->n_inputs];
+    for (int i = 0; i < net->n_inputs; ++i) {
+        x[i] = (real) input[i];
+    }
+    const real *in = x;
+#else
+    const real *in = input;
+#endif
     const struct Llist *iter = net->tail;
     while (iter != NULL) {
-        layer_forward(iter->layer, net, input);
-        input = layer_output(iter->layer);
+        layer_forward(iter->layer, net, in);
+        in = layer_output(iter->layer);
         iter = iter->prev;
     }
+    PROFILE_STOP(PROF_NEURAL_FORWARD);
 }
 
 /**
- * @brief Performs a gradient descent update on a neural network.
- * @param [in] net The neural network to be updated.
+ * @brief Computes and accumulates the gradients of a neural network.
+ * @param [in] net The neural network.
  * @param [in] truth The desired network output.
  * @param [in] input The input state.
+ * @param [in] scale Scaling factor applied to the output error.
  */
-void
-neural_learn(const struct Net *net, const double *truth, const double *input)
+static void
+neural_backward(const struct Net *net, const double *truth,
+                const double *input, const double scale)
 {
+#ifdef SINGLE_PRECISION
+    real x[net->n_inputs];
+    for (int i = 0; i < net->n_inputs; ++i) {
+        x[i] = (real) input[i];
+    }
+    const real *in = x;
+#else
+    const real *in = input;
+#endif
     // reset deltas
     const struct Llist *iter = net->tail;
     while (iter != NULL) {
-        memset(iter->layer->delta, 0, sizeof(double) * iter->layer->n_outputs);
+        memset(iter->layer->delta, 0, sizeof(real) * iter->layer->n_outputs);
         iter = iter->prev;
     }
     // calculate output layer delta
     const struct Layer *p = net->head->layer;
     for (int i = 0; i < p->n_outputs; ++i) {
-        p->delta[i] = truth[i] - p->output[i];
+        p->delta[i] = (truth[i] - p->output[i]) * scale;
     }
     // backward phase
     iter = net->head;
     while (iter != NULL) {
         const struct Layer *l = iter->layer;
         if (iter->next == NULL) {
-            layer_backward(l, net, input, 0);
+            layer_backward(l, net, in, 0);
         } else {
             const struct Layer *prev = iter->next->layer;
             layer_backward(l, net, prev->output, prev->delta);
         }
         iter = iter->next;
     }
-    // update phase
-    iter = net->tail;
+}
+
+/**
+ * @brief Applies the accumulated gradients to a neural network.
+ * @param [in] net The neural network to be updated.
+ */
+static void
+neural_update(struct Net *net)
+{
+    const struct Llist *iter = net->tail;
     while (iter != NULL) {
         layer_update(iter->layer);
         iter = iter->prev;
     }
+    neural_touch(net);
+}
+
+/**
+ * @brief Performs a gradient descent update on a neural network.
+ * @param [in] net The neural network to be updated.
+ * @param [in] truth The desired network output.
+ * @param [in] input The input state.
+ */
+void
+neural_learn(struct Net *net, const double *truth, const double *input)
+{
+    PROFILE_START(PROF_NEURAL_BACKWARD);
+    neural_backward(net, truth, input, 1);
+    neural_update(net);
+    PROFILE_STOP(PROF_NEURAL_BACKWARD);
+}
+
+/**
+ * @brief Performs mini-batch gradient descent on a neural network.
+ * @details The gradients of each sample are accumulated and averaged, and the
+ * weights are updated once every batch_size samples; momentum and weight
+ * decay are likewise applied once per mini-batch.
+ * @pre The network has been forward propagated with the input.
+ * @param [in] net The neural network to be updated.
+ * @param [in] truth The desired network output.
+ * @param [in] input The input state.
+ * @param [in] batch_size The number of samples per update.
+ */
+void
+neural_learn_batch(struct Net *net, const double *truth, const double *input,
+                   const int batch_size)
+{
+    if (batch_size < 2) {
+        neural_learn(net, truth, input);
+        return;
+    }
+    PROFILE_START(PROF_NEURAL_BACKWARD);
+    neural_backward(net, truth, input, 1. / batch_size);
+    ++(net->n_accumulated);
+    if (net->n_accumulated >= batch_size) {
+        net->n_accumulated = 0;
+        neural_update(net);
+    }
+    PROFILE_STOP(PROF_NEURAL_BACKWARD);
 }
 
 /**
@@ -374,12 +478,67 @@ neural_output(const struct Net *net, const int IDX)
     return layer_output(net->head->layer)[IDX];
 }
 
+/**
+ * @brief Shifts the bias of an output neuron so that its output lies on a
+ * specified side of 0.5 for an input.
+ * @details Only the selected neuron is altered. The shift is computed from
+ * the neuron's unclamped weighted input, and the network is then propagated
+ * again to verify the output. If rounding defeats the shift, the weights of
+ * the neuron are cleared so that its output is set by the bias alone.
+ * @pre The output layer is fully-connected.
+ * @param [in] net The neural network to alter.
+ * @param [in] x The input to cover.
+ * @param [in] IDX Which neuron in the output layer to alter.
+ * @param [in] high Whether the output should be above 0.5, otherwise below.
+ * @return Whether the output was successfully set.
+ */
+bool
+neural_cover_output(struct Net *net, const double *x, const int IDX,
+                    const bool high)
+{
+    static const real candidates[] = { 1, -1, 2, -2, 4, -4, 8, -8, 0 };
+    const int n_candidates = sizeof(candidates) / sizeof(candidates[0]);
+    struct Layer *l = net->head->layer;
+    if (l->type != CONNECTED || IDX < 0 || IDX >= l->n_outputs) {
+        return false;
+    }
+    neural_propagate(net, x, false);
+    real *w = &l->weights[IDX * l->n_inputs];
+    real sum = l->biases[IDX];
+    if (net->head->next != NULL) {
+        const real *in = layer_output(net->head->next->layer);
+        for (int i = 0; i < l->n_inputs; ++i) {
+            sum += w[i] * in[i];
+        }
+    } else {
+        for (int i = 0; i < l->n_inputs; ++i) {
+            sum += w[i] * (real) x[i];
+        }
+    }
+    for (int i = 0; i < n_candidates; ++i) {
+        if ((neural_activate(l->function, candidates[i]) > 0.5) == high) {
+            l->biases[IDX] += candidates[i] - sum;
+            neural_touch(net);
+            neural_propagate(net, x, false);
+            if ((neural_output(net, IDX) > 0.5) == high) {
+                return true;
+            }
+            memset(w, 0, sizeof(real) * l->n_inputs);
+            l->biases[IDX] = candidates[i];
+            neural_touch(net);
+            neural_propagate(net, x, false);
+            return (neural_output(net, IDX) > 0.5) == high;
+        }
+    }
+    return false;
+}
+
 /**
  * @brief Returns the outputs from the output layer of a neural network.
  * @param [in] net The neural network to output.
  * @return The neural network outputs.
  */
-double *
+real *
 neural_outputs(const struct Net *net)
 {
     return layer_output(net->head->layer);
@@ -430,6 +589,25 @@ neural_size(const struct Net *net)
     return size;
 }
 
+/**
+ * @brief Returns the number of bytes of heap memory used by a neural network.
+ * @details The network structure itself is not included since it is embedded
+ * within the representation that owns it.
+ * @param [in] net A neural network.
+ * @return The number of bytes allocated for the layers and list elements.
+ */
+size_t
+neural_bytes(const struct Net *net)
+{
+    size_t bytes = 0;
+    const struct Llist *iter = net->tail;
+    while (iter != NULL) {
+        bytes += sizeof(struct Llist) + layer_bytes(iter->layer);
+        iter = iter->prev;
+    }
+    return bytes;
+}
+
 /**
  * @brief Writes a neural network to a file.
  * @param [in] net The neural network to save.
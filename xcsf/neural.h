@@ -29,6 +29,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "precision.h"
+
 struct ArgsLayer; //!< Forward declaration of layer parameter structure
 struct Layer; //!< Forward declaration of layer structure.
 
@@ -48,24 +50,34 @@ struct Net {
     int n_layers; //!< Number of layers (hidden + output)
     int n_inputs; //!< Number of network inputs
     int n_outputs; //!< Number of network outputs
-    double *output; //!< Pointer to the network output
+    real *output; //!< Pointer to the network output
     struct Llist *head; //!< Pointer to the head layer (output layer)
     struct Llist *tail; //!< Pointer to the tail layer (first layer)
     bool train; //!< Whether the network is in training mode
+    unsigned long stamp; //!< Unique identifier of the current parameters
+    int batch_slot; //!< Slot of the packed input layer within a batch
+    int n_accumulated; //!< Number of samples with gradients pending update
 };
 
 bool
-neural_mutate(const struct Net *net);
+neural_mutate(struct Net *net);
 
 double
 neural_output(const struct Net *net, const int IDX);
 
-double *
+bool
+neural_cover_output(struct Net *net, const double *x, const int IDX,
+                    const bool high);
+
+real *
 neural_outputs(const struct Net *net);
 
 double
 neural_size(const struct Net *net);
 
+size_t
+neural_bytes(const struct Net *net);
+
 size_t
 neural_load(struct Net *net, FILE *fp);
 
@@ -97,7 +109,11 @@ void
 neural_pop(struct Net *net);
 
 void
-neural_learn(const struct Net *net, const double *output, const double *input);
+neural_learn_batch(struct Net *net, const double *truth, const double *input,
+                   const int batch_size);
+
+void
+neural_learn(struct Net *net, const double *output, const double *input);
 
 void
 neural_print(const struct Net *net, const bool print_weights);
@@ -106,7 +122,7 @@ void
 neural_propagate(struct Net *net, const double *input, const bool train);
 
 void
-neural_rand(const struct Net *net);
+neural_rand(struct Net *net);
 
 void
-neural_resize(const struct Net *net);
+neural_resize(struct Net *net);
@@ -31,8 +31,8 @@
  * @param [in] x The input to the activation function.
  * @return The result from applying the activation function.
  */
-double
-neural_activate(const int a, const double x)
+real
+neural_activate(const int a, const real x)
 {
     switch (a) {
         case LOGISTIC:
@@ -69,8 +69,8 @@ neural_activate(const int a, const double x)
  * @param [in] x The input to the activation function.
  * @return The derivative from applying the activation function.
  */
-double
-neural_gradient(const int a, const double x)
+real
+neural_gradient(const int a, const real x)
 {
     switch (a) {
         case LOGISTIC:
@@ -196,7 +196,7 @@ neural_activation_as_int(const char *a)
  * @param [in] a The activation function.
  */
 void
-neural_activate_array(double *state, double *output, const int n, const int a)
+neural_activate_array(real *state, real *output, const int n, const int a)
 {
     for (int i = 0; i < n; ++i) {
         state[i] = clamp(state[i], NEURON_MIN, NEURON_MAX);
@@ -212,7 +212,7 @@ neural_activate_array(double *state, double *output, const int n, const int a)
  * @param [in] a The activation function.
  */
 void
-neural_gradient_array(const double *state, double *delta, const int n,
+neural_gradient_array(const real *state, real *delta, const int n,
                       const int a)
 {
     for (int i = 0; i < n; ++i) {
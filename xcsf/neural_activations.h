@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "precision.h"
 #include <math.h>
 
 #define LOGISTIC (0) //!< Logistic [0,1]
@@ -52,11 +53,11 @@
 #define STRING_LOGGY ("loggy\0") //!< Loggy
 #define STRING_SOFT_MAX ("softmax\0") //!< Softmax
 
-double
-neural_activate(const int a, const double x);
+real
+neural_activate(const int a, const real x);
 
-double
-neural_gradient(const int a, const double x);
+real
+neural_gradient(const int a, const real x);
 
 const char *
 neural_activation_string(const int a);
@@ -65,144 +66,144 @@ int
 neural_activation_as_int(const char *a);
 
 void
-neural_activate_array(double *state, double *output, const int n, const int a);
+neural_activate_array(real *state, real *output, const int n, const int a);
 
 void
-neural_gradient_array(const double *state, double *delta, const int n,
+neural_gradient_array(const real *state, real *delta, const int n,
                       const int a);
 
-static inline double
-logistic_activate(const double x)
+static inline real
+logistic_activate(const real x)
 {
     return 1. / (1. + exp(-x));
 }
 
-static inline double
-logistic_gradient(const double x)
+static inline real
+logistic_gradient(const real x)
 {
-    double fx = 1. / (1. + exp(-x));
+    real fx = 1. / (1. + exp(-x));
     return (1 - fx) * fx;
 }
 
-static inline double
-loggy_activate(const double x)
+static inline real
+loggy_activate(const real x)
 {
     return 2. / (1. + exp(-x)) - 1;
 }
 
-static inline double
-loggy_gradient(const double x)
+static inline real
+loggy_gradient(const real x)
 {
-    double fx = exp(x);
+    real fx = exp(x);
     return (2 * fx) / ((fx + 1) * (fx + 1));
 }
 
-static inline double
-gaussian_activate(const double x)
+static inline real
+gaussian_activate(const real x)
 {
     return exp(-x * x);
 }
 
-static inline double
-gaussian_gradient(const double x)
+static inline real
+gaussian_gradient(const real x)
 {
     return -2 * x * exp(-x * x);
 }
 
-static inline double
-relu_activate(const double x)
+static inline real
+relu_activate(const real x)
 {
     return x * (x > 0);
 }
 
-static inline double
-relu_gradient(const double x)
+static inline real
+relu_gradient(const real x)
 {
     return (x > 0);
 }
 
-static inline double
-selu_activate(const double x)
+static inline real
+selu_activate(const real x)
 {
     return (x >= 0) * 1.0507 * x + (x < 0) * 1.0507 * 1.6732 * expm1(x);
 }
 
-static inline double
-selu_gradient(const double x)
+static inline real
+selu_gradient(const real x)
 {
     return (x >= 0) * 1.0507 + (x < 0) * (1.0507 * 1.6732 * exp(x));
 }
 
-static inline double
-linear_activate(const double x)
+static inline real
+linear_activate(const real x)
 {
     return x;
 }
 
-static inline double
-linear_gradient(const double x)
+static inline real
+linear_gradient(const real x)
 {
     (void) x;
     return 1;
 }
 
-static inline double
-soft_plus_activate(const double x)
+static inline real
+soft_plus_activate(const real x)
 {
     return log1p(exp(x));
 }
 
-static inline double
-soft_plus_gradient(const double x)
+static inline real
+soft_plus_gradient(const real x)
 {
     return 1. / (1. + exp(-x));
 }
 
-static inline double
-tanh_activate(const double x)
+static inline real
+tanh_activate(const real x)
 {
     return tanh(x);
 }
 
-static inline double
-tanh_gradient(const double x)
+static inline real
+tanh_gradient(const real x)
 {
-    double t = tanh(x);
+    real t = tanh(x);
     return 1 - t * t;
 }
 
-static inline double
-leaky_activate(const double x)
+static inline real
+leaky_activate(const real x)
 {
     return (x > 0) ? x : .1 * x;
 }
 
-static inline double
-leaky_gradient(const double x)
+static inline real
+leaky_gradient(const real x)
 {
     return (x < 0) ? .1 : 1;
 }
 
-static inline double
-sin_activate(const double x)
+static inline real
+sin_activate(const real x)
 {
     return sin(x);
 }
 
-static inline double
-sin_gradient(const double x)
+static inline real
+sin_gradient(const real x)
 {
     return cos(x);
 }
 
-static inline double
-cos_activate(const double x)
+static inline real
+cos_activate(const real x)
 {
     return cos(x);
 }
 
-static inline double
-cos_gradient(const double x)
+static inline real
+cos_gradient(const real x)
 {
     return -sin(x);
 }
@@ -0,0 +1,298 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file neural_batch.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Batched forward propagation of neural networks sharing an input.
+ * @details Within a set every network receives the same input state, so the
+ * input layers of all networks with a connected input layer are evaluated as
+ * one stacked matrix-vector product regardless of their number of neurons.
+ * Only the input layer is batched: deeper layers of different networks have
+ * both different inputs and different weights, so they form no common matrix
+ * product and are propagated per network.
+ * Networks are packed when first seen and repacked only after their stamp
+ * changes, i.e., after mutation or gradient descent. Stale rows are reclaimed
+ * by resetting the batch when its capacity is exhausted.
+ */
+
+#include "neural_batch.h"
+#include "blas.h"
+#include "neural_activations.h"
+#include "neural_layer.h"
+#include "profile.h"
+
+#define BATCH_ROWS_MIN (1024) //!< Minimum number of rows allocated
+#define BATCH_SLOTS_MIN (64) //!< Minimum number of slots allocated
+
+/**
+ * @brief Creates an empty batch.
+ * @return A pointer to the new batch.
+ */
+struct NeuralBatch *
+neural_batch_init(void)
+{
+    struct NeuralBatch *batch = malloc(sizeof(struct NeuralBatch));
+    batch->n_inputs = 0;
+    batch->n_rows = 0;
+    batch->max_rows = 0;
+    batch->n_slots = 0;
+    batch->max_slots = 0;
+    batch->stamps = NULL;
+    batch->offsets = NULL;
+    batch->weights = NULL;
+    batch->biases = NULL;
+    batch->state = NULL;
+    return batch;
+}
+
+/**
+ * @brief Frees a batch.
+ * @param [in] batch The batch to be freed.
+ */
+void
+neural_batch_free(struct NeuralBatch *batch)
+{
+    if (batch != NULL) {
+        free(batch->stamps);
+        free(batch->offsets);
+        free(batch->weights);
+        free(batch->biases);
+        free(batch->state);
+        free(batch);
+    }
+}
+
+/**
+ * @brief Returns the number of bytes of heap memory used by a batch.
+ * @param [in] batch The batch, which may be NULL.
+ * @return The number of bytes allocated for the batch and its packed layers.
+ */
+size_t
+neural_batch_bytes(const struct NeuralBatch *batch)
+{
+    if (batch == NULL) {
+        return 0;
+    }
+    return sizeof(struct NeuralBatch) +
+        sizeof(real) * ((size_t) batch->max_rows * batch->n_inputs +
+                        2 * (size_t) batch->max_rows) +
+        (sizeof(unsigned long) + sizeof(int)) * batch->max_slots;
+}
+
+/**
+ * @brief Returns whether the input layer of a network can be batched.
+ * @param [in] net The neural network.
+ * @param [in] n_inputs The number of inputs to each batched layer.
+ * @return Whether the network has a connected input layer with the number of
+ * inputs of the batch.
+ */
+static inline bool
+neural_batch_eligible(const struct Net *net, const int n_inputs)
+{
+    return net->tail != NULL && net->tail->layer->type == CONNECTED &&
+        net->tail->layer->n_inputs == n_inputs;
+}
+
+/**
+ * @brief Returns whether the current parameters of a network are packed.
+ * @param [in] batch The batch.
+ * @param [in] net The neural network.
+ * @return Whether the network is packed and unmodified since packing.
+ */
+static inline bool
+neural_batch_packed(const struct NeuralBatch *batch, const struct Net *net)
+{
+    return net->batch_slot >= 0 && net->batch_slot < batch->n_slots &&
+        batch->stamps[net->batch_slot] == net->stamp;
+}
+
+/**
+ * @brief Discards all packed networks and ensures sufficient capacity.
+ * @param [in] batch The batch to reset.
+ * @param [in] n_inputs The number of inputs to each packed layer.
+ * @param [in] rows The number of rows required.
+ * @param [in] slots The number of slots required.
+ */
+static void
+neural_batch_reset(struct NeuralBatch *batch, const int n_inputs,
+                   const int rows, const int slots)
+{
+    batch->n_rows = 0;
+    batch->n_slots = 0;
+    if (n_inputs != batch->n_inputs || 2 * rows > batch->max_rows) {
+        batch->n_inputs = n_inputs;
+        batch->max_rows =
+            (2 * rows > BATCH_ROWS_MIN) ? 2 * rows : BATCH_ROWS_MIN;
+        const size_t n_weights = (size_t) batch->max_rows * n_inputs;
+        free(batch->weights);
+        free(batch->biases);
+        free(batch->state);
+        batch->weights = malloc(sizeof(real) * n_weights);
+        batch->biases = malloc(sizeof(real) * batch->max_rows);
+        batch->state = malloc(sizeof(real) * batch->max_rows);
+    }
+    if (2 * slots > batch->max_slots) {
+        batch->max_slots =
+            (2 * slots > BATCH_SLOTS_MIN) ? 2 * slots : BATCH_SLOTS_MIN;
+        free(batch->stamps);
+        free(batch->offsets);
+        batch->stamps = malloc(sizeof(unsigned long) * batch->max_slots);
+        batch->offsets = malloc(sizeof(int) * batch->max_slots);
+    }
+}
+
+/**
+ * @brief Copies the input layer of a network into the next free slot.
+ * @param [in] batch The batch.
+ * @param [in] net The neural network to pack.
+ */
+static void
+neural_batch_pack(struct NeuralBatch *batch, struct Net *net)
+{
+    const struct Layer *l = net->tail->layer;
+    const int slot = batch->n_slots;
+    const int offset = batch->n_rows;
+    memcpy(batch->weights + (size_t) offset * batch->n_inputs, l->weights,
+           sizeof(real) * l->n_outputs * batch->n_inputs);
+    memcpy(batch->biases + offset, l->biases, sizeof(real) * l->n_outputs);
+    batch->stamps[slot] = net->stamp;
+    batch->offsets[slot] = offset;
+    batch->n_rows += l->n_outputs;
+    ++(batch->n_slots);
+    net->batch_slot = slot;
+}
+
+/**
+ * @brief Computes the input layer states of a set of networks.
+ * @details Networks sharing contiguous packed rows are computed together with
+ * a single matrix multiplication. Networks without a connected input layer,
+ * or whose input layer has a different number of inputs from the first such
+ * layer, are skipped and propagated as normal by neural_batch_propagate().
+ * @param [in] batch The batch.
+ * @param [in] nets The neural networks receiving the input.
+ * @param [in] n The number of neural networks.
+ * @param [in] input The input state.
+ */
+void
+neural_batch_forward(struct NeuralBatch *batch, struct Net **nets,
+                     const int n, const double *input)
+{
+    int n_inputs = 0;
+    for (int i = 0; i < n && n_inputs < 1; ++i) {
+        if (nets[i]->tail != NULL && nets[i]->tail->layer->type == CONNECTED) {
+            n_inputs = nets[i]->tail->layer->n_inputs;
+        }
+    }
+    int rows = 0;
+    int slots = 0;
+    int stale_rows = 0;
+    int stale_slots = 0;
+    for (int i = 0; i < n; ++i) {
+        if (!neural_batch_eligible(nets[i], n_inputs)) {
+            continue;
+        }
+        const struct Layer *l = nets[i]->tail->layer;
+        rows += l->n_outputs;
+        ++slots;
+        if (!neural_batch_packed(batch, nets[i])) {
+            stale_rows += l->n_outputs;
+            ++stale_slots;
+        }
+    }
+    if (slots < 1) {
+        return;
+    }
+    PROFILE_START(PROF_NEURAL_FORWARD);
+    if (n_inputs != batch->n_inputs ||
+        batch->n_rows + stale_rows > batch->max_rows ||
+        batch->n_slots + stale_slots > batch->max_slots) {
+        neural_batch_reset(batch, n_inputs, rows, slots);
+    }
+    for (int i = 0; i < n; ++i) {
+        if (neural_batch_eligible(nets[i], n_inputs) &&
+            !neural_batch_packed(batch, nets[i])) {
+            neural_batch_pack(batch, nets[i]);
+        }
+    }
+#ifdef SINGLE_PRECISION
+    real x[n_inputs];
+    for (int i = 0; i < n_inputs; ++i) {
+        x[i] = (real) input[i];
+    }
+    const real *in = x;
+#else
+    const real *in = input;
+#endif
+    int i = 0;
+    while (i < n) {
+        if (!neural_batch_eligible(nets[i], n_inputs)) {
+            ++i;
+            continue;
+        }
+        const int start = batch->offsets[nets[i]->batch_slot];
+        int end = start + nets[i]->tail->layer->n_outputs;
+        int j = i + 1;
+        while (j < n && neural_batch_eligible(nets[j], n_inputs) &&
+               batch->offsets[nets[j]->batch_slot] == end) {
+            end += nets[j]->tail->layer->n_outputs;
+            ++j;
+        }
+        const int m = end - start;
+        const real *w = batch->weights + (size_t) start * n_inputs;
+        real *state = batch->state + start;
+        memcpy(state, batch->biases + start, sizeof(real) * m);
+        blas_gemm(0, 1, 1, m, n_inputs, 1, in, n_inputs, w, n_inputs, 1, state,
+                  m);
+        i = j;
+    }
+    PROFILE_STOP(PROF_NEURAL_FORWARD);
+}
+
+/**
+ * @brief Forward propagates a network whose input layer has been batched.
+ * @pre neural_batch_forward() has been called with the same input for a set
+ * containing the network.
+ * @param [in] batch The batch used to compute the input layer.
+ * @param [in] net The neural network to propagate.
+ * @param [in] input The input state.
+ * @param [in] train Whether the network is in training mode.
+ */
+void
+neural_batch_propagate(const struct NeuralBatch *batch, struct Net *net,
+                       const double *input, const bool train)
+{
+    if (!neural_batch_eligible(net, batch->n_inputs) ||
+        !neural_batch_packed(batch, net)) {
+        neural_propagate(net, input, train);
+        return;
+    }
+    PROFILE_START(PROF_NEURAL_FORWARD);
+    net->train = train;
+    const struct Layer *l = net->tail->layer;
+    const int offset = batch->offsets[net->batch_slot];
+    memcpy(l->state, batch->state + offset, sizeof(real) * l->n_outputs);
+    neural_activate_array(l->state, l->output, l->n_outputs, l->function);
+    const real *in = l->output;
+    const struct Llist *iter = net->tail->prev;
+    while (iter != NULL) {
+        layer_forward(iter->layer, net, in);
+        in = layer_output(iter->layer);
+        iter = iter->prev;
+    }
+    PROFILE_STOP(PROF_NEURAL_FORWARD);
+}
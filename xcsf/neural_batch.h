@@ -0,0 +1,65 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file neural_batch.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Batched forward propagation of neural networks sharing an input.
+ */
+
+#pragma once
+
+#include "neural.h"
+
+/**
+ * @brief Packed input layers of a group of neural networks.
+ * @details The weights and biases of each network's connected input layer are
+ * stacked into contiguous rows so that the layers of many networks receiving
+ * the same input can be computed with a single matrix multiplication. Only
+ * input layers with the same number of inputs are packed together. Each
+ * slot records the stamp of the network at the time it was packed, and a
+ * network is only repacked after it has been modified.
+ */
+struct NeuralBatch {
+    int n_inputs; //!< Number of inputs to each packed layer
+    int n_rows; //!< Number of packed rows in use
+    int max_rows; //!< Maximum number of rows before the batch is reset
+    int n_slots; //!< Number of packed slots in use
+    int max_slots; //!< Number of allocated slots
+    unsigned long *stamps; //!< Stamp of the network packed in each slot
+    int *offsets; //!< Row offset of each slot
+    real *weights; //!< Packed layer weights
+    real *biases; //!< Packed layer biases
+    real *state; //!< Packed layer states
+};
+
+struct NeuralBatch *
+neural_batch_init(void);
+
+void
+neural_batch_free(struct NeuralBatch *batch);
+
+size_t
+neural_batch_bytes(const struct NeuralBatch *batch);
+
+void
+neural_batch_forward(struct NeuralBatch *batch, struct Net **nets,
+                     const int n, const double *input);
+
+void
+neural_batch_propagate(const struct NeuralBatch *batch, struct Net *net,
+                       const double *input, const bool train);
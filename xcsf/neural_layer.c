@@ -120,6 +120,60 @@ layer_mutate_neurons(const struct Layer *l, const double mu)
     return n;
 }
 
+/**
+ * @brief Returns the number of neurons or filters to allocate memory for.
+ * @details Layers that evolve neurons reserve memory for up to twice the
+ * number required, limited by the maximum number of neurons, so that most
+ * neuron and filter mutations do not reach the allocator.
+ * @param [in] l The layer to be allocated memory.
+ * @param [in] n The number of neurons or filters required.
+ * @return The number of neurons or filters to allocate memory for.
+ */
+int
+layer_reserve(const struct Layer *l, const int n)
+{
+    if (!(l->options & LAYER_EVOLVE_NEURONS) || n >= l->max_outputs) {
+        return n;
+    }
+    return (2 * n < l->max_outputs) ? 2 * n : l->max_outputs;
+}
+
+/**
+ * @brief Ensures a layer's output, bias, and weight arrays are large enough.
+ * @details Arrays are only reallocated when the number of elements in use
+ * exceeds the number allocated, in which case memory is reserved for further
+ * growth. The number of outputs, biases, and weights must each be a multiple
+ * of the number of neurons or filters.
+ * @param [in] l The layer to be allocated memory.
+ * @param [in] n_units The number of neurons or filters in use.
+ */
+void
+layer_ensure_capacity(struct Layer *l, const int n_units)
+{
+    const int n = layer_reserve(l, n_units);
+    if (l->n_outputs > l->n_outputs_alloc) {
+        l->n_outputs_alloc = l->n_outputs / n_units * n;
+        const size_t size = sizeof(real) * l->n_outputs_alloc;
+        l->state = realloc(l->state, size);
+        l->output = realloc(l->output, size);
+        l->delta = realloc(l->delta, size);
+    }
+    if (l->n_biases > l->n_biases_alloc) {
+        l->n_biases_alloc = l->n_biases / n_units * n;
+        const size_t size = sizeof(real) * l->n_biases_alloc;
+        l->biases = realloc(l->biases, size);
+        l->bias_updates = realloc(l->bias_updates, size);
+    }
+    if (l->n_weights > l->n_weights_alloc) {
+        l->n_weights_alloc = l->n_weights / n_units * n;
+        const size_t size = sizeof(real) * l->n_weights_alloc;
+        l->weights = realloc(l->weights, size);
+        l->weight_updates = realloc(l->weight_updates, size);
+        l->weight_active =
+            realloc(l->weight_active, sizeof(bool) * l->n_weights_alloc);
+    }
+}
+
 /**
  * @brief Adds N neurons to a layer. Negative N removes neurons.
  * @pre N must be appropriately bounds checked for the layer.
@@ -136,15 +190,7 @@ layer_add_neurons(struct Layer *l, const int N)
     l->n_weights = l->n_outputs * l->n_inputs;
     layer_guard_outputs(l);
     layer_guard_weights(l);
-    l->weights = realloc(l->weights, sizeof(double) * l->n_weights);
-    l->weight_active = realloc(l->weight_active, sizeof(bool) * l->n_weights);
-    l->weight_updates =
-        realloc(l->weight_updates, sizeof(double) * l->n_weights);
-    l->state = realloc(l->state, sizeof(double) * l->n_outputs);
-    l->output = realloc(l->output, sizeof(double) * l->n_outputs);
-    l->biases = realloc(l->biases, sizeof(double) * l->n_biases);
-    l->bias_updates = realloc(l->bias_updates, sizeof(double) * l->n_biases);
-    l->delta = realloc(l->delta, sizeof(double) * l->n_outputs);
+    layer_ensure_capacity(l, l->n_outputs);
     for (int i = old_n_weights; i < l->n_weights; ++i) {
         if (l->options & LAYER_EVOLVE_CONNECT && rand_uniform(0, 1) < 0.5) {
             l->weights[i] = 0;
@@ -165,6 +211,39 @@ layer_add_neurons(struct Layer *l, const int N)
     layer_calc_n_active(l);
 }
 
+/**
+ * @brief Mutates the connectivity of sampled weights within a layer.
+ * @details Weights are sampled with the larger of the two mutation rates and
+ * each sampled weight is then accepted with the ratio of its own rate, which
+ * is equivalent to testing every weight with its own rate.
+ * @param [in] l The neural network layer to mutate.
+ * @param [in] mu_enable Probability of enabling a currently disabled weight.
+ * @param [in] mu_disable Probability of disabling a currently enabled weight.
+ * @return Whether any alterations were made.
+ */
+static bool
+layer_mutate_connectivity_sparse(struct Layer *l, const double mu_enable,
+                                 const double mu_disable)
+{
+    bool mod = false;
+    const double p = fmax(mu_enable, mu_disable);
+    const int n = l->n_weights;
+    for (int i = rand_skip(p, n); i < n; i += rand_skip(p, n) + 1) {
+        if (!l->weight_active[i] && rand_uniform(0, p) < mu_enable) {
+            l->weight_active[i] = true;
+            l->weights[i] = rand_normal(0, WEIGHT_SD);
+            ++(l->n_active);
+            mod = true;
+        } else if (l->weight_active[i] && rand_uniform(0, p) < mu_disable) {
+            l->weight_active[i] = false;
+            l->weights[i] = 0;
+            --(l->n_active);
+            mod = true;
+        }
+    }
+    return mod;
+}
+
 /**
  * @brief Mutates a layer's connectivity by zeroing weights.
  * @param [in] l The neural network layer to mutate.
@@ -177,6 +256,12 @@ layer_mutate_connectivity(struct Layer *l, const double mu_enable,
                           const double mu_disable)
 {
     bool mod = false;
+    if (l->options & LAYER_SPARSE_MUTATE) {
+        if (l->n_inputs > 1 && l->n_outputs > 1) {
+            mod = layer_mutate_connectivity_sparse(l, mu_enable, mu_disable);
+        }
+        return mod;
+    }
     if (l->n_inputs > 1 && l->n_outputs > 1) {
         for (int i = 0; i < l->n_weights; ++i) {
             if (!l->weight_active[i] && rand_uniform(0, 1) < mu_enable) {
@@ -240,6 +325,42 @@ layer_ensure_input_represention(struct Layer *l)
     }
 }
 
+/**
+ * @brief Mutates sampled weights and biases within a layer.
+ * @details Each weight and bias is selected with probability equal to the
+ * mutation rate and only the selected elements receive a Gaussian
+ * perturbation with standard deviation equal to the mutation rate.
+ * @param [in] l The neural network layer to mutate.
+ * @param [in] mu The rate of mutation.
+ * @return Whether any alterations were made.
+ */
+static bool
+layer_mutate_weights_sparse(struct Layer *l, const double mu)
+{
+    bool mod = false;
+    const int n_w = l->n_weights;
+    for (int i = rand_skip(mu, n_w); i < n_w; i += rand_skip(mu, n_w) + 1) {
+        if (l->weight_active[i]) {
+            const real orig = l->weights[i];
+            l->weights[i] += rand_normal(0, mu);
+            l->weights[i] = clamp(l->weights[i], WEIGHT_MIN, WEIGHT_MAX);
+            if (l->weights[i] != orig) {
+                mod = true;
+            }
+        }
+    }
+    const int n_b = l->n_biases;
+    for (int i = rand_skip(mu, n_b); i < n_b; i += rand_skip(mu, n_b) + 1) {
+        const real orig = l->biases[i];
+        l->biases[i] += rand_normal(0, mu);
+        l->biases[i] = clamp(l->biases[i], WEIGHT_MIN, WEIGHT_MAX);
+        if (l->biases[i] != orig) {
+            mod = true;
+        }
+    }
+    return mod;
+}
+
 /**
  * @brief Mutates a layer's weights and biases by adding random numbers from a
  * Gaussian normal distribution with zero mean and standard deviation equal to
@@ -251,10 +372,13 @@ layer_ensure_input_represention(struct Layer *l)
 bool
 layer_mutate_weights(struct Layer *l, const double mu)
 {
+    if (l->options & LAYER_SPARSE_MUTATE) {
+        return layer_mutate_weights_sparse(l, mu);
+    }
     bool mod = false;
     for (int i = 0; i < l->n_weights; ++i) {
         if (l->weight_active[i]) {
-            const double orig = l->weights[i];
+            const real orig = l->weights[i];
             l->weights[i] += rand_normal(0, mu);
             l->weights[i] = clamp(l->weights[i], WEIGHT_MIN, WEIGHT_MAX);
             if (l->weights[i] != orig) {
@@ -263,7 +387,7 @@ layer_mutate_weights(struct Layer *l, const double mu)
         }
     }
     for (int i = 0; i < l->n_biases; ++i) {
-        const double orig = l->biases[i];
+        const real orig = l->biases[i];
         l->biases[i] += rand_normal(0, mu);
         l->biases[i] = clamp(l->biases[i], WEIGHT_MIN, WEIGHT_MAX);
         if (l->biases[i] != orig) {
@@ -418,6 +542,9 @@ layer_defaults(struct Layer *l)
     l->n_weights = 0;
     l->n_biases = 0;
     l->n_active = 0;
+    l->n_outputs_alloc = 0;
+    l->n_biases_alloc = 0;
+    l->n_weights_alloc = 0;
     l->function = 0;
     l->scale = 0;
     l->probability = 0;
@@ -54,6 +54,7 @@
 #define LAYER_SGD_WEIGHTS (1 << 3) //!< Layer may perform gradient descent
 #define LAYER_EVOLVE_ETA (1 << 4) //!< Layer may evolve rate of gradient descent
 #define LAYER_EVOLVE_CONNECT (1 << 5) //!< Layer may evolve connectivity
+#define LAYER_SPARSE_MUTATE (1 << 6) //!< Layer mutates sampled elements only
 
 #define NEURON_MIN (-100) //!< Minimum neuron state
 #define NEURON_MAX (100) //!< Maximum neuron state
@@ -72,15 +73,15 @@
  */
 struct Layer {
     int type; //!< Layer type: CONNECTED, DROPOUT, etc.
-    double *state; //!< Current neuron states (before activation function)
-    double *output; //!< Current neuron outputs (after activation function)
+    real *state; //!< Current neuron states (before activation function)
+    real *output; //!< Current neuron outputs (after activation function)
     uint32_t options; //!< Bitwise layer options permitting evolution, SGD, etc.
-    double *weights; //!< Weights for calculating neuron states
+    real *weights; //!< Weights for calculating neuron states
     bool *weight_active; //!< Whether each connection is present in the layer
-    double *biases; //!< Biases for calculating neuron states
-    double *bias_updates; //!< Updates to biases
-    double *weight_updates; //!< Updates to weights
-    double *delta; //!< Delta for updating weights
+    real *biases; //!< Biases for calculating neuron states
+    real *bias_updates; //!< Updates to biases
+    real *weight_updates; //!< Updates to weights
+    real *delta; //!< Delta for updating weights
     double *mu; //!< Mutation rates
     double eta; //!< Gradient descent rate
     double eta_max; //!< Maximum gradient descent rate
@@ -94,11 +95,14 @@ struct Layer {
     int n_weights; //!< Number of layer weights
     int n_biases; //!< Number of layer biases
     int n_active; //!< Number of active weights / connections
+    int n_outputs_alloc; //!< Number of outputs memory is allocated for
+    int n_biases_alloc; //!< Number of biases memory is allocated for
+    int n_weights_alloc; //!< Number of weights memory is allocated for
     int function; //!< Layer activation function
     double scale; //!< Usage depends on layer implementation
     double probability; //!< Usage depends on layer implementation
     struct LayerVtbl const *layer_vptr; //!< Functions acting on layers
-    double *prev_state; //!< Previous state for recursive layers
+    real *prev_state; //!< Previous state for recursive layers
     struct Layer *input_layer; //!< Recursive layer input
     struct Layer *self_layer; //!< Recursive layer self
     struct Layer *output_layer; //!< Recursive layer output
@@ -111,18 +115,18 @@ struct Layer {
     struct Layer *wi; //!< LSTM
     struct Layer *wg; //!< LSTM
     struct Layer *wo; //!< LSTM
-    double *cell; //!< LSTM
-    double *prev_cell; //!< LSTM
-    double *f; //!< LSTM
-    double *i; //!< LSTM
-    double *g; //!< LSTM
-    double *o; //!< LSTM
-    double *c; //!< LSTM
-    double *h; //!< LSTM
-    double *temp; //!< LSTM
-    double *temp2; //!< LSTM
-    double *temp3; //!< LSTM
-    double *dc; //!< LSTM
+    real *cell; //!< LSTM
+    real *prev_cell; //!< LSTM
+    real *f; //!< LSTM
+    real *i; //!< LSTM
+    real *g; //!< LSTM
+    real *o; //!< LSTM
+    real *c; //!< LSTM
+    real *h; //!< LSTM
+    real *temp; //!< LSTM
+    real *temp2; //!< LSTM
+    real *temp3; //!< LSTM
+    real *dc; //!< LSTM
     int height; //!< Pool, Conv, and Upsample
     int width; //!< Pool, Conv, and Upsample
     int channels; //!< Pool, Conv, and Upsample
@@ -150,12 +154,13 @@ struct LayerVtbl {
     void (*layer_impl_print)(const struct Layer *l, const bool print_weights);
     void (*layer_impl_update)(const struct Layer *l);
     void (*layer_impl_backward)(const struct Layer *l, const struct Net *net,
-                                const double *input, double *delta);
+                                const real *input, real *delta);
     void (*layer_impl_forward)(const struct Layer *l, const struct Net *net,
-                               const double *input);
-    double *(*layer_impl_output)(const struct Layer *l);
+                               const real *input);
+    real *(*layer_impl_output)(const struct Layer *l);
     size_t (*layer_impl_save)(const struct Layer *l, FILE *fp);
     size_t (*layer_impl_load)(struct Layer *l, FILE *fp);
+    size_t (*layer_impl_bytes)(const struct Layer *l);
 };
 
 /**
@@ -182,12 +187,23 @@ layer_load(struct Layer *l, FILE *fp)
     return (*l->layer_vptr->layer_impl_load)(l, fp);
 }
 
+/**
+ * @brief Returns the number of bytes of heap memory used by a layer.
+ * @param [in] l The layer whose memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+static inline size_t
+layer_bytes(const struct Layer *l)
+{
+    return (*l->layer_vptr->layer_impl_bytes)(l);
+}
+
 /**
  * @brief Returns the outputs of a layer.
  * @param [in] l The layer whose outputs are to be returned.
  * @return The layer outputs.
  */
-static inline double *
+static inline real *
 layer_output(const struct Layer *l)
 {
     return (*l->layer_vptr->layer_impl_output)(l);
@@ -200,7 +216,7 @@ layer_output(const struct Layer *l)
  * @param [in] input Input to the layer.
  */
 static inline void
-layer_forward(const struct Layer *l, const struct Net *net, const double *input)
+layer_forward(const struct Layer *l, const struct Net *net, const real *input)
 {
     (*l->layer_vptr->layer_impl_forward)(l, net, input);
 }
@@ -214,7 +230,7 @@ layer_forward(const struct Layer *l, const struct Net *net, const double *input)
  */
 static inline void
 layer_backward(const struct Layer *l, const struct Net *net,
-               const double *input, double *delta)
+               const real *input, real *delta)
 {
     (*l->layer_vptr->layer_impl_backward)(l, net, input, delta);
 }
@@ -313,6 +329,12 @@ layer_mutate_neurons(const struct Layer *l, const double mu);
 void
 layer_add_neurons(struct Layer *l, const int n);
 
+int
+layer_reserve(const struct Layer *l, const int n);
+
+void
+layer_ensure_capacity(struct Layer *l, const int n_units);
+
 void
 layer_calc_n_active(struct Layer *l);
 
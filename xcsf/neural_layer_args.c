@@ -34,6 +34,8 @@
 #include "neural_layer_upsample.h"
 #include "utils.h"
 
+#define LAYER_SPARSE_BUILD (2) //!< First build saving sparse mutation
+
 /**
  * @brief Sets layer parameters to default values.
  * @param [in] args The layer parameters to initialise.
@@ -66,6 +68,7 @@ layer_args_init(struct ArgsLayer *args)
     args->evolve_eta = false;
     args->evolve_connect = false;
     args->sgd_weights = false;
+    args->sparse_mutate = false;
     args->next = NULL;
 }
 
@@ -102,6 +105,7 @@ layer_args_copy(const struct ArgsLayer *src)
     new->evolve_eta = src->evolve_eta;
     new->evolve_connect = src->evolve_connect;
     new->sgd_weights = src->sgd_weights;
+    new->sparse_mutate = src->sparse_mutate;
     new->next = NULL;
     return new;
 }
@@ -181,6 +185,9 @@ layer_args_print_evo(const struct ArgsLayer *args)
         printf(", n_max=%d", args->n_max);
         printf(", max_neuron_grow=%d", args->max_neuron_grow);
     }
+    if (args->sparse_mutate) {
+        printf(", sparse_mutate=true");
+    }
 }
 
 /**
@@ -378,6 +385,9 @@ layer_args_opt(const struct ArgsLayer *args)
     if (args->evolve_connect) {
         lopt |= LAYER_EVOLVE_CONNECT;
     }
+    if (args->sparse_mutate) {
+        lopt |= LAYER_SPARSE_MUTATE;
+    }
     return lopt;
 }
 
@@ -398,6 +408,24 @@ layer_args_length(const struct ArgsLayer *args)
     return n;
 }
 
+/**
+ * @brief Returns whether any layer retains state between forward passes.
+ * @param [in] args Layer initialisation parameters.
+ * @return Whether a recurrent or LSTM layer is present.
+ */
+bool
+layer_args_stateful(const struct ArgsLayer *args)
+{
+    const struct ArgsLayer *iter = args;
+    while (iter != NULL) {
+        if (iter->type == RECURRENT || iter->type == LSTM) {
+            return true;
+        }
+        iter = iter->next;
+    }
+    return false;
+}
+
 /**
  * @brief Saves neural network layer parameters.
  * @param [in] args Layer initialisation parameters.
@@ -437,6 +465,7 @@ layer_args_save(const struct ArgsLayer *args, FILE *fp)
         s += fwrite(&iter->evolve_eta, sizeof(bool), 1, fp);
         s += fwrite(&iter->evolve_connect, sizeof(bool), 1, fp);
         s += fwrite(&iter->sgd_weights, sizeof(bool), 1, fp);
+        s += fwrite(&iter->sparse_mutate, sizeof(bool), 1, fp);
         iter = iter->next;
     }
     return s;
@@ -445,11 +474,12 @@ layer_args_save(const struct ArgsLayer *args, FILE *fp)
 /**
  * @brief Loads neural network layer parameters.
  * @param [in] largs Pointer to the list of layer parameters to load.
+ * @param [in] build The build version number of the saved parameters.
  * @param [in] fp Pointer to the output file.
  * @return The total number of elements read.
  */
 size_t
-layer_args_load(struct ArgsLayer **largs, FILE *fp)
+layer_args_load(struct ArgsLayer **largs, const int build, FILE *fp)
 {
     layer_args_free(largs);
     size_t s = 0;
@@ -483,6 +513,9 @@ layer_args_load(struct ArgsLayer **largs, FILE *fp)
         s += fread(&arg->evolve_eta, sizeof(bool), 1, fp);
         s += fread(&arg->evolve_connect, sizeof(bool), 1, fp);
         s += fread(&arg->sgd_weights, sizeof(bool), 1, fp);
+        if (build >= LAYER_SPARSE_BUILD) {
+            s += fread(&arg->sparse_mutate, sizeof(bool), 1, fp);
+        }
         if (*largs == NULL) {
             *largs = arg;
         } else {
@@ -50,6 +50,7 @@ struct ArgsLayer {
     _Bool evolve_eta; //!< Ability to evolve gradient descent rate
     _Bool evolve_connect; //!< Ability to evolve weight connectivity
     _Bool sgd_weights; //!< Ability to update weights with gradient descent
+    _Bool sparse_mutate; //!< Whether to mutate only sampled elements
     struct ArgsLayer *next; //!< Next layer parameters
 };
 
@@ -74,8 +75,11 @@ layer_args_validate(struct ArgsLayer *args);
 uint32_t
 layer_args_opt(const struct ArgsLayer *args);
 
+bool
+layer_args_stateful(const struct ArgsLayer *args);
+
 size_t
 layer_args_save(const struct ArgsLayer *args, FILE *fp);
 
 size_t
-layer_args_load(struct ArgsLayer **largs, FILE *fp);
+layer_args_load(struct ArgsLayer **largs, const int build, FILE *fp);
@@ -50,14 +50,17 @@ malloc_layer_arrays(struct Layer *l)
 {
     layer_guard_outputs(l);
     layer_guard_weights(l);
-    l->state = calloc(l->n_outputs, sizeof(double));
-    l->output = calloc(l->n_outputs, sizeof(double));
-    l->biases = malloc(sizeof(double) * l->n_outputs);
-    l->bias_updates = calloc(l->n_outputs, sizeof(double));
-    l->delta = calloc(l->n_outputs, sizeof(double));
-    l->weight_updates = calloc(l->n_weights, sizeof(double));
-    l->weight_active = malloc(sizeof(bool) * l->n_weights);
-    l->weights = malloc(sizeof(double) * l->n_weights);
+    l->n_outputs_alloc = layer_reserve(l, l->n_outputs);
+    l->n_biases_alloc = l->n_outputs_alloc;
+    l->n_weights_alloc = l->n_outputs_alloc * l->n_inputs;
+    l->state = calloc(l->n_outputs_alloc, sizeof(real));
+    l->output = calloc(l->n_outputs_alloc, sizeof(real));
+    l->biases = malloc(sizeof(real) * l->n_biases_alloc);
+    l->bias_updates = calloc(l->n_biases_alloc, sizeof(real));
+    l->delta = calloc(l->n_outputs_alloc, sizeof(real));
+    l->weight_updates = calloc(l->n_weights_alloc, sizeof(real));
+    l->weight_active = malloc(sizeof(bool) * l->n_weights_alloc);
+    l->weights = malloc(sizeof(real) * l->n_weights_alloc);
     l->mu = malloc(sizeof(double) * N_MU);
 }
 
@@ -91,7 +94,7 @@ neural_layer_connected_init(struct Layer *l, const struct ArgsLayer *args)
         l->weights[i] = rand_normal(0, WEIGHT_SD_INIT);
         l->weight_active[i] = true;
     }
-    memset(l->biases, 0, sizeof(double) * l->n_biases);
+    memset(l->biases, 0, sizeof(real) * l->n_biases);
     sam_init(l->mu, N_MU, MU_TYPE);
 }
 
@@ -147,8 +150,8 @@ neural_layer_connected_copy(const struct Layer *src)
     l->max_neuron_grow = src->max_neuron_grow;
     l->n_active = src->n_active;
     malloc_layer_arrays(l);
-    memcpy(l->biases, src->biases, sizeof(double) * src->n_biases);
-    memcpy(l->weights, src->weights, sizeof(double) * src->n_weights);
+    memcpy(l->biases, src->biases, sizeof(real) * src->n_biases);
+    memcpy(l->weights, src->weights, sizeof(real) * src->n_weights);
     memcpy(l->weight_active, src->weight_active, sizeof(bool) * src->n_weights);
     memcpy(l->mu, src->mu, sizeof(double) * N_MU);
     return l;
@@ -172,15 +175,15 @@ neural_layer_connected_rand(struct Layer *l)
  */
 void
 neural_layer_connected_forward(const struct Layer *l, const struct Net *net,
-                               const double *input)
+                               const real *input)
 {
     (void) net;
     const int k = l->n_inputs;
     const int n = l->n_outputs;
-    const double *a = input;
-    const double *b = l->weights;
-    double *c = l->state;
-    memcpy(l->state, l->biases, sizeof(double) * l->n_outputs);
+    const real *a = input;
+    const real *b = l->weights;
+    real *c = l->state;
+    memcpy(l->state, l->biases, sizeof(real) * l->n_outputs);
     blas_gemm(0, 1, 1, n, k, 1, a, k, b, k, 1, c, n);
     neural_activate_array(l->state, l->output, l->n_outputs, l->function);
 }
@@ -194,25 +197,25 @@ neural_layer_connected_forward(const struct Layer *l, const struct Net *net,
  */
 void
 neural_layer_connected_backward(const struct Layer *l, const struct Net *net,
-                                const double *input, double *delta)
+                                const real *input, real *delta)
 {
     (void) net;
     neural_gradient_array(l->state, l->delta, l->n_outputs, l->function);
     if (l->options & LAYER_SGD_WEIGHTS) {
         const int m = l->n_outputs;
         const int n = l->n_inputs;
-        const double *a = l->delta;
-        const double *b = input;
-        double *c = l->weight_updates;
+        const real *a = l->delta;
+        const real *b = input;
+        real *c = l->weight_updates;
         blas_axpy(l->n_outputs, 1, l->delta, 1, l->bias_updates, 1);
         blas_gemm(1, 0, m, n, 1, 1, a, m, b, n, 1, c, n);
     }
     if (delta) {
         const int k = l->n_outputs;
         const int n = l->n_inputs;
-        const double *a = l->delta;
-        const double *b = l->weights;
-        double *c = delta;
+        const real *a = l->delta;
+        const real *b = l->weights;
+        real *c = delta;
         blas_gemm(0, 0, 1, n, k, 1, a, k, b, n, 1, c, n);
     }
 }
@@ -237,46 +240,68 @@ neural_layer_connected_update(const struct Layer *l)
     }
 }
 
+/**
+ * @brief Moves a row of a connected layer's weights to a new stride.
+ * @param [in] l The layer whose weights are to be moved.
+ * @param [in] i The row to move.
+ * @param [in] n_inputs The new number of inputs.
+ */
+static void
+move_weight_row(const struct Layer *l, const int i, const int n_inputs)
+{
+    const int n = (n_inputs < l->n_inputs) ? n_inputs : l->n_inputs;
+    const int from = i * l->n_inputs;
+    const int to = i * n_inputs;
+    memmove(l->weights + to, l->weights + from, sizeof(real) * n);
+    memmove(l->weight_updates + to, l->weight_updates + from,
+            sizeof(real) * n);
+    memmove(l->weight_active + to, l->weight_active + from, sizeof(bool) * n);
+}
+
 /**
  * @brief Resizes a connected layer if the previous layer has changed size.
+ * @details Weights are rearranged in place within the allocated memory, which
+ * is only grown when the new number of weights exceeds the number allocated.
  * @param [in] l The layer to resize.
  * @param [in] prev The layer previous to the one being resized.
  */
 void
 neural_layer_connected_resize(struct Layer *l, const struct Layer *prev)
 {
-    const int n_weights = prev->n_outputs * l->n_outputs;
+    const int n_inputs = prev->n_outputs;
+    const int n_weights = n_inputs * l->n_outputs;
     if (n_weights < 1 || n_weights > N_WEIGHTS_MAX) {
         printf("neural_layer_connected: malloc() invalid resize\n");
         layer_print(l, false);
         exit(EXIT_FAILURE);
     }
-    double *weights = malloc(sizeof(double) * n_weights);
-    double *weight_updates = malloc(sizeof(double) * n_weights);
-    bool *weight_active = malloc(sizeof(bool) * n_weights);
-    for (int i = 0; i < l->n_outputs; ++i) {
-        const int orig_offset = i * l->n_inputs;
-        const int offset = i * prev->n_outputs;
-        for (int j = 0; j < prev->n_outputs; ++j) {
-            if (j < l->n_inputs) {
-                weights[offset + j] = l->weights[orig_offset + j];
-                weight_updates[offset + j] = l->weight_updates[orig_offset + j];
-                weight_active[offset + j] = l->weight_active[orig_offset + j];
-            } else {
-                weights[offset + j] = rand_normal(0, WEIGHT_SD);
-                weight_updates[offset + j] = 0;
-                weight_active[offset + j] = true;
+    if (n_weights > l->n_weights_alloc) {
+        l->n_weights_alloc = n_inputs * layer_reserve(l, l->n_outputs);
+        const size_t size = sizeof(real) * l->n_weights_alloc;
+        l->weights = realloc(l->weights, size);
+        l->weight_updates = realloc(l->weight_updates, size);
+        l->weight_active =
+            realloc(l->weight_active, sizeof(bool) * l->n_weights_alloc);
+    }
+    if (n_inputs > l->n_inputs) {
+        for (int i = l->n_outputs - 1; i > 0; --i) {
+            move_weight_row(l, i, n_inputs);
+        }
+        for (int i = 0; i < l->n_outputs; ++i) {
+            const int offset = i * n_inputs;
+            for (int j = l->n_inputs; j < n_inputs; ++j) {
+                l->weights[offset + j] = rand_normal(0, WEIGHT_SD);
+                l->weight_updates[offset + j] = 0;
+                l->weight_active[offset + j] = true;
             }
         }
+    } else {
+        for (int i = 1; i < l->n_outputs; ++i) {
+            move_weight_row(l, i, n_inputs);
+        }
     }
-    free(l->weights);
-    free(l->weight_updates);
-    free(l->weight_active);
-    l->weights = weights;
-    l->weight_updates = weight_updates;
-    l->weight_active = weight_active;
     l->n_weights = n_weights;
-    l->n_inputs = prev->n_outputs;
+    l->n_inputs = n_inputs;
     layer_calc_n_active(l);
     if (l->options & LAYER_EVOLVE_CONNECT) {
         layer_ensure_input_represention(l);
@@ -324,7 +349,7 @@ neural_layer_connected_mutate(struct Layer *l)
  * @param [in] l The layer whose output to return.
  * @return The layer output.
  */
-double *
+real *
 neural_layer_connected_output(const struct Layer *l)
 {
     return l->output;
@@ -370,11 +395,11 @@ neural_layer_connected_save(const struct Layer *l, FILE *fp)
     s += fwrite(&l->momentum, sizeof(double), 1, fp);
     s += fwrite(&l->decay, sizeof(double), 1, fp);
     s += fwrite(&l->n_active, sizeof(int), 1, fp);
-    s += fwrite(l->weights, sizeof(double), l->n_weights, fp);
+    s += fwrite(l->weights, sizeof(real), l->n_weights, fp);
     s += fwrite(l->weight_active, sizeof(bool), l->n_weights, fp);
-    s += fwrite(l->biases, sizeof(double), l->n_biases, fp);
-    s += fwrite(l->bias_updates, sizeof(double), l->n_biases, fp);
-    s += fwrite(l->weight_updates, sizeof(double), l->n_weights, fp);
+    s += fwrite(l->biases, sizeof(real), l->n_biases, fp);
+    s += fwrite(l->bias_updates, sizeof(real), l->n_biases, fp);
+    s += fwrite(l->weight_updates, sizeof(real), l->n_weights, fp);
     s += fwrite(l->mu, sizeof(double), N_MU, fp);
     return s;
 }
@@ -407,11 +432,25 @@ neural_layer_connected_load(struct Layer *l, FILE *fp)
     l->out_c = 1;
     l->out_h = 1;
     malloc_layer_arrays(l);
-    s += fread(l->weights, sizeof(double), l->n_weights, fp);
+    s += fread(l->weights, sizeof(real), l->n_weights, fp);
     s += fread(l->weight_active, sizeof(bool), l->n_weights, fp);
-    s += fread(l->biases, sizeof(double), l->n_biases, fp);
-    s += fread(l->bias_updates, sizeof(double), l->n_biases, fp);
-    s += fread(l->weight_updates, sizeof(double), l->n_weights, fp);
+    s += fread(l->biases, sizeof(real), l->n_biases, fp);
+    s += fread(l->bias_updates, sizeof(real), l->n_biases, fp);
+    s += fread(l->weight_updates, sizeof(real), l->n_weights, fp);
     s += fread(l->mu, sizeof(double), N_MU, fp);
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by a connected layer.
+ * @param [in] l The layer whose memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+neural_layer_connected_bytes(const struct Layer *l)
+{
+    const size_t n_real = 3 * l->n_outputs_alloc + 2 * l->n_biases_alloc +
+        2 * (size_t) l->n_weights_alloc;
+    return sizeof(struct Layer) + sizeof(real) * n_real +
+        sizeof(bool) * l->n_weights_alloc + sizeof(double) * N_MU;
+}
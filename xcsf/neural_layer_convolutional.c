@@ -73,7 +73,7 @@ static size_t
 get_workspace_size(const struct Layer *l)
 {
     const size_t workspace_size = (size_t) l->out_h * l->out_w * l->size *
-        l->size * l->channels * sizeof(double);
+        l->size * l->channels * sizeof(real);
     if (workspace_size < 1) {
         printf("neural_layer_convolutional: invalid workspace size\n");
         layer_print(l, false);
@@ -102,36 +102,32 @@ static void
 malloc_layer_arrays(struct Layer *l)
 {
     guard_malloc(l);
-    l->delta = calloc(l->n_outputs, sizeof(double));
-    l->state = calloc(l->n_outputs, sizeof(double));
-    l->output = calloc(l->n_outputs, sizeof(double));
-    l->weights = malloc(sizeof(double) * l->n_weights);
-    l->weight_updates = calloc(l->n_weights, sizeof(double));
-    l->weight_active = malloc(sizeof(bool) * l->n_weights);
-    l->biases = malloc(sizeof(double) * l->n_biases);
-    l->bias_updates = calloc(l->n_biases, sizeof(double));
+    const int n = layer_reserve(l, l->n_filters);
+    l->n_outputs_alloc = l->n_outputs / l->n_filters * n;
+    l->n_biases_alloc = n;
+    l->n_weights_alloc = l->n_weights / l->n_filters * n;
+    l->delta = calloc(l->n_outputs_alloc, sizeof(real));
+    l->state = calloc(l->n_outputs_alloc, sizeof(real));
+    l->output = calloc(l->n_outputs_alloc, sizeof(real));
+    l->weights = malloc(sizeof(real) * l->n_weights_alloc);
+    l->weight_updates = calloc(l->n_weights_alloc, sizeof(real));
+    l->weight_active = malloc(sizeof(bool) * l->n_weights_alloc);
+    l->biases = malloc(sizeof(real) * l->n_biases_alloc);
+    l->bias_updates = calloc(l->n_biases_alloc, sizeof(real));
     l->temp = malloc(get_workspace_size(l));
     l->mu = malloc(sizeof(double) * N_MU);
 }
 
 /**
  * @brief Resize memory used by a convolutional layer.
+ * @details Memory reserved for additional filters is reused where possible.
  * @param [in] l The layer to be reallocated memory.
  */
 static void
 realloc_layer_arrays(struct Layer *l)
 {
     guard_malloc(l);
-    l->delta = realloc(l->delta, sizeof(double) * l->n_outputs);
-    l->state = realloc(l->state, sizeof(double) * l->n_outputs);
-    l->output = realloc(l->output, sizeof(double) * l->n_outputs);
-    l->weights = realloc(l->weights, sizeof(double) * l->n_weights);
-    l->weight_updates =
-        realloc(l->weight_updates, sizeof(double) * l->n_weights);
-    l->weight_active = realloc(l->weight_active, sizeof(bool) * l->n_weights);
-    l->biases = realloc(l->biases, sizeof(double) * l->n_biases);
-    l->bias_updates = realloc(l->bias_updates, sizeof(double) * l->n_biases);
-    l->temp = realloc(l->temp, get_workspace_size(l));
+    layer_ensure_capacity(l, l->n_filters);
 }
 
 /**
@@ -190,7 +186,7 @@ neural_layer_convolutional_init(struct Layer *l, const struct ArgsLayer *args)
         l->weights[i] = rand_normal(0, WEIGHT_SD_INIT);
         l->weight_active[i] = true;
     }
-    memset(l->biases, 0, sizeof(double) * l->n_biases);
+    memset(l->biases, 0, sizeof(real) * l->n_biases);
     sam_init(l->mu, N_MU, MU_TYPE);
 }
 
@@ -233,9 +229,9 @@ neural_layer_convolutional_copy(const struct Layer *src)
     l->eta_max = src->eta_max;
     l->eta_min = src->eta_min;
     malloc_layer_arrays(l);
-    memcpy(l->weights, src->weights, sizeof(double) * src->n_weights);
+    memcpy(l->weights, src->weights, sizeof(real) * src->n_weights);
     memcpy(l->weight_active, src->weight_active, sizeof(bool) * src->n_weights);
-    memcpy(l->biases, src->biases, sizeof(double) * src->n_biases);
+    memcpy(l->biases, src->biases, sizeof(real) * src->n_biases);
     memcpy(l->mu, src->mu, sizeof(double) * N_MU);
     return l;
 }
@@ -258,16 +254,16 @@ neural_layer_convolutional_rand(struct Layer *l)
  */
 void
 neural_layer_convolutional_forward(const struct Layer *l, const struct Net *net,
-                                   const double *input)
+                                   const real *input)
 {
     (void) net;
     const int m = l->n_filters;
     const int k = l->size * l->size * l->channels;
     const int n = l->out_w * l->out_h;
-    const double *a = l->weights;
-    double *b = l->temp;
-    double *c = l->state;
-    memset(l->state, 0, sizeof(double) * l->n_outputs);
+    const real *a = l->weights;
+    real *b = l->temp;
+    real *c = l->state;
+    memset(l->state, 0, sizeof(real) * l->n_outputs);
     if (l->size == 1) {
         blas_gemm(0, 0, m, n, k, 1, a, k, input, n, 1, c, n);
     } else {
@@ -292,8 +288,8 @@ neural_layer_convolutional_forward(const struct Layer *l, const struct Net *net,
  */
 void
 neural_layer_convolutional_backward(const struct Layer *l,
-                                    const struct Net *net, const double *input,
-                                    double *delta)
+                                    const struct Net *net, const real *input,
+                                    real *delta)
 {
     (void) net;
     const int m = l->n_filters;
@@ -304,9 +300,9 @@ neural_layer_convolutional_backward(const struct Layer *l,
         for (int i = 0; i < l->n_biases; ++i) {
             l->bias_updates[i] += blas_sum(l->delta + k * i, k);
         }
-        const double *a = l->delta;
-        double *b = l->temp;
-        double *c = l->weight_updates;
+        const real *a = l->delta;
+        real *b = l->temp;
+        real *c = l->weight_updates;
         if (l->size == 1) {
             blas_gemm(0, 1, m, n, k, 1, a, k, input, k, 1, c, n);
         } else {
@@ -316,9 +312,9 @@ neural_layer_convolutional_backward(const struct Layer *l,
         }
     }
     if (delta) {
-        const double *a = l->weights;
-        const double *b = l->delta;
-        double *c = l->temp;
+        const real *a = l->weights;
+        const real *b = l->delta;
+        real *c = l->temp;
         if (l->size == 1) {
             c = delta;
         }
@@ -369,6 +365,7 @@ neural_layer_convolutional_resize(struct Layer *l, const struct Layer *prev)
     l->n_inputs = l->width * l->height * l->channels;
     l->n_weights = l->channels * l->n_filters * l->size * l->size;
     realloc_layer_arrays(l);
+    l->temp = realloc(l->temp, get_workspace_size(l));
     for (int i = old_n_weights; i < l->n_weights; ++i) {
         l->weights[i] = rand_normal(0, WEIGHT_SD);
         l->weight_updates[i] = 0;
@@ -481,7 +478,7 @@ neural_layer_convolutional_mutate(struct Layer *l)
  * @param [in] l The layer whose output to return.
  * @return The layer output.
  */
-double *
+real *
 neural_layer_convolutional_output(const struct Layer *l)
 {
     return l->output;
@@ -539,11 +536,11 @@ neural_layer_convolutional_save(const struct Layer *l, FILE *fp)
     s += fwrite(&l->momentum, sizeof(double), 1, fp);
     s += fwrite(&l->decay, sizeof(double), 1, fp);
     s += fwrite(&l->max_neuron_grow, sizeof(int), 1, fp);
-    s += fwrite(l->weights, sizeof(double), l->n_weights, fp);
-    s += fwrite(l->weight_updates, sizeof(double), l->n_weights, fp);
+    s += fwrite(l->weights, sizeof(real), l->n_weights, fp);
+    s += fwrite(l->weight_updates, sizeof(real), l->n_weights, fp);
     s += fwrite(l->weight_active, sizeof(bool), l->n_weights, fp);
-    s += fwrite(l->biases, sizeof(double), l->n_biases, fp);
-    s += fwrite(l->bias_updates, sizeof(double), l->n_filters, fp);
+    s += fwrite(l->biases, sizeof(real), l->n_biases, fp);
+    s += fwrite(l->bias_updates, sizeof(real), l->n_filters, fp);
     s += fwrite(l->mu, sizeof(double), N_MU, fp);
     return s;
 }
@@ -583,11 +580,26 @@ neural_layer_convolutional_load(struct Layer *l, FILE *fp)
     s += fread(&l->decay, sizeof(double), 1, fp);
     s += fread(&l->max_neuron_grow, sizeof(int), 1, fp);
     malloc_layer_arrays(l);
-    s += fread(l->weights, sizeof(double), l->n_weights, fp);
-    s += fread(l->weight_updates, sizeof(double), l->n_weights, fp);
+    s += fread(l->weights, sizeof(real), l->n_weights, fp);
+    s += fread(l->weight_updates, sizeof(real), l->n_weights, fp);
     s += fread(l->weight_active, sizeof(bool), l->n_weights, fp);
-    s += fread(l->biases, sizeof(double), l->n_biases, fp);
-    s += fread(l->bias_updates, sizeof(double), l->n_biases, fp);
+    s += fread(l->biases, sizeof(real), l->n_biases, fp);
+    s += fread(l->bias_updates, sizeof(real), l->n_biases, fp);
     s += fread(l->mu, sizeof(double), N_MU, fp);
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by a convolutional layer.
+ * @param [in] l The layer whose memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+neural_layer_convolutional_bytes(const struct Layer *l)
+{
+    const size_t n_real = 3 * l->n_outputs_alloc + 2 * l->n_biases_alloc +
+        2 * (size_t) l->n_weights_alloc;
+    return sizeof(struct Layer) + sizeof(real) * n_real +
+        sizeof(bool) * l->n_weights_alloc + sizeof(double) * N_MU +
+        get_workspace_size(l);
+}
@@ -36,12 +36,12 @@ neural_layer_convolutional_rand(struct Layer *l);
 
 void
 neural_layer_convolutional_forward(const struct Layer *l, const struct Net *net,
-                                   const double *input);
+                                   const real *input);
 
 void
 neural_layer_convolutional_backward(const struct Layer *l,
-                                    const struct Net *net, const double *input,
-                                    double *delta);
+                                    const struct Net *net, const real *input,
+                                    real *delta);
 
 void
 neural_layer_convolutional_update(const struct Layer *l);
@@ -56,7 +56,7 @@ neural_layer_convolutional_mutate(struct Layer *l);
 void
 neural_layer_convolutional_free(const struct Layer *l);
 
-double *
+real *
 neural_layer_convolutional_output(const struct Layer *l);
 
 size_t
@@ -65,6 +65,9 @@ neural_layer_convolutional_save(const struct Layer *l, FILE *fp);
 size_t
 neural_layer_convolutional_load(struct Layer *l, FILE *fp);
 
+size_t
+neural_layer_convolutional_bytes(const struct Layer *l);
+
 void
 neural_layer_convolutional_resize(struct Layer *l, const struct Layer *prev);
 
@@ -78,5 +81,5 @@ static struct LayerVtbl const layer_convolutional_vtbl = {
     &neural_layer_convolutional_print,    &neural_layer_convolutional_update,
     &neural_layer_convolutional_backward, &neural_layer_convolutional_forward,
     &neural_layer_convolutional_output,   &neural_layer_convolutional_save,
-    &neural_layer_convolutional_load,
+    &neural_layer_convolutional_load,     &neural_layer_convolutional_bytes,
 };
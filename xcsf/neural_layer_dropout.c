@@ -33,9 +33,9 @@ static void
 malloc_layer_arrays(struct Layer *l)
 {
     layer_guard_outputs(l);
-    l->output = calloc(l->n_outputs, sizeof(double));
-    l->delta = calloc(l->n_outputs, sizeof(double));
-    l->state = calloc(l->n_outputs, sizeof(double));
+    l->output = calloc(l->n_outputs, sizeof(real));
+    l->delta = calloc(l->n_outputs, sizeof(real));
+    l->state = calloc(l->n_outputs, sizeof(real));
 }
 
 /**
@@ -125,10 +125,10 @@ neural_layer_dropout_rand(struct Layer *l)
  */
 void
 neural_layer_dropout_forward(const struct Layer *l, const struct Net *net,
-                             const double *input)
+                             const real *input)
 {
     if (!net->train) {
-        memcpy(l->output, input, sizeof(double) * l->n_inputs);
+        memcpy(l->output, input, sizeof(real) * l->n_inputs);
     } else {
         for (int i = 0; i < l->n_inputs; ++i) {
             l->state[i] = rand_uniform(0, 1);
@@ -150,7 +150,7 @@ neural_layer_dropout_forward(const struct Layer *l, const struct Net *net,
  */
 void
 neural_layer_dropout_backward(const struct Layer *l, const struct Net *net,
-                              const double *input, double *delta)
+                              const real *input, real *delta)
 {
     (void) net;
     (void) input;
@@ -210,7 +210,7 @@ neural_layer_dropout_resize(struct Layer *l, const struct Layer *prev)
  * @param [in] l The layer whose output to return.
  * @return The layer output.
  */
-double *
+real *
 neural_layer_dropout_output(const struct Layer *l)
 {
     return l->output;
@@ -271,3 +271,14 @@ neural_layer_dropout_load(struct Layer *l, FILE *fp)
     malloc_layer_arrays(l);
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by a dropout layer.
+ * @param [in] l The layer whose memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+neural_layer_dropout_bytes(const struct Layer *l)
+{
+    return sizeof(struct Layer) + sizeof(real) * 3 * l->n_outputs;
+}
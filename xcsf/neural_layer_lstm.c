@@ -88,22 +88,23 @@ static void
 malloc_layer_arrays(struct Layer *l)
 {
     layer_guard_outputs(l);
-    l->delta = calloc(l->n_outputs, sizeof(double));
-    l->output = calloc(l->n_outputs, sizeof(double));
-    l->state = calloc(l->n_outputs, sizeof(double));
-    l->prev_state = calloc(l->n_outputs, sizeof(double));
-    l->prev_cell = calloc(l->n_outputs, sizeof(double));
-    l->cell = calloc(l->n_outputs, sizeof(double));
-    l->f = calloc(l->n_outputs, sizeof(double));
-    l->i = calloc(l->n_outputs, sizeof(double));
-    l->g = calloc(l->n_outputs, sizeof(double));
-    l->o = calloc(l->n_outputs, sizeof(double));
-    l->c = calloc(l->n_outputs, sizeof(double));
-    l->h = calloc(l->n_outputs, sizeof(double));
-    l->temp = calloc(l->n_outputs, sizeof(double));
-    l->temp2 = calloc(l->n_outputs, sizeof(double));
-    l->temp3 = calloc(l->n_outputs, sizeof(double));
-    l->dc = calloc(l->n_outputs, sizeof(double));
+    l->n_outputs_alloc = layer_reserve(l, l->n_outputs);
+    l->delta = calloc(l->n_outputs_alloc, sizeof(real));
+    l->output = calloc(l->n_outputs_alloc, sizeof(real));
+    l->state = calloc(l->n_outputs_alloc, sizeof(real));
+    l->prev_state = calloc(l->n_outputs_alloc, sizeof(real));
+    l->prev_cell = calloc(l->n_outputs_alloc, sizeof(real));
+    l->cell = calloc(l->n_outputs_alloc, sizeof(real));
+    l->f = calloc(l->n_outputs_alloc, sizeof(real));
+    l->i = calloc(l->n_outputs_alloc, sizeof(real));
+    l->g = calloc(l->n_outputs_alloc, sizeof(real));
+    l->o = calloc(l->n_outputs_alloc, sizeof(real));
+    l->c = calloc(l->n_outputs_alloc, sizeof(real));
+    l->h = calloc(l->n_outputs_alloc, sizeof(real));
+    l->temp = calloc(l->n_outputs_alloc, sizeof(real));
+    l->temp2 = calloc(l->n_outputs_alloc, sizeof(real));
+    l->temp3 = calloc(l->n_outputs_alloc, sizeof(real));
+    l->dc = calloc(l->n_outputs_alloc, sizeof(real));
 }
 
 /**
@@ -131,6 +132,37 @@ free_layer_arrays(const struct Layer *l)
     free(l->dc);
 }
 
+/**
+ * @brief Zeros the memory used by an LSTM layer, reallocating if too small.
+ * @param [in] l The layer whose memory is to be reset.
+ */
+static void
+reset_layer_arrays(struct Layer *l)
+{
+    if (l->n_outputs > l->n_outputs_alloc) {
+        free_layer_arrays(l);
+        malloc_layer_arrays(l);
+        return;
+    }
+    const size_t size = sizeof(real) * l->n_outputs;
+    memset(l->delta, 0, size);
+    memset(l->output, 0, size);
+    memset(l->state, 0, size);
+    memset(l->prev_state, 0, size);
+    memset(l->prev_cell, 0, size);
+    memset(l->cell, 0, size);
+    memset(l->f, 0, size);
+    memset(l->i, 0, size);
+    memset(l->g, 0, size);
+    memset(l->o, 0, size);
+    memset(l->c, 0, size);
+    memset(l->h, 0, size);
+    memset(l->temp, 0, size);
+    memset(l->temp2, 0, size);
+    memset(l->temp3, 0, size);
+    memset(l->dc, 0, size);
+}
+
 /**
  * @brief Sets the gradient descent rate used to update an LSTM layer.
  * @param [in] l The layer whose gradient descent rate is to be set.
@@ -155,7 +187,7 @@ set_eta(struct Layer *l)
 static void
 reset_layer_deltas(const struct Layer *l)
 {
-    size_t size = l->n_outputs * sizeof(double);
+    size_t size = l->n_outputs * sizeof(real);
     memset(l->wf->delta, 0, size);
     memset(l->wi->delta, 0, size);
     memset(l->wg->delta, 0, size);
@@ -210,8 +242,7 @@ mutate_neurons(struct Layer *l)
         set_layer_n_weights(l);
         set_layer_n_biases(l);
         set_layer_n_active(l);
-        free_layer_arrays(l);
-        malloc_layer_arrays(l);
+        reset_layer_arrays(l);
         return true;
     }
     return false;
@@ -400,7 +431,7 @@ neural_layer_lstm_rand(struct Layer *l)
  */
 void
 neural_layer_lstm_forward(const struct Layer *l, const struct Net *net,
-                          const double *input)
+                          const real *input)
 {
     layer_forward(l->uf, net, input);
     layer_forward(l->ui, net, input);
@@ -410,27 +441,27 @@ neural_layer_lstm_forward(const struct Layer *l, const struct Net *net,
     layer_forward(l->wi, net, l->h);
     layer_forward(l->wg, net, l->h);
     layer_forward(l->wo, net, l->h);
-    memcpy(l->f, l->wf->output, sizeof(double) * l->n_outputs);
+    memcpy(l->f, l->wf->output, sizeof(real) * l->n_outputs);
     blas_axpy(l->n_outputs, 1, l->uf->output, 1, l->f, 1);
-    memcpy(l->i, l->wi->output, sizeof(double) * l->n_outputs);
+    memcpy(l->i, l->wi->output, sizeof(real) * l->n_outputs);
     blas_axpy(l->n_outputs, 1, l->ui->output, 1, l->i, 1);
-    memcpy(l->g, l->wg->output, sizeof(double) * l->n_outputs);
+    memcpy(l->g, l->wg->output, sizeof(real) * l->n_outputs);
     blas_axpy(l->n_outputs, 1, l->ug->output, 1, l->g, 1);
-    memcpy(l->o, l->wo->output, sizeof(double) * l->n_outputs);
+    memcpy(l->o, l->wo->output, sizeof(real) * l->n_outputs);
     blas_axpy(l->n_outputs, 1, l->uo->output, 1, l->o, 1);
     neural_activate_array(l->f, l->f, l->n_outputs, l->recurrent_function);
     neural_activate_array(l->i, l->i, l->n_outputs, l->recurrent_function);
     neural_activate_array(l->g, l->g, l->n_outputs, l->function);
     neural_activate_array(l->o, l->o, l->n_outputs, l->recurrent_function);
-    memcpy(l->temp, l->i, sizeof(double) * l->n_outputs);
+    memcpy(l->temp, l->i, sizeof(real) * l->n_outputs);
     blas_mul(l->n_outputs, l->g, 1, l->temp, 1);
     blas_mul(l->n_outputs, l->f, 1, l->c, 1);
     blas_axpy(l->n_outputs, 1, l->temp, 1, l->c, 1);
-    memcpy(l->h, l->c, sizeof(double) * l->n_outputs);
+    memcpy(l->h, l->c, sizeof(real) * l->n_outputs);
     neural_activate_array(l->h, l->h, l->n_outputs, l->function);
     blas_mul(l->n_outputs, l->o, 1, l->h, 1);
-    memcpy(l->cell, l->c, sizeof(double) * l->n_outputs);
-    memcpy(l->output, l->h, sizeof(double) * l->n_outputs);
+    memcpy(l->cell, l->c, sizeof(real) * l->n_outputs);
+    memcpy(l->output, l->h, sizeof(real) * l->n_outputs);
 }
 
 /**
@@ -442,48 +473,48 @@ neural_layer_lstm_forward(const struct Layer *l, const struct Net *net,
  */
 void
 neural_layer_lstm_backward(const struct Layer *l, const struct Net *net,
-                           const double *input, double *delta)
+                           const real *input, real *delta)
 {
     reset_layer_deltas(l);
-    memcpy(l->temp3, l->delta, sizeof(double) * l->n_outputs);
-    memcpy(l->temp, l->c, sizeof(double) * l->n_outputs);
+    memcpy(l->temp3, l->delta, sizeof(real) * l->n_outputs);
+    memcpy(l->temp, l->c, sizeof(real) * l->n_outputs);
     neural_activate_array(l->temp, l->temp, l->n_outputs, l->function);
-    memcpy(l->temp2, l->temp3, sizeof(double) * l->n_outputs);
+    memcpy(l->temp2, l->temp3, sizeof(real) * l->n_outputs);
     blas_mul(l->n_outputs, l->o, 1, l->temp2, 1);
     neural_gradient_array(l->temp, l->temp2, l->n_outputs, l->function);
     blas_axpy(l->n_outputs, 1, l->dc, 1, l->temp2, 1);
-    memcpy(l->temp, l->c, sizeof(double) * l->n_outputs);
+    memcpy(l->temp, l->c, sizeof(real) * l->n_outputs);
     neural_activate_array(l->temp, l->temp, l->n_outputs, l->function);
     blas_mul(l->n_outputs, l->temp3, 1, l->temp, 1);
     neural_gradient_array(l->o, l->temp, l->n_outputs, l->recurrent_function);
-    memcpy(l->wo->delta, l->temp, sizeof(double) * l->n_outputs);
+    memcpy(l->wo->delta, l->temp, sizeof(real) * l->n_outputs);
     layer_backward(l->wo, net, l->prev_state, 0);
-    memcpy(l->uo->delta, l->temp, sizeof(double) * l->n_outputs);
+    memcpy(l->uo->delta, l->temp, sizeof(real) * l->n_outputs);
     layer_backward(l->uo, net, input, delta);
-    memcpy(l->temp, l->temp2, sizeof(double) * l->n_outputs);
+    memcpy(l->temp, l->temp2, sizeof(real) * l->n_outputs);
     blas_mul(l->n_outputs, l->i, 1, l->temp, 1);
     neural_gradient_array(l->g, l->temp, l->n_outputs, l->function);
-    memcpy(l->wg->delta, l->temp, sizeof(double) * l->n_outputs);
+    memcpy(l->wg->delta, l->temp, sizeof(real) * l->n_outputs);
     layer_backward(l->wg, net, l->prev_state, 0);
-    memcpy(l->ug->delta, l->temp, sizeof(double) * l->n_outputs);
+    memcpy(l->ug->delta, l->temp, sizeof(real) * l->n_outputs);
     layer_backward(l->ug, net, input, delta);
-    memcpy(l->temp, l->temp2, sizeof(double) * l->n_outputs);
+    memcpy(l->temp, l->temp2, sizeof(real) * l->n_outputs);
     blas_mul(l->n_outputs, l->g, 1, l->temp, 1);
     neural_gradient_array(l->i, l->temp, l->n_outputs, l->recurrent_function);
-    memcpy(l->wi->delta, l->temp, sizeof(double) * l->n_outputs);
+    memcpy(l->wi->delta, l->temp, sizeof(real) * l->n_outputs);
     layer_backward(l->wi, net, l->prev_state, 0);
-    memcpy(l->ui->delta, l->temp, sizeof(double) * l->n_outputs);
+    memcpy(l->ui->delta, l->temp, sizeof(real) * l->n_outputs);
     layer_backward(l->ui, net, input, delta);
-    memcpy(l->temp, l->temp2, sizeof(double) * l->n_outputs);
+    memcpy(l->temp, l->temp2, sizeof(real) * l->n_outputs);
     blas_mul(l->n_outputs, l->prev_cell, 1, l->temp, 1);
     neural_gradient_array(l->f, l->temp, l->n_outputs, l->recurrent_function);
-    memcpy(l->wf->delta, l->temp, sizeof(double) * l->n_outputs);
+    memcpy(l->wf->delta, l->temp, sizeof(real) * l->n_outputs);
     layer_backward(l->wf, net, l->prev_state, 0);
-    memcpy(l->uf->delta, l->temp, sizeof(double) * l->n_outputs);
+    memcpy(l->uf->delta, l->temp, sizeof(real) * l->n_outputs);
     layer_backward(l->uf, net, input, delta);
-    memcpy(l->temp, l->temp2, sizeof(double) * l->n_outputs);
+    memcpy(l->temp, l->temp2, sizeof(real) * l->n_outputs);
     blas_mul(l->n_outputs, l->f, 1, l->temp, 1);
-    memcpy(l->dc, l->temp, sizeof(double) * l->n_outputs);
+    memcpy(l->dc, l->temp, sizeof(real) * l->n_outputs);
 }
 
 /**
@@ -529,7 +560,7 @@ neural_layer_lstm_resize(struct Layer *l, const struct Layer *prev)
  * @param [in] l The layer whose output to return.
  * @return The layer output.
  */
-double *
+real *
 neural_layer_lstm_output(const struct Layer *l)
 {
     return l->output;
@@ -620,19 +651,19 @@ neural_layer_lstm_save(const struct Layer *l, FILE *fp)
     s += fwrite(&l->max_neuron_grow, sizeof(int), 1, fp);
     s += fwrite(&l->options, sizeof(uint32_t), 1, fp);
     s += fwrite(l->mu, sizeof(double), N_MU, fp);
-    s += fwrite(l->state, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->prev_state, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->cell, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->f, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->i, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->g, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->o, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->c, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->h, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->temp, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->temp2, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->temp3, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->dc, sizeof(double), l->n_outputs, fp);
+    s += fwrite(l->state, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->prev_state, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->cell, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->f, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->i, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->g, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->o, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->c, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->h, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->temp, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->temp2, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->temp3, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->dc, sizeof(real), l->n_outputs, fp);
     s += layer_save(l->uf, fp);
     s += layer_save(l->ui, fp);
     s += layer_save(l->ug, fp);
@@ -672,19 +703,19 @@ neural_layer_lstm_load(struct Layer *l, FILE *fp)
     malloc_layer_arrays(l);
     l->mu = malloc(sizeof(double) * N_MU);
     s += fread(l->mu, sizeof(double), N_MU, fp);
-    s += fread(l->state, sizeof(double), l->n_outputs, fp);
-    s += fread(l->prev_state, sizeof(double), l->n_outputs, fp);
-    s += fread(l->cell, sizeof(double), l->n_outputs, fp);
-    s += fread(l->f, sizeof(double), l->n_outputs, fp);
-    s += fread(l->i, sizeof(double), l->n_outputs, fp);
-    s += fread(l->g, sizeof(double), l->n_outputs, fp);
-    s += fread(l->o, sizeof(double), l->n_outputs, fp);
-    s += fread(l->c, sizeof(double), l->n_outputs, fp);
-    s += fread(l->h, sizeof(double), l->n_outputs, fp);
-    s += fread(l->temp, sizeof(double), l->n_outputs, fp);
-    s += fread(l->temp2, sizeof(double), l->n_outputs, fp);
-    s += fread(l->temp3, sizeof(double), l->n_outputs, fp);
-    s += fread(l->dc, sizeof(double), l->n_outputs, fp);
+    s += fread(l->state, sizeof(real), l->n_outputs, fp);
+    s += fread(l->prev_state, sizeof(real), l->n_outputs, fp);
+    s += fread(l->cell, sizeof(real), l->n_outputs, fp);
+    s += fread(l->f, sizeof(real), l->n_outputs, fp);
+    s += fread(l->i, sizeof(real), l->n_outputs, fp);
+    s += fread(l->g, sizeof(real), l->n_outputs, fp);
+    s += fread(l->o, sizeof(real), l->n_outputs, fp);
+    s += fread(l->c, sizeof(real), l->n_outputs, fp);
+    s += fread(l->h, sizeof(real), l->n_outputs, fp);
+    s += fread(l->temp, sizeof(real), l->n_outputs, fp);
+    s += fread(l->temp2, sizeof(real), l->n_outputs, fp);
+    s += fread(l->temp3, sizeof(real), l->n_outputs, fp);
+    s += fread(l->dc, sizeof(real), l->n_outputs, fp);
     s += layer_load(l->uf, fp);
     s += layer_load(l->ui, fp);
     s += layer_load(l->ug, fp);
@@ -695,3 +726,17 @@ neural_layer_lstm_load(struct Layer *l, FILE *fp)
     s += layer_load(l->wo, fp);
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by an LSTM layer.
+ * @param [in] l The layer whose memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+neural_layer_lstm_bytes(const struct Layer *l)
+{
+    return sizeof(struct Layer) + sizeof(real) * 16 * l->n_outputs_alloc +
+        sizeof(double) * N_MU + layer_bytes(l->uf) + layer_bytes(l->ui) +
+        layer_bytes(l->ug) + layer_bytes(l->uo) + layer_bytes(l->wf) +
+        layer_bytes(l->wi) + layer_bytes(l->wg) + layer_bytes(l->wo);
+}
@@ -35,8 +35,8 @@ malloc_layer_arrays(struct Layer *l)
 {
     layer_guard_outputs(l);
     l->indexes = calloc(l->n_outputs, sizeof(int));
-    l->output = calloc(l->n_outputs, sizeof(double));
-    l->delta = calloc(l->n_outputs, sizeof(double));
+    l->output = calloc(l->n_outputs, sizeof(real));
+    l->delta = calloc(l->n_outputs, sizeof(real));
 }
 
 /**
@@ -48,8 +48,8 @@ realloc_layer_arrays(struct Layer *l)
 {
     layer_guard_outputs(l);
     l->indexes = realloc(l->indexes, sizeof(int) * l->n_outputs);
-    l->output = realloc(l->output, sizeof(double) * l->n_outputs);
-    l->delta = realloc(l->delta, sizeof(double) * l->n_outputs);
+    l->output = realloc(l->output, sizeof(real) * l->n_outputs);
+    l->delta = realloc(l->delta, sizeof(real) * l->n_outputs);
 }
 
 /**
@@ -140,12 +140,12 @@ neural_layer_maxpool_rand(struct Layer *l)
  * @return The index of the maximum value.
  */
 static int
-max_pool(const struct Layer *l, const double *input, const int i, const int j,
+max_pool(const struct Layer *l, const real *input, const int i, const int j,
          const int k)
 {
     const int w_offset = -l->pad / 2;
     const int h_offset = w_offset;
-    double max = -DBL_MAX;
+    real max = -FLT_MAX;
     int max_index = -1;
     for (int n = 0; n < l->size; ++n) {
         for (int m = 0; m < l->size; ++m) {
@@ -175,7 +175,7 @@ max_pool(const struct Layer *l, const double *input, const int i, const int j,
  */
 void
 neural_layer_maxpool_forward(const struct Layer *l, const struct Net *net,
-                             const double *input)
+                             const real *input)
 {
     (void) net;
     for (int k = 0; k < l->channels; ++k) {
@@ -201,7 +201,7 @@ neural_layer_maxpool_forward(const struct Layer *l, const struct Net *net,
  */
 void
 neural_layer_maxpool_backward(const struct Layer *l, const struct Net *net,
-                              const double *input, double *delta)
+                              const real *input, real *delta)
 {
     (void) net;
     (void) input;
@@ -262,7 +262,7 @@ neural_layer_maxpool_resize(struct Layer *l, const struct Layer *prev)
  * @param [in] l The layer whose output to return.
  * @return The layer output.
  */
-double *
+real *
 neural_layer_maxpool_output(const struct Layer *l)
 {
     return l->output;
@@ -333,3 +333,15 @@ neural_layer_maxpool_load(struct Layer *l, FILE *fp)
     malloc_layer_arrays(l);
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by a maxpooling layer.
+ * @param [in] l The layer whose memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+neural_layer_maxpool_bytes(const struct Layer *l)
+{
+    return sizeof(struct Layer) + sizeof(real) * 2 * l->n_outputs +
+        sizeof(int) * l->n_outputs;
+}
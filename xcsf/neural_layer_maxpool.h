@@ -36,11 +36,11 @@ neural_layer_maxpool_rand(struct Layer *l);
 
 void
 neural_layer_maxpool_forward(const struct Layer *l, const struct Net *net,
-                             const double *input);
+                             const real *input);
 
 void
 neural_layer_maxpool_backward(const struct Layer *l, const struct Net *net,
-                              const double *input, double *delta);
+                              const real *input, real *delta);
 
 void
 neural_layer_maxpool_update(const struct Layer *l);
@@ -54,7 +54,7 @@ neural_layer_maxpool_mutate(struct Layer *l);
 void
 neural_layer_maxpool_free(const struct Layer *l);
 
-double *
+real *
 neural_layer_maxpool_output(const struct Layer *l);
 
 size_t
@@ -63,6 +63,9 @@ neural_layer_maxpool_save(const struct Layer *l, FILE *fp);
 size_t
 neural_layer_maxpool_load(struct Layer *l, FILE *fp);
 
+size_t
+neural_layer_maxpool_bytes(const struct Layer *l);
+
 void
 neural_layer_maxpool_resize(struct Layer *l, const struct Layer *prev);
 
@@ -76,5 +79,5 @@ static struct LayerVtbl const layer_maxpool_vtbl = {
     &neural_layer_maxpool_print,    &neural_layer_maxpool_update,
     &neural_layer_maxpool_backward, &neural_layer_maxpool_forward,
     &neural_layer_maxpool_output,   &neural_layer_maxpool_save,
-    &neural_layer_maxpool_load
+    &neural_layer_maxpool_load,     &neural_layer_maxpool_bytes
 };
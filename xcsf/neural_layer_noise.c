@@ -33,9 +33,9 @@ static void
 malloc_layer_arrays(struct Layer *l)
 {
     layer_guard_outputs(l);
-    l->output = calloc(l->n_outputs, sizeof(double));
-    l->delta = calloc(l->n_outputs, sizeof(double));
-    l->state = calloc(l->n_outputs, sizeof(double));
+    l->output = calloc(l->n_outputs, sizeof(real));
+    l->delta = calloc(l->n_outputs, sizeof(real));
+    l->state = calloc(l->n_outputs, sizeof(real));
 }
 
 /**
@@ -125,7 +125,7 @@ neural_layer_noise_rand(struct Layer *l)
  */
 void
 neural_layer_noise_forward(const struct Layer *l, const struct Net *net,
-                           const double *input)
+                           const real *input)
 {
     if (!net->train) {
         for (int i = 0; i < l->n_inputs; ++i) {
@@ -152,7 +152,7 @@ neural_layer_noise_forward(const struct Layer *l, const struct Net *net,
  */
 void
 neural_layer_noise_backward(const struct Layer *l, const struct Net *net,
-                            const double *input, double *delta)
+                            const real *input, real *delta)
 {
     (void) net;
     (void) input;
@@ -208,7 +208,7 @@ neural_layer_noise_resize(struct Layer *l, const struct Layer *prev)
  * @param [in] l The layer whose output to return.
  * @return The layer output.
  */
-double *
+real *
 neural_layer_noise_output(const struct Layer *l)
 {
     return l->output;
@@ -269,3 +269,14 @@ neural_layer_noise_load(struct Layer *l, FILE *fp)
     malloc_layer_arrays(l);
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by a noise layer.
+ * @param [in] l The layer whose memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+neural_layer_noise_bytes(const struct Layer *l)
+{
+    return sizeof(struct Layer) + sizeof(real) * 3 * l->n_outputs;
+}
@@ -51,21 +51,27 @@ static void
 malloc_layer_arrays(struct Layer *l)
 {
     layer_guard_outputs(l);
-    l->state = calloc(l->n_outputs, sizeof(double));
-    l->prev_state = calloc(l->n_outputs, sizeof(double));
+    l->n_outputs_alloc = layer_reserve(l, l->n_outputs);
+    l->state = calloc(l->n_outputs_alloc, sizeof(real));
+    l->prev_state = calloc(l->n_outputs_alloc, sizeof(real));
     l->mu = malloc(sizeof(double) * N_MU);
 }
 
 /**
  * @brief Resize memory used by a recurrent layer.
+ * @details Memory is only reallocated if more neurons than reserved are used.
  * @param [in] l The layer to be allocated memory.
  */
 static void
 realloc_layer_arrays(struct Layer *l)
 {
     layer_guard_outputs(l);
-    l->state = realloc(l->state, l->n_outputs * sizeof(double));
-    l->prev_state = realloc(l->prev_state, l->n_outputs * sizeof(double));
+    if (l->n_outputs > l->n_outputs_alloc) {
+        l->n_outputs_alloc = layer_reserve(l, l->n_outputs);
+        const size_t size = sizeof(real) * l->n_outputs_alloc;
+        l->state = realloc(l->state, size);
+        l->prev_state = realloc(l->prev_state, size);
+    }
 }
 
 /**
@@ -295,7 +301,7 @@ neural_layer_recurrent_copy(const struct Layer *src)
     l->delta = l->output_layer->delta;
     malloc_layer_arrays(l);
     memcpy(l->mu, src->mu, sizeof(double) * N_MU);
-    memcpy(l->prev_state, src->prev_state, sizeof(double) * src->n_outputs);
+    memcpy(l->prev_state, src->prev_state, sizeof(real) * src->n_outputs);
     return l;
 }
 
@@ -335,12 +341,12 @@ neural_layer_recurrent_rand(struct Layer *l)
  */
 void
 neural_layer_recurrent_forward(const struct Layer *l, const struct Net *net,
-                               const double *input)
+                               const real *input)
 {
-    memcpy(l->prev_state, l->state, sizeof(double) * l->n_outputs);
+    memcpy(l->prev_state, l->state, sizeof(real) * l->n_outputs);
     layer_forward(l->input_layer, net, input);
     layer_forward(l->self_layer, net, l->output_layer->output);
-    memcpy(l->state, l->input_layer->output, sizeof(double) * l->n_outputs);
+    memcpy(l->state, l->input_layer->output, sizeof(real) * l->n_outputs);
     blas_axpy(l->n_outputs, 1, l->self_layer->output, 1, l->state, 1);
     layer_forward(l->output_layer, net, l->state);
 }
@@ -354,13 +360,13 @@ neural_layer_recurrent_forward(const struct Layer *l, const struct Net *net,
  */
 void
 neural_layer_recurrent_backward(const struct Layer *l, const struct Net *net,
-                                const double *input, double *delta)
+                                const real *input, real *delta)
 {
-    memset(l->input_layer->delta, 0, sizeof(double) * l->n_outputs);
-    memset(l->self_layer->delta, 0, sizeof(double) * l->n_outputs);
+    memset(l->input_layer->delta, 0, sizeof(real) * l->n_outputs);
+    memset(l->self_layer->delta, 0, sizeof(real) * l->n_outputs);
     layer_backward(l->output_layer, net, l->state, l->self_layer->delta);
     memcpy(l->input_layer->delta, l->self_layer->delta,
-           sizeof(double) * l->n_outputs);
+           sizeof(real) * l->n_outputs);
     layer_backward(l->self_layer, net, l->prev_state, 0);
     layer_backward(l->input_layer, net, input, delta);
 }
@@ -398,7 +404,7 @@ neural_layer_recurrent_resize(struct Layer *l, const struct Layer *prev)
  * @param [in] l The layer whose output to return.
  * @return The layer output.
  */
-double *
+real *
 neural_layer_recurrent_output(const struct Layer *l)
 {
     return l->output;
@@ -462,8 +468,8 @@ neural_layer_recurrent_save(const struct Layer *l, FILE *fp)
     s += fwrite(&l->eta, sizeof(double), 1, fp);
     s += fwrite(&l->n_active, sizeof(int), 1, fp);
     s += fwrite(l->mu, sizeof(double), N_MU, fp);
-    s += fwrite(l->state, sizeof(double), l->n_outputs, fp);
-    s += fwrite(l->prev_state, sizeof(double), l->n_outputs, fp);
+    s += fwrite(l->state, sizeof(real), l->n_outputs, fp);
+    s += fwrite(l->prev_state, sizeof(real), l->n_outputs, fp);
     s += layer_save(l->input_layer, fp);
     s += layer_save(l->self_layer, fp);
     s += layer_save(l->output_layer, fp);
@@ -492,10 +498,23 @@ neural_layer_recurrent_load(struct Layer *l, FILE *fp)
     l->out_h = 1;
     malloc_layer_arrays(l);
     s += fread(l->mu, sizeof(double), N_MU, fp);
-    s += fread(l->state, sizeof(double), l->n_outputs, fp);
-    s += fread(l->prev_state, sizeof(double), l->n_outputs, fp);
+    s += fread(l->state, sizeof(real), l->n_outputs, fp);
+    s += fread(l->prev_state, sizeof(real), l->n_outputs, fp);
     s += layer_load(l->input_layer, fp);
     s += layer_load(l->self_layer, fp);
     s += layer_load(l->output_layer, fp);
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by a recurrent layer.
+ * @param [in] l The layer whose memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+neural_layer_recurrent_bytes(const struct Layer *l)
+{
+    return sizeof(struct Layer) + sizeof(real) * 2 * l->n_outputs_alloc +
+        sizeof(double) * N_MU + layer_bytes(l->input_layer) +
+        layer_bytes(l->self_layer) + layer_bytes(l->output_layer);
+}
@@ -33,8 +33,8 @@ static void
 malloc_layer_arrays(struct Layer *l)
 {
     layer_guard_outputs(l);
-    l->output = calloc(l->n_outputs, sizeof(double));
-    l->delta = calloc(l->n_outputs, sizeof(double));
+    l->output = calloc(l->n_outputs, sizeof(real));
+    l->delta = calloc(l->n_outputs, sizeof(real));
 }
 
 /**
@@ -111,18 +111,18 @@ neural_layer_softmax_rand(struct Layer *l)
  */
 void
 neural_layer_softmax_forward(const struct Layer *l, const struct Net *net,
-                             const double *input)
+                             const real *input)
 {
     (void) net;
-    double largest = input[0];
+    real largest = input[0];
     for (int i = 1; i < l->n_inputs; ++i) {
         if (input[i] > largest) {
             largest = input[i];
         }
     }
-    double sum = 0;
+    real sum = 0;
     for (int i = 0; i < l->n_inputs; ++i) {
-        const double e = exp((input[i] / l->scale) - (largest / l->scale));
+        const real e = exp((input[i] / l->scale) - (largest / l->scale));
         sum += e;
         l->output[i] = e;
     }
@@ -140,7 +140,7 @@ neural_layer_softmax_forward(const struct Layer *l, const struct Net *net,
  */
 void
 neural_layer_softmax_backward(const struct Layer *l, const struct Net *net,
-                              const double *input, double *delta)
+                              const real *input, real *delta)
 {
     (void) net;
     (void) input;
@@ -219,7 +219,7 @@ neural_layer_softmax_free(const struct Layer *l)
  * @param [in] l The layer whose output to return.
  * @return The layer output.
  */
-double *
+real *
 neural_layer_softmax_output(const struct Layer *l)
 {
     return l->output;
@@ -262,3 +262,14 @@ neural_layer_softmax_load(struct Layer *l, FILE *fp)
     malloc_layer_arrays(l);
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by a softmax layer.
+ * @param [in] l The layer whose memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+neural_layer_softmax_bytes(const struct Layer *l)
+{
+    return sizeof(struct Layer) + sizeof(real) * 2 * l->n_outputs;
+}
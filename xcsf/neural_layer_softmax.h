@@ -36,10 +36,10 @@ neural_layer_softmax_rand(struct Layer *l);
 
 void
 neural_layer_softmax_forward(const struct Layer *l, const struct Net *net,
-                             const double *input);
+                             const real *input);
 void
 neural_layer_softmax_backward(const struct Layer *l, const struct Net *net,
-                              const double *input, double *delta);
+                              const real *input, real *delta);
 
 void
 neural_layer_softmax_update(const struct Layer *l);
@@ -53,7 +53,7 @@ neural_layer_softmax_mutate(struct Layer *l);
 void
 neural_layer_softmax_free(const struct Layer *l);
 
-double *
+real *
 neural_layer_softmax_output(const struct Layer *l);
 
 size_t
@@ -62,6 +62,9 @@ neural_layer_softmax_save(const struct Layer *l, FILE *fp);
 size_t
 neural_layer_softmax_load(struct Layer *l, FILE *fp);
 
+size_t
+neural_layer_softmax_bytes(const struct Layer *l);
+
 void
 neural_layer_softmax_resize(struct Layer *l, const struct Layer *prev);
 
@@ -75,5 +78,5 @@ static struct LayerVtbl const layer_softmax_vtbl = {
     &neural_layer_softmax_print,    &neural_layer_softmax_update,
     &neural_layer_softmax_backward, &neural_layer_softmax_forward,
     &neural_layer_softmax_output,   &neural_layer_softmax_save,
-    &neural_layer_softmax_load
+    &neural_layer_softmax_load,     &neural_layer_softmax_bytes
 };
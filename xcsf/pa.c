@@ -23,6 +23,9 @@
 
 #include "pa.h"
 #include "cl.h"
+#include "clset.h"
+#include "pipeline.h"
+#include "profile.h"
 #include "utils.h"
 
 /**
@@ -60,43 +63,25 @@ pa_init(struct XCSF *xcsf)
 void
 pa_build(const struct XCSF *xcsf, const double *x)
 {
+    PROFILE_START(PROF_PA_BUILD);
     const struct Set *set = &xcsf->mset;
     double *pa = xcsf->pa;
     double *nr = xcsf->nr;
     pa_reset(xcsf);
-#ifdef PARALLEL_PRED
-    struct Cl *clist[set->size];
-    struct Clist *iter = set->list;
-    for (int i = 0; i < set->size; ++i) {
-        clist[i] = NULL;
-        if (iter != NULL) {
-            clist[i] = iter->cl;
-            iter = iter->next;
-        }
-    }
-    #pragma omp parallel for reduction(+ : pa[:xcsf->pa_size], nr[:xcsf->pa_size])
-    for (int i = 0; i < set->size; ++i) {
-        if (clist[i] != NULL) {
-            const double *pred = cl_predict(xcsf, clist[i], x);
+    if (set->size > 0) {
+        struct Cl *clist[set->size];
+        const int n = clset_to_array(set, clist);
+        pipeline_predict(xcsf, clist, n, x);
+        for (int i = 0; i < n; ++i) {
+            const double *pred = clist[i]->prediction;
             const double fitness = clist[i]->fit;
+            const int offset = clist[i]->action * xcsf->y_dim;
             for (int j = 0; j < xcsf->y_dim; ++j) {
-                pa[clist[i]->action * xcsf->y_dim + j] += pred[j] * fitness;
-                nr[clist[i]->action * xcsf->y_dim + j] += fitness;
+                pa[offset + j] += pred[j] * fitness;
+                nr[offset + j] += fitness;
             }
         }
     }
-#else
-    const struct Clist *iter = set->list;
-    while (iter != NULL) {
-        const double *pred = cl_predict(xcsf, iter->cl, x);
-        const double fitness = iter->cl->fit;
-        for (int j = 0; j < xcsf->y_dim; ++j) {
-            pa[iter->cl->action * xcsf->y_dim + j] += pred[j] * fitness;
-            nr[iter->cl->action * xcsf->y_dim + j] += fitness;
-        }
-        iter = iter->next;
-    }
-#endif
     for (int i = 0; i < xcsf->n_actions; ++i) {
         for (int j = 0; j < xcsf->y_dim; ++j) {
             const int k = i * xcsf->y_dim + j;
@@ -107,6 +92,7 @@ pa_build(const struct XCSF *xcsf, const double *x)
             }
         }
     }
+    PROFILE_STOP(PROF_PA_BUILD);
 }
 
 /**
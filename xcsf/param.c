@@ -23,8 +23,11 @@
 
 #include "param.h"
 #include "action.h"
+#include "checkpoint.h"
 #include "condition.h"
 #include "ea.h"
+#include "metrics.h"
+#include "pipeline.h"
 #include "prediction.h"
 
 #ifdef PARALLEL
@@ -42,6 +45,10 @@ param_defaults_general(struct XCSF *xcsf)
     param_set_pop_init(xcsf, true);
     param_set_max_trials(xcsf, 100000);
     param_set_perf_trials(xcsf, 1000);
+    param_set_checkpoint_trials(xcsf, 0);
+    param_set_checkpoint_file(xcsf, "checkpoint.xcsf");
+    param_set_metrics_format(xcsf, METRICS_NONE);
+    param_set_metrics_file(xcsf, "metrics.log");
     param_set_pop_size(xcsf, 2000);
     param_set_loss_func(xcsf, LOSS_MAE);
     param_set_huber_delta(xcsf, 1);
@@ -59,6 +66,15 @@ param_print_general(const struct XCSF *xcsf)
     xcsf->POP_INIT ? printf("true") : printf("false");
     printf(", MAX_TRIALS=%d", xcsf->MAX_TRIALS);
     printf(", PERF_TRIALS=%d", xcsf->PERF_TRIALS);
+    printf(", CHECKPOINT_TRIALS=%d", xcsf->CHECKPOINT_TRIALS);
+    if (xcsf->CHECKPOINT_TRIALS > 0) {
+        printf(", CHECKPOINT_FILE=%s", xcsf->CHECKPOINT_FILE);
+    }
+    printf(", METRICS_FORMAT=%s",
+           metrics_format_as_string(xcsf->METRICS_FORMAT));
+    if (xcsf->METRICS_FORMAT != METRICS_NONE) {
+        printf(", METRICS_FILE=%s", xcsf->METRICS_FILE);
+    }
     printf(", POP_SIZE=%d", xcsf->POP_SIZE);
     printf(", LOSS_FUNC=%s", loss_type_as_string(xcsf->LOSS_FUNC));
     if (xcsf->LOSS_FUNC == LOSS_HUBER) {
@@ -318,14 +334,23 @@ param_init(struct XCSF *xcsf, const int x_dim, const int y_dim,
            const int n_actions)
 {
     xcsf->time = 0;
+    xcsf->load_build = VERSION_BUILD;
     xcsf->error = xcsf->E0;
     xcsf->mset_size = 0;
     xcsf->aset_size = 0;
     xcsf->mfrac = 0;
-    xcsf->ea = malloc(sizeof(struct ArgsEA));
-    xcsf->act = malloc(sizeof(struct ArgsAct));
-    xcsf->cond = malloc(sizeof(struct ArgsCond));
-    xcsf->pred = malloc(sizeof(struct ArgsPred));
+    xcsf->n_covered = 0;
+    xcsf->n_ea = 0;
+    xcsf->checkpoint = NULL;
+    xcsf->metrics = NULL;
+    xcsf->perf_ptr = NULL;
+    xcsf->perf_data = NULL;
+    xcsf->CHECKPOINT_FILE = NULL;
+    xcsf->METRICS_FILE = NULL;
+    xcsf->ea = calloc(1, sizeof(struct ArgsEA));
+    xcsf->act = calloc(1, sizeof(struct ArgsAct));
+    xcsf->cond = calloc(1, sizeof(struct ArgsCond));
+    xcsf->pred = calloc(1, sizeof(struct ArgsPred));
     param_set_n_actions(xcsf, n_actions);
     param_set_x_dim(xcsf, x_dim);
     param_set_y_dim(xcsf, y_dim);
@@ -337,11 +362,16 @@ param_init(struct XCSF *xcsf, const int x_dim, const int y_dim,
     action_param_defaults(xcsf);
     cond_param_defaults(xcsf);
     pred_param_defaults(xcsf);
+    pipeline_set(xcsf);
 }
 
 void
 param_free(struct XCSF *xcsf)
 {
+    checkpoint_free(xcsf);
+    free(xcsf->CHECKPOINT_FILE);
+    metrics_free(xcsf);
+    free(xcsf->METRICS_FILE);
     action_param_free(xcsf);
     cond_param_free(xcsf);
     pred_param_free(xcsf);
@@ -443,6 +473,7 @@ param_load(struct XCSF *xcsf, FILE *fp)
     s += action_param_load(xcsf, fp);
     s += cond_param_load(xcsf, fp);
     s += pred_param_load(xcsf, fp);
+    pipeline_set(xcsf);
     return s;
 }
 
@@ -498,6 +529,57 @@ param_set_perf_trials(struct XCSF *xcsf, const int a)
     }
 }
 
+void
+param_set_checkpoint_trials(struct XCSF *xcsf, const int a)
+{
+    if (a < 0) {
+        printf("Warning: tried to set CHECKPOINT_TRIALS too small\n");
+        xcsf->CHECKPOINT_TRIALS = 0;
+    } else {
+        xcsf->CHECKPOINT_TRIALS = a;
+    }
+}
+
+void
+param_set_checkpoint_file(struct XCSF *xcsf, const char *a)
+{
+    free(xcsf->CHECKPOINT_FILE);
+    const size_t len = strlen(a);
+    xcsf->CHECKPOINT_FILE = malloc(len + 1);
+    memcpy(xcsf->CHECKPOINT_FILE, a, len);
+    xcsf->CHECKPOINT_FILE[len] = '\0';
+}
+
+void
+param_set_metrics_format_string(struct XCSF *xcsf, const char *a)
+{
+    xcsf->METRICS_FORMAT = metrics_format_as_int(a);
+}
+
+void
+param_set_metrics_format(struct XCSF *xcsf, const int a)
+{
+    if (a < 0) {
+        printf("Warning: tried to set METRICS_FORMAT too small\n");
+        xcsf->METRICS_FORMAT = 0;
+    } else if (a >= METRICS_NUM) {
+        printf("Warning: tried to set METRICS_FORMAT too large\n");
+        xcsf->METRICS_FORMAT = METRICS_NUM - 1;
+    } else {
+        xcsf->METRICS_FORMAT = a;
+    }
+}
+
+void
+param_set_metrics_file(struct XCSF *xcsf, const char *a)
+{
+    free(xcsf->METRICS_FILE);
+    const size_t len = strlen(a);
+    xcsf->METRICS_FILE = malloc(len + 1);
+    memcpy(xcsf->METRICS_FILE, a, len);
+    xcsf->METRICS_FILE[len] = '\0';
+}
+
 void
 param_set_pop_size(struct XCSF *xcsf, const int a)
 {
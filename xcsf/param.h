@@ -56,6 +56,21 @@ param_set_max_trials(struct XCSF *xcsf, const int a);
 void
 param_set_perf_trials(struct XCSF *xcsf, const int a);
 
+void
+param_set_checkpoint_trials(struct XCSF *xcsf, const int a);
+
+void
+param_set_checkpoint_file(struct XCSF *xcsf, const char *a);
+
+void
+param_set_metrics_format_string(struct XCSF *xcsf, const char *a);
+
+void
+param_set_metrics_format(struct XCSF *xcsf, const int a);
+
+void
+param_set_metrics_file(struct XCSF *xcsf, const char *a);
+
 void
 param_set_pop_size(struct XCSF *xcsf, const int a);
 
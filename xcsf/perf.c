@@ -22,24 +22,38 @@
  */
 
 #include "perf.h"
+#include "metrics.h"
 
 /**
- * @brief Displays the current training and test performance.
+ * @brief Reports the current training and test performance.
+ * @details Performance is appended to the performance log if one is open,
+ * then passed to the performance callback if one is set and displayed
+ * otherwise.
  * @param [in] xcsf The XCSF data structure.
  * @param [in] error The current training error.
  * @param [in] terror The current testing error.
  * @param [in] trial The number of learning trials executed.
+ * @return Whether the callback requested the experiment to stop.
  */
-void
+bool
 perf_print(const struct XCSF *xcsf, double *error, double *terror,
            const int trial)
 {
+    bool stop = false;
     if (trial % xcsf->PERF_TRIALS == 0 && trial > 0) {
         *error /= xcsf->PERF_TRIALS;
         *terror /= xcsf->PERF_TRIALS;
-        printf("%d %.5f %.5f %d\n", trial, *error, *terror, xcsf->pset.size);
-        fflush(stdout);
+        metrics_report(xcsf, trial, *error, *terror);
+        if (xcsf->perf_ptr != NULL) {
+            stop = (xcsf->perf_ptr)(xcsf, xcsf->perf_data, trial, *error,
+                                    *terror);
+        } else {
+            printf("%d %.5f %.5f %d\n", trial, *error, *terror,
+                   xcsf->pset.size);
+            fflush(stdout);
+        }
         *error = 0;
         *terror = 0;
     }
+    return stop;
 }
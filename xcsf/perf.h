@@ -25,6 +25,6 @@
 
 #include "xcsf.h"
 
-void
+bool
 perf_print(const struct XCSF *xcsf, double *error, double *terror,
            const int trial);
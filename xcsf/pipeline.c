@@ -0,0 +1,401 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file pipeline.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Set-level trial pipelines specialised per representation.
+ * @details The generic pipeline dispatches every classifier operation through
+ * the condition, prediction, and action vtables. For the common fixed-length
+ * representation combinations a specialised pipeline is instantiated at
+ * compile-time that calls the implementations directly, allowing them to be
+ * inlined into the set loops. The pipeline is selected whenever the
+ * condition, prediction, or action type is set. Classifiers whose functions
+ * do not match the specialisation are processed via their vtables. Neural
+ * network conditions and predictions are evaluated with a pipeline that
+ * computes the input layers of all networks in the set as a single batch.
+ */
+
+#include "pipeline.h"
+#include "act_integer.h"
+#include "action.h"
+#include "cl.h"
+#include "cond_ellipsoid.h"
+#include "cond_neural.h"
+#include "cond_rectangle.h"
+#include "cond_ternary.h"
+#include "condition.h"
+#include "pred_constant.h"
+#include "pred_neural.h"
+#include "pred_nlms.h"
+#include "pred_rls.h"
+#include "prediction.h"
+
+#ifdef PARALLEL_MATCH
+    #define PIPELINE_OMP_MATCH _Pragma("omp parallel for")
+#else
+    #define PIPELINE_OMP_MATCH
+#endif
+
+#ifdef PARALLEL_PRED
+    #define PIPELINE_OMP_PRED _Pragma("omp parallel for")
+#else
+    #define PIPELINE_OMP_PRED
+#endif
+
+#ifdef PARALLEL_UPDATE
+    #define PIPELINE_OMP_UPDATE _Pragma("omp parallel for")
+#else
+    #define PIPELINE_OMP_UPDATE
+#endif
+
+/**
+ * @brief Generic matching via the classifier vtables.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] clist The classifiers to process.
+ * @param [in] n The number of classifiers.
+ * @param [in] x The input state.
+ */
+static void
+pipeline_generic_match(const struct XCSF *xcsf, struct Cl **clist,
+                       const int n, const double *x)
+{
+    PIPELINE_OMP_MATCH
+    for (int i = 0; i < n; ++i) {
+        if (cl_match(xcsf, clist[i], x)) {
+            cl_action(xcsf, clist[i], x);
+        }
+    }
+}
+
+/**
+ * @brief Generic prediction via the classifier vtables.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] clist The classifiers to process.
+ * @param [in] n The number of classifiers.
+ * @param [in] x The input state.
+ */
+static void
+pipeline_generic_predict(const struct XCSF *xcsf, struct Cl **clist,
+                         const int n, const double *x)
+{
+    PIPELINE_OMP_PRED
+    for (int i = 0; i < n; ++i) {
+        cl_predict(xcsf, clist[i], x);
+    }
+}
+
+/**
+ * @brief Generic updating via the classifier vtables.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] clist The classifiers to process.
+ * @param [in] n The number of classifiers.
+ * @param [in] x The input state.
+ * @param [in] y The true (payoff) value.
+ * @param [in] set_num The number of micro-classifiers in the set.
+ * @param [in] cur Whether the payoff is for the current or previous state.
+ */
+static void
+pipeline_generic_update(const struct XCSF *xcsf, struct Cl **clist,
+                        const int n, const double *x, const double *y,
+                        const int set_num, const bool cur)
+{
+    PIPELINE_OMP_UPDATE
+    for (int i = 0; i < n; ++i) {
+        cl_update(xcsf, clist[i], x, y, set_num, cur);
+    }
+}
+
+static const struct PipelineVtbl pipeline_generic_vtbl = {
+    &pipeline_generic_match, &pipeline_generic_predict,
+    &pipeline_generic_update
+};
+
+/**
+ * @brief Matching with batched neural network conditions.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] clist The classifiers to process.
+ * @param [in] n The number of classifiers.
+ * @param [in] x The input state.
+ */
+static void
+pipeline_neural_match(const struct XCSF *xcsf, struct Cl **clist, const int n,
+                      const double *x)
+{
+    struct Cl *batch[n];
+    int n_batch = 0;
+    for (int i = 0; i < n; ++i) {
+        if (clist[i]->cond_vptr->cond_impl_match == &cond_neural_match) {
+            batch[n_batch] = clist[i];
+            ++n_batch;
+        }
+    }
+    cond_neural_forward_batch(xcsf, batch, n_batch, x);
+    PIPELINE_OMP_MATCH
+    for (int i = 0; i < n; ++i) {
+        struct Cl *c = clist[i];
+        if (c->cond_vptr->cond_impl_match != &cond_neural_match) {
+            if (cl_match(xcsf, c, x)) {
+                cl_action(xcsf, c, x);
+            }
+            continue;
+        }
+        c->m = cond_neural_match_batched(xcsf, c, x);
+        ++(c->age);
+        if (c->m) {
+            ++(c->mtotal);
+            cl_action(xcsf, c, x);
+        }
+    }
+}
+
+/**
+ * @brief Prediction with batched neural network predictions.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] clist The classifiers to process.
+ * @param [in] n The number of classifiers.
+ * @param [in] x The input state.
+ */
+static void
+pipeline_neural_predict(const struct XCSF *xcsf, struct Cl **clist,
+                        const int n, const double *x)
+{
+    struct Cl *batch[n];
+    int n_batch = 0;
+    for (int i = 0; i < n; ++i) {
+        if (clist[i]->pred_vptr->pred_impl_compute == &pred_neural_compute) {
+            batch[n_batch] = clist[i];
+            ++n_batch;
+        }
+    }
+    pred_neural_forward_batch(xcsf, batch, n_batch, x);
+    PIPELINE_OMP_PRED
+    for (int i = 0; i < n; ++i) {
+        struct Cl *c = clist[i];
+        if (c->pred_vptr->pred_impl_compute == &pred_neural_compute) {
+            pred_neural_compute_batched(xcsf, c, x);
+        } else {
+            cl_predict(xcsf, c, x);
+        }
+    }
+}
+
+static const struct PipelineVtbl pipeline_neural_vtbl = {
+    &pipeline_neural_match, &pipeline_neural_predict, &pipeline_generic_update
+};
+
+/**
+ * @brief Instantiates a pipeline for an integer action representation.
+ * @param NAME The name of the pipeline.
+ * @param COND The prefix of the condition implementation functions.
+ * @param PRED The prefix of the prediction implementation functions.
+ */
+#define PIPELINE_DEFINE(NAME, COND, PRED)                                      \
+    static inline bool pipeline_##NAME##_direct(const struct Cl *c)            \
+    {                                                                          \
+        return c->cond_vptr->cond_impl_match == &COND##_match &&               \
+            c->pred_vptr->pred_impl_compute == &PRED##_compute &&              \
+            c->act_vptr->act_impl_compute == &act_integer_compute;             \
+    }                                                                          \
+                                                                               \
+    static void pipeline_##NAME##_match(const struct XCSF *xcsf,               \
+                                        struct Cl **clist, const int n,        \
+                                        const double *x)                       \
+    {                                                                          \
+        PIPELINE_OMP_MATCH                                                     \
+        for (int i = 0; i < n; ++i) {                                          \
+            struct Cl *c = clist[i];                                           \
+            if (!pipeline_##NAME##_direct(c)) {                                \
+                if (cl_match(xcsf, c, x)) {                                    \
+                    cl_action(xcsf, c, x);                                     \
+                }                                                              \
+                continue;                                                      \
+            }                                                                  \
+            c->m = COND##_match(xcsf, c, x);                                   \
+            ++(c->age);                                                        \
+            if (c->m) {                                                        \
+                ++(c->mtotal);                                                 \
+                c->action = act_integer_compute(xcsf, c, x);                   \
+            }                                                                  \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    static void pipeline_##NAME##_predict(const struct XCSF *xcsf,             \
+                                          struct Cl **clist, const int n,      \
+                                          const double *x)                     \
+    {                                                                          \
+        PIPELINE_OMP_PRED                                                      \
+        for (int i = 0; i < n; ++i) {                                          \
+            struct Cl *c = clist[i];                                           \
+            if (pipeline_##NAME##_direct(c)) {                                 \
+                PRED##_compute(xcsf, c, x);                                    \
+            } else {                                                           \
+                cl_predict(xcsf, c, x);                                        \
+            }                                                                  \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    static void pipeline_##NAME##_update(                                      \
+        const struct XCSF *xcsf, struct Cl **clist, const int n,               \
+        const double *x, const double *y, const int set_num, const bool cur)   \
+    {                                                                          \
+        PIPELINE_OMP_UPDATE                                                    \
+        for (int i = 0; i < n; ++i) {                                          \
+            struct Cl *c = clist[i];                                           \
+            if (!pipeline_##NAME##_direct(c)) {                                \
+                cl_update(xcsf, c, x, y, set_num, cur);                        \
+                continue;                                                      \
+            }                                                                  \
+            cl_unshare(xcsf, c);                                               \
+            if (!cur) {                                                        \
+                PRED##_compute(xcsf, c, x);                                    \
+            }                                                                  \
+            cl_update_err_size(xcsf, c, y, set_num);                           \
+            COND##_update(xcsf, c, x, y);                                      \
+            PRED##_update(xcsf, c, x, y);                                      \
+            act_integer_update(xcsf, c, x, y);                                 \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    static const struct PipelineVtbl pipeline_##NAME##_vtbl = {                \
+        &pipeline_##NAME##_match, &pipeline_##NAME##_predict,                  \
+        &pipeline_##NAME##_update                                              \
+    };
+
+PIPELINE_DEFINE(rectangle_constant, cond_rectangle, pred_constant)
+PIPELINE_DEFINE(rectangle_nlms, cond_rectangle, pred_nlms)
+PIPELINE_DEFINE(rectangle_rls, cond_rectangle, pred_rls)
+PIPELINE_DEFINE(ellipsoid_constant, cond_ellipsoid, pred_constant)
+PIPELINE_DEFINE(ellipsoid_nlms, cond_ellipsoid, pred_nlms)
+PIPELINE_DEFINE(ellipsoid_rls, cond_ellipsoid, pred_rls)
+PIPELINE_DEFINE(ternary_constant, cond_ternary, pred_constant)
+PIPELINE_DEFINE(ternary_nlms, cond_ternary, pred_nlms)
+PIPELINE_DEFINE(ternary_rls, cond_ternary, pred_rls)
+
+/**
+ * @brief Returns the prediction column index of a specialised pipeline.
+ * @param [in] type The prediction type.
+ * @return The column index, or -1 if no specialisation exists.
+ */
+static int
+pipeline_pred_index(const int type)
+{
+    switch (type) {
+        case PRED_TYPE_CONSTANT:
+            return 0;
+        case PRED_TYPE_NLMS_LINEAR:
+        case PRED_TYPE_NLMS_QUADRATIC:
+            return 1;
+        case PRED_TYPE_RLS_LINEAR:
+        case PRED_TYPE_RLS_QUADRATIC:
+            return 2;
+        default:
+            return -1;
+    }
+}
+
+/**
+ * @brief Returns the condition row index of a specialised pipeline.
+ * @param [in] type The condition type.
+ * @return The row index, or -1 if no specialisation exists.
+ */
+static int
+pipeline_cond_index(const int type)
+{
+    switch (type) {
+        case COND_TYPE_HYPERRECTANGLE:
+            return 0;
+        case COND_TYPE_HYPERELLIPSOID:
+            return 1;
+        case COND_TYPE_TERNARY:
+            return 2;
+        default:
+            return -1;
+    }
+}
+
+/**
+ * @brief Specialised pipelines indexed by condition and prediction.
+ */
+static const struct PipelineVtbl *const pipeline_table[3][3] = {
+    { &pipeline_rectangle_constant_vtbl, &pipeline_rectangle_nlms_vtbl,
+      &pipeline_rectangle_rls_vtbl },
+    { &pipeline_ellipsoid_constant_vtbl, &pipeline_ellipsoid_nlms_vtbl,
+      &pipeline_ellipsoid_rls_vtbl },
+    { &pipeline_ternary_constant_vtbl, &pipeline_ternary_nlms_vtbl,
+      &pipeline_ternary_rls_vtbl },
+};
+
+/**
+ * @brief Names of the specialised pipelines.
+ */
+static const char *const pipeline_names[3][3] = {
+    { "rectangle-constant", "rectangle-nlms", "rectangle-rls" },
+    { "ellipsoid-constant", "ellipsoid-nlms", "ellipsoid-rls" },
+    { "ternary-constant", "ternary-nlms", "ternary-rls" },
+};
+
+/**
+ * @brief Selects the set-level pipeline for the current representation.
+ * @details The batched neural pipeline is chosen for neural network conditions
+ * or predictions. Otherwise a specialised pipeline is chosen if one has been
+ * instantiated for the condition and prediction types with integer actions,
+ * falling back to the generic vtable pipeline.
+ * @param [in] xcsf The XCSF data structure.
+ */
+void
+pipeline_set(struct XCSF *xcsf)
+{
+    xcsf->pipe_vptr = &pipeline_generic_vtbl;
+    if (xcsf->act == NULL || xcsf->cond == NULL || xcsf->pred == NULL) {
+        return;
+    }
+    if (xcsf->cond->type == COND_TYPE_NEURAL ||
+        xcsf->pred->type == PRED_TYPE_NEURAL) {
+        xcsf->pipe_vptr = &pipeline_neural_vtbl;
+        return;
+    }
+    if (xcsf->act->type != ACT_TYPE_INTEGER) {
+        return;
+    }
+    const int i = pipeline_cond_index(xcsf->cond->type);
+    const int j = pipeline_pred_index(xcsf->pred->type);
+    if (i >= 0 && j >= 0) {
+        xcsf->pipe_vptr = pipeline_table[i][j];
+    }
+}
+
+/**
+ * @brief Returns the name of the currently selected pipeline.
+ * @param [in] xcsf The XCSF data structure.
+ * @return String representing the name of the pipeline.
+ */
+const char *
+pipeline_name(const struct XCSF *xcsf)
+{
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            if (xcsf->pipe_vptr == pipeline_table[i][j]) {
+                return pipeline_names[i][j];
+            }
+        }
+    }
+    if (xcsf->pipe_vptr == &pipeline_neural_vtbl) {
+        return "neural";
+    }
+    return "generic";
+}
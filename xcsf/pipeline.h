@@ -0,0 +1,98 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file pipeline.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Set-level trial pipelines specialised per representation.
+ */
+
+#pragma once
+
+#include "xcsf.h"
+
+/**
+ * @brief Set-level pipeline interface for matching, predicting and updating.
+ * @details Each implementation processes an array of classifiers in a single
+ * call so that representation-specific functions can be called directly
+ * rather than through the per-classifier vtables.
+ */
+struct PipelineVtbl {
+    void (*pipeline_impl_match)(const struct XCSF *xcsf, struct Cl **clist,
+                                const int n, const double *x);
+    void (*pipeline_impl_predict)(const struct XCSF *xcsf, struct Cl **clist,
+                                  const int n, const double *x);
+    void (*pipeline_impl_update)(const struct XCSF *xcsf, struct Cl **clist,
+                                 const int n, const double *x,
+                                 const double *y, const int set_num,
+                                 const bool cur);
+};
+
+void
+pipeline_set(struct XCSF *xcsf);
+
+const char *
+pipeline_name(const struct XCSF *xcsf);
+
+/**
+ * @brief Processes the matching conditions and actions of classifiers.
+ * @details Sets the match flag of each classifier and the action of each
+ * matching classifier.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] clist The classifiers to process.
+ * @param [in] n The number of classifiers.
+ * @param [in] x The input state.
+ */
+static inline void
+pipeline_match(const struct XCSF *xcsf, struct Cl **clist, const int n,
+               const double *x)
+{
+    (*xcsf->pipe_vptr->pipeline_impl_match)(xcsf, clist, n, x);
+}
+
+/**
+ * @brief Computes the predictions of classifiers.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] clist The classifiers to process.
+ * @param [in] n The number of classifiers.
+ * @param [in] x The input state.
+ */
+static inline void
+pipeline_predict(const struct XCSF *xcsf, struct Cl **clist, const int n,
+                 const double *x)
+{
+    (*xcsf->pipe_vptr->pipeline_impl_predict)(xcsf, clist, n, x);
+}
+
+/**
+ * @brief Updates classifiers with the target payoff.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] clist The classifiers to process.
+ * @param [in] n The number of classifiers.
+ * @param [in] x The input state.
+ * @param [in] y The true (payoff) value.
+ * @param [in] set_num The number of micro-classifiers in the set.
+ * @param [in] cur Whether the payoff is for the current or previous state.
+ */
+static inline void
+pipeline_update(const struct XCSF *xcsf, struct Cl **clist, const int n,
+                const double *x, const double *y, const int set_num,
+                const bool cur)
+{
+    (*xcsf->pipe_vptr->pipeline_impl_update)(xcsf, clist, n, x, y, set_num,
+                                             cur);
+}
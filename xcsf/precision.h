@@ -0,0 +1,36 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file precision.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Floating point precision used for storage and computation.
+ * @details Hyperrectangle and hyperellipsoid conditions, NLMS predictions,
+ * neural networks, and the linear algebra routines store and compute values
+ * using the real type. Building with SINGLE_PRECISION defined selects 32-bit
+ * floats; otherwise doubles are used. Accumulations that are sensitive to
+ * rounding, such as dot products and recursive least squares, are performed
+ * with double precision in both cases.
+ */
+
+#pragma once
+
+#ifdef SINGLE_PRECISION
+typedef float real; //!< Working floating point type
+#else
+typedef double real; //!< Working floating point type
+#endif
@@ -39,6 +39,9 @@ pred_constant_size(const struct XCSF *xcsf, const struct Cl *c);
 size_t
 pred_constant_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
 
+size_t
+pred_constant_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
 size_t
 pred_constant_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp);
 
@@ -70,5 +73,5 @@ static struct PredVtbl const pred_constant_vtbl = {
     &pred_constant_crossover, &pred_constant_mutate, &pred_constant_compute,
     &pred_constant_copy,      &pred_constant_free,   &pred_constant_init,
     &pred_constant_print,     &pred_constant_update, &pred_constant_size,
-    &pred_constant_save,      &pred_constant_load
+    &pred_constant_save,      &pred_constant_load,   &pred_constant_bytes
 };
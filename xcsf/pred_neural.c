@@ -90,9 +90,8 @@ void
 pred_neural_update(const struct XCSF *xcsf, const struct Cl *c, const double *x,
                    const double *y)
 {
-    (void) xcsf;
-    const struct PredNeural *pred = c->pred;
-    neural_learn(&pred->net, y, x);
+    struct PredNeural *pred = c->pred;
+    neural_learn_batch(&pred->net, y, x, xcsf->pred->batch_size);
 }
 
 /**
@@ -112,6 +111,51 @@ pred_neural_compute(const struct XCSF *xcsf, const struct Cl *c,
     }
 }
 
+/**
+ * @brief Computes the input layers of the neural network predictions of a
+ * set of classifiers with a single batched operation.
+ * @details Each prediction is then completed with pred_neural_compute_batched.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] clist The classifiers with neural network predictions.
+ * @param [in] n The number of classifiers.
+ * @param [in] x The input state.
+ */
+void
+pred_neural_forward_batch(const struct XCSF *xcsf, struct Cl **clist,
+                          const int n, const double *x)
+{
+    if (n < 1) {
+        return;
+    }
+    if (xcsf->pred->batch == NULL) {
+        xcsf->pred->batch = neural_batch_init();
+    }
+    struct Net *nets[n];
+    for (int i = 0; i < n; ++i) {
+        struct PredNeural *pred = clist[i]->pred;
+        nets[i] = &pred->net;
+    }
+    neural_batch_forward(xcsf->pred->batch, nets, n, x);
+}
+
+/**
+ * @brief Completes a neural network prediction after the input layer has been
+ * computed by pred_neural_forward_batch.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier calculating the prediction.
+ * @param [in] x The input state.
+ */
+void
+pred_neural_compute_batched(const struct XCSF *xcsf, const struct Cl *c,
+                            const double *x)
+{
+    struct PredNeural *pred = c->pred;
+    neural_batch_propagate(xcsf->pred->batch, &pred->net, x, xcsf->explore);
+    for (int i = 0; i < xcsf->y_dim; ++i) {
+        c->prediction[i] = neural_output(&pred->net, i);
+    }
+}
+
 /**
  * @brief Prints a neural network prediction.
  * @param [in] xcsf The XCSF data structure.
@@ -152,7 +196,7 @@ bool
 pred_neural_mutate(const struct XCSF *xcsf, const struct Cl *c)
 {
     (void) xcsf;
-    const struct PredNeural *pred = c->pred;
+    struct PredNeural *pred = c->pred;
     return neural_mutate(&pred->net);
 }
 
@@ -204,6 +248,20 @@ pred_neural_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
     return s;
 }
 
+/**
+ * @brief Returns the heap memory used by a neural prediction.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose prediction memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+pred_neural_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    (void) xcsf;
+    const struct PredNeural *pred = c->pred;
+    return sizeof(struct PredNeural) + neural_bytes(&pred->net);
+}
+
 /**
  * @brief Returns the gradient descent rate of a neural prediction layer.
  * @param [in] xcsf The XCSF data structure.
@@ -328,6 +386,7 @@ pred_neural_expand(const struct XCSF *xcsf, const struct Cl *c)
     new.evolve_functions = largs->evolve_functions;
     new.evolve_eta = largs->evolve_eta;
     new.sgd_weights = largs->sgd_weights;
+    new.sparse_mutate = largs->sparse_mutate;
     new.eta = largs->eta;
     new.eta_min = largs->eta_min;
     new.momentum = largs->momentum;
@@ -368,6 +427,7 @@ pred_neural_ae_to_classifier(const struct XCSF *xcsf, const struct Cl *c,
     new.evolve_weights = largs->evolve_weights;
     new.evolve_eta = largs->evolve_eta;
     new.sgd_weights = largs->sgd_weights;
+    new.sparse_mutate = largs->sparse_mutate;
     new.eta = largs->eta;
     new.eta_min = largs->eta_min;
     new.momentum = largs->momentum;
@@ -25,6 +25,7 @@
 
 #include "neural.h"
 #include "neural_activations.h"
+#include "neural_batch.h"
 #include "neural_layer.h"
 #include "prediction.h"
 #include "xcsf.h"
@@ -63,6 +64,9 @@ pred_neural_size(const struct XCSF *xcsf, const struct Cl *c);
 size_t
 pred_neural_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
 
+size_t
+pred_neural_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
 size_t
 pred_neural_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp);
 
@@ -70,6 +74,14 @@ void
 pred_neural_compute(const struct XCSF *xcsf, const struct Cl *c,
                     const double *x);
 
+void
+pred_neural_compute_batched(const struct XCSF *xcsf, const struct Cl *c,
+                            const double *x);
+
+void
+pred_neural_forward_batch(const struct XCSF *xcsf, struct Cl **clist,
+                          const int n, const double *x);
+
 void
 pred_neural_copy(const struct XCSF *xcsf, struct Cl *dest,
                  const struct Cl *src);
@@ -102,5 +114,5 @@ static struct PredVtbl const pred_neural_vtbl = {
     &pred_neural_crossover, &pred_neural_mutate, &pred_neural_compute,
     &pred_neural_copy,      &pred_neural_free,   &pred_neural_init,
     &pred_neural_print,     &pred_neural_update, &pred_neural_size,
-    &pred_neural_save,      &pred_neural_load
+    &pred_neural_save,      &pred_neural_load,   &pred_neural_bytes
 };
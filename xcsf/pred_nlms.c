@@ -54,7 +54,7 @@ pred_nlms_init(const struct XCSF *xcsf, struct Cl *c)
     }
     // initialise weights
     pred->n_weights = pred->n * xcsf->y_dim;
-    pred->weights = calloc(pred->n_weights, sizeof(double));
+    pred->weights = calloc(pred->n_weights, sizeof(real));
     blas_fill(xcsf->y_dim, xcsf->pred->x0, pred->weights, pred->n);
     // initialise learning rate
     pred->mu = malloc(sizeof(double) * N_MU);
@@ -82,7 +82,7 @@ pred_nlms_copy(const struct XCSF *xcsf, struct Cl *dest, const struct Cl *src)
     struct PredNLMS *dest_pred = dest->pred;
     const struct PredNLMS *src_pred = src->pred;
     memcpy(dest_pred->weights, src_pred->weights,
-           sizeof(double) * src_pred->n_weights);
+           sizeof(real) * src_pred->n_weights);
     memcpy(dest_pred->mu, src_pred->mu, sizeof(double) * N_MU);
     dest_pred->eta = src_pred->eta;
 }
@@ -119,17 +119,44 @@ pred_nlms_update(const struct XCSF *xcsf, const struct Cl *c, const double *x,
     // normalise update
     const int n = pred->n;
     const double X0 = xcsf->pred->x0;
-    const double norm = X0 * X0 + blas_dot(xcsf->x_dim, x, 1, x, 1);
+    double norm = X0 * X0;
+    for (int i = 0; i < xcsf->x_dim; ++i) {
+        norm += x[i] * x[i];
+    }
     // update weights using the error
     for (int i = 0; i < xcsf->y_dim; ++i) {
         const double error = y[i] - c->prediction[i];
         const double correction = (pred->eta * error) / norm;
-        blas_axpy(n, correction, pred->tmp_input, 1, &pred->weights[i * n], 1);
+        real *w = &pred->weights[i * n];
+        for (int j = 0; j < n; ++j) {
+            w[j] += correction * pred->tmp_input[j];
+        }
+    }
+}
+
+/**
+ * @brief Returns the dot product of n weights with the transformed input.
+ * @details Inlined with a constant length the loop is fully unrolled. The
+ * products are accumulated with double precision.
+ * @param [in] weights The weights of one output variable.
+ * @param [in] input The transformed input.
+ * @param [in] n The number of weights.
+ * @return The dot product.
+ */
+static inline double
+pred_nlms_dot_n(const real *weights, const double *input, const int n)
+{
+    double dot = 0;
+    for (int i = 0; i < n; ++i) {
+        dot += weights[i] * input[i];
     }
+    return dot;
 }
 
 /**
  * @brief Computes the current NLMS prediction for a provided input.
+ * @details Fixed-length kernels are used for linear predictions with common
+ * low-dimensional inputs.
  * @param [in] xcsf The XCSF data structure.
  * @param [in] c The classifier calculating the prediction.
  * @param [in] x The input state.
@@ -139,10 +166,30 @@ pred_nlms_compute(const struct XCSF *xcsf, const struct Cl *c, const double *x)
 {
     const struct PredNLMS *pred = c->pred;
     const int n = pred->n;
+    const double *input = pred->tmp_input;
     pred_transform_input(xcsf, x, xcsf->pred->x0, pred->tmp_input);
     for (int i = 0; i < xcsf->y_dim; ++i) {
-        c->prediction[i] =
-            blas_dot(n, &pred->weights[i * n], 1, pred->tmp_input, 1);
+        const real *w = &pred->weights[i * n];
+        switch (n) {
+            case 2:
+                c->prediction[i] = pred_nlms_dot_n(w, input, 2);
+                break;
+            case 3:
+                c->prediction[i] = pred_nlms_dot_n(w, input, 3);
+                break;
+            case 5:
+                c->prediction[i] = pred_nlms_dot_n(w, input, 5);
+                break;
+            case 9:
+                c->prediction[i] = pred_nlms_dot_n(w, input, 9);
+                break;
+            case 17:
+                c->prediction[i] = pred_nlms_dot_n(w, input, 17);
+                break;
+            default:
+                c->prediction[i] = pred_nlms_dot_n(w, input, n);
+                break;
+        }
     }
 }
 
@@ -233,7 +280,7 @@ pred_nlms_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp)
     size_t s = 0;
     s += fwrite(&pred->n, sizeof(int), 1, fp);
     s += fwrite(&pred->n_weights, sizeof(int), 1, fp);
-    s += fwrite(pred->weights, sizeof(double), pred->n_weights, fp);
+    s += fwrite(pred->weights, sizeof(real), pred->n_weights, fp);
     s += fwrite(pred->mu, sizeof(double), N_MU, fp);
     s += fwrite(&pred->eta, sizeof(double), 1, fp);
     return s;
@@ -254,8 +301,23 @@ pred_nlms_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
     size_t s = 0;
     s += fread(&pred->n, sizeof(int), 1, fp);
     s += fread(&pred->n_weights, sizeof(int), 1, fp);
-    s += fread(pred->weights, sizeof(double), pred->n_weights, fp);
+    s += fread(pred->weights, sizeof(real), pred->n_weights, fp);
     s += fread(pred->mu, sizeof(double), N_MU, fp);
     s += fread(&pred->eta, sizeof(double), 1, fp);
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by an NLMS prediction.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose prediction memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+pred_nlms_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    (void) xcsf;
+    const struct PredNLMS *pred = c->pred;
+    return sizeof(struct PredNLMS) + sizeof(real) * pred->n_weights +
+        sizeof(double) * (N_MU + pred->n);
+}
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "precision.h"
 #include "prediction.h"
 #include "xcsf.h"
 
@@ -32,7 +33,7 @@
 struct PredNLMS {
     int n; //!< Number of weights for each predicted variable
     int n_weights; //!< Total number of weights
-    double *weights; //!< Weights used to compute prediction
+    real *weights; //!< Weights used to compute prediction
     double *mu; //!< Mutation rates
     double eta; //!< Gradient descent rate
     double *tmp_input; //!< Temporary storage for updating weights
@@ -51,6 +52,9 @@ pred_nlms_size(const struct XCSF *xcsf, const struct Cl *c);
 size_t
 pred_nlms_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
 
+size_t
+pred_nlms_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
 size_t
 pred_nlms_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp);
 
@@ -80,5 +84,5 @@ static struct PredVtbl const pred_nlms_vtbl = {
     &pred_nlms_crossover, &pred_nlms_mutate, &pred_nlms_compute,
     &pred_nlms_copy,      &pred_nlms_free,   &pred_nlms_init,
     &pred_nlms_print,     &pred_nlms_update, &pred_nlms_size,
-    &pred_nlms_save,      &pred_nlms_load
+    &pred_nlms_save,      &pred_nlms_load,   &pred_nlms_bytes
 };
@@ -22,9 +22,51 @@
  */
 
 #include "pred_rls.h"
-#include "blas.h"
 #include "utils.h"
 
+/**
+ * @brief Returns the dot product of two double precision vectors.
+ * @details RLS always uses double precision for numerical stability of the
+ * gain matrix, regardless of the working precision.
+ * @param [in] n The number of elements in vectors x and y.
+ * @param [in] x Vector with n elements.
+ * @param [in] y Vector with n elements.
+ * @return The resulting dot product.
+ */
+static double
+pred_rls_dot(const int n, const double *x, const double *y)
+{
+    double dot = 0;
+    for (int i = 0; i < n; ++i) {
+        dot += x[i] * y[i];
+    }
+    return dot;
+}
+
+/**
+ * @brief Performs the double precision matrix multiplication C = A * B.
+ * @param [in] m Number of rows of matrix A and C.
+ * @param [in] n Number of columns of matrix B and C.
+ * @param [in] k Number of columns of A and rows of B.
+ * @param [in] A Matrix with m rows and k columns.
+ * @param [in] B Matrix with k rows and n columns.
+ * @param [out] C Matrix with m rows and n columns.
+ */
+static void
+pred_rls_matmul(const int m, const int n, const int k, const double *A,
+                const double *B, double *C)
+{
+    memset(C, 0, sizeof(double) * m * n);
+    for (int i = 0; i < m; ++i) {
+        for (int p = 0; p < k; ++p) {
+            const double a = A[i * k + p];
+            for (int j = 0; j < n; ++j) {
+                C[i * n + j] += a * B[p * n + j];
+            }
+        }
+    }
+}
+
 /**
  * @brief Initialises an RLS prediction.
  * @param [in] xcsf The XCSF data structure.
@@ -45,7 +87,9 @@ pred_rls_init(const struct XCSF *xcsf, struct Cl *c)
     // initialise weights
     pred->n_weights = pred->n * xcsf->y_dim;
     pred->weights = calloc(pred->n_weights, sizeof(double));
-    blas_fill(xcsf->y_dim, xcsf->pred->x0, pred->weights, pred->n);
+    for (int i = 0; i < xcsf->y_dim; ++i) {
+        pred->weights[i * pred->n] = xcsf->pred->x0;
+    }
     // initialise gain matrix
     const int n_sqrd = pred->n * pred->n;
     pred->matrix = calloc(n_sqrd, sizeof(double));
@@ -110,18 +154,20 @@ pred_rls_update(const struct XCSF *xcsf, const struct Cl *c, const double *x,
     const struct PredRLS *pred = c->pred;
     const int n = pred->n;
     // gain vector = matrix * tmp_input (tmp_input set during compute)
-    const double *A = pred->matrix;
-    const double *B = pred->tmp_input;
-    double *C = pred->tmp_vec;
-    blas_gemm(0, 0, n, 1, n, 1, A, n, B, 1, 0, C, 1);
+    pred_rls_matmul(n, 1, n, pred->matrix, pred->tmp_input, pred->tmp_vec);
     // divide gain vector by lambda + gain vector
-    double divisor = blas_dot(n, pred->tmp_input, 1, pred->tmp_vec, 1);
+    double divisor = pred_rls_dot(n, pred->tmp_input, pred->tmp_vec);
     divisor = 1 / (divisor + xcsf->pred->lambda);
-    blas_scal(n, divisor, pred->tmp_vec, 1);
+    for (int i = 0; i < n; ++i) {
+        pred->tmp_vec[i] *= divisor;
+    }
     // update weights using the error
     for (int i = 0; i < xcsf->y_dim; ++i) {
         const double error = y[i] - c->prediction[i];
-        blas_axpy(n, error, pred->tmp_vec, 1, &pred->weights[i * n], 1);
+        double *w = &pred->weights[i * n];
+        for (int j = 0; j < n; ++j) {
+            w[j] += error * pred->tmp_vec[j];
+        }
     }
     // update gain matrix
     for (int i = 0; i < n; ++i) {
@@ -135,10 +181,8 @@ pred_rls_update(const struct XCSF *xcsf, const struct Cl *c, const double *x,
         }
     }
     // tmp_matrix2 = tmp_matrix1 * pred_matrix
-    A = pred->tmp_matrix1;
-    B = pred->matrix;
-    C = pred->tmp_matrix2;
-    blas_gemm(0, 0, n, n, n, 1, A, n, B, n, 0, C, n);
+    pred_rls_matmul(n, n, n, pred->tmp_matrix1, pred->matrix,
+                    pred->tmp_matrix2);
     // divide gain matrix entries by lambda
     const double lambda = xcsf->pred->lambda;
     for (int i = 0; i < n; ++i) {
@@ -162,7 +206,7 @@ pred_rls_compute(const struct XCSF *xcsf, const struct Cl *c, const double *x)
     pred_transform_input(xcsf, x, xcsf->pred->x0, pred->tmp_input);
     for (int i = 0; i < xcsf->y_dim; ++i) {
         c->prediction[i] =
-            blas_dot(n, &pred->weights[i * n], 1, pred->tmp_input, 1);
+            pred_rls_dot(n, &pred->weights[i * n], pred->tmp_input);
     }
 }
 
@@ -271,3 +315,19 @@ pred_rls_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
     s += fread(pred->matrix, sizeof(double), n_sqrd, fp);
     return s;
 }
+
+/**
+ * @brief Returns the heap memory used by an RLS prediction.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose prediction memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+size_t
+pred_rls_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    (void) xcsf;
+    const struct PredRLS *pred = c->pred;
+    const size_t n_sqrd = (size_t) pred->n * pred->n;
+    return sizeof(struct PredRLS) +
+        sizeof(double) * (pred->n_weights + 3 * n_sqrd + 2 * pred->n);
+}
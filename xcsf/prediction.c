@@ -21,11 +21,15 @@
  * @brief Interface for classifier predictions.
  */
 
+#include "neural_batch.h"
+#include "pipeline.h"
 #include "pred_constant.h"
 #include "pred_neural.h"
 #include "pred_nlms.h"
 #include "pred_rls.h"
 
+#define PRED_BATCH_BUILD (2) //!< First build saving the mini-batch size
+
 /**
  * @brief Sets a classifier's prediction functions to the implementations.
  * @param [in] xcsf The XCSF data structure.
@@ -158,6 +162,7 @@ pred_param_defaults(struct XCSF *xcsf)
     pred_param_set_scale_factor(xcsf, 1000);
     pred_param_set_x0(xcsf, 1);
     pred_param_set_evolve_eta(xcsf, true);
+    pred_param_set_batch_size(xcsf, 1);
     pred_param_defaults_neural(xcsf);
 }
 
@@ -209,6 +214,7 @@ pred_param_print(const struct XCSF *xcsf)
             pred_param_print_rls(xcsf);
             break;
         case PRED_TYPE_NEURAL:
+            printf(", PRED_BATCH_SIZE=%d", pred->batch_size);
             layer_args_print(xcsf->pred->largs, "PRED");
             break;
         default:
@@ -234,6 +240,7 @@ pred_param_save(const struct XCSF *xcsf, FILE *fp)
     s += fwrite(&pred->scale_factor, sizeof(double), 1, fp);
     s += fwrite(&pred->x0, sizeof(double), 1, fp);
     s += fwrite(&pred->evolve_eta, sizeof(bool), 1, fp);
+    s += fwrite(&pred->batch_size, sizeof(int), 1, fp);
     s += layer_args_save(pred->largs, fp);
     return s;
 }
@@ -256,7 +263,12 @@ pred_param_load(struct XCSF *xcsf, FILE *fp)
     s += fread(&pred->scale_factor, sizeof(double), 1, fp);
     s += fread(&pred->x0, sizeof(double), 1, fp);
     s += fread(&pred->evolve_eta, sizeof(bool), 1, fp);
-    s += layer_args_load(&pred->largs, fp);
+    if (xcsf->load_build >= PRED_BATCH_BUILD) {
+        s += fread(&pred->batch_size, sizeof(int), 1, fp);
+    } else {
+        pred->batch_size = 1;
+    }
+    s += layer_args_load(&pred->largs, xcsf->load_build, fp);
     return s;
 }
 
@@ -268,32 +280,34 @@ void
 pred_param_free(struct XCSF *xcsf)
 {
     layer_args_free(&xcsf->pred->largs);
+    neural_batch_free(xcsf->pred->batch);
+    xcsf->pred->batch = NULL;
 }
 
 /**
- * @brief Prepares the input state for least squares computation.
- * @param [in] xcsf The XCSF data structure.
+ * @brief Prepares an input state of dimension n for least squares computation.
+ * @details Inlined with a constant dimension the loops are fully unrolled.
  * @param [in] x The input state.
  * @param [in] X0 Bias term.
+ * @param [in] n The number of input dimensions.
+ * @param [in] quadratic Whether to include the quadratic terms.
  * @param [out] tmp_input The transformed input.
  */
-void
-pred_transform_input(const struct XCSF *xcsf, const double *x, const double X0,
-                     double *tmp_input)
+static inline void
+pred_transform_input_n(const double *x, const double X0, const int n,
+                       const bool quadratic, double *tmp_input)
 {
     // bias term
     tmp_input[0] = X0;
-    int idx = 1;
     // linear terms
-    for (int i = 0; i < xcsf->x_dim; ++i) {
-        tmp_input[idx] = x[i];
-        ++idx;
+    for (int i = 0; i < n; ++i) {
+        tmp_input[i + 1] = x[i];
     }
     // quadratic terms
-    if (xcsf->pred->type == PRED_TYPE_NLMS_QUADRATIC ||
-        xcsf->pred->type == PRED_TYPE_RLS_QUADRATIC) {
-        for (int i = 0; i < xcsf->x_dim; ++i) {
-            for (int j = i; j < xcsf->x_dim; ++j) {
+    if (quadratic) {
+        int idx = n + 1;
+        for (int i = 0; i < n; ++i) {
+            for (int j = i; j < n; ++j) {
                 tmp_input[idx] = x[i] * x[j];
                 ++idx;
             }
@@ -301,6 +315,42 @@ pred_transform_input(const struct XCSF *xcsf, const double *x, const double X0,
     }
 }
 
+/**
+ * @brief Prepares the input state for least squares computation.
+ * @details Fixed-dimension kernels are used for common low-dimensional inputs.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] x The input state.
+ * @param [in] X0 Bias term.
+ * @param [out] tmp_input The transformed input.
+ */
+void
+pred_transform_input(const struct XCSF *xcsf, const double *x, const double X0,
+                     double *tmp_input)
+{
+    const bool quadratic = (xcsf->pred->type == PRED_TYPE_NLMS_QUADRATIC ||
+                            xcsf->pred->type == PRED_TYPE_RLS_QUADRATIC);
+    switch (xcsf->x_dim) {
+        case 1:
+            pred_transform_input_n(x, X0, 1, quadratic, tmp_input);
+            break;
+        case 2:
+            pred_transform_input_n(x, X0, 2, quadratic, tmp_input);
+            break;
+        case 4:
+            pred_transform_input_n(x, X0, 4, quadratic, tmp_input);
+            break;
+        case 8:
+            pred_transform_input_n(x, X0, 8, quadratic, tmp_input);
+            break;
+        case 16:
+            pred_transform_input_n(x, X0, 16, quadratic, tmp_input);
+            break;
+        default:
+            pred_transform_input_n(x, X0, xcsf->x_dim, quadratic, tmp_input);
+            break;
+    }
+}
+
 /* parameter setters */
 
 void
@@ -355,6 +405,17 @@ pred_param_set_evolve_eta(struct XCSF *xcsf, const bool a)
     xcsf->pred->evolve_eta = a;
 }
 
+void
+pred_param_set_batch_size(struct XCSF *xcsf, const int a)
+{
+    if (a < 1) {
+        printf("Warning: tried to set PRED BATCH_SIZE too small\n");
+        xcsf->pred->batch_size = 1;
+    } else {
+        xcsf->pred->batch_size = a;
+    }
+}
+
 void
 pred_param_set_type(struct XCSF *xcsf, const int a)
 {
@@ -364,10 +425,12 @@ pred_param_set_type(struct XCSF *xcsf, const int a)
     } else {
         xcsf->pred->type = a;
     }
+    pipeline_set(xcsf);
 }
 
 void
 pred_param_set_type_string(struct XCSF *xcsf, const char *a)
 {
     xcsf->pred->type = prediction_type_as_int(a);
+    pipeline_set(xcsf);
 }
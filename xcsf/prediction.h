@@ -50,7 +50,9 @@ struct ArgsPred {
     double lambda; //!< RLS forget rate
     double scale_factor; //!< Initial values for the RLS gain-matrix
     double x0; //!< Prediction weight vector offset value
+    int batch_size; //!< Number of samples per neural network update
     struct ArgsLayer *largs; //!< Linked-list of layer parameters
+    struct NeuralBatch *batch; //!< Packed neural network input layers
 };
 
 const char *
@@ -102,6 +104,7 @@ struct PredVtbl {
     size_t (*pred_impl_save)(const struct XCSF *xcsf, const struct Cl *c,
                              FILE *fp);
     size_t (*pred_impl_load)(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
+    size_t (*pred_impl_bytes)(const struct XCSF *xcsf, const struct Cl *c);
 };
 
 /**
@@ -142,6 +145,18 @@ pred_size(const struct XCSF *xcsf, const struct Cl *c)
     return (*c->pred_vptr->pred_impl_size)(xcsf, c);
 }
 
+/**
+ * @brief Returns the number of bytes of heap memory used by the prediction.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] c The classifier whose prediction memory usage to return.
+ * @return The number of bytes allocated, including temporary storage.
+ */
+static inline size_t
+pred_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    return (*c->pred_vptr->pred_impl_bytes)(xcsf, c);
+}
+
 /**
  * @brief Performs classifier prediction crossover.
  * @param [in] xcsf The XCSF data structure.
@@ -260,6 +275,9 @@ pred_param_set_x0(struct XCSF *xcsf, const double a);
 void
 pred_param_set_evolve_eta(struct XCSF *xcsf, const bool a);
 
+void
+pred_param_set_batch_size(struct XCSF *xcsf, const int a);
+
 void
 pred_param_set_type(struct XCSF *xcsf, const int a);
 
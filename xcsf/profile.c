@@ -0,0 +1,420 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file profile.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Per-phase timing, event and hardware counters.
+ * @details Instrumentation is compiled in only when PROFILE is defined;
+ * otherwise the macros expand to nothing and all totals remain zero. Totals
+ * are process-wide and accumulated atomically, so phases executed within
+ * parallel regions report the sum of time spent by all threads. Phases are
+ * timed inclusively, e.g., matching includes any covering it performs.
+ *
+ * On Linux, hardware counters opened with perf_event_open() are additionally
+ * sampled around the coarse phases flagged in hw_phases. The counters follow
+ * the thread that opened them, so work done by OpenMP worker threads is not
+ * included; set OMP_NUM_THREADS=1 for a complete attribution.
+ */
+
+#include "profile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef PROFILE_HW
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+static uint64_t profile_ns[PROF_PHASES] = { 0 }; //!< Nanoseconds per phase
+static uint64_t profile_n[PROF_PHASES] = { 0 }; //!< Calls per phase
+static uint64_t profile_events[PROF_COUNTERS] = { 0 }; //!< Event counts
+static uint64_t profile_hw_totals[PROF_PHASES][PROF_HW_EVENTS] = {
+    { 0 }
+}; //!< Hardware counts per phase
+#ifdef PROFILE_HW
+static int hw_fd[PROF_HW_EVENTS] = { -1, -1, -1, -1 }; //!< Open counters
+#endif
+
+static const bool hw_phases[PROF_PHASES] = {
+    true, false, true, true, true, true, false, false, false
+}; //!< Whether hardware counters are sampled in each phase
+
+static const char *phase_names[PROF_PHASES] = {
+    "match", "cover", "pa_build", "update", "ea", "enforce_limit",
+    "subsumption", "neural_forward", "neural_backward"
+}; //!< Names of each phase
+
+static const char *counter_names[PROF_COUNTERS] = {
+    "matched", "covered", "offspring", "subsumed", "deleted", "allocated"
+}; //!< Names of each counter
+
+static const char *hw_names[PROF_HW_EVENTS] = {
+    "cycles", "instructions", "cache_misses", "branch_misses"
+}; //!< Names of each hardware counter
+
+/**
+ * @brief Returns whether instrumentation has been compiled in.
+ * @return Whether PROFILE was defined when building.
+ */
+bool
+profile_enabled(void)
+{
+#ifdef PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Returns the name of a timed phase.
+ * @param [in] phase The phase.
+ * @return The name of the phase.
+ */
+const char *
+profile_phase_name(const int phase)
+{
+    if (phase < 0 || phase >= PROF_PHASES) {
+        printf("profile_phase_name(): invalid phase: %d\n", phase);
+        exit(EXIT_FAILURE);
+    }
+    return phase_names[phase];
+}
+
+/**
+ * @brief Returns the name of an event counter.
+ * @param [in] counter The counter.
+ * @return The name of the counter.
+ */
+const char *
+profile_counter_name(const int counter)
+{
+    if (counter < 0 || counter >= PROF_COUNTERS) {
+        printf("profile_counter_name(): invalid counter: %d\n", counter);
+        exit(EXIT_FAILURE);
+    }
+    return counter_names[counter];
+}
+
+/**
+ * @brief Returns the name of a hardware counter.
+ * @param [in] event The hardware counter.
+ * @return The name of the hardware counter.
+ */
+const char *
+profile_hw_name(const int event)
+{
+    if (event < 0 || event >= PROF_HW_EVENTS) {
+        printf("profile_hw_name(): invalid event: %d\n", event);
+        exit(EXIT_FAILURE);
+    }
+    return hw_names[event];
+}
+
+/**
+ * @brief Returns the cumulative time spent in a phase.
+ * @param [in] phase The phase.
+ * @return The time in seconds.
+ */
+double
+profile_time(const int phase)
+{
+    return profile_ns[phase] * 1e-9;
+}
+
+/**
+ * @brief Returns the number of times a phase has been executed.
+ * @param [in] phase The phase.
+ * @return The number of calls.
+ */
+uint64_t
+profile_calls(const int phase)
+{
+    return profile_n[phase];
+}
+
+/**
+ * @brief Returns the cumulative count of an event.
+ * @param [in] counter The counter.
+ * @return The number of events.
+ */
+uint64_t
+profile_counter(const int counter)
+{
+    return profile_events[counter];
+}
+
+/**
+ * @brief Returns the cumulative count of a hardware event within a phase.
+ * @param [in] phase The phase.
+ * @param [in] event The hardware counter.
+ * @return The number of events.
+ */
+uint64_t
+profile_hw(const int phase, const int event)
+{
+    return profile_hw_totals[phase][event];
+}
+
+#ifdef PROFILE_HW
+/**
+ * @brief Opens a user-space hardware counter for the calling thread.
+ * @param [in] config The generalised hardware event.
+ * @param [in] group The group leader, or -1 to open a new group.
+ * @return The counter file descriptor, or -1 on failure.
+ */
+static int
+profile_hw_event(const uint64_t config, const int group)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(struct perf_event_attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(struct perf_event_attr);
+    attr.config = config;
+    attr.disabled = (group == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int) syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+}
+#endif
+
+/**
+ * @brief Opens hardware counters for the calling thread.
+ * @details Fails where unsupported, e.g., in virtual machines without a
+ * virtualised PMU, or where perf_event_paranoid forbids user-space counting.
+ * @return Whether the counters are open.
+ */
+bool
+profile_hw_open(void)
+{
+#ifdef PROFILE_HW
+    if (hw_fd[0] >= 0) {
+        return true;
+    }
+    static const uint64_t configs[PROF_HW_EVENTS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+    for (int i = 0; i < PROF_HW_EVENTS; ++i) {
+        hw_fd[i] = profile_hw_event(configs[i], hw_fd[0]);
+        if (hw_fd[i] < 0) {
+            profile_hw_close();
+            return false;
+        }
+    }
+    ioctl(hw_fd[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(hw_fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Closes any open hardware counters.
+ */
+void
+profile_hw_close(void)
+{
+#ifdef PROFILE_HW
+    for (int i = PROF_HW_EVENTS - 1; i >= 0; --i) {
+        if (hw_fd[i] >= 0) {
+            close(hw_fd[i]);
+            hw_fd[i] = -1;
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Reads the current values of the open hardware counters.
+ * @param [out] values The counter values.
+ * @return Whether the counters were read.
+ */
+static bool
+profile_hw_read(uint64_t *values)
+{
+#ifdef PROFILE_HW
+    uint64_t buf[PROF_HW_EVENTS + 1];
+    if (hw_fd[0] < 0 || read(hw_fd[0], buf, sizeof(buf)) != sizeof(buf)) {
+        return false;
+    }
+    memcpy(values, buf + 1, sizeof(uint64_t) * PROF_HW_EVENTS);
+    return true;
+#else
+    (void) values;
+    return false;
+#endif
+}
+
+/**
+ * @brief Returns the current time of a monotonic clock.
+ * @return The time in nanoseconds.
+ */
+uint64_t
+profile_now(void)
+{
+    struct timespec ts;
+#ifdef _WIN32
+    timespec_get(&ts, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
+
+/**
+ * @brief Records the start of a phase.
+ * @param [in] phase The phase starting.
+ * @return The counter values at the start of the phase.
+ */
+struct ProfileMark
+profile_begin(const int phase)
+{
+    struct ProfileMark mark;
+    mark.sampled = hw_phases[phase] && profile_hw_read(mark.hw);
+    mark.ns = profile_now();
+    return mark;
+}
+
+/**
+ * @brief Adds the time and hardware events elapsed since the start of a phase.
+ * @param [in] phase The phase completed.
+ * @param [in] mark The counter values at the start of the phase.
+ */
+void
+profile_end(const int phase, const struct ProfileMark *mark)
+{
+    const uint64_t elapsed = profile_now() - mark->ns;
+    uint64_t hw[PROF_HW_EVENTS];
+    if (mark->sampled && profile_hw_read(hw)) {
+        for (int i = 0; i < PROF_HW_EVENTS; ++i) {
+            const uint64_t n = hw[i] - mark->hw[i];
+#ifdef PARALLEL
+    #pragma omp atomic
+#endif
+            profile_hw_totals[phase][i] += n;
+        }
+    }
+#ifdef PARALLEL
+    #pragma omp atomic
+#endif
+    profile_ns[phase] += elapsed;
+#ifdef PARALLEL
+    #pragma omp atomic
+#endif
+    ++profile_n[phase];
+}
+
+/**
+ * @brief Adds to the count of an event.
+ * @param [in] counter The counter.
+ * @param [in] n The number of events.
+ */
+void
+profile_count(const int counter, const uint64_t n)
+{
+#ifdef PARALLEL
+    #pragma omp atomic
+#endif
+    profile_events[counter] += n;
+}
+
+/**
+ * @brief Returns the instructions retired per cycle within a phase.
+ * @param [in] phase The phase.
+ * @return The IPC, or 0 if no cycles were counted.
+ */
+double
+profile_ipc(const int phase)
+{
+    const uint64_t cycles = profile_hw_totals[phase][PROF_HW_CYCLES];
+    if (cycles == 0) {
+        return 0;
+    }
+    return (double) profile_hw_totals[phase][PROF_HW_INSTRUCTIONS] / cycles;
+}
+
+/**
+ * @brief Returns the cache misses while matching per classifier matched.
+ * @return The cache misses per classifier matched.
+ */
+double
+profile_misses_per_matched(void)
+{
+    const uint64_t matched = profile_events[PROF_MATCHED];
+    if (matched == 0) {
+        return 0;
+    }
+    return (double) profile_hw_totals[PROF_MATCH][PROF_HW_CACHE_MISSES] /
+        matched;
+}
+
+/**
+ * @brief Prints the cumulative time and calls of each phase, the counts of
+ * each event, and any hardware events sampled.
+ */
+void
+profile_print(void)
+{
+    for (int i = 0; i < PROF_PHASES; ++i) {
+        printf("%-16s %12.6f s %12llu calls\n", phase_names[i],
+               profile_time(i), (unsigned long long) profile_n[i]);
+    }
+    for (int i = 0; i < PROF_COUNTERS; ++i) {
+        printf("%-16s %12llu\n", counter_names[i],
+               (unsigned long long) profile_events[i]);
+    }
+    for (int i = 0; i < PROF_PHASES; ++i) {
+        if (profile_hw_totals[i][PROF_HW_CYCLES] > 0) {
+            printf("%-16s IPC %6.3f", phase_names[i], profile_ipc(i));
+            for (int j = 0; j < PROF_HW_EVENTS; ++j) {
+                printf(" %s %llu", hw_names[j],
+                       (unsigned long long) profile_hw_totals[i][j]);
+            }
+            printf("\n");
+        }
+    }
+    if (profile_hw_totals[PROF_MATCH][PROF_HW_CYCLES] > 0) {
+        printf("cache misses per classifier matched %.3f\n",
+               profile_misses_per_matched());
+    }
+}
+
+/**
+ * @brief Resets all phase times, calls, and event counts to zero.
+ */
+void
+profile_reset(void)
+{
+    for (int i = 0; i < PROF_PHASES; ++i) {
+        profile_ns[i] = 0;
+        profile_n[i] = 0;
+        for (int j = 0; j < PROF_HW_EVENTS; ++j) {
+            profile_hw_totals[i][j] = 0;
+        }
+    }
+    for (int i = 0; i < PROF_COUNTERS; ++i) {
+        profile_events[i] = 0;
+    }
+}
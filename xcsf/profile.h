@@ -0,0 +1,130 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file profile.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Per-phase timing, event and hardware counters.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PROF_MATCH (0) //!< Phase constructing the match set
+#define PROF_COVER (1) //!< Phase covering unrepresented actions
+#define PROF_PA_BUILD (2) //!< Phase building the prediction array
+#define PROF_UPDATE (3) //!< Phase updating a set
+#define PROF_EA (4) //!< Phase running the evolutionary algorithm
+#define PROF_ENFORCE_LIMIT (5) //!< Phase enforcing the population size limit
+#define PROF_SUBSUMPTION (6) //!< Phase performing set and EA subsumption
+#define PROF_NEURAL_FORWARD (7) //!< Phase forward propagating networks
+#define PROF_NEURAL_BACKWARD (8) //!< Phase back propagating networks
+#define PROF_PHASES (9) //!< Number of timed phases
+
+#define PROF_MATCHED (0) //!< Counter of classifiers matched
+#define PROF_COVERED (1) //!< Counter of classifiers created by covering
+#define PROF_OFFSPRING (2) //!< Counter of offspring created by the EA
+#define PROF_SUBSUMED (3) //!< Counter of offspring subsumed
+#define PROF_DELETED (4) //!< Counter of classifier deletions
+#define PROF_ALLOCATED (5) //!< Counter of classifiers allocated
+#define PROF_COUNTERS (6) //!< Number of event counters
+
+#define PROF_HW_CYCLES (0) //!< Hardware counter of CPU cycles
+#define PROF_HW_INSTRUCTIONS (1) //!< Hardware counter of instructions retired
+#define PROF_HW_CACHE_MISSES (2) //!< Hardware counter of cache misses
+#define PROF_HW_BRANCH_MISSES (3) //!< Hardware counter of branch mispredictions
+#define PROF_HW_EVENTS (4) //!< Number of hardware counters
+
+#if defined(PROFILE) && defined(__linux__)
+    #define PROFILE_HW //!< Whether hardware counters can be sampled
+#endif
+
+/**
+ * @brief Counter values recorded at the start of a phase.
+ */
+struct ProfileMark {
+    uint64_t ns; //!< Time the phase started
+    uint64_t hw[PROF_HW_EVENTS]; //!< Hardware counts when the phase started
+    bool sampled; //!< Whether the hardware counts were read
+};
+
+#ifdef PROFILE
+    #define PROFILE_START(phase)                                               \
+        const struct ProfileMark profile_##phase = profile_begin(phase)
+    #define PROFILE_STOP(phase) profile_end(phase, &profile_##phase)
+    #define PROFILE_COUNT(counter, n) profile_count(counter, n)
+#else
+    #define PROFILE_START(phase) ((void) 0)
+    #define PROFILE_STOP(phase) ((void) 0)
+    #define PROFILE_COUNT(counter, n) ((void) 0)
+#endif
+
+bool
+profile_enabled(void);
+
+const char *
+profile_counter_name(const int counter);
+
+const char *
+profile_phase_name(const int phase);
+
+const char *
+profile_hw_name(const int event);
+
+double
+profile_time(const int phase);
+
+uint64_t
+profile_calls(const int phase);
+
+uint64_t
+profile_counter(const int counter);
+
+uint64_t
+profile_hw(const int phase, const int event);
+
+double
+profile_ipc(const int phase);
+
+double
+profile_misses_per_matched(void);
+
+bool
+profile_hw_open(void);
+
+void
+profile_hw_close(void);
+
+uint64_t
+profile_now(void);
+
+struct ProfileMark
+profile_begin(const int phase);
+
+void
+profile_end(const int phase, const struct ProfileMark *mark);
+
+void
+profile_count(const int counter, const uint64_t n);
+
+void
+profile_print(void);
+
+void
+profile_reset(void);
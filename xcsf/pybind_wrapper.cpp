@@ -27,25 +27,33 @@
 
 #include "../lib/pybind11/include/pybind11/numpy.h"
 #include "../lib/pybind11/include/pybind11/pybind11.h"
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 namespace py = pybind11;
 
+static const int PREDICT_BLOCK = 256; //!< Rows converted together by predict()
+
 extern "C" {
 #include "action.h"
 #include "clset.h"
+#include "clset_export.h"
 #include "clset_neural.h"
 #include "condition.h"
 #include "config.h"
 #include "dgp.h"
 #include "ea.h"
 #include "gp.h"
+#include "metrics.h"
 #include "neural_activations.h"
 #include "neural_layer.h"
 #include "pa.h"
 #include "param.h"
 #include "prediction.h"
+#include "profile.h"
 #include "utils.h"
 #include "xcs_rl.h"
 #include "xcs_supervised.h"
@@ -61,8 +69,180 @@ class XCS
     double *state; //!< Current input state for RL
     int action; //!< Current action for RL
     double payoff; //!< Current reward for RL
-    struct Input *train_data; //!< Training data for supervised learning
-    struct Input *test_data; //!< Test data for supervised learning
+    bool fitting; //!< Whether supervised learning is in progress
+    std::recursive_mutex mutex; //!< Serialises calls made without the GIL
+
+    /**
+     * @brief A two-dimensional array of any memory layout.
+     */
+    struct Strided {
+        const char *data; //!< Address of the first element
+        ptrdiff_t row; //!< Bytes between rows
+        ptrdiff_t col; //!< Bytes between columns
+        bool single; //!< Whether elements are float32 rather than float64
+    };
+
+    /**
+     * @brief Holds the model lock for the lifetime of the guard.
+     * @details The GIL is released while waiting for the lock, so a lock is
+     * never waited for while holding the GIL, and reacquired once it is held.
+     */
+    class ModelLock
+    {
+        py::gil_scoped_release release; //!< Released before locking
+        std::lock_guard<std::recursive_mutex> guard; //!< The model lock
+        py::gil_scoped_acquire acquire; //!< Reacquired after locking
+
+      public:
+        explicit ModelLock(std::recursive_mutex &m) : guard(m)
+        {
+        }
+    };
+
+    /**
+     * @brief Predicts rows read from and written to arrays of any layout.
+     * @details Contiguous float64 rows are predicted in place. Other rows are
+     * converted in blocks of PREDICT_BLOCK rows.
+     * @param [in] in The input variables.
+     * @param [in] pred The array to receive the predictions.
+     * @param [in] n_samples The number of rows to predict.
+     */
+    void
+    predict_strided(const struct Strided *in, const struct Strided *pred,
+                    const int n_samples)
+    {
+        const int x_dim = xcs.x_dim;
+        const int pa_size = xcs.pa_size;
+        const ptrdiff_t d = sizeof(double);
+        const bool direct_in =
+            !in->single && in->col == d && in->row == x_dim * d;
+        const bool direct_out = pred->col == d && pred->row == pa_size * d;
+        if (direct_in && direct_out) {
+            xcs_supervised_predict(&xcs, (const double *) in->data,
+                                   (double *) pred->data, n_samples);
+            return;
+        }
+        std::vector<double> x((size_t) PREDICT_BLOCK * x_dim);
+        std::vector<double> y((size_t) PREDICT_BLOCK * pa_size);
+        for (int start = 0; start < n_samples; start += PREDICT_BLOCK) {
+            const int n = std::min(PREDICT_BLOCK, n_samples - start);
+            const char *src = in->data + start * in->row;
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < x_dim; ++j) {
+                    const char *e = src + i * in->row + j * in->col;
+                    x[i * x_dim + j] = in->single ? *(const float *) e
+                                                  : *(const double *) e;
+                }
+            }
+            xcs_supervised_predict(&xcs, x.data(), y.data(), n);
+            char *dst = (char *) pred->data + start * pred->row;
+            for (int i = 0; i < n; ++i) {
+                for (int j = 0; j < pa_size; ++j) {
+                    *(double *) (dst + i * pred->row + j * pred->col) =
+                        y[i * pa_size + j];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Passes performance reports to a Python callback.
+     * @details Called every PERF_TRIALS trials while the GIL is released. The
+     * training thread still holds the model's lock, which it may reacquire,
+     * so the callback can predict, score, or pickle the model. An exception
+     * raised by the callback is kept for the caller and stops training.
+     * @param [in] xcsf The XCSF data structure.
+     * @param [in] data The Python callable.
+     * @param [in] trial The number of learning trials executed.
+     * @param [in] error The current training error.
+     * @param [in] terror The current testing error.
+     * @return Whether the callback requested training to stop.
+     */
+    static bool
+    perf_callback(const struct XCSF *xcsf, void *data, const int trial,
+                  const double error, const double terror)
+    {
+        py::gil_scoped_acquire acquire;
+        const py::object &callback = *(const py::object *) data;
+        py::dict metrics;
+        metrics["trial"] = trial;
+        metrics["train"] = error;
+        metrics["test"] = terror;
+        metrics["pset_size"] = xcsf->pset.size;
+        metrics["pset_num"] = xcsf->pset.num;
+        metrics["mset_size"] = xcsf->mset_size;
+        metrics["aset_size"] = xcsf->aset_size;
+        metrics["mfrac"] = xcsf->mfrac;
+        try {
+            return py::bool_(callback(metrics));
+        } catch (py::error_already_set &e) {
+            e.restore();
+            return true;
+        }
+    }
+
+    /**
+     * @brief Executes supervised learning.
+     * @details The GIL is released while training. Fitting again from the
+     * performance callback is rejected.
+     * @param [in] train Training data, or NULL if streamed.
+     * @param [in] stream Stream of training data, or NULL.
+     * @param [in] test Test data, or NULL.
+     * @param [in] shuffle Whether to randomise the instances during training.
+     * @param [in] batch_size Number of samples per neural network update
+     * during this fit only, or 0 to use PRED_BATCH_SIZE.
+     * @param [in] callback Optional callable receiving a dict of performance
+     * metrics every PERF_TRIALS trials instead of printing them. Training
+     * stops early if it returns True.
+     * @return The average XCSF training error using the loss function.
+     */
+    double
+    fit_supervised(const struct Input *train, struct Stream *stream,
+                   const struct Input *test, const bool shuffle,
+                   const int batch_size, const py::object &callback)
+    {
+        double error = 0;
+        bool nested = false;
+        {
+            py::gil_scoped_release release;
+            std::lock_guard<std::recursive_mutex> guard(mutex);
+            nested = fitting;
+            if (!nested) {
+                fitting = true;
+                const int prev_batch_size = xcs.pred->batch_size;
+                if (batch_size > 0) {
+                    pred_param_set_batch_size(&xcs, batch_size);
+                }
+                if (!callback.is_none()) {
+                    xcs.perf_ptr = perf_callback;
+                    xcs.perf_data = (void *) &callback;
+                }
+                // first execution
+                if (xcs.time == 0) {
+                    clset_pset_init(&xcs);
+                }
+                if (stream != NULL) {
+                    error =
+                        xcs_supervised_fit_stream(&xcs, stream, test, shuffle);
+                } else {
+                    error = xcs_supervised_fit(&xcs, train, test, shuffle);
+                }
+                xcs.perf_ptr = NULL;
+                xcs.perf_data = NULL;
+                if (batch_size > 0) {
+                    pred_param_set_batch_size(&xcs, prev_batch_size);
+                }
+                fitting = false;
+            }
+        }
+        if (nested) {
+            throw std::runtime_error("fit() called from its own callback");
+        }
+        if (PyErr_Occurred()) {
+            throw py::error_already_set();
+        }
+        return error;
+    }
 
   public:
     /**
@@ -90,23 +270,61 @@ class XCS
         config_read(&xcs, filename);
         xcsf_init(&xcs);
         pa_init(&xcs);
+        init_data();
+    }
+
+    /**
+     * @brief Constructor restoring a pickled state.
+     * @param [in] state A bytes object returned by get_state().
+     */
+    explicit XCS(const py::bytes &state)
+    {
+        char *buffer = NULL;
+        Py_ssize_t size = 0;
+        if (PyBytes_AsStringAndSize(state.ptr(), &buffer, &size) != 0) {
+            throw py::error_already_set();
+        }
+        param_init(&xcs, 1, 1, 1);
+        xcsf_init(&xcs);
+        xcsf_deserialise(&xcs, buffer, (size_t) size);
+        pa_init(&xcs);
+        init_data();
+    }
+
+    /**
+     * @brief Returns the entire current state of XCSF for pickling.
+     * @details Uses the same format as save() without touching the disk.
+     * @return A bytes object holding the serialised model.
+     */
+    py::bytes
+    get_state(void)
+    {
+        char *buffer = NULL;
+        size_t size = 0;
+        {
+            py::gil_scoped_release release;
+            std::lock_guard<std::recursive_mutex> guard(mutex);
+            xcsf_serialise(&xcs, &buffer, &size);
+        }
+        py::bytes state(buffer, size);
+        free(buffer);
+        return state;
+    }
+
+  private:
+    /**
+     * @brief Initialises the RL state and supervised learning status.
+     */
+    void
+    init_data(void)
+    {
         state = NULL;
         action = 0;
         payoff = 0;
-        train_data = (struct Input *) malloc(sizeof(struct Input));
-        train_data->n_samples = 0;
-        train_data->x_dim = 0;
-        train_data->y_dim = 0;
-        train_data->x = NULL;
-        train_data->y = NULL;
-        test_data = (struct Input *) malloc(sizeof(struct Input));
-        test_data->n_samples = 0;
-        test_data->x_dim = 0;
-        test_data->y_dim = 0;
-        test_data->x = NULL;
-        test_data->y = NULL;
+        fitting = false;
     }
 
+  public:
     /**
      * @brief Returns the XCSF major version number.
      * @return Major version number.
@@ -145,6 +363,7 @@ class XCS
     size_t
     save(const char *filename)
     {
+        ModelLock lock(mutex);
         return xcsf_save(&xcs, filename);
     }
 
@@ -156,6 +375,7 @@ class XCS
     size_t
     load(const char *filename)
     {
+        ModelLock lock(mutex);
         return xcsf_load(&xcs, filename);
     }
 
@@ -165,6 +385,7 @@ class XCS
     void
     store(void)
     {
+        ModelLock lock(mutex);
         xcsf_store_pset(&xcs);
     }
 
@@ -174,6 +395,7 @@ class XCS
     void
     retrieve(void)
     {
+        ModelLock lock(mutex);
         xcsf_retrieve_pset(&xcs);
     }
 
@@ -183,6 +405,7 @@ class XCS
     void
     print_params(void)
     {
+        ModelLock lock(mutex);
         param_print(&xcs);
     }
 
@@ -193,6 +416,7 @@ class XCS
     void
     pred_expand(void)
     {
+        ModelLock lock(mutex);
         xcsf_pred_expand(&xcs);
     }
 
@@ -204,6 +428,7 @@ class XCS
     void
     ae_to_classifier(const int y_dim, const int n_del)
     {
+        ModelLock lock(mutex);
         xcsf_ae_to_classifier(&xcs, y_dim, n_del);
     }
 
@@ -217,6 +442,7 @@ class XCS
     print_pset(const bool print_cond, const bool print_act,
                const bool print_pred)
     {
+        ModelLock lock(mutex);
         xcsf_print_pset(&xcs, print_cond, print_act, print_pred);
     }
 
@@ -233,6 +459,8 @@ class XCS
     fit(const py::array_t<double> input, const int action, const double reward)
     {
         py::buffer_info buf = input.request();
+        py::gil_scoped_release release;
+        std::lock_guard<std::recursive_mutex> guard(mutex);
         state = (double *) buf.ptr;
         return xcs_rl_fit(&xcs, state, action, reward);
     }
@@ -243,6 +471,7 @@ class XCS
     void
     init_trial(void)
     {
+        ModelLock lock(mutex);
         if (xcs.time == 0) {
             clset_pset_init(&xcs);
         }
@@ -255,6 +484,7 @@ class XCS
     void
     end_trial(void)
     {
+        ModelLock lock(mutex);
         xcs_rl_end_trial(&xcs);
     }
 
@@ -264,6 +494,7 @@ class XCS
     void
     init_step(void)
     {
+        ModelLock lock(mutex);
         xcs_rl_init_step(&xcs);
     }
 
@@ -273,6 +504,7 @@ class XCS
     void
     end_step(void)
     {
+        ModelLock lock(mutex);
         xcs_rl_end_step(&xcs, state, action, payoff);
     }
 
@@ -287,6 +519,8 @@ class XCS
     decision(const py::array_t<double> input, const bool explore)
     {
         py::buffer_info buf = input.request();
+        py::gil_scoped_release release;
+        std::lock_guard<std::recursive_mutex> guard(mutex);
         state = (double *) buf.ptr;
         param_set_explore(&xcs, explore);
         action = xcs_rl_decision(&xcs, state);
@@ -302,6 +536,8 @@ class XCS
     void
     update(const double reward, const bool done)
     {
+        py::gil_scoped_release release;
+        std::lock_guard<std::recursive_mutex> guard(mutex);
         payoff = reward;
         xcs_rl_update(&xcs, state, action, payoff, done);
     }
@@ -316,6 +552,7 @@ class XCS
     double
     error(const double reward, const bool done, const double max_p)
     {
+        ModelLock lock(mutex);
         payoff = reward;
         return xcs_rl_error(&xcs, action, payoff, done, max_p);
     }
@@ -328,30 +565,45 @@ class XCS
      * @param [in] train_X The input values to use for training.
      * @param [in] train_Y The true output values to use for training.
      * @param [in] shuffle Whether to randomise the instances during training.
+     * @param [in] callback Optional performance callback.
+     * @return The average XCSF training error using the loss function.
+     */
+    double
+    fit(const py::array_t<double> train_X, const py::array_t<double> train_Y,
+        const bool shuffle, const py::object &callback)
+    {
+        return fit(train_X, train_Y, shuffle, 0, callback);
+    }
+
+    /**
+     * @brief Executes MAX_TRIALS number of XCSF learning iterations using the
+     * provided training data with mini-batch neural network updates.
+     * @param [in] train_X The input values to use for training.
+     * @param [in] train_Y The true output values to use for training.
+     * @param [in] shuffle Whether to randomise the instances during training.
+     * @param [in] batch_size Number of samples per neural network update
+     * during this fit only, or 0 to use PRED_BATCH_SIZE.
+     * @param [in] callback Optional performance callback.
      * @return The average XCSF training error using the loss function.
      */
     double
     fit(const py::array_t<double> train_X, const py::array_t<double> train_Y,
-        const bool shuffle)
+        const bool shuffle, const int batch_size, const py::object &callback)
     {
         const py::buffer_info buf_x = train_X.request();
         const py::buffer_info buf_y = train_Y.request();
         if (buf_x.shape[0] != buf_y.shape[0]) {
-            printf("error: training X and Y n_samples are not equal\n");
-            exit(EXIT_FAILURE);
+            throw std::invalid_argument(
+                "training X and Y n_samples are not equal");
         }
         // load training data
-        train_data->n_samples = buf_x.shape[0];
-        train_data->x_dim = buf_x.shape[1];
-        train_data->y_dim = buf_y.shape[1];
-        train_data->x = (double *) buf_x.ptr;
-        train_data->y = (double *) buf_y.ptr;
-        // first execution
-        if (xcs.time == 0) {
-            clset_pset_init(&xcs);
-        }
+        const struct Input train = {
+            (double *) buf_x.ptr, (double *) buf_y.ptr, (int) buf_x.shape[1],
+            (int) buf_y.shape[1], (int) buf_x.shape[0]
+        };
         // execute
-        return xcs_supervised_fit(&xcs, train_data, NULL, shuffle);
+        return fit_supervised(&train, NULL, NULL, shuffle, batch_size,
+                              callback);
     }
 
     /**
@@ -362,72 +614,208 @@ class XCS
      * @param [in] test_X The input values to use for testing.
      * @param [in] test_Y The true output values to use for testing.
      * @param [in] shuffle Whether to randomise the instances during training.
+     * @param [in] callback Optional performance callback.
+     * @return The average XCSF training error using the loss function.
+     */
+    double
+    fit(const py::array_t<double> train_X, const py::array_t<double> train_Y,
+        const py::array_t<double> test_X, const py::array_t<double> test_Y,
+        const bool shuffle, const py::object &callback)
+    {
+        return fit(train_X, train_Y, test_X, test_Y, shuffle, 0, callback);
+    }
+
+    /**
+     * @brief Executes MAX_TRIALS number of XCSF learning iterations using the
+     * provided training data with mini-batch neural network updates and test
+     * iterations using the test data.
+     * @param [in] train_X The input values to use for training.
+     * @param [in] train_Y The true output values to use for training.
+     * @param [in] test_X The input values to use for testing.
+     * @param [in] test_Y The true output values to use for testing.
+     * @param [in] shuffle Whether to randomise the instances during training.
+     * @param [in] batch_size Number of samples per neural network update
+     * during this fit only, or 0 to use PRED_BATCH_SIZE.
+     * @param [in] callback Optional performance callback.
      * @return The average XCSF training error using the loss function.
      */
     double
     fit(const py::array_t<double> train_X, const py::array_t<double> train_Y,
         const py::array_t<double> test_X, const py::array_t<double> test_Y,
-        const bool shuffle)
+        const bool shuffle, const int batch_size, const py::object &callback)
     {
         const py::buffer_info buf_train_x = train_X.request();
         const py::buffer_info buf_train_y = train_Y.request();
         const py::buffer_info buf_test_x = test_X.request();
         const py::buffer_info buf_test_y = test_Y.request();
         if (buf_train_x.shape[0] != buf_train_y.shape[0]) {
-            printf("error: training X and Y n_samples are not equal\n");
-            exit(EXIT_FAILURE);
+            throw std::invalid_argument(
+                "training X and Y n_samples are not equal");
         }
         if (buf_test_x.shape[0] != buf_test_y.shape[0]) {
-            printf("error: testing X and Y n_samples are not equal\n");
-            exit(EXIT_FAILURE);
+            throw std::invalid_argument(
+                "testing X and Y n_samples are not equal");
         }
         if (buf_train_x.shape[1] != buf_test_x.shape[1]) {
-            printf("error: number of train and test X cols are not equal\n");
-            exit(EXIT_FAILURE);
+            throw std::invalid_argument(
+                "number of train and test X cols are not equal");
         }
         if (buf_train_y.shape[1] != buf_test_y.shape[1]) {
-            printf("error: number of train and test Y cols are not equal\n");
-            exit(EXIT_FAILURE);
+            throw std::invalid_argument(
+                "number of train and test Y cols are not equal");
         }
         // load training data
-        train_data->n_samples = buf_train_x.shape[0];
-        train_data->x_dim = buf_train_x.shape[1];
-        train_data->y_dim = buf_train_y.shape[1];
-        train_data->x = (double *) buf_train_x.ptr;
-        train_data->y = (double *) buf_train_y.ptr;
+        const struct Input train = {
+            (double *) buf_train_x.ptr, (double *) buf_train_y.ptr,
+            (int) buf_train_x.shape[1], (int) buf_train_y.shape[1],
+            (int) buf_train_x.shape[0]
+        };
         // load testing data
-        test_data->n_samples = buf_test_x.shape[0];
-        test_data->x_dim = buf_test_x.shape[1];
-        test_data->y_dim = buf_test_y.shape[1];
-        test_data->x = (double *) buf_test_x.ptr;
-        test_data->y = (double *) buf_test_y.ptr;
-        // first execution
-        if (xcs.time == 0) {
-            clset_pset_init(&xcs);
-        }
+        const struct Input test = {
+            (double *) buf_test_x.ptr, (double *) buf_test_y.ptr,
+            (int) buf_test_x.shape[1], (int) buf_test_y.shape[1],
+            (int) buf_test_x.shape[0]
+        };
         // execute
-        return xcs_supervised_fit(&xcs, train_data, test_data, shuffle);
+        return fit_supervised(&train, NULL, &test, shuffle, batch_size,
+                              callback);
+    }
+
+    /**
+     * @brief Executes MAX_TRIALS number of XCSF learning iterations using
+     * training data streamed from a binary dataset file.
+     * @details Only two chunks of the training data are held in memory.
+     * @param [in] train_file The name of the binary dataset file.
+     * @param [in] chunk The number of samples in each chunk.
+     * @param [in] shuffle Whether to shuffle the samples within each chunk.
+     * @param [in] callback Optional performance callback.
+     * @return The average XCSF training error using the loss function.
+     */
+    double
+    fit_stream(const std::string &train_file, const int chunk,
+               const bool shuffle, const py::object &callback)
+    {
+        struct Stream *stream = stream_open(train_file.c_str(), chunk, shuffle);
+        double error = 0;
+        try {
+            error = fit_supervised(NULL, stream, NULL, shuffle, 0, callback);
+        } catch (...) {
+            stream_free(stream);
+            throw;
+        }
+        stream_free(stream);
+        return error;
+    }
+
+    /**
+     * @brief Executes MAX_TRIALS number of XCSF learning iterations using
+     * training data streamed from a binary dataset file and test iterations
+     * using the test data.
+     * @details Only two chunks of the training data are held in memory.
+     * @param [in] train_file The name of the binary dataset file.
+     * @param [in] test_X The input values to use for testing.
+     * @param [in] test_Y The true output values to use for testing.
+     * @param [in] chunk The number of samples in each chunk.
+     * @param [in] shuffle Whether to shuffle the samples within each chunk
+     * and to randomise the test instances.
+     * @param [in] callback Optional performance callback.
+     * @return The average XCSF training error using the loss function.
+     */
+    double
+    fit_stream(const std::string &train_file, const py::array_t<double> test_X,
+               const py::array_t<double> test_Y, const int chunk,
+               const bool shuffle, const py::object &callback)
+    {
+        const py::buffer_info buf_test_x = test_X.request();
+        const py::buffer_info buf_test_y = test_Y.request();
+        if (buf_test_x.shape[0] != buf_test_y.shape[0]) {
+            throw std::invalid_argument(
+                "testing X and Y n_samples are not equal");
+        }
+        // load testing data
+        const struct Input test = {
+            (double *) buf_test_x.ptr, (double *) buf_test_y.ptr,
+            (int) buf_test_x.shape[1], (int) buf_test_y.shape[1],
+            (int) buf_test_x.shape[0]
+        };
+        struct Stream *stream = stream_open(train_file.c_str(), chunk, shuffle);
+        if (stream->src.x_dim != test.x_dim ||
+            stream->src.y_dim != test.y_dim) {
+            stream_free(stream);
+            throw std::invalid_argument(
+                "number of train and test cols are not equal");
+        }
+        double error = 0;
+        try {
+            error = fit_supervised(NULL, stream, &test, shuffle, 0, callback);
+        } catch (...) {
+            stream_free(stream);
+            throw;
+        }
+        stream_free(stream);
+        return error;
     }
 
     /**
      * @brief Returns the XCSF prediction array for the provided input.
+     * @details Float64 and float32 inputs of any memory layout are read in
+     * place and the predictions are written directly into the output array.
+     * Only non-contiguous or float32 data is converted, one block of rows at a
+     * time. The GIL is released while predicting.
      * @param [in] x The input variables.
+     * @param [in] out Optional float64 array to receive the predictions.
      * @return The prediction array values.
      */
-    py::array_t<double>
-    predict(const py::array_t<double> x)
+    py::object
+    predict(const py::array &x, const py::object &out)
     {
+        ModelLock lock(mutex);
         // inputs to predict
-        const py::buffer_info buf_x = x.request();
-        const int n_samples = buf_x.shape[0];
-        const double *input = (double *) buf_x.ptr;
+        py::array input = x;
+        if (!py::isinstance<py::array_t<double>>(input) &&
+            !py::isinstance<py::array_t<float>>(input)) {
+            input = py::array_t<double, py::array::forcecast>::ensure(x);
+        }
+        if (!input || input.ndim() != 2 || input.shape(1) != xcs.x_dim) {
+            throw std::invalid_argument(
+                "predict() X must have shape (n_samples, " +
+                std::to_string(xcs.x_dim) + ")");
+        }
+        const int n_samples = input.shape(0);
         // predicted outputs
-        double *output =
-            (double *) malloc(sizeof(double) * n_samples * xcs.pa_size);
-        xcs_supervised_predict(&xcs, input, output, n_samples);
-        // return numpy array
-        return py::array_t<double>(
-            std::vector<ptrdiff_t>{ n_samples, xcs.pa_size }, output);
+        py::array output;
+        if (out.is_none()) {
+            double *data =
+                (double *) malloc(sizeof(double) * n_samples * xcs.pa_size);
+            py::capsule owner(data, [](void *p) { free(p); });
+            const ptrdiff_t row = xcs.pa_size * sizeof(double);
+            output = py::array_t<double>(
+                std::vector<ptrdiff_t>{ n_samples, xcs.pa_size },
+                std::vector<ptrdiff_t>{ row, sizeof(double) }, data, owner);
+        } else {
+            if (!py::isinstance<py::array_t<double>>(out)) {
+                throw std::invalid_argument(
+                    "predict() out must be a float64 array");
+            }
+            output = py::reinterpret_borrow<py::array>(out);
+            if (output.ndim() != 2 || output.shape(0) != n_samples ||
+                output.shape(1) != xcs.pa_size) {
+                throw std::invalid_argument(
+                    "predict() out must have shape (" +
+                    std::to_string(n_samples) + ", " +
+                    std::to_string(xcs.pa_size) + ")");
+            }
+        }
+        struct Strided in = { (const char *) input.data(), input.strides(0),
+                              input.strides(1),
+                              py::isinstance<py::array_t<float>>(input) };
+        struct Strided pred = { (char *) output.mutable_data(),
+                                output.strides(0), output.strides(1), false };
+        {
+            py::gil_scoped_release release;
+            predict_strided(&in, &pred, n_samples);
+        }
+        return std::move(output);
     }
 
     /**
@@ -456,18 +844,18 @@ class XCS
         const py::buffer_info buf_x = test_X.request();
         const py::buffer_info buf_y = test_Y.request();
         if (buf_x.shape[0] != buf_y.shape[0]) {
-            printf("error: training X and Y n_samples are not equal\n");
-            exit(EXIT_FAILURE);
+            throw std::invalid_argument(
+                "training X and Y n_samples are not equal");
         }
-        test_data->n_samples = buf_x.shape[0];
-        test_data->x_dim = buf_x.shape[1];
-        test_data->y_dim = buf_y.shape[1];
-        test_data->x = (double *) buf_x.ptr;
-        test_data->y = (double *) buf_y.ptr;
+        const struct Input test = { (double *) buf_x.ptr, (double *) buf_y.ptr,
+                                    (int) buf_x.shape[1], (int) buf_y.shape[1],
+                                    (int) buf_x.shape[0] };
+        py::gil_scoped_release release;
+        std::lock_guard<std::recursive_mutex> guard(mutex);
         if (N > 1) {
-            return xcs_supervised_score_n(&xcs, test_data, N);
+            return xcs_supervised_score_n(&xcs, &test, N);
         }
-        return xcs_supervised_score(&xcs, test_data);
+        return xcs_supervised_score(&xcs, &test);
     }
 
     /* GETTERS */
@@ -479,309 +867,553 @@ class XCS
     double
     error(void)
     {
+        ModelLock lock(mutex);
         return xcs.error;
     }
 
     int
     get_omp_num_threads(void)
     {
+        ModelLock lock(mutex);
         return xcs.OMP_NUM_THREADS;
     }
 
     bool
     get_pop_init(void)
     {
+        ModelLock lock(mutex);
         return xcs.POP_INIT;
     }
 
     int
     get_max_trials(void)
     {
+        ModelLock lock(mutex);
         return xcs.MAX_TRIALS;
     }
 
     int
     get_perf_trials(void)
     {
+        ModelLock lock(mutex);
         return xcs.PERF_TRIALS;
     }
 
+    int
+    get_checkpoint_trials(void)
+    {
+        ModelLock lock(mutex);
+        return xcs.CHECKPOINT_TRIALS;
+    }
+
+    const char *
+    get_checkpoint_file(void)
+    {
+        ModelLock lock(mutex);
+        return xcs.CHECKPOINT_FILE;
+    }
+
+    const char *
+    get_metrics_format(void)
+    {
+        ModelLock lock(mutex);
+        return metrics_format_as_string(xcs.METRICS_FORMAT);
+    }
+
+    const char *
+    get_metrics_file(void)
+    {
+        ModelLock lock(mutex);
+        return xcs.METRICS_FILE;
+    }
+
     int
     get_pop_max_size(void)
     {
+        ModelLock lock(mutex);
         return xcs.POP_SIZE;
     }
 
     const char *
     get_loss_func(void)
     {
+        ModelLock lock(mutex);
         return loss_type_as_string(xcs.LOSS_FUNC);
     }
 
     double
     get_huber_delta(void)
     {
+        ModelLock lock(mutex);
         return xcs.HUBER_DELTA;
     }
 
     double
     get_alpha(void)
     {
+        ModelLock lock(mutex);
         return xcs.ALPHA;
     }
 
     double
     get_beta(void)
     {
+        ModelLock lock(mutex);
         return xcs.BETA;
     }
 
     double
     get_delta(void)
     {
+        ModelLock lock(mutex);
         return xcs.DELTA;
     }
 
     double
     get_e0(void)
     {
+        ModelLock lock(mutex);
         return xcs.E0;
     }
 
     double
     get_init_error(void)
     {
+        ModelLock lock(mutex);
         return xcs.INIT_ERROR;
     }
 
     double
     get_init_fitness(void)
     {
+        ModelLock lock(mutex);
         return xcs.INIT_FITNESS;
     }
 
     double
     get_nu(void)
     {
+        ModelLock lock(mutex);
         return xcs.NU;
     }
 
     int
     get_m_probation(void)
     {
+        ModelLock lock(mutex);
         return xcs.M_PROBATION;
     }
 
     bool
     get_stateful(void)
     {
+        ModelLock lock(mutex);
         return xcs.STATEFUL;
     }
 
     bool
     get_compaction(void)
     {
+        ModelLock lock(mutex);
         return xcs.COMPACTION;
     }
 
     int
     get_theta_del(void)
     {
+        ModelLock lock(mutex);
         return xcs.THETA_DEL;
     }
 
     int
     get_theta_sub(void)
     {
+        ModelLock lock(mutex);
         return xcs.THETA_SUB;
     }
 
     bool
     get_set_subsumption(void)
     {
+        ModelLock lock(mutex);
         return xcs.SET_SUBSUMPTION;
     }
 
     int
     get_pset_size(void)
     {
+        ModelLock lock(mutex);
         return xcs.pset.size;
     }
 
     int
     get_pset_num(void)
     {
+        ModelLock lock(mutex);
         return xcs.pset.num;
     }
 
     int
     get_time(void)
     {
+        ModelLock lock(mutex);
         return xcs.time;
     }
 
     double
     get_x_dim(void)
     {
+        ModelLock lock(mutex);
         return xcs.x_dim;
     }
 
     double
     get_y_dim(void)
     {
+        ModelLock lock(mutex);
         return xcs.y_dim;
     }
 
     double
     get_n_actions(void)
     {
+        ModelLock lock(mutex);
         return xcs.n_actions;
     }
 
+    /**
+     * @brief Returns the heap memory used by the population, by component.
+     * @return A dictionary of the number of bytes used by the classifiers,
+     * conditions, predictions, actions, shared temporary storage, and total.
+     */
+    py::dict
+    get_pset_bytes(void)
+    {
+        ModelLock lock(mutex);
+        struct SetBytes bytes;
+        clset_bytes(&xcs, &xcs.pset, &bytes);
+        py::dict totals;
+        totals["cl"] = bytes.cl;
+        totals["cond"] = bytes.cond;
+        totals["pred"] = bytes.pred;
+        totals["act"] = bytes.act;
+        totals["shared"] = bytes.shared;
+        totals["total"] =
+            bytes.cl + bytes.cond + bytes.pred + bytes.act + bytes.shared;
+        return totals;
+    }
+
     double
     get_pset_mean_cond_size(void)
     {
+        ModelLock lock(mutex);
         return clset_mean_cond_size(&xcs, &xcs.pset);
     }
 
     double
     get_pset_mean_pred_size(void)
     {
+        ModelLock lock(mutex);
         return clset_mean_pred_size(&xcs, &xcs.pset);
     }
 
     double
     get_pset_mean_pred_eta(const int layer)
     {
+        ModelLock lock(mutex);
         return clset_mean_pred_eta(&xcs, &xcs.pset, layer);
     }
 
     double
     get_pset_mean_pred_neurons(const int layer)
     {
+        ModelLock lock(mutex);
         return clset_mean_pred_neurons(&xcs, &xcs.pset, layer);
     }
 
     double
     get_pset_mean_pred_connections(const int layer)
     {
+        ModelLock lock(mutex);
         return clset_mean_pred_connections(&xcs, &xcs.pset, layer);
     }
 
     double
     get_pset_mean_pred_layers(void)
     {
+        ModelLock lock(mutex);
         return clset_mean_pred_layers(&xcs, &xcs.pset);
     }
 
     double
     get_pset_mean_cond_connections(const int layer)
     {
+        ModelLock lock(mutex);
         return clset_mean_cond_connections(&xcs, &xcs.pset, layer);
     }
 
     double
     get_pset_mean_cond_neurons(const int layer)
     {
+        ModelLock lock(mutex);
         return clset_mean_cond_neurons(&xcs, &xcs.pset, layer);
     }
 
     double
     get_pset_mean_cond_layers(void)
     {
+        ModelLock lock(mutex);
         return clset_mean_cond_layers(&xcs, &xcs.pset);
     }
 
+    /**
+     * @brief Returns the fitness of each classifier in the population.
+     * @return A float64 array of shape (pset_size,).
+     */
+    py::array_t<double>
+    get_pset_fitness(void)
+    {
+        ModelLock lock(mutex);
+        py::array_t<double> fit(xcs.pset.size);
+        clset_export_cl(&xcs.pset, NULL, fit.mutable_data(), NULL, NULL);
+        return fit;
+    }
+
+    /**
+     * @brief Returns the error of each classifier in the population.
+     * @return A float64 array of shape (pset_size,).
+     */
+    py::array_t<double>
+    get_pset_error(void)
+    {
+        ModelLock lock(mutex);
+        py::array_t<double> err(xcs.pset.size);
+        clset_export_cl(&xcs.pset, err.mutable_data(), NULL, NULL, NULL);
+        return err;
+    }
+
+    /**
+     * @brief Returns the numerosity of each classifier in the population.
+     * @return An int32 array of shape (pset_size,).
+     */
+    py::array_t<int>
+    get_pset_numerosity(void)
+    {
+        ModelLock lock(mutex);
+        py::array_t<int> num(xcs.pset.size);
+        clset_export_cl(&xcs.pset, NULL, NULL, num.mutable_data(), NULL);
+        return num;
+    }
+
+    /**
+     * @brief Returns the experience of each classifier in the population.
+     * @return An int32 array of shape (pset_size,).
+     */
+    py::array_t<int>
+    get_pset_experience(void)
+    {
+        ModelLock lock(mutex);
+        py::array_t<int> exp(xcs.pset.size);
+        clset_export_cl(&xcs.pset, NULL, NULL, NULL, exp.mutable_data());
+        return exp;
+    }
+
+    /**
+     * @brief Returns the condition centers of the population.
+     * @details Only hyperrectangle and hyperellipsoid conditions have centers.
+     * @return A float64 array of shape (pset_size, x_dim).
+     */
+    py::array_t<double>
+    get_pset_center(void)
+    {
+        ModelLock lock(mutex);
+        const int n = clset_export_cond(&xcs, &xcs.pset, NULL, NULL);
+        py::array_t<double> center({ xcs.pset.size, n });
+        clset_export_cond(&xcs, &xcs.pset, center.mutable_data(), NULL);
+        return center;
+    }
+
+    /**
+     * @brief Returns the condition spreads of the population.
+     * @details Only hyperrectangle and hyperellipsoid conditions have spreads.
+     * @return A float64 array of shape (pset_size, x_dim).
+     */
+    py::array_t<double>
+    get_pset_spread(void)
+    {
+        ModelLock lock(mutex);
+        const int n = clset_export_cond(&xcs, &xcs.pset, NULL, NULL);
+        py::array_t<double> spread({ xcs.pset.size, n });
+        clset_export_cond(&xcs, &xcs.pset, NULL, spread.mutable_data());
+        return spread;
+    }
+
+    /**
+     * @brief Returns the prediction weights of the population.
+     * @details Only NLMS and RLS predictions have weight matrices.
+     * @return A float64 array of shape (pset_size, y_dim, n_weights).
+     */
+    py::array_t<double>
+    get_pset_pred_weights(void)
+    {
+        ModelLock lock(mutex);
+        const int n = clset_export_pred(&xcs, &xcs.pset, NULL) / xcs.y_dim;
+        py::array_t<double> weights({ xcs.pset.size, xcs.y_dim, n });
+        clset_export_pred(&xcs, &xcs.pset, weights.mutable_data());
+        return weights;
+    }
+
+    /**
+     * @brief Returns the weights of a neural layer throughout the population.
+     * @details All weights are copied into a single array; the returned list
+     * holds one view of it for each classifier.
+     * @param [in] cond Whether to return condition rather than prediction
+     * layers.
+     * @param [in] layer The position of the layer.
+     * @return A list of float64 arrays.
+     */
+    py::list
+    pset_layer_weights(const bool cond, const int layer)
+    {
+        ModelLock lock(mutex);
+        std::vector<int> n_weights(xcs.pset.size);
+        const size_t total = clset_export_layer(&xcs, &xcs.pset, cond, layer,
+                                                NULL, n_weights.data());
+        py::array_t<double> weights(total);
+        double *data = weights.mutable_data();
+        clset_export_layer(&xcs, &xcs.pset, cond, layer, data, NULL);
+        py::list views;
+        for (const int n : n_weights) {
+            views.append(py::array_t<double>(n, data, weights));
+            data += n;
+        }
+        return views;
+    }
+
+    py::list
+    get_pset_cond_layer_weights(const int layer)
+    {
+        return pset_layer_weights(true, layer);
+    }
+
+    py::list
+    get_pset_pred_layer_weights(const int layer)
+    {
+        return pset_layer_weights(false, layer);
+    }
+
     double
     get_mset_size(void)
     {
+        ModelLock lock(mutex);
         return xcs.mset_size;
     }
 
     double
     get_aset_size(void)
     {
+        ModelLock lock(mutex);
         return xcs.aset_size;
     }
 
     double
     get_mfrac(void)
     {
+        ModelLock lock(mutex);
         return xcs.mfrac;
     }
 
     int
     get_teletransportation(void)
     {
+        ModelLock lock(mutex);
         return xcs.TELETRANSPORTATION;
     }
 
     double
     get_gamma(void)
     {
+        ModelLock lock(mutex);
         return xcs.GAMMA;
     }
 
     double
     get_p_explore(void)
     {
+        ModelLock lock(mutex);
         return xcs.P_EXPLORE;
     }
 
     int
     get_ea_select_type(void)
     {
+        ModelLock lock(mutex);
         return xcs.ea->select_type;
     }
 
     double
     get_ea_select_size(void)
     {
+        ModelLock lock(mutex);
         return xcs.ea->select_size;
     }
 
     double
     get_theta_ea(void)
     {
+        ModelLock lock(mutex);
         return xcs.ea->theta;
     }
 
     int
     get_lambda(void)
     {
+        ModelLock lock(mutex);
         return xcs.ea->lambda;
     }
 
     double
     get_p_crossover(void)
     {
+        ModelLock lock(mutex);
         return xcs.ea->p_crossover;
     }
 
     double
     get_err_reduc(void)
     {
+        ModelLock lock(mutex);
         return xcs.ea->err_reduc;
     }
 
     double
     get_fit_reduc(void)
     {
+        ModelLock lock(mutex);
         return xcs.ea->fit_reduc;
     }
 
     bool
     get_ea_subsumption(void)
     {
+        ModelLock lock(mutex);
         return xcs.ea->subsumption;
     }
 
     bool
     get_ea_pred_reset(void)
     {
+        ModelLock lock(mutex);
         return xcs.ea->pred_reset;
     }
 
+    int
+    get_pred_batch_size(void)
+    {
+        ModelLock lock(mutex);
+        return xcs.pred->batch_size;
+    }
+
     /* SETTERS */
 
     /**
@@ -791,6 +1423,7 @@ class XCS
     void
     set_condition(const std::string &type)
     {
+        ModelLock lock(mutex);
         cond_param_set_type_string(&xcs, type.c_str());
     }
 
@@ -801,6 +1434,7 @@ class XCS
     void
     set_action(const std::string &type)
     {
+        ModelLock lock(mutex);
         action_param_set_type_string(&xcs, type.c_str());
     }
 
@@ -811,6 +1445,7 @@ class XCS
     void
     set_prediction(const std::string &type)
     {
+        ModelLock lock(mutex);
         pred_param_set_type_string(&xcs, type.c_str());
     }
 
@@ -822,6 +1457,7 @@ class XCS
     void
     set_condition(const std::string &type, const py::dict &args)
     {
+        ModelLock lock(mutex);
         cond_param_set_type_string(&xcs, type.c_str());
         switch (xcs.cond->type) {
             case COND_TYPE_HYPERRECTANGLE:
@@ -920,6 +1556,8 @@ class XCS
                 graph_param_set_n(dargs, item.second.cast<int>());
             } else if (name == "evolve-cycles") {
                 graph_param_set_evolve_cycles(dargs, item.second.cast<bool>());
+            } else if (name == "sparse-mutate") {
+                graph_param_set_sparse_mutate(dargs, item.second.cast<bool>());
             } else {
                 printf("Unknown DGP parameter: %s\n", name.c_str());
                 exit(EXIT_FAILURE);
@@ -1001,6 +1639,8 @@ class XCS
                 larg->evolve_eta = item.second.cast<bool>();
             } else if (name == "sgd-weights") {
                 larg->sgd_weights = item.second.cast<bool>();
+            } else if (name == "sparse-mutate") {
+                larg->sparse_mutate = item.second.cast<bool>();
             } else if (name == "activation") {
                 const auto value = item.second.cast<std::string>();
                 larg->function = neural_activation_as_int(value.c_str());
@@ -1051,6 +1691,7 @@ class XCS
     void
     set_action(const std::string &type, const py::dict &args)
     {
+        ModelLock lock(mutex);
         action_param_set_type_string(&xcs, type.c_str());
         if (xcs.act->type == ACT_TYPE_NEURAL) {
             unpack_act_neural(args);
@@ -1091,6 +1732,7 @@ class XCS
     void
     set_prediction(const std::string &type, const py::dict &args)
     {
+        ModelLock lock(mutex);
         pred_param_set_type_string(&xcs, type.c_str());
         switch (xcs.pred->type) {
             case PRED_TYPE_NLMS_LINEAR:
@@ -1184,207 +1826,340 @@ class XCS
     void
     set_omp_num_threads(const int a)
     {
+        ModelLock lock(mutex);
         param_set_omp_num_threads(&xcs, a);
     }
 
     void
     set_pop_init(const bool a)
     {
+        ModelLock lock(mutex);
         param_set_pop_init(&xcs, a);
     }
 
     void
     set_max_trials(const int a)
     {
+        ModelLock lock(mutex);
         param_set_max_trials(&xcs, a);
     }
 
     void
     set_perf_trials(const int a)
     {
+        ModelLock lock(mutex);
         param_set_perf_trials(&xcs, a);
     }
 
+    void
+    set_checkpoint_trials(const int a)
+    {
+        ModelLock lock(mutex);
+        param_set_checkpoint_trials(&xcs, a);
+    }
+
+    void
+    set_checkpoint_file(const char *a)
+    {
+        ModelLock lock(mutex);
+        param_set_checkpoint_file(&xcs, a);
+    }
+
+    void
+    set_metrics_format(const char *a)
+    {
+        ModelLock lock(mutex);
+        param_set_metrics_format_string(&xcs, a);
+    }
+
+    void
+    set_metrics_file(const char *a)
+    {
+        ModelLock lock(mutex);
+        param_set_metrics_file(&xcs, a);
+    }
+
     void
     set_pop_max_size(const int a)
     {
+        ModelLock lock(mutex);
         param_set_pop_size(&xcs, a);
     }
 
     void
     set_loss_func(const char *a)
     {
+        ModelLock lock(mutex);
         param_set_loss_func_string(&xcs, a);
     }
 
     void
     set_huber_delta(const double a)
     {
+        ModelLock lock(mutex);
         param_set_huber_delta(&xcs, a);
     }
 
     void
     set_alpha(const double a)
     {
+        ModelLock lock(mutex);
         param_set_alpha(&xcs, a);
     }
 
     void
     set_beta(const double a)
     {
+        ModelLock lock(mutex);
         param_set_beta(&xcs, a);
     }
 
     void
     set_delta(const double a)
     {
+        ModelLock lock(mutex);
         param_set_delta(&xcs, a);
     }
 
     void
     set_e0(const double a)
     {
+        ModelLock lock(mutex);
         param_set_e0(&xcs, a);
     }
 
     void
     set_init_error(const double a)
     {
+        ModelLock lock(mutex);
         param_set_init_error(&xcs, a);
     }
 
     void
     set_init_fitness(const double a)
     {
+        ModelLock lock(mutex);
         param_set_init_fitness(&xcs, a);
     }
 
     void
     set_nu(const double a)
     {
+        ModelLock lock(mutex);
         param_set_nu(&xcs, a);
     }
 
     void
     set_m_probation(const int a)
     {
+        ModelLock lock(mutex);
         param_set_m_probation(&xcs, a);
     }
 
     void
     set_theta_del(const int a)
     {
+        ModelLock lock(mutex);
         param_set_theta_del(&xcs, a);
     }
 
     void
     set_theta_sub(const int a)
     {
+        ModelLock lock(mutex);
         param_set_theta_sub(&xcs, a);
     }
 
     void
     set_set_subsumption(const bool a)
     {
+        ModelLock lock(mutex);
         param_set_set_subsumption(&xcs, a);
     }
 
     void
     set_teletransportation(const int a)
     {
+        ModelLock lock(mutex);
         param_set_teletransportation(&xcs, a);
     }
 
     void
     set_stateful(const bool a)
     {
+        ModelLock lock(mutex);
         param_set_stateful(&xcs, a);
     }
 
     void
     set_compaction(const bool a)
     {
+        ModelLock lock(mutex);
         param_set_compaction(&xcs, a);
     }
 
     void
     set_gamma(const double a)
     {
+        ModelLock lock(mutex);
         param_set_gamma(&xcs, a);
     }
 
     void
     set_p_explore(const double a)
     {
+        ModelLock lock(mutex);
         param_set_p_explore(&xcs, a);
     }
 
     void
     set_ea_select_type(const char *a)
     {
+        ModelLock lock(mutex);
         ea_param_set_type_string(&xcs, a);
     }
 
     void
     set_ea_select_size(const double a)
     {
+        ModelLock lock(mutex);
         ea_param_set_select_size(&xcs, a);
     }
 
     void
     set_theta_ea(const double a)
     {
+        ModelLock lock(mutex);
         ea_param_set_theta(&xcs, a);
     }
 
     void
     set_lambda(const int a)
     {
+        ModelLock lock(mutex);
         ea_param_set_lambda(&xcs, a);
     }
 
     void
     set_p_crossover(const double a)
     {
+        ModelLock lock(mutex);
         ea_param_set_p_crossover(&xcs, a);
     }
 
     void
     set_err_reduc(const double a)
     {
+        ModelLock lock(mutex);
         ea_param_set_err_reduc(&xcs, a);
     }
 
     void
     set_fit_reduc(const double a)
     {
+        ModelLock lock(mutex);
         ea_param_set_fit_reduc(&xcs, a);
     }
 
     void
     set_ea_subsumption(const bool a)
     {
+        ModelLock lock(mutex);
         ea_param_set_subsumption(&xcs, a);
     }
 
     void
     set_ea_pred_reset(const bool a)
     {
+        ModelLock lock(mutex);
         ea_param_set_pred_reset(&xcs, a);
     }
+
+    void
+    set_pred_batch_size(const int a)
+    {
+        ModelLock lock(mutex);
+        pred_param_set_batch_size(&xcs, a);
+    }
 };
 
+/**
+ * @brief Returns the cumulative per-phase timings and event counts.
+ * @details All totals are zero unless built with PROFILE.
+ * @return A dict mapping each phase to a (seconds, calls) tuple and each
+ * counter to its number of events.
+ */
+static py::dict
+profile_totals(void)
+{
+    py::dict totals;
+    for (int i = 0; i < PROF_PHASES; ++i) {
+        totals[profile_phase_name(i)] =
+            py::make_tuple(profile_time(i), profile_calls(i));
+    }
+    for (int i = 0; i < PROF_COUNTERS; ++i) {
+        totals[profile_counter_name(i)] = profile_counter(i);
+    }
+    return totals;
+}
+
+/**
+ * @brief Returns the hardware events sampled within each phase.
+ * @details Only phases with sampled cycles are included. Hardware counters
+ * must first be opened with profile_hw_open().
+ * @return A dict mapping each phase to a dict of event counts and IPC, and
+ * "misses_per_matched" to the cache misses per classifier matched.
+ */
+static py::dict
+profile_hw_totals(void)
+{
+    py::dict totals;
+    for (int i = 0; i < PROF_PHASES; ++i) {
+        if (profile_hw(i, PROF_HW_CYCLES) == 0) {
+            continue;
+        }
+        py::dict events;
+        for (int j = 0; j < PROF_HW_EVENTS; ++j) {
+            events[profile_hw_name(j)] = profile_hw(i, j);
+        }
+        events["ipc"] = profile_ipc(i);
+        totals[profile_phase_name(i)] = events;
+    }
+    totals["misses_per_matched"] = profile_misses_per_matched();
+    return totals;
+}
+
 PYBIND11_MODULE(xcsf, m)
 {
     rand_init();
 
+    m.def("profile", &profile_totals);
+    m.def("profile_enabled", &profile_enabled);
+    m.def("profile_reset", &profile_reset);
+    m.def("profile_hw", &profile_hw_totals);
+    m.def("profile_hw_open", &profile_hw_open);
+    m.def("profile_hw_close", &profile_hw_close);
+
     double (XCS::*fit1)(const py::array_t<double>, const int, const double) =
         &XCS::fit;
     double (XCS::*fit2)(const py::array_t<double>, const py::array_t<double>,
-                        const bool) = &XCS::fit;
+                        const bool, const py::object &) = &XCS::fit;
     double (XCS::*fit3)(const py::array_t<double>, const py::array_t<double>,
                         const py::array_t<double>, const py::array_t<double>,
-                        const bool) = &XCS::fit;
+                        const bool, const py::object &) = &XCS::fit;
+    double (XCS::*fit4)(const py::array_t<double>, const py::array_t<double>,
+                        const bool, const int, const py::object &) = &XCS::fit;
+    double (XCS::*fit5)(const py::array_t<double>, const py::array_t<double>,
+                        const py::array_t<double>, const py::array_t<double>,
+                        const bool, const int, const py::object &) =
+        &XCS::fit;
+
+    double (XCS::*fit_stream1)(const std::string &, const int, const bool,
+                               const py::object &) = &XCS::fit_stream;
+    double (XCS::*fit_stream2)(const std::string &, const py::array_t<double>,
+                               const py::array_t<double>, const int,
+                               const bool, const py::object &) =
+        &XCS::fit_stream;
 
     double (XCS::*score1)(const py::array_t<double> test_X,
                           const py::array_t<double> test_Y) = &XCS::score;
@@ -1410,6 +2185,8 @@ PYBIND11_MODULE(xcsf, m)
     py::class_<XCS>(m, "XCS")
         .def(py::init<const int, const int, const int>())
         .def(py::init<const int, const int, const int, const char *>())
+        .def(py::pickle([](XCS &self) { return self.get_state(); },
+                        [](const py::bytes &state) { return new XCS(state); }))
         .def("condition", condition1)
         .def("condition", condition2)
         .def("action", action1)
@@ -1417,13 +2194,29 @@ PYBIND11_MODULE(xcsf, m)
         .def("prediction", prediction1)
         .def("prediction", prediction2)
         .def("fit", fit1)
-        .def("fit", fit2)
-        .def("fit", fit3)
+        .def("fit", fit2, py::arg("train_X"), py::arg("train_Y"),
+             py::arg("shuffle"), py::arg("callback") = py::none())
+        .def("fit", fit3, py::arg("train_X"), py::arg("train_Y"),
+             py::arg("test_X"), py::arg("test_Y"), py::arg("shuffle"),
+             py::arg("callback") = py::none())
+        .def("fit", fit4, py::arg("train_X"), py::arg("train_Y"),
+             py::arg("shuffle"), py::arg("batch_size"),
+             py::arg("callback") = py::none())
+        .def("fit", fit5, py::arg("train_X"), py::arg("train_Y"),
+             py::arg("test_X"), py::arg("test_Y"), py::arg("shuffle"),
+             py::arg("batch_size"), py::arg("callback") = py::none())
+        .def("fit_stream", fit_stream1, py::arg("train_file"),
+             py::arg("chunk"), py::arg("shuffle"),
+             py::arg("callback") = py::none())
+        .def("fit_stream", fit_stream2, py::arg("train_file"),
+             py::arg("test_X"), py::arg("test_Y"), py::arg("chunk"),
+             py::arg("shuffle"), py::arg("callback") = py::none())
         .def("score", score1)
         .def("score", score2)
         .def("error", error1)
         .def("error", error2)
-        .def("predict", &XCS::predict)
+        .def("predict", &XCS::predict, py::arg("X"),
+             py::arg("out") = py::none())
         .def("save", &XCS::save)
         .def("load", &XCS::load)
         .def("store", &XCS::store)
@@ -1443,6 +2236,14 @@ PYBIND11_MODULE(xcsf, m)
         .def_property("MAX_TRIALS", &XCS::get_max_trials, &XCS::set_max_trials)
         .def_property("PERF_TRIALS", &XCS::get_perf_trials,
                       &XCS::set_perf_trials)
+        .def_property("CHECKPOINT_TRIALS", &XCS::get_checkpoint_trials,
+                      &XCS::set_checkpoint_trials)
+        .def_property("CHECKPOINT_FILE", &XCS::get_checkpoint_file,
+                      &XCS::set_checkpoint_file)
+        .def_property("METRICS_FORMAT", &XCS::get_metrics_format,
+                      &XCS::set_metrics_format)
+        .def_property("METRICS_FILE", &XCS::get_metrics_file,
+                      &XCS::set_metrics_file)
         .def_property("POP_SIZE", &XCS::get_pop_max_size,
                       &XCS::set_pop_max_size)
         .def_property("LOSS_FUNC", &XCS::get_loss_func, &XCS::set_loss_func)
@@ -1482,12 +2283,15 @@ PYBIND11_MODULE(xcsf, m)
                       &XCS::set_ea_subsumption)
         .def_property("EA_PRED_RESET", &XCS::get_ea_pred_reset,
                       &XCS::set_ea_pred_reset)
+        .def_property("PRED_BATCH_SIZE", &XCS::get_pred_batch_size,
+                      &XCS::set_pred_batch_size)
         .def("time", &XCS::get_time)
         .def("x_dim", &XCS::get_x_dim)
         .def("y_dim", &XCS::get_y_dim)
         .def("n_actions", &XCS::get_n_actions)
         .def("pset_size", &XCS::get_pset_size)
         .def("pset_num", &XCS::get_pset_num)
+        .def("pset_bytes", &XCS::get_pset_bytes)
         .def("pset_mean_cond_size", &XCS::get_pset_mean_cond_size)
         .def("pset_mean_pred_size", &XCS::get_pset_mean_pred_size)
         .def("pset_mean_pred_eta", &XCS::get_pset_mean_pred_eta)
@@ -1497,6 +2301,15 @@ PYBIND11_MODULE(xcsf, m)
         .def("pset_mean_cond_neurons", &XCS::get_pset_mean_cond_neurons)
         .def("pset_mean_cond_layers", &XCS::get_pset_mean_cond_layers)
         .def("pset_mean_cond_connections", &XCS::get_pset_mean_cond_connections)
+        .def("pset_fitness", &XCS::get_pset_fitness)
+        .def("pset_error", &XCS::get_pset_error)
+        .def("pset_numerosity", &XCS::get_pset_numerosity)
+        .def("pset_experience", &XCS::get_pset_experience)
+        .def("pset_center", &XCS::get_pset_center)
+        .def("pset_spread", &XCS::get_pset_spread)
+        .def("pset_pred_weights", &XCS::get_pset_pred_weights)
+        .def("pset_cond_layer_weights", &XCS::get_pset_cond_layer_weights)
+        .def("pset_pred_layer_weights", &XCS::get_pset_pred_layer_weights)
         .def("mset_size", &XCS::get_mset_size)
         .def("aset_size", &XCS::get_aset_size)
         .def("mfrac", &XCS::get_mfrac)
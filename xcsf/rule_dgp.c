@@ -57,13 +57,14 @@ rule_dgp_cond_copy(const struct XCSF *xcsf, struct Cl *dest,
     dest->cond = new;
 }
 
-void
+bool
 rule_dgp_cond_cover(const struct XCSF *xcsf, const struct Cl *c,
                     const double *x)
 {
     (void) xcsf;
     (void) c;
     (void) x;
+    return true;
 }
 
 void
@@ -145,12 +146,21 @@ size_t
 rule_dgp_cond_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
 {
     struct RuleDGP *new = malloc(sizeof(struct RuleDGP));
-    size_t s = graph_load(&new->dgp, fp);
+    size_t s =
+        graph_load(&new->dgp, xcsf->cond->dargs, xcsf->load_build, fp);
     new->n_outputs = (int) fmax(1, ceil(log2(xcsf->n_actions)));
     c->cond = new;
     return s;
 }
 
+size_t
+rule_dgp_cond_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    (void) xcsf;
+    const struct RuleDGP *cond = c->cond;
+    return sizeof(struct RuleDGP) + graph_bytes(&cond->dgp);
+}
+
 /* ACTION FUNCTIONS */
 
 void
@@ -183,15 +193,24 @@ rule_dgp_act_print(const struct XCSF *xcsf, const struct Cl *c)
     (void) c;
 }
 
-void
+bool
 rule_dgp_act_cover(const struct XCSF *xcsf, const struct Cl *c, const double *x,
                    const int action)
 {
     struct RuleDGP *cond = c->cond;
-    do {
+    for (int i = 0; i < COND_COVER_ATTEMPTS; ++i) {
         graph_rand(&cond->dgp);
-    } while (!rule_dgp_cond_match(xcsf, c, x) &&
-             rule_dgp_act_compute(xcsf, c, x) != action);
+        if (rule_dgp_cond_match(xcsf, c, x) &&
+            rule_dgp_act_compute(xcsf, c, x) == action) {
+            return true;
+        }
+    }
+    bool covered = graph_cover(&cond->dgp, x, 0, true);
+    for (int i = 0; i < cond->n_outputs && covered; ++i) {
+        covered = graph_cover(&cond->dgp, x, i + 1, (action >> i) & 1);
+    }
+    return covered && rule_dgp_cond_match(xcsf, c, x) &&
+        rule_dgp_act_compute(xcsf, c, x) == action;
 }
 
 int
@@ -266,3 +285,11 @@ rule_dgp_act_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
     (void) fp;
     return 0;
 }
+
+size_t
+rule_dgp_act_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    (void) xcsf;
+    (void) c;
+    return 0;
+}
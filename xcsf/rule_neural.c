@@ -66,13 +66,14 @@ rule_neural_cond_copy(const struct XCSF *xcsf, struct Cl *dest,
     dest->cond = new;
 }
 
-void
+bool
 rule_neural_cond_cover(const struct XCSF *xcsf, const struct Cl *c,
                        const double *x)
 {
     (void) xcsf;
     (void) c;
     (void) x;
+    return true;
 }
 
 void
@@ -101,7 +102,7 @@ bool
 rule_neural_cond_mutate(const struct XCSF *xcsf, const struct Cl *c)
 {
     (void) xcsf;
-    const struct RuleNeural *cond = c->cond;
+    struct RuleNeural *cond = c->cond;
     return neural_mutate(&cond->net);
 }
 
@@ -160,6 +161,14 @@ rule_neural_cond_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
     return s;
 }
 
+size_t
+rule_neural_cond_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    (void) xcsf;
+    const struct RuleNeural *cond = c->cond;
+    return sizeof(struct RuleNeural) + neural_bytes(&cond->net);
+}
+
 /* ACTION FUNCTIONS */
 
 void
@@ -192,15 +201,25 @@ rule_neural_act_print(const struct XCSF *xcsf, const struct Cl *c)
     (void) c;
 }
 
-void
+bool
 rule_neural_act_cover(const struct XCSF *xcsf, const struct Cl *c,
                       const double *x, const int action)
 {
-    const struct RuleNeural *cond = c->cond;
-    do {
+    struct RuleNeural *cond = c->cond;
+    for (int i = 0; i < COND_COVER_ATTEMPTS; ++i) {
         neural_rand(&cond->net);
-    } while (!rule_neural_cond_match(xcsf, c, x) &&
-             rule_neural_act_compute(xcsf, c, x) != action);
+        if (rule_neural_cond_match(xcsf, c, x) &&
+            rule_neural_act_compute(xcsf, c, x) == action) {
+            return true;
+        }
+    }
+    bool covered = neural_cover_output(&cond->net, x, 0, true);
+    for (int i = 1; i < cond->net.n_outputs && covered; ++i) {
+        const bool high = (action >> (i - 1)) & 1;
+        covered = neural_cover_output(&cond->net, x, i, high);
+    }
+    return covered && rule_neural_cond_match(xcsf, c, x) &&
+        rule_neural_act_compute(xcsf, c, x) == action;
 }
 
 int
@@ -275,3 +294,11 @@ rule_neural_act_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp)
     (void) fp;
     return 0;
 }
+
+size_t
+rule_neural_act_bytes(const struct XCSF *xcsf, const struct Cl *c)
+{
+    (void) xcsf;
+    (void) c;
+    return 0;
+}
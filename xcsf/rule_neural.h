@@ -54,7 +54,7 @@ void
 rule_neural_cond_copy(const struct XCSF *xcsf, struct Cl *dest,
                       const struct Cl *src);
 
-void
+bool
 rule_neural_cond_cover(const struct XCSF *xcsf, const struct Cl *c,
                        const double *x);
 
@@ -80,6 +80,9 @@ rule_neural_cond_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp);
 size_t
 rule_neural_cond_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
 
+size_t
+rule_neural_cond_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
 /**
  * @brief Neural network rule condition implemented functions.
  */
@@ -90,7 +93,7 @@ static struct CondVtbl const rule_neural_cond_vtbl = {
     &rule_neural_cond_free,      &rule_neural_cond_init,
     &rule_neural_cond_print,     &rule_neural_cond_update,
     &rule_neural_cond_size,      &rule_neural_cond_save,
-    &rule_neural_cond_load
+    &rule_neural_cond_load,      &rule_neural_cond_bytes
 };
 
 bool
@@ -112,7 +115,7 @@ void
 rule_neural_act_copy(const struct XCSF *xcsf, struct Cl *dest,
                      const struct Cl *src);
 
-void
+bool
 rule_neural_act_cover(const struct XCSF *xcsf, const struct Cl *c,
                       const double *x, const int action);
 
@@ -135,6 +138,9 @@ rule_neural_act_save(const struct XCSF *xcsf, const struct Cl *c, FILE *fp);
 size_t
 rule_neural_act_load(const struct XCSF *xcsf, struct Cl *c, FILE *fp);
 
+size_t
+rule_neural_act_bytes(const struct XCSF *xcsf, const struct Cl *c);
+
 /**
  * @brief Neural network rule action implemented functions.
  */
@@ -144,5 +150,6 @@ static struct ActVtbl const rule_neural_act_vtbl = {
     &rule_neural_act_copy,    &rule_neural_act_cover,
     &rule_neural_act_free,    &rule_neural_act_init,
     &rule_neural_act_print,   &rule_neural_act_update,
-    &rule_neural_act_save,    &rule_neural_act_load
+    &rule_neural_act_save,    &rule_neural_act_load,
+    &rule_neural_act_bytes
 };
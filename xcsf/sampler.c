@@ -0,0 +1,134 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file sampler.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Drawing of samples from in-memory data sets.
+ */
+
+#include "sampler.h"
+#include "utils.h"
+
+#define SAMPLE_BLOCK (64) //!< Number of shuffled samples staged together
+#define PREFETCH_DIST (8) //!< Number of samples prefetched ahead of staging
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define PREFETCH(p) __builtin_prefetch(p)
+#else
+    #define PREFETCH(p)
+#endif
+
+/**
+ * @brief Initialises a sampler.
+ * @param [in] s The sampler to initialise.
+ * @param [in] data The data set to sample.
+ * @param [in] shuffle Whether to draw samples in shuffled epochs.
+ */
+void
+sampler_init(struct Sampler *s, const struct Input *data, const bool shuffle)
+{
+    s->data = data;
+    s->shuffle = shuffle;
+    s->order = NULL;
+    s->x = NULL;
+    s->y = NULL;
+    s->pos = data->n_samples;
+    s->n_staged = 0;
+    s->next = 0;
+    if (shuffle) {
+        s->order = malloc(sizeof(int) * data->n_samples);
+        for (int i = 0; i < data->n_samples; ++i) {
+            s->order[i] = i;
+        }
+        s->x = malloc(sizeof(double) * SAMPLE_BLOCK * data->x_dim);
+        s->y = malloc(sizeof(double) * SAMPLE_BLOCK * data->y_dim);
+    }
+}
+
+/**
+ * @brief Frees the memory used by a sampler.
+ * @param [in] s The sampler to free.
+ */
+void
+sampler_free(const struct Sampler *s)
+{
+    free(s->order);
+    free(s->x);
+    free(s->y);
+}
+
+/**
+ * @brief Gathers the next block of permuted samples into the staging buffers.
+ * @param [in] s The sampler.
+ */
+static void
+sampler_stage(struct Sampler *s)
+{
+    const struct Input *data = s->data;
+    const int n = data->n_samples;
+    for (int k = 0; k < SAMPLE_BLOCK; ++k) {
+        if (s->pos >= n) { // new epoch
+            for (int i = n - 1; i > 0; --i) {
+                const int j = rand_uniform_int(0, i + 1);
+                const int tmp = s->order[i];
+                s->order[i] = s->order[j];
+                s->order[j] = tmp;
+            }
+            s->pos = 0;
+        }
+        if (s->pos + PREFETCH_DIST < n) {
+            const int ahead = s->order[s->pos + PREFETCH_DIST];
+            PREFETCH(&data->x[(size_t) ahead * data->x_dim]);
+            PREFETCH(&data->y[(size_t) ahead * data->y_dim]);
+        }
+        const int row = s->order[s->pos];
+        ++(s->pos);
+        memcpy(&s->x[k * data->x_dim], &data->x[(size_t) row * data->x_dim],
+               sizeof(double) * data->x_dim);
+        memcpy(&s->y[k * data->y_dim], &data->y[(size_t) row * data->y_dim],
+               sizeof(double) * data->y_dim);
+    }
+    s->n_staged = SAMPLE_BLOCK;
+    s->next = 0;
+}
+
+/**
+ * @brief Draws the next sample.
+ * @param [in] s The sampler.
+ * @param [in] cnt The current sequence counter.
+ * @param [out] x The feature variables of the sample.
+ * @param [out] y The target variables of the sample.
+ */
+void
+sampler_next(struct Sampler *s, const int cnt, const double **x,
+             const double **y)
+{
+    const struct Input *data = s->data;
+    if (!s->shuffle) {
+        const int row = cnt % data->n_samples;
+        *x = &data->x[row * data->x_dim];
+        *y = &data->y[row * data->y_dim];
+        return;
+    }
+    if (s->next >= s->n_staged) {
+        sampler_stage(s);
+    }
+    *x = &s->x[s->next * data->x_dim];
+    *y = &s->y[s->next * data->y_dim];
+    ++(s->next);
+}
@@ -0,0 +1,54 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file sampler.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Drawing of samples from in-memory data sets.
+ */
+
+#pragma once
+
+#include "xcsf.h"
+
+/**
+ * @brief Draws the samples of a data set in shuffled epochs.
+ * @details Each epoch visits every sample once in a random permutation.
+ * Blocks of the permuted samples are gathered into contiguous staging
+ * buffers, prefetching the rows ahead, so that trials read the samples
+ * sequentially from memory.
+ */
+struct Sampler {
+    const struct Input *data; //!< The data set sampled
+    bool shuffle; //!< Whether to draw samples in shuffled epochs
+    int *order; //!< Permutation of the current epoch
+    int pos; //!< Next position within the permutation
+    double *x; //!< Staged feature variables
+    double *y; //!< Staged target variables
+    int n_staged; //!< Number of samples staged
+    int next; //!< Next staged sample to be drawn
+};
+
+void
+sampler_init(struct Sampler *s, const struct Input *data, const bool shuffle);
+
+void
+sampler_free(const struct Sampler *s);
+
+void
+sampler_next(struct Sampler *s, const int cnt, const double **x,
+             const double **y);
@@ -0,0 +1,325 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file stream.c
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Double-buffered streaming of training data.
+ * @details A chunk is read from the source into one buffer while samples are
+ * drawn from the other, so that reading overlaps with learning and only two
+ * chunks are ever resident. The random permutation of each chunk is drawn by
+ * the consumer so that the sequence of random numbers, and therefore the
+ * result of a run, does not depend on thread timing.
+ */
+
+#include "stream.h"
+#include "dataset.h"
+#include "utils.h"
+
+#ifndef _WIN32
+    #define STREAM_SEEK(fp, offset) fseeko(fp, (off_t) (offset), SEEK_SET)
+#else
+    #define STREAM_SEEK(fp, offset) _fseeki64(fp, (__int64) (offset), SEEK_SET)
+#endif
+
+/**
+ * @brief Binary dataset file read sequentially by a stream source.
+ */
+struct StreamFile {
+    FILE *fp; //!< The dataset file
+    struct DatasetHeader header; //!< The dataset header
+    int64_t row; //!< Next sample to be read
+};
+
+/**
+ * @brief Reads the next samples from a binary dataset file.
+ * @param [in] ctx The dataset file.
+ * @param [out] x The feature variables read.
+ * @param [out] y The target variables read.
+ * @param [in] n The maximum number of samples to read.
+ * @return The number of samples read.
+ */
+static int
+stream_file_read(void *ctx, double *x, double *y, const int n)
+{
+    struct StreamFile *file = ctx;
+    const struct DatasetHeader *h = &file->header;
+    const int64_t remaining = h->n_samples - file->row;
+    const int rows = (remaining < n) ? (int) remaining : n;
+    if (rows < 1) {
+        return 0;
+    }
+    const int64_t x_offset = (int64_t) sizeof(struct DatasetHeader) +
+        (int64_t) sizeof(double) * file->row * h->x_dim;
+    const int64_t y_offset = (int64_t) sizeof(struct DatasetHeader) +
+        (int64_t) sizeof(double) *
+            (h->n_samples * h->x_dim + file->row * h->y_dim);
+    const size_t n_x = (size_t) rows * h->x_dim;
+    const size_t n_y = (size_t) rows * h->y_dim;
+    if (STREAM_SEEK(file->fp, x_offset) != 0 ||
+        fread(x, sizeof(double), n_x, file->fp) != n_x ||
+        STREAM_SEEK(file->fp, y_offset) != 0 ||
+        fread(y, sizeof(double), n_y, file->fp) != n_y) {
+        printf("stream_file_read(): read error\n");
+        exit(EXIT_FAILURE);
+    }
+    file->row += rows;
+    return rows;
+}
+
+/**
+ * @brief Restarts reading a binary dataset file from the first sample.
+ * @param [in] ctx The dataset file.
+ */
+static void
+stream_file_rewind(void *ctx)
+{
+    struct StreamFile *file = ctx;
+    file->row = 0;
+}
+
+/**
+ * @brief Closes a binary dataset file.
+ * @param [in] ctx The dataset file.
+ */
+static void
+stream_file_close(void *ctx)
+{
+    struct StreamFile *file = ctx;
+    fclose(file->fp);
+    free(file);
+}
+
+/**
+ * @brief Fills a chunk buffer from the source.
+ * @details Reads until the chunk is full, starting a new epoch at the end of
+ * the source. A chunk therefore never spans the end of an epoch unless the
+ * source holds fewer samples than a chunk.
+ * @param [in] stream The stream.
+ * @param [in] b The chunk buffer to fill.
+ */
+static void
+stream_fill(struct Stream *stream, const int b)
+{
+    const struct StreamSource *src = &stream->src;
+    int rows = src->read(src->ctx, stream->x[b], stream->y[b], stream->chunk);
+    if (rows < 1) {
+        src->rewind(src->ctx);
+        ++(stream->read_epoch);
+        rows = src->read(src->ctx, stream->x[b], stream->y[b], stream->chunk);
+        if (rows < 1) {
+            printf("stream_fill(): empty source\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    stream->rows[b] = rows;
+    stream->epochs[b] = stream->read_epoch;
+}
+
+#ifdef STREAM_THREAD
+/**
+ * @brief Background reader filling each chunk buffer once it is drawn from.
+ * @param [in] arg The stream.
+ * @return NULL.
+ */
+static void *
+stream_reader(void *arg)
+{
+    struct Stream *stream = arg;
+    int b = 0;
+    while (true) {
+        pthread_mutex_lock(&stream->mutex);
+        while (stream->full[b] && !stream->stop) {
+            pthread_cond_wait(&stream->cond, &stream->mutex);
+        }
+        const bool stop = stream->stop;
+        pthread_mutex_unlock(&stream->mutex);
+        if (stop) {
+            return NULL;
+        }
+        stream_fill(stream, b);
+        pthread_mutex_lock(&stream->mutex);
+        stream->full[b] = true;
+        pthread_cond_broadcast(&stream->cond);
+        pthread_mutex_unlock(&stream->mutex);
+        b = 1 - b;
+    }
+}
+#endif
+
+/**
+ * @brief Releases the current chunk buffer and waits for the next.
+ * @param [in] stream The stream.
+ */
+static void
+stream_advance(struct Stream *stream)
+{
+    const int next = (stream->cur < 0) ? 0 : 1 - stream->cur;
+#ifdef STREAM_THREAD
+    pthread_mutex_lock(&stream->mutex);
+    if (stream->cur >= 0) {
+        stream->full[stream->cur] = false;
+        pthread_cond_broadcast(&stream->cond);
+    }
+    while (!stream->full[next]) {
+        pthread_cond_wait(&stream->cond, &stream->mutex);
+    }
+    pthread_mutex_unlock(&stream->mutex);
+#else
+    if (stream->cur >= 0) {
+        stream->full[stream->cur] = false;
+    }
+    stream_fill(stream, next);
+    stream->full[next] = true;
+#endif
+    stream->epoch = stream->epochs[next];
+    stream->cur = next;
+    stream->pos = 0;
+    const int n = stream->rows[next];
+    for (int i = 0; i < n; ++i) {
+        stream->order[i] = i;
+    }
+    if (stream->shuffle) {
+        for (int i = n - 1; i > 0; --i) {
+            const int j = rand_uniform_int(0, i + 1);
+            const int tmp = stream->order[i];
+            stream->order[i] = stream->order[j];
+            stream->order[j] = tmp;
+        }
+    }
+}
+
+/**
+ * @brief Creates a stream drawing samples from a source.
+ * @param [in] src The source of the samples, which is owned by the stream.
+ * @param [in] chunk The maximum number of samples resident in each buffer.
+ * @param [in] shuffle Whether to shuffle the samples within each chunk.
+ * @return A pointer to the new stream.
+ */
+struct Stream *
+stream_init(const struct StreamSource *src, const int chunk,
+            const bool shuffle)
+{
+    if (chunk < 1 || src->x_dim < 1 || src->y_dim < 1) {
+        printf("stream_init(): invalid chunk or source dimensions\n");
+        exit(EXIT_FAILURE);
+    }
+    struct Stream *stream = malloc(sizeof(struct Stream));
+    stream->src = *src;
+    stream->chunk = chunk;
+    stream->shuffle = shuffle;
+    for (int b = 0; b < 2; ++b) {
+        stream->x[b] = malloc(sizeof(double) * (size_t) chunk * src->x_dim);
+        stream->y[b] = malloc(sizeof(double) * (size_t) chunk * src->y_dim);
+        stream->rows[b] = 0;
+        stream->epochs[b] = 0;
+        stream->full[b] = false;
+    }
+    stream->order = malloc(sizeof(int) * chunk);
+    stream->cur = -1;
+    stream->pos = 0;
+    stream->epoch = 0;
+    stream->read_epoch = 0;
+    stream->stop = false;
+#ifdef STREAM_THREAD
+    pthread_mutex_init(&stream->mutex, NULL);
+    pthread_cond_init(&stream->cond, NULL);
+    if (pthread_create(&stream->thread, NULL, stream_reader, stream) != 0) {
+        printf("stream_init(): failed to create reader thread\n");
+        exit(EXIT_FAILURE);
+    }
+#endif
+    return stream;
+}
+
+/**
+ * @brief Creates a stream drawing samples from a binary dataset file.
+ * @param [in] filename The name of the dataset file.
+ * @param [in] chunk The maximum number of samples resident in each buffer.
+ * @param [in] shuffle Whether to shuffle the samples within each chunk.
+ * @return A pointer to the new stream.
+ */
+struct Stream *
+stream_open(const char *filename, const int chunk, const bool shuffle)
+{
+    struct StreamFile *file = malloc(sizeof(struct StreamFile));
+    file->fp = fopen(filename, "rb");
+    if (file->fp == 0) {
+        printf("Error opening file: %s. %s.\n", filename, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    const struct DatasetHeader *h = &file->header;
+    if (fread(&file->header, sizeof(struct DatasetHeader), 1, file->fp) != 1 ||
+        memcmp(h->magic, DATASET_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != DATASET_VERSION || h->dtype != DATASET_FLOAT64 ||
+        h->x_dim < 1 || h->y_dim < 1 || h->n_samples < 1) {
+        printf("Error reading file: %s. Not a dataset file\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    file->row = 0;
+    const struct StreamSource src = { file,
+                                      h->x_dim,
+                                      h->y_dim,
+                                      stream_file_read,
+                                      stream_file_rewind,
+                                      stream_file_close };
+    return stream_init(&src, chunk, shuffle);
+}
+
+/**
+ * @brief Draws the next sample from a stream.
+ * @details The returned pointers remain valid until the next call.
+ * @param [in] stream The stream.
+ * @param [out] x The feature variables of the sample.
+ * @param [out] y The target variables of the sample.
+ */
+void
+stream_next(struct Stream *stream, const double **x, const double **y)
+{
+    if (stream->cur < 0 || stream->pos >= stream->rows[stream->cur]) {
+        stream_advance(stream);
+    }
+    const int row = stream->order[stream->pos];
+    ++(stream->pos);
+    *x = &stream->x[stream->cur][(size_t) row * stream->src.x_dim];
+    *y = &stream->y[stream->cur][(size_t) row * stream->src.y_dim];
+}
+
+/**
+ * @brief Stops the background reader and frees a stream and its source.
+ * @param [in] stream The stream to be freed.
+ */
+void
+stream_free(struct Stream *stream)
+{
+#ifdef STREAM_THREAD
+    pthread_mutex_lock(&stream->mutex);
+    stream->stop = true;
+    pthread_cond_broadcast(&stream->cond);
+    pthread_mutex_unlock(&stream->mutex);
+    pthread_join(stream->thread, NULL);
+    pthread_mutex_destroy(&stream->mutex);
+    pthread_cond_destroy(&stream->cond);
+#endif
+    stream->src.close(stream->src.ctx);
+    for (int b = 0; b < 2; ++b) {
+        free(stream->x[b]);
+        free(stream->y[b]);
+    }
+    free(stream->order);
+    free(stream);
+}
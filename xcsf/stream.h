@@ -0,0 +1,96 @@
+/*
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file stream.h
+ * @author Richard Preen <rpreen@gmail.com>
+ * @copyright The Authors.
+ * @date 2020.
+ * @brief Double-buffered streaming of training data.
+ */
+
+#pragma once
+
+#include "xcsf.h"
+
+#ifndef _WIN32
+    #include <pthread.h>
+    #define STREAM_THREAD //!< Whether chunks are read on a background thread
+#endif
+
+/**
+ * @brief A source of training samples read sequentially in chunks.
+ * @details Sources are read only by the stream's background thread.
+ */
+struct StreamSource {
+    void *ctx; //!< Source specific data
+    int x_dim; //!< Number of feature variables
+    int y_dim; //!< Number of target variables
+    /**
+     * @brief Reads up to n samples, returning the number read (0 at the end).
+     */
+    int (*read)(void *ctx, double *x, double *y, const int n);
+    /**
+     * @brief Restarts the source from the first sample for a new epoch.
+     */
+    void (*rewind)(void *ctx);
+    /**
+     * @brief Releases the source specific data.
+     */
+    void (*close)(void *ctx);
+};
+
+/**
+ * @brief Training data streamed from a source through two chunk buffers.
+ * @details While samples are drawn from the current chunk, the next chunk is
+ * read into the other buffer on a background thread. At the end of the
+ * source the next epoch starts from its first sample. Samples within each
+ * chunk may be drawn in a random order, shuffling within a window of the
+ * chunk size.
+ */
+struct Stream {
+    struct StreamSource src; //!< Source of the samples
+    int chunk; //!< Maximum number of samples in each chunk
+    bool shuffle; //!< Whether to shuffle the samples within each chunk
+    double *x[2]; //!< Feature variables of each chunk buffer
+    double *y[2]; //!< Target variables of each chunk buffer
+    int rows[2]; //!< Number of samples in each chunk buffer
+    bool full[2]; //!< Whether each chunk buffer is ready to be drawn from
+    int *order; //!< Order in which the samples of the current chunk are drawn
+    int cur; //!< Chunk buffer currently drawn from (-1 before the first)
+    int pos; //!< Number of samples drawn from the current chunk
+    int epoch; //!< Number of completed passes when the current chunk was read
+    int epochs[2]; //!< Number of completed passes when each chunk was read
+    int read_epoch; //!< Number of completed passes by the reader
+    bool stop; //!< Whether the background reader should exit
+#ifdef STREAM_THREAD
+    pthread_t thread; //!< Background reader
+    pthread_mutex_t mutex; //!< Guards the buffer states
+    pthread_cond_t cond; //!< Signals changes to the buffer states
+#endif
+};
+
+struct Stream *
+stream_init(const struct StreamSource *src, const int chunk,
+            const bool shuffle);
+
+struct Stream *
+stream_open(const char *filename, const int chunk, const bool shuffle);
+
+void
+stream_next(struct Stream *stream, const double **x, const double **y);
+
+void
+stream_free(struct Stream *stream);
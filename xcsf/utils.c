@@ -66,6 +66,28 @@ rand_uniform_int(const int min, const int max)
     return (int) floor(rand_uniform(min, max));
 }
 
+/**
+ * @brief Returns the number of failed Bernoulli trials before a success.
+ * @details The gap is drawn from the geometric distribution so that elements
+ * selected independently with probability p can be visited directly, drawing
+ * one random number per selected element rather than one per element.
+ * @param [in] p The probability of success of each trial.
+ * @param [in] max The maximum number of trials to skip.
+ * @return The number of trials to skip.
+ */
+int
+rand_skip(const double p, const int max)
+{
+    if (p >= 1) {
+        return 0;
+    }
+    if (p <= 0) {
+        return max;
+    }
+    const double skip = floor(log(dsfmt_gv_genrand_open_open()) / log1p(-p));
+    return (skip < max) ? (int) skip : max;
+}
+
 /**
  * @brief Returns a random Gaussian with specified mean and standard deviation.
  * @details Box-Muller transform.
@@ -36,6 +36,9 @@ rand_uniform(const double min, const double max);
 int
 rand_uniform_int(const int min, const int max);
 
+int
+rand_skip(const double p, const int max);
+
 void
 rand_init(void);
 
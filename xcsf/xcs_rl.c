@@ -23,9 +23,11 @@
  */
 
 #include "xcs_rl.h"
+#include "checkpoint.h"
 #include "clset.h"
 #include "ea.h"
 #include "env.h"
+#include "metrics.h"
 #include "pa.h"
 #include "param.h"
 #include "perf.h"
@@ -71,6 +73,7 @@ xcs_rl_trial(struct XCSF *xcsf, double *error, const bool explore)
 
 /**
  * @brief Executes a reinforcement learning experiment.
+ * @details Stops early if the performance callback requests it.
  * @param [in] xcsf The XCSF data structure.
  * @return The mean number of steps to goal.
  */
@@ -81,15 +84,22 @@ xcs_rl_exp(struct XCSF *xcsf)
     double werr = 0; // prediction error: windowed total
     double tperf = 0; // steps to goal: total over all trials
     double wperf = 0; // steps to goal: windowed total
-    for (int cnt = 0; cnt < xcsf->MAX_TRIALS; ++cnt) {
+    int n_trials = xcsf->MAX_TRIALS;
+    metrics_start(xcsf);
+    for (int cnt = 0; cnt < n_trials; ++cnt) {
         xcs_rl_trial(xcsf, &error, true); // explore
         const double perf = xcs_rl_trial(xcsf, &error, false); // exploit
         wperf += perf;
         tperf += perf;
         werr += error;
-        perf_print(xcsf, &wperf, &werr, cnt);
+        if (perf_print(xcsf, &wperf, &werr, cnt)) {
+            n_trials = cnt + 1;
+        }
+        checkpoint_trial(xcsf, cnt);
     }
-    return tperf / xcsf->MAX_TRIALS;
+    checkpoint_wait(xcsf);
+    metrics_flush(xcsf);
+    return tperf / n_trials;
 }
 
 /**
@@ -22,14 +22,27 @@
  */
 
 #include "xcs_supervised.h"
+#include "checkpoint.h"
 #include "clset.h"
+#include "cond_dgp.h"
+#include "cond_gp.h"
 #include "ea.h"
 #include "loss.h"
+#include "metrics.h"
 #include "pa.h"
 #include "param.h"
 #include "perf.h"
+#include "sampler.h"
+#include "stream.h"
 #include "utils.h"
 
+/**
+ * @brief Number of rows matched as a block, within the limits of both the
+ * tree GP and DGP condition blocks.
+ */
+#define MATCH_BLOCK                                                            \
+    ((COND_GP_BLOCK < COND_DGP_BLOCK) ? COND_GP_BLOCK : COND_DGP_BLOCK)
+
 /**
  * @brief Selects a data sample for training or testing.
  * @param [in] data The input data.
@@ -69,26 +82,66 @@ xcs_supervised_trial(struct XCSF *xcsf, const double *x, const double *y)
 }
 
 /**
- * @brief Executes MAX_TRIALS number of XCSF learning iterations using the
- * training data and test iterations using the test data.
+ * @brief Draws the next training sample from a sampler.
+ * @param [in] src The sampler of training data.
+ * @param [in] cnt The current trial number.
+ * @param [out] x The feature variables of the sample.
+ * @param [out] y The labelled variables of the sample.
+ */
+static void
+xcs_supervised_next_sampler(void *src, const int cnt, const double **x,
+                            const double **y)
+{
+    sampler_next((struct Sampler *) src, cnt, x, y);
+}
+
+/**
+ * @brief Draws the next training sample from a stream.
+ * @param [in] src The stream of training data.
+ * @param [in] cnt The current trial number (unused).
+ * @param [out] x The feature variables of the sample.
+ * @param [out] y The labelled variables of the sample.
+ */
+static void
+xcs_supervised_next_stream(void *src, const int cnt, const double **x,
+                           const double **y)
+{
+    (void) cnt;
+    stream_next((struct Stream *) src, x, y);
+}
+
+/**
+ * @brief Executes MAX_TRIALS number of XCSF learning iterations using samples
+ * drawn from a training source and test iterations using the test data.
+ * @details Stops early if the performance callback requests it.
  * @param [in] xcsf The XCSF data structure.
- * @param [in] train_data The input data to use for training.
+ * @param [in] next Function drawing the next training sample from the source.
+ * @param [in] src The source of training data.
  * @param [in] test_data The input data to use for testing.
- * @param [in] shuffle Whether to randomise the instances during training.
+ * @param [in] shuffle Whether to draw the test instances in shuffled epochs.
  * @return The average XCSF training error using the loss function.
  */
-double
-xcs_supervised_fit(struct XCSF *xcsf, const struct Input *train_data,
-                   const struct Input *test_data, const bool shuffle)
+static double
+xcs_supervised_fit_trials(struct XCSF *xcsf,
+                          void (*next)(void *src, const int cnt,
+                                       const double **x, const double **y),
+                          void *src, const struct Input *test_data,
+                          const bool shuffle)
 {
     double err = 0; // training error: total over all trials
     double werr = 0; // training error: windowed total
     double wterr = 0; // testing error: windowed total
-    for (int cnt = 0; cnt < xcsf->MAX_TRIALS; ++cnt) {
+    struct Sampler test;
+    if (test_data != NULL) {
+        sampler_init(&test, test_data, shuffle);
+    }
+    int n_trials = xcsf->MAX_TRIALS;
+    metrics_start(xcsf);
+    for (int cnt = 0; cnt < n_trials; ++cnt) {
         // training sample
-        int row = xcs_supervised_sample(train_data, cnt, shuffle);
-        const double *x = &train_data->x[row * train_data->x_dim];
-        const double *y = &train_data->y[row * train_data->y_dim];
+        const double *x = NULL;
+        const double *y = NULL;
+        next(src, cnt, &x, &y);
         param_set_explore(xcsf, true);
         xcs_supervised_trial(xcsf, x, y);
         const double error = (xcsf->loss_ptr)(xcsf, xcsf->pa, y);
@@ -97,16 +150,101 @@ xcs_supervised_fit(struct XCSF *xcsf, const struct Input *train_data,
         xcsf->error += (error - xcsf->error) * xcsf->BETA;
         // test sample
         if (test_data != NULL) {
-            row = xcs_supervised_sample(test_data, cnt, shuffle);
-            x = &test_data->x[row * test_data->x_dim];
-            y = &test_data->y[row * test_data->y_dim];
+            sampler_next(&test, cnt, &x, &y);
             param_set_explore(xcsf, false);
             xcs_supervised_trial(xcsf, x, y);
             wterr += (xcsf->loss_ptr)(xcsf, xcsf->pa, y);
         }
-        perf_print(xcsf, &werr, &wterr, cnt);
+        if (perf_print(xcsf, &werr, &wterr, cnt)) {
+            n_trials = cnt + 1;
+        }
+        checkpoint_trial(xcsf, cnt);
+    }
+    checkpoint_wait(xcsf);
+    metrics_flush(xcsf);
+    if (test_data != NULL) {
+        sampler_free(&test);
+    }
+    return err / n_trials;
+}
+
+/**
+ * @brief Executes MAX_TRIALS number of XCSF learning iterations using the
+ * training data and test iterations using the test data.
+ * @details Stops early if the performance callback requests it.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] train_data The input data to use for training.
+ * @param [in] test_data The input data to use for testing.
+ * @param [in] shuffle Whether to draw the instances in shuffled epochs.
+ * @return The average XCSF training error using the loss function.
+ */
+double
+xcs_supervised_fit(struct XCSF *xcsf, const struct Input *train_data,
+                   const struct Input *test_data, const bool shuffle)
+{
+    struct Sampler train;
+    sampler_init(&train, train_data, shuffle);
+    const double err = xcs_supervised_fit_trials(
+        xcsf, xcs_supervised_next_sampler, &train, test_data, shuffle);
+    sampler_free(&train);
+    return err;
+}
+
+/**
+ * @brief Executes MAX_TRIALS number of XCSF learning iterations using samples
+ * drawn from a training stream and test iterations using the test data.
+ * @details Training data are drawn in the order supplied by the stream and
+ * need not fit in memory. Stops early if the performance callback requests
+ * it.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] train The stream of training data.
+ * @param [in] test_data The input data to use for testing.
+ * @param [in] shuffle Whether to draw the test instances in shuffled epochs.
+ * @return The average XCSF training error using the loss function.
+ */
+double
+xcs_supervised_fit_stream(struct XCSF *xcsf, struct Stream *train,
+                          const struct Input *test_data, const bool shuffle)
+{
+    if (train->src.x_dim != xcsf->x_dim || train->src.y_dim != xcsf->y_dim) {
+        printf("xcs_supervised_fit_stream(): mismatched dimensions\n");
+        exit(EXIT_FAILURE);
+    }
+    return xcs_supervised_fit_trials(xcsf, xcs_supervised_next_stream, train,
+                                     test_data, shuffle);
+}
+
+/**
+ * @brief Evaluates the conditions of the population over a block of rows.
+ * @details Tree GP conditions, and DGP conditions when STATEFUL is false, are
+ * evaluated over the whole block at once so that matching each row is a
+ * lookup. Other conditions are matched one row at a time as normal.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] x The input rows, or NULL to clear the block.
+ * @param [in] n The number of rows, at most MATCH_BLOCK.
+ */
+static void
+xcs_supervised_match_block(const struct XCSF *xcsf, const double *x,
+                           const int n)
+{
+    if (xcsf->cond->type == COND_TYPE_GP) {
+        cond_gp_match_block(xcsf, &xcsf->pset, x, n);
+    } else if (xcsf->cond->type == COND_TYPE_DGP && !xcsf->STATEFUL) {
+        cond_dgp_match_block(xcsf, &xcsf->pset, x, n);
     }
-    return err / xcsf->MAX_TRIALS;
+}
+
+/**
+ * @brief Returns the number of rows in a block starting at a row.
+ * @param [in] start The first row of the block.
+ * @param [in] n_samples The total number of rows.
+ * @return The number of rows in the block.
+ */
+static inline int
+xcs_supervised_block_size(const int start, const int n_samples)
+{
+    return (n_samples - start < MATCH_BLOCK) ? n_samples - start
+                                             : MATCH_BLOCK;
 }
 
 /**
@@ -121,11 +259,16 @@ xcs_supervised_predict(struct XCSF *xcsf, const double *x, double *pred,
                        const int n_samples)
 {
     param_set_explore(xcsf, false);
-    for (int row = 0; row < n_samples; ++row) {
-        xcs_supervised_trial(xcsf, &x[row * xcsf->x_dim], NULL);
-        memcpy(&pred[row * xcsf->pa_size], xcsf->pa,
-               sizeof(double) * xcsf->pa_size);
+    for (int start = 0; start < n_samples; start += MATCH_BLOCK) {
+        const int n = xcs_supervised_block_size(start, n_samples);
+        xcs_supervised_match_block(xcsf, &x[start * xcsf->x_dim], n);
+        for (int row = start; row < start + n; ++row) {
+            xcs_supervised_trial(xcsf, &x[row * xcsf->x_dim], NULL);
+            memcpy(&pred[row * xcsf->pa_size], xcsf->pa,
+                   sizeof(double) * xcsf->pa_size);
+        }
     }
+    xcs_supervised_match_block(xcsf, NULL, 0);
 }
 
 /**
@@ -139,12 +282,17 @@ xcs_supervised_score(struct XCSF *xcsf, const struct Input *data)
 {
     param_set_explore(xcsf, false);
     double err = 0;
-    for (int row = 0; row < data->n_samples; ++row) {
-        const double *x = &data->x[row * data->x_dim];
-        const double *y = &data->y[row * data->y_dim];
-        xcs_supervised_trial(xcsf, x, y);
-        err += (xcsf->loss_ptr)(xcsf, xcsf->pa, y);
+    for (int start = 0; start < data->n_samples; start += MATCH_BLOCK) {
+        const int n = xcs_supervised_block_size(start, data->n_samples);
+        xcs_supervised_match_block(xcsf, &data->x[start * data->x_dim], n);
+        for (int row = start; row < start + n; ++row) {
+            const double *x = &data->x[row * data->x_dim];
+            const double *y = &data->y[row * data->y_dim];
+            xcs_supervised_trial(xcsf, x, y);
+            err += (xcsf->loss_ptr)(xcsf, xcsf->pa, y);
+        }
     }
+    xcs_supervised_match_block(xcsf, NULL, 0);
     return err / data->n_samples;
 }
 
@@ -23,12 +23,17 @@
 
 #pragma once
 
+#include "stream.h"
 #include "xcsf.h"
 
 double
 xcs_supervised_fit(struct XCSF *xcsf, const struct Input *train_data,
                    const struct Input *test_data, const bool shuffle);
 
+double
+xcs_supervised_fit_stream(struct XCSF *xcsf, struct Stream *train,
+                          const struct Input *test_data, const bool shuffle);
+
 double
 xcs_supervised_score(struct XCSF *xcsf, const struct Input *data);
 
@@ -21,14 +21,44 @@
  * @brief System-level functions for initialising, saving, loading, etc.
  */
 
+#include "action.h"
+#include "checkpoint.h"
 #include "cl.h"
 #include "clset.h"
 #include "cond_neural.h"
+#include "condition.h"
 #include "loss.h"
+#include "neural_layer.h"
 #include "pa.h"
 #include "param.h"
+#include "precision.h"
+#include "prediction.h"
 #include "pred_neural.h"
 
+#ifndef _WIN32
+    #include <sys/mman.h>
+    #define MODEL_MMAP //!< Whether saved models are memory mapped
+#endif
+
+#ifdef __GLIBC__
+    #include <stdio_ext.h>
+    #define MODEL_UNLOCKED(fp) __fsetlocking(fp, FSETLOCKING_BYCALLER)
+#else
+    #define MODEL_UNLOCKED(fp)
+#endif
+
+#define MODEL_MAGIC ("XCSFMODL") //!< Identifies a saved model
+#define MODEL_ALIGN (64) //!< Alignment of each section of a saved model
+#define MODEL_PARAMS (0) //!< Section holding the parameters
+#define MODEL_PSET (1) //!< Section holding the population
+#define MODEL_SECTIONS (2) //!< Number of sections in a saved model
+#define MODEL_BUFFER (1 << 20) //!< Bytes buffered when streaming a model
+
+/**
+ * @brief Rounds a number of bytes up to a multiple of the section alignment.
+ */
+#define MODEL_ALIGNED(n) (((n) + MODEL_ALIGN - 1) / MODEL_ALIGN * MODEL_ALIGN)
+
 /**
  * @brief Initialises XCSF with an empty population.
  * @param [in] xcsf The XCSF data structure.
@@ -41,6 +71,8 @@ xcsf_init(struct XCSF *xcsf)
     xcsf->mset_size = 0;
     xcsf->aset_size = 0;
     xcsf->mfrac = 0;
+    xcsf->n_covered = 0;
+    xcsf->n_ea = 0;
     clset_init(&xcsf->pset);
     clset_init(&xcsf->prev_pset);
 }
@@ -75,8 +107,136 @@ xcsf_print_pset(const struct XCSF *xcsf, const bool print_cond,
     clset_print(xcsf, &xcsf->pset, print_cond, print_act, print_pred);
 }
 
+/**
+ * @brief Header of a saved XCSF model.
+ * @details The header is followed by the sections listed in its table, each
+ * aligned to MODEL_ALIGN bytes. The format is only a container: the
+ * parameters and population sections hold the same elements as the
+ * corresponding parts of the legacy format and are parsed element by element.
+ * Loaded classifiers therefore own their memory and nothing refers to the file
+ * once it has been read; classifiers are not mapped for read-only use.
+ */
+struct ModelHeader {
+    char magic[8]; //!< File identifier
+    int32_t major; //!< Major version number
+    int32_t minor; //!< Minor version number
+    int32_t build; //!< Build version number
+    int32_t precision; //!< Number of bytes used by the real type
+    int32_t n_sections; //!< Number of sections
+    int32_t reserved; //!< Unused
+    uint64_t offset[MODEL_SECTIONS]; //!< File offset of each section
+    uint64_t size[MODEL_SECTIONS]; //!< Number of bytes in each section
+};
+
+/**
+ * @brief Exits if a saved model was written by an incompatible build.
+ * @param [in] filename The name of the saved model.
+ * @param [in] major The major version number of the saved model.
+ * @param [in] minor The minor version number of the saved model.
+ * @param [in] precision The number of bytes used by the real type.
+ */
+static void
+xcsf_check_version(const char *filename, const int major, const int minor,
+                   const int precision)
+{
+    if (major != VERSION_MAJOR || minor != VERSION_MINOR) {
+        printf("Error loading file: %s. Version mismatch. ", filename);
+        printf("This version: %d.%d\n", VERSION_MAJOR, VERSION_MINOR);
+        printf("Loaded version: %d.%d\n", major, minor);
+        exit(EXIT_FAILURE);
+    }
+    if (precision != (int) sizeof(real)) {
+        printf("Error loading file: %s. Precision mismatch. ", filename);
+        printf("This build: %d bytes\n", (int) sizeof(real));
+        printf("Loaded file: %d bytes\n", precision);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Writes a section of a saved model.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] section Which section to write.
+ * @param [in] fp Pointer to the file to be written.
+ * @return The number of elements written.
+ */
+static size_t
+xcsf_save_section(const struct XCSF *xcsf, const int section, FILE *fp)
+{
+    if (section == MODEL_PARAMS) {
+        return param_save(xcsf, fp);
+    }
+    return clset_pset_save(xcsf, fp);
+}
+
+/**
+ * @brief Reads a section of a saved model.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] section Which section to read.
+ * @param [in] fp Pointer to the file to be read.
+ * @return The number of elements read.
+ */
+static size_t
+xcsf_load_section(struct XCSF *xcsf, const int section, FILE *fp)
+{
+    if (section == MODEL_PARAMS) {
+        return param_load(xcsf, fp);
+    }
+    return clset_pset_load(xcsf, fp);
+}
+
+/**
+ * @brief Pads a saved model with zeros up to the section alignment.
+ * @param [in] fp Pointer to the file being written.
+ * @return The file offset after padding.
+ */
+static uint64_t
+xcsf_save_pad(FILE *fp)
+{
+    static const char zeros[MODEL_ALIGN] = { 0 };
+    const uint64_t pos = (uint64_t) ftell(fp);
+    const uint64_t aligned = MODEL_ALIGNED(pos);
+    fwrite(zeros, sizeof(char), aligned - pos, fp);
+    return aligned;
+}
+
+/**
+ * @brief Writes the current state of XCSF to a stream.
+ * @details The header is rewritten with the section table once all sections
+ * are known, leaving the stream positioned at its end.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] fp Pointer to a seekable stream positioned at its start.
+ * @return The total number of elements written.
+ */
+size_t
+xcsf_write(const struct XCSF *xcsf, FILE *fp)
+{
+    struct ModelHeader header;
+    memset(&header, 0, sizeof(struct ModelHeader));
+    memcpy(header.magic, MODEL_MAGIC, sizeof(header.magic));
+    header.major = VERSION_MAJOR;
+    header.minor = VERSION_MINOR;
+    header.build = VERSION_BUILD;
+    header.precision = sizeof(real);
+    header.n_sections = MODEL_SECTIONS;
+    size_t s = fwrite(&header, sizeof(struct ModelHeader), 1, fp);
+    for (int i = 0; i < MODEL_SECTIONS; ++i) {
+        header.offset[i] = xcsf_save_pad(fp);
+        s += xcsf_save_section(xcsf, i, fp);
+        header.size[i] = (uint64_t) ftell(fp) - header.offset[i];
+    }
+    const long end = (long) xcsf_save_pad(fp);
+    fseek(fp, 0, SEEK_SET);
+    fwrite(&header, sizeof(struct ModelHeader), 1, fp);
+    fseek(fp, end, SEEK_SET);
+    return s;
+}
+
 /**
  * @brief Writes the current state of XCSF to a file.
+ * @details The model is first serialised into memory and then written to the
+ * file unbuffered with a single call, at the cost of holding a copy of the
+ * model in memory while saving.
  * @param [in] xcsf The XCSF data structure.
  * @param [in] filename The name of the output file.
  * @return The total number of elements written.
@@ -89,18 +249,181 @@ xcsf_save(const struct XCSF *xcsf, const char *filename)
         printf("Error saving file: %s. %s.\n", filename, strerror(errno));
         exit(EXIT_FAILURE);
     }
-    size_t s = 0;
-    s += fwrite(&VERSION_MAJOR, sizeof(int), 1, fp);
-    s += fwrite(&VERSION_MINOR, sizeof(int), 1, fp);
-    s += fwrite(&VERSION_BUILD, sizeof(int), 1, fp);
-    s += param_save(xcsf, fp);
-    s += clset_pset_save(xcsf, fp);
+    setvbuf(fp, NULL, _IONBF, 0);
+    char *buffer = NULL;
+    size_t size = 0;
+    const size_t s = xcsf_serialise(xcsf, &buffer, &size);
+    const size_t written = fwrite(buffer, sizeof(char), size, fp);
+    free(buffer);
+    if (written != size || fclose(fp) != 0) {
+        printf("Error saving file: %s. %s.\n", filename, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    return s;
+}
+
+/**
+ * @brief Writes the current state of XCSF to a memory buffer.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [out] buffer The newly allocated buffer, to be freed by the caller.
+ * @param [out] size The number of bytes in the buffer.
+ * @return The total number of elements written.
+ */
+size_t
+xcsf_serialise(const struct XCSF *xcsf, char **buffer, size_t *size)
+{
+#ifdef _WIN32
+    FILE *fp = tmpfile();
+    const size_t s = xcsf_write(xcsf, fp);
+    *size = (size_t) ftell(fp);
+    *buffer = malloc(*size);
+    rewind(fp);
+    *size = fread(*buffer, sizeof(char), *size, fp);
+#else
+    FILE *fp = open_memstream(buffer, size);
+    MODEL_UNLOCKED(fp);
+    const size_t s = xcsf_write(xcsf, fp);
+#endif
     fclose(fp);
     return s;
 }
 
+/**
+ * @brief Reads the state of XCSF from a file in the legacy format.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] filename The name of the input file.
+ * @param [in] fp Pointer to the file positioned at its start.
+ * @return The total number of elements read.
+ */
+static size_t
+xcsf_load_legacy(struct XCSF *xcsf, const char *filename, FILE *fp)
+{
+    size_t s = 0;
+    int major = 0;
+    int minor = 0;
+    int build = 0;
+    s += fread(&major, sizeof(int), 1, fp);
+    s += fread(&minor, sizeof(int), 1, fp);
+    s += fread(&build, sizeof(int), 1, fp);
+    int precision = sizeof(double);
+    if (build > 0 && major == VERSION_MAJOR && minor == VERSION_MINOR) {
+        s += fread(&precision, sizeof(int), 1, fp);
+    }
+    xcsf_check_version(filename, major, minor, precision);
+    xcsf->load_build = build;
+    s += param_load(xcsf, fp);
+    s += clset_pset_load(xcsf, fp);
+    xcsf->load_build = VERSION_BUILD;
+    return s;
+}
+
+/**
+ * @brief Exits if a model header is incompatible with this build.
+ * @param [in] filename The name of the saved model.
+ * @param [in] header The model header.
+ */
+static void
+xcsf_check_header(const char *filename, const struct ModelHeader *header)
+{
+    xcsf_check_version(filename, header->major, header->minor,
+                       header->precision);
+    if (header->n_sections < MODEL_SECTIONS) {
+        printf("Error loading file: %s. Missing sections\n", filename);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Opens a read-only stream over a block of memory.
+ * @param [in] data The start of the block.
+ * @param [in] size The number of bytes in the block.
+ * @return Pointer to the stream.
+ */
+static FILE *
+xcsf_open_memory(const char *data, const size_t size)
+{
+#ifdef _WIN32
+    FILE *fp = tmpfile();
+    fwrite(data, sizeof(char), size, fp);
+    rewind(fp);
+#else
+    FILE *fp = fmemopen((void *) (uintptr_t) data, size, "rb");
+    MODEL_UNLOCKED(fp);
+#endif
+    return fp;
+}
+
+/**
+ * @brief Reads the sections of a saved model held in memory.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] filename The name of the saved model.
+ * @param [in] data The start of the saved model.
+ * @param [in] size The number of bytes in the saved model.
+ * @param [in] header The model header.
+ * @return The number of elements read from the sections.
+ */
+static size_t
+xcsf_load_memory(struct XCSF *xcsf, const char *filename, const char *data,
+                 const size_t size, const struct ModelHeader *header)
+{
+    size_t s = 0;
+    xcsf->load_build = header->build;
+    for (int i = 0; i < MODEL_SECTIONS; ++i) {
+        if (header->offset[i] + header->size[i] > size) {
+            printf("Error loading file: %s. Truncated\n", filename);
+            exit(EXIT_FAILURE);
+        }
+        FILE *mem = xcsf_open_memory(data + header->offset[i], header->size[i]);
+        s += xcsf_load_section(xcsf, i, mem);
+        fclose(mem);
+    }
+    xcsf->load_build = VERSION_BUILD;
+    return s;
+}
+
+/**
+ * @brief Reads the sections of a saved model.
+ * @details The file is memory mapped and each section is parsed from the
+ * mapping through a stream, which avoids a read call per element but still
+ * copies every element into newly allocated classifiers. Where mapping is
+ * unavailable, each section is read from the file.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] filename The name of the input file.
+ * @param [in] fp Pointer to the file.
+ * @param [in] header The model header.
+ * @return The number of elements read from the sections.
+ */
+static size_t
+xcsf_load_model(struct XCSF *xcsf, const char *filename, FILE *fp,
+                const struct ModelHeader *header)
+{
+    xcsf_check_header(filename, header);
+#ifdef MODEL_MMAP
+    fseek(fp, 0, SEEK_END);
+    const size_t file_size = (size_t) ftell(fp);
+    void *map = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+    if (map != MAP_FAILED) {
+        posix_madvise(map, file_size, POSIX_MADV_SEQUENTIAL);
+        const size_t s =
+            xcsf_load_memory(xcsf, filename, map, file_size, header);
+        munmap(map, file_size);
+        return s;
+    }
+#endif
+    size_t s = 0;
+    setvbuf(fp, NULL, _IOFBF, MODEL_BUFFER);
+    xcsf->load_build = header->build;
+    for (int i = 0; i < MODEL_SECTIONS; ++i) {
+        fseek(fp, (long) header->offset[i], SEEK_SET);
+        s += xcsf_load_section(xcsf, i, fp);
+    }
+    xcsf->load_build = VERSION_BUILD;
+    return s;
+}
+
 /**
  * @brief Reads the state of XCSF from a file.
+ * @details Files written in the legacy format are also read.
  * @param [in] xcsf The XCSF data structure.
  * @param [in] filename The name of the input file.
  * @return The total number of elements read.
@@ -117,26 +440,52 @@ xcsf_load(struct XCSF *xcsf, const char *filename)
         printf("Error loading file: %s. %s.\n", filename, strerror(errno));
         exit(EXIT_FAILURE);
     }
-    size_t s = 0;
-    int major = 0;
-    int minor = 0;
-    int build = 0;
-    s += fread(&major, sizeof(int), 1, fp);
-    s += fread(&minor, sizeof(int), 1, fp);
-    s += fread(&build, sizeof(int), 1, fp);
-    if (major != VERSION_MAJOR || minor != VERSION_MINOR) {
-        printf("Error loading file: %s. Version mismatch. ", filename);
-        printf("This version: %d.%d\n", VERSION_MAJOR, VERSION_MINOR);
-        printf("Loaded version: %d.%d\n", major, minor);
-        fclose(fp);
-        exit(EXIT_FAILURE);
+    MODEL_UNLOCKED(fp);
+    struct ModelHeader header;
+    size_t s = fread(&header, sizeof(struct ModelHeader), 1, fp);
+    if (s == 1 &&
+        memcmp(header.magic, MODEL_MAGIC, sizeof(header.magic)) == 0) {
+        s += xcsf_load_model(xcsf, filename, fp, &header);
+    } else {
+        rewind(fp);
+        s = xcsf_load_legacy(xcsf, filename, fp);
     }
-    s += param_load(xcsf, fp);
-    s += clset_pset_load(xcsf, fp);
     fclose(fp);
     return s;
 }
 
+/**
+ * @brief Reads the state of XCSF from a memory buffer.
+ * @details The buffer must hold a model written by xcsf_serialise() or
+ * xcsf_save(); the legacy format is not read.
+ * @param [in] xcsf The XCSF data structure.
+ * @param [in] buffer The serialised model.
+ * @param [in] size The number of bytes in the buffer.
+ * @return The total number of elements read.
+ */
+size_t
+xcsf_deserialise(struct XCSF *xcsf, const char *buffer, const size_t size)
+{
+    const char *name = "<memory>";
+    struct ModelHeader header;
+    if (size < sizeof(struct ModelHeader)) {
+        printf("Error loading file: %s. Truncated\n", name);
+        exit(EXIT_FAILURE);
+    }
+    memcpy(&header, buffer, sizeof(struct ModelHeader));
+    if (memcmp(header.magic, MODEL_MAGIC, sizeof(header.magic)) != 0) {
+        printf("Error loading file: %s. Not a saved model\n", name);
+        exit(EXIT_FAILURE);
+    }
+    xcsf_check_header(name, &header);
+    if (xcsf->pset.size > 0) {
+        clset_kill(xcsf, &xcsf->pset);
+        clset_init(&xcsf->pset);
+    }
+    const size_t s = 1; // the header
+    return s + xcsf_load_memory(xcsf, name, buffer, size, &header);
+}
+
 /**
  * @brief Inserts a new hidden layer before the output layer within all
  * prediction neural networks in the population.
@@ -147,6 +496,7 @@ xcsf_pred_expand(const struct XCSF *xcsf)
 {
     const struct Clist *iter = xcsf->pset.list;
     while (iter != NULL) {
+        cl_unshare(xcsf, iter->cl);
         pred_neural_expand(xcsf, iter->cl);
         iter->cl->fit = xcsf->INIT_FITNESS;
         iter->cl->err = xcsf->INIT_ERROR;
@@ -171,6 +521,7 @@ xcsf_ae_to_classifier(struct XCSF *xcsf, const int y_dim, const int n_del)
     pa_init(xcsf);
     const struct Clist *iter = xcsf->pset.list;
     while (iter != NULL) {
+        cl_unshare(xcsf, iter->cl);
         free(iter->cl->prediction);
         iter->cl->prediction = calloc(xcsf->y_dim, sizeof(double));
         pred_neural_ae_to_classifier(xcsf, iter->cl, n_del);
@@ -182,19 +533,66 @@ xcsf_ae_to_classifier(struct XCSF *xcsf, const int y_dim, const int n_del)
     }
 }
 
+/**
+ * @brief Returns whether classifiers may share components with a snapshot.
+ * @details Components that carry state from one trial to the next are
+ * modified by matching and prediction, and so must be copied when stored.
+ * @param [in] xcsf The XCSF data structure.
+ * @return Whether the population can be stored by sharing components.
+ */
+bool
+xcsf_pset_shareable(const struct XCSF *xcsf)
+{
+    switch (xcsf->cond->type) {
+        case COND_TYPE_DGP:
+        case RULE_TYPE_DGP:
+            if (xcsf->STATEFUL) {
+                return false;
+            }
+            break;
+        case COND_TYPE_NEURAL:
+        case RULE_TYPE_NEURAL:
+        case RULE_TYPE_NETWORK:
+            if (layer_args_stateful(xcsf->cond->largs)) {
+                return false;
+            }
+            break;
+        default:
+            break;
+    }
+    if (xcsf->pred->type == PRED_TYPE_NEURAL &&
+        layer_args_stateful(xcsf->pred->largs)) {
+        return false;
+    }
+    if (xcsf->act->type == ACT_TYPE_NEURAL &&
+        layer_args_stateful(xcsf->act->largs)) {
+        return false;
+    }
+    return true;
+}
+
 /**
  * @brief Stores the current population.
+ * @details Where possible, the stored classifiers share their conditions,
+ * predictions, and actions with the current population, which are then only
+ * copied when modified. A classifier shares with at most one other, so any
+ * checkpoint still sharing the population is completed first.
  * @param [in] xcsf The XCSF data structure.
  */
 void
 xcsf_store_pset(struct XCSF *xcsf)
 {
+    checkpoint_wait(xcsf);
     clset_kill(xcsf, &xcsf->prev_pset);
+    const bool share = xcsf_pset_shareable(xcsf);
     const struct Clist *iter = xcsf->pset.list;
     while (iter != NULL) {
         struct Cl *new = malloc(sizeof(struct Cl));
-        const struct Cl *src = iter->cl;
-        cl_init_copy(xcsf, new, src);
+        if (share) {
+            cl_share(xcsf, new, iter->cl);
+        } else {
+            cl_init_copy(xcsf, new, iter->cl);
+        }
         clset_add(&xcsf->prev_pset, new);
         iter = iter->next;
     }
@@ -202,6 +600,8 @@ xcsf_store_pset(struct XCSF *xcsf)
 
 /**
  * @brief Retrieves the previously stored population.
+ * @details Components still shared with the current population are handed
+ * to the stored classifiers as the current population is freed.
  * @param [in] xcsf The XCSF data structure.
  */
 void
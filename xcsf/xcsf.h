@@ -36,7 +36,7 @@
 
 static const int VERSION_MAJOR = 1; //!< XCSF major version number
 static const int VERSION_MINOR = 2; //!< XCSF minor version number
-static const int VERSION_BUILD = 0; //!< XCSF build version number
+static const int VERSION_BUILD = 2; //!< XCSF build version number
 
 /**
  * @brief Classifier data structure.
@@ -59,6 +59,7 @@ struct Cl {
     int action; //!< Current classifier action
     int age; //!< Total number of times match testing been performed
     int mtotal; //!< Total number of times actually matched an input
+    struct Cl *share; //!< Classifier sharing the condition, pred, and action
 };
 
 /**
@@ -93,7 +94,10 @@ struct XCSF {
     struct ArgsPred *pred; //!< Prediction parameters
     struct ArgsEA *ea; //!< EA parameters
     struct EnvVtbl const *env_vptr; //!< Functions acting on environments
+    struct PipelineVtbl const *pipe_vptr; //!< Set-level trial functions
     void *env; //!< Environment structure (for built-in problems)
+    struct Checkpoint *checkpoint; //!< Background checkpoint writer
+    struct Metrics *metrics; //!< Performance log
     double error; //!< Average system error
     double mset_size; //!< Average match set size
     double aset_size; //!< Average action set size
@@ -103,14 +107,20 @@ struct XCSF {
     double *pa; //!< Prediction array (stores fitness weighted predictions)
     double *nr; //!< Prediction array (stores total fitness)
     double *prev_state; //!< Environment state on the previous step
+    unsigned long n_covered; //!< Number of classifiers created by covering
+    unsigned long n_ea; //!< Number of times the EA has run
     int time; //!< Current number of EA executions
     int pa_size; //!< Prediction array size
+    int load_build; //!< Build version number of the model being loaded
     int x_dim; //!< Number of problem input variables
     int y_dim; //!< Number of problem output variables
     int n_actions; //!< Number of class labels / actions
     bool explore; //!< Whether the system is currently exploring or exploiting
     double (*loss_ptr)(const struct XCSF *, const double *,
                        const double *); //!< Error function
+    bool (*perf_ptr)(const struct XCSF *, void *, const int, const double,
+                     const double); //!< Performance callback; true stops
+    void *perf_data; //!< Data passed to the performance callback
     double GAMMA; //!< Discount factor for multi-step reward
     double P_EXPLORE; //!< Probability of exploring vs. exploiting
     double ALPHA; //!< Linear coefficient used to calculate classifier accuracy
@@ -124,6 +134,10 @@ struct XCSF {
     int OMP_NUM_THREADS; //!< Number of threads for parallel processing
     int MAX_TRIALS; //!< Number of problem instances to run in one experiment
     int PERF_TRIALS; //!< Number of problem instances to avg performance output
+    int CHECKPOINT_TRIALS; //!< Number of problem instances between checkpoints
+    char *CHECKPOINT_FILE; //!< Name of the file checkpoints are written to
+    int METRICS_FORMAT; //!< Format of the performance log
+    char *METRICS_FILE; //!< Name of the file the performance log is written to
     int POP_SIZE; //!< Maximum number of micro-classifiers in the population
     int LOSS_FUNC; //!< Which loss/error function to apply
     int TELETRANSPORTATION; //!< Maximum steps for a multi-step problem
@@ -153,6 +167,15 @@ xcsf_load(struct XCSF *xcsf, const char *filename);
 size_t
 xcsf_save(const struct XCSF *xcsf, const char *filename);
 
+size_t
+xcsf_write(const struct XCSF *xcsf, FILE *fp);
+
+size_t
+xcsf_serialise(const struct XCSF *xcsf, char **buffer, size_t *size);
+
+size_t
+xcsf_deserialise(struct XCSF *xcsf, const char *buffer, const size_t size);
+
 void
 xcsf_free(struct XCSF *xcsf);
 
@@ -174,3 +197,6 @@ xcsf_retrieve_pset(struct XCSF *xcsf);
 
 void
 xcsf_store_pset(struct XCSF *xcsf);
+
+bool
+xcsf_pset_shareable(const struct XCSF *xcsf);